@@ -29,6 +29,7 @@
 #include <OpenSim/Tools/AnalyzeTool.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Analyses/InducedAccelerationsSolver.h>
+#include <OpenSim/Analyses/InducedAccelerations.h>
 
 using namespace OpenSim;
 using namespace SimTK;
@@ -49,11 +50,50 @@ int main()
 		// check that analysis version still works
 		testDoublePendulum();
 
+		// Also record all coordinates and some bodies, which the joint solve
+		// below is compared against
+		Array<string> coordNames("all", 1), bodyNames;
+		bodyNames.append("pelvis");
+		bodyNames.append("calcn_r");
+		bodyNames.append("torso");
+		bodyNames.append("hand_l");
+		bodyNames.append("center_of_mass");
+
 		AnalyzeTool analyze("subject02_Setup_IAA_02_232.xml");
+		InducedAccelerations& iaa = dynamic_cast<InducedAccelerations&>(
+			analyze.getModel().updAnalysisSet().get("InducedAccelerations"));
+		iaa.setCoordNames(coordNames);
+		iaa.setBodyNames(bodyNames);
 		analyze.run();
 		Storage result1("ResultsInducedAccelerations/subject02_running_arms_InducedAccelerations_center_of_mass.sto"), standard1("std_subject02_running_arms_InducedAccelerations_CENTER_OF_MASS.sto");
 		CHECK_STORAGE_AGAINST_STANDARD(result1, standard1, Array<double>(0.15, result1.getSmallestNumberOfStates()), __FILE__, __LINE__, "Induced Accelerations of Running failed");
 		cout << "Induced Accelerations of Running passed\n" << endl;
+
+		// Gravity and the actuators solved together must match the
+		// accelerations induced when each is realized on its own, for every
+		// coordinate, body and the center of mass
+		AnalyzeTool analyzeJointly("subject02_Setup_IAA_02_232.xml");
+		analyzeJointly.setResultsDir("ResultsInducedAccelerationsJointly");
+		InducedAccelerations& iaaJointly = dynamic_cast<InducedAccelerations&>(
+			analyzeJointly.getModel().updAnalysisSet().get("InducedAccelerations"));
+		iaaJointly.setCoordNames(coordNames);
+		iaaJointly.setBodyNames(bodyNames);
+		iaaJointly.setSolveContributorsJointly(true);
+		double startTime = SimTK::realTime();
+		analyzeJointly.run();
+		cout << "Jointly solved Induced Accelerations of Running in " << 1.e3*(SimTK::realTime()-startTime) << "ms\n" << endl;
+
+		Array<string> names(bodyNames);
+		const CoordinateSet& coords = analyze.getModel().getCoordinateSet();
+		for(int i=0; i<coords.getSize(); ++i)
+			names.append(coords[i].getName());
+		for(int i=0; i<names.getSize(); ++i){
+			string file = "subject02_running_arms_InducedAccelerations_"+names[i]+".sto";
+			Storage sequential("ResultsInducedAccelerations/"+file), jointly("ResultsInducedAccelerationsJointly/"+file);
+			ASSERT(jointly.getSize()==sequential.getSize(), __FILE__, __LINE__, "Jointly solved Induced Accelerations of "+names[i]+" have a different number of rows");
+			CHECK_STORAGE_AGAINST_STANDARD(jointly, sequential, Array<double>(1e-6, sequential.getSmallestNumberOfStates()), __FILE__, __LINE__, "Jointly solved Induced Accelerations of "+names[i]+" failed");
+		}
+		cout << "Jointly solved Induced Accelerations of Running passed\n" << endl;
 	}
 	catch (const OpenSim::Exception& e) {
         e.print(cerr);
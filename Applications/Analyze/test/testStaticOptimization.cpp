@@ -125,6 +125,66 @@ void testArm26(const string& muscleModelClassName, double actTol, double forceTo
                                     __FILE__, __LINE__, 
                                     "Arm26 forces "+muscName+" failed.");
     cout << resultsDir <<": test Arm26 passed." << endl;
+
+	// Solving the frames in parallel must reproduce the sequential solution
+	AnalyzeTool analyze3("arm26_Setup_StaticOptimization.xml");
+	analyze3.setResultsDir(resultsDir+"_parallel");
+	StaticOptimization& so = dynamic_cast<StaticOptimization&>(
+		analyze3.getModel().updAnalysisSet().get("StaticOptimization"));
+	so.setNumThreads(4);
+	analyze3.run();
+
+	Storage activations3(
+		resultsDir+"_parallel/arm26_StaticOptimization_activation.sto");
+	Storage forces3(resultsDir+"_parallel/arm26_StaticOptimization_force.sto");
+	ASSERT(activations3.getSize() == activations1.getSize());
+
+	CHECK_STORAGE_AGAINST_STANDARD(activations3, activations1, 
+        Array<double>(actTol, 6), 
+        __FILE__, __LINE__, 
+        "Arm26 activations "+muscName+" solved in parallel failed.");
+
+	CHECK_STORAGE_AGAINST_STANDARD(forces3, forces1, 
+        Array<double>(forceTol, 6),
+        __FILE__,  __LINE__, 
+        "Arm26 forces "+muscName+" solved in parallel failed.");
+    cout << resultsDir <<": test Arm26 in parallel passed." << endl;
+
+	// Warm starting each chunk from its previous frame must reproduce the
+	// warm started sequential solution
+	AnalyzeTool analyze4("arm26_Setup_StaticOptimization.xml");
+	analyze4.setResultsDir(resultsDir+"_warm");
+	StaticOptimization& soWarm = dynamic_cast<StaticOptimization&>(
+		analyze4.getModel().updAnalysisSet().get("StaticOptimization"));
+	soWarm.setUseWarmStart(true);
+	analyze4.run();
+
+	AnalyzeTool analyze5("arm26_Setup_StaticOptimization.xml");
+	analyze5.setResultsDir(resultsDir+"_warm_parallel");
+	StaticOptimization& soWarmParallel = dynamic_cast<StaticOptimization&>(
+		analyze5.getModel().updAnalysisSet().get("StaticOptimization"));
+	soWarmParallel.setUseWarmStart(true);
+	soWarmParallel.setNumThreads(4);
+	analyze5.run();
+
+	Storage activations4(resultsDir+"_warm/arm26_StaticOptimization_activation.sto");
+	Storage forces4(resultsDir+"_warm/arm26_StaticOptimization_force.sto");
+	Storage activations5(
+		resultsDir+"_warm_parallel/arm26_StaticOptimization_activation.sto");
+	Storage forces5(
+		resultsDir+"_warm_parallel/arm26_StaticOptimization_force.sto");
+	ASSERT(activations5.getSize() == activations4.getSize());
+
+	CHECK_STORAGE_AGAINST_STANDARD(activations5, activations4, 
+        Array<double>(actTol, 6), 
+        __FILE__, __LINE__, 
+        "Arm26 activations "+muscName+" warm started in parallel failed.");
+
+	CHECK_STORAGE_AGAINST_STANDARD(forces5, forces4, 
+        Array<double>(forceTol, 6),
+        __FILE__,  __LINE__, 
+        "Arm26 forces "+muscName+" warm started in parallel failed.");
+    cout << resultsDir <<": test Arm26 warm started in parallel passed." << endl;
   
 	
 	cout << "=============================================================\n" << endl;
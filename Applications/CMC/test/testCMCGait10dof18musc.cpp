@@ -58,7 +58,11 @@ void testGait10dof18musc() {
 	cout << "*                      testGait10dof18musc                       *" << endl;
 	cout << "******************************************************************\n" << endl;
 	CMCTool cmc("gait10dof18musc_Setup_CMC.xml");
+	// Most of the time is spent integrating the actuator system for the
+	// root solves of the excitations.
+	double startTime = SimTK::realTime();
 	cmc.run();
+	cout << "CMC of gait10dof18musc took " << SimTK::realTime()-startTime << "s\n" << endl;
 
 	Storage results("gait10dof18musc_ResultsCMC/walk_subject_states.sto");
 	Storage temp("gait10dof18musc_std_walk_subject_states.sto");
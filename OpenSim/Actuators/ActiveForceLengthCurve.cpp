@@ -64,6 +64,8 @@ ActiveForceLengthCurve::ActiveForceLengthCurve(double minActiveNormFiberLength,
 void ActiveForceLengthCurve::setNull()
 {
     setAuthors("Matthew Millard");
+    m_useLookupTable = false;
+    m_lookupTableTolerance = 1e-8;
 }
 
 void ActiveForceLengthCurve::constructProperties()
@@ -86,6 +88,8 @@ void ActiveForceLengthCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(m_useLookupTable)
+        m_curve.setUseLookupTable(true, m_lookupTableTolerance);
     setObjectIsUpToDateWithProperties();
 }
 
@@ -169,6 +173,43 @@ double ActiveForceLengthCurve::calcDerivative(double normFiberLength,
     return m_curve.calcDerivative(normFiberLength,order);
 }
 
+void ActiveForceLengthCurve::
+    calcValueAndDerivatives(int n, const double* normFiberLengths, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ActiveForceLengthCurve: Curve is not up-to-date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, normFiberLengths, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& ActiveForceLengthCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ActiveForceLengthCurve: Curve is not up-to-date with its properties");
+    return m_curve;
+}
+
+void ActiveForceLengthCurve::setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "ActiveForceLengthCurve::setUseLookupTable",
+        "tolerance must be greater than 0, but %e was entered", tolerance);
+
+    if(isObjectUpToDateWithProperties()) {
+        m_curve.setUseLookupTable(useTable, tolerance);
+    }
+    m_useLookupTable = useTable;
+    m_lookupTableTolerance = tolerance;
+}
+
+bool ActiveForceLengthCurve::getUseLookupTable() const
+{   return m_useLookupTable; }
+
 SimTK::Vec2 ActiveForceLengthCurve::getCurveDomain() const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
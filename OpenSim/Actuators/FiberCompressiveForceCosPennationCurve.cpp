@@ -248,6 +248,29 @@ double FiberCompressiveForceCosPennationCurve::
     return m_curve.calcDerivative(cosPennationAngle,order);
 }
 
+void FiberCompressiveForceCosPennationCurve::
+    calcValueAndDerivatives(int n, const double* cosPennationAngles, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveCosPennationCurve: Curve is not"
+        " to date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, cosPennationAngles, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& FiberCompressiveForceCosPennationCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveCosPennationCurve: Curve is not"
+        " to date with its properties");
+    return m_curve;
+}
+
 double FiberCompressiveForceCosPennationCurve::
     calcIntegral(double cosPennationAngle) const
 {    
@@ -252,6 +252,29 @@ double FiberCompressiveForceLengthCurve::
     return m_curve.calcDerivative(aNormLength,order);
 }
 
+void FiberCompressiveForceLengthCurve::
+    calcValueAndDerivatives(int n, const double* aNormLengths, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveForceLengthCurve: Curve is not"
+        " to date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, aNormLengths, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& FiberCompressiveForceLengthCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
+        "FiberCompressiveForceLengthCurve: Curve is not"
+        " to date with its properties");
+    return m_curve;
+}
+
 SimTK::Vec2 FiberCompressiveForceLengthCurve::getCurveDomain() const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties()==true,
@@ -274,6 +274,32 @@ public:
     */
     double calcDerivative(double aNormLength, int order) const;
 
+    /** Calculates the value and the first and second derivatives of the fiber-
+    compressive-force-length curve at n values of the normalized fiber length
+    together. The curve is inverted once per point for all three quantities,
+    and points are evaluated in vectorized loops where possible (see
+    SmoothSegmentedFunction::calcValueAndDerivatives).
+    @param n
+        The number of points.
+    @param aNormLengths
+        The n values of the normalized fiber length.
+    @param value
+        The n values of the curve, or NULL if they are not needed.
+    @param firstDerivative
+        The n first derivatives of the curve, or NULL if they are not needed.
+    @param secondDerivative
+        The n second derivatives of the curve, or NULL if they are not needed.
+    */
+    void calcValueAndDerivatives(int n, const double* aNormLengths,
+                                 double* value,
+                                 double* firstDerivative = NULL,
+                                 double* secondDerivative = NULL) const;
+
+    /** @returns The SmoothSegmentedFunction that implements the curve, for
+    evaluating the curves of several muscles together with 
+    SmoothSegmentedFunction::calcValueAndDerivatives. */
+    const SmoothSegmentedFunction& getSmoothSegmentedFunction() const;
+
     /**     
     @param aNormLength
                 Here aNormLength = l/l0, where l is the length 
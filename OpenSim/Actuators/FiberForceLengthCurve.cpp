@@ -67,6 +67,8 @@ FiberForceLengthCurve::FiberForceLengthCurve(double strainAtZeroForce,
 void FiberForceLengthCurve::setNull()
 {
     setAuthors("Matthew Millard");
+    m_useLookupTable = false;
+    m_lookupTableTolerance = 1e-8;
 }
 
 void FiberForceLengthCurve::constructProperties()
@@ -92,6 +94,8 @@ void FiberForceLengthCurve::buildCurve(bool computeIntegral)
 
     m_curve = *f;
     delete f;
+    if(m_useLookupTable)
+        m_curve.setUseLookupTable(true, m_lookupTableTolerance);
 
     setObjectIsUpToDateWithProperties();
 }
@@ -230,6 +234,43 @@ double FiberForceLengthCurve::calcDerivative(double normFiberLength,
     return m_curve.calcDerivative(normFiberLength,order);
 }
 
+void FiberForceLengthCurve::
+    calcValueAndDerivatives(int n, const double* normFiberLengths, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceLengthCurve: Curve is not up-to-date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, normFiberLengths, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& FiberForceLengthCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceLengthCurve: Curve is not up-to-date with its properties");
+    return m_curve;
+}
+
+void FiberForceLengthCurve::setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "FiberForceLengthCurve::setUseLookupTable",
+        "tolerance must be greater than 0, but %e was entered", tolerance);
+
+    if(isObjectUpToDateWithProperties()) {
+        m_curve.setUseLookupTable(useTable, tolerance);
+    }
+    m_useLookupTable = useTable;
+    m_lookupTableTolerance = tolerance;
+}
+
+bool FiberForceLengthCurve::getUseLookupTable() const
+{   return m_useLookupTable; }
+
 double FiberForceLengthCurve::calcIntegral(double normFiberLength) const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
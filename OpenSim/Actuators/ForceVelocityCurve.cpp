@@ -69,6 +69,8 @@ ForceVelocityCurve::ForceVelocityCurve(double concentricSlopeAtVmax,
 void ForceVelocityCurve::setNull()
 {
     setAuthors("Matthew Millard");
+    m_useLookupTable = false;
+    m_lookupTableTolerance = 1e-8;
 }
 
 void ForceVelocityCurve::constructProperties()
@@ -88,6 +90,8 @@ void ForceVelocityCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(m_useLookupTable)
+        m_curve.setUseLookupTable(true, m_lookupTableTolerance);
     setObjectIsUpToDateWithProperties();
 }
 
@@ -187,6 +191,43 @@ double ForceVelocityCurve::calcDerivative(double normFiberVelocity,
     return m_curve.calcDerivative(normFiberVelocity,order);
 }
 
+void ForceVelocityCurve::
+    calcValueAndDerivatives(int n, const double* normFiberVelocities, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ForceVelocityCurve: Curve is not up-to-date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, normFiberVelocities, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& ForceVelocityCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "ForceVelocityCurve: Curve is not up-to-date with its properties");
+    return m_curve;
+}
+
+void ForceVelocityCurve::setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "ForceVelocityCurve::setUseLookupTable",
+        "tolerance must be greater than 0, but %e was entered", tolerance);
+
+    if(isObjectUpToDateWithProperties()) {
+        m_curve.setUseLookupTable(useTable, tolerance);
+    }
+    m_useLookupTable = useTable;
+    m_lookupTableTolerance = tolerance;
+}
+
+bool ForceVelocityCurve::getUseLookupTable() const
+{   return m_useLookupTable; }
+
 SimTK::Vec2 ForceVelocityCurve::getCurveDomain() const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
@@ -70,6 +70,8 @@ ForceVelocityInverseCurve::ForceVelocityInverseCurve(
 void ForceVelocityInverseCurve::setNull()
 {
     setAuthors("Matthew Millard");
+    m_useLookupTable = false;
+    m_lookupTableTolerance = 1e-8;
 }
 
 void ForceVelocityInverseCurve::constructProperties()
@@ -89,6 +91,8 @@ void ForceVelocityInverseCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(m_useLookupTable)
+        m_curve.setUseLookupTable(true, m_lookupTableTolerance);
     setObjectIsUpToDateWithProperties();
 }
 
@@ -192,6 +196,45 @@ calcDerivative(double aForceVelocityMultiplier, int order) const
     return m_curve.calcDerivative(aForceVelocityMultiplier,order);
 }
 
+void ForceVelocityInverseCurve::
+    calcValueAndDerivatives(int n, const double* aForceVelocityMultipliers, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceVelocityInverseCurve: Curve is not up-to-date with its "
+        "properties");
+
+    m_curve.calcValueAndDerivatives(n, aForceVelocityMultipliers, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& ForceVelocityInverseCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "FiberForceVelocityInverseCurve: Curve is not up-to-date with its "
+        "properties");
+    return m_curve;
+}
+
+void ForceVelocityInverseCurve::setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "ForceVelocityInverseCurve::setUseLookupTable",
+        "tolerance must be greater than 0, but %e was entered", tolerance);
+
+    if(isObjectUpToDateWithProperties()) {
+        m_curve.setUseLookupTable(useTable, tolerance);
+    }
+    m_useLookupTable = useTable;
+    m_lookupTableTolerance = tolerance;
+}
+
+bool ForceVelocityInverseCurve::getUseLookupTable() const
+{   return m_useLookupTable; }
+
 SimTK::Vec2 ForceVelocityInverseCurve::getCurveDomain() const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
@@ -291,6 +291,47 @@ public:
     */
     double calcDerivative(double aForceVelocityMultiplier, int order) const;
 
+    /** Calculates the value and the first and second derivatives of the force-
+    velocity-inverse curve at n values of the force-velocity multiplier
+    together. The curve is inverted once per point for all three quantities,
+    and points are evaluated in vectorized loops where possible (see
+    SmoothSegmentedFunction::calcValueAndDerivatives).
+    @param n
+        The number of points.
+    @param aForceVelocityMultipliers
+        The n values of the force-velocity multiplier.
+    @param value
+        The n values of the curve, or NULL if they are not needed.
+    @param firstDerivative
+        The n first derivatives of the curve, or NULL if they are not needed.
+    @param secondDerivative
+        The n second derivatives of the curve, or NULL if they are not needed.
+    */
+    void calcValueAndDerivatives(int n, const double* aForceVelocityMultipliers,
+                                 double* value,
+                                 double* firstDerivative = NULL,
+                                 double* secondDerivative = NULL) const;
+
+    /** @returns The SmoothSegmentedFunction that implements the curve, for
+    evaluating the curves of several muscles together with 
+    SmoothSegmentedFunction::calcValueAndDerivatives. */
+    const SmoothSegmentedFunction& getSmoothSegmentedFunction() const;
+
+    /** Enables or disables the evaluation of the curve from a lookup table
+    built to the given relative error tolerance (see
+    SmoothSegmentedFunction::setUseLookupTable). The setting is not a property:
+    it is not serialized, but it is kept by copies of the curve and applied
+    again whenever the curve is rebuilt from its properties.
+    @param useTable
+        True to evaluate the curve from a lookup table.
+    @param tolerance
+        The relative error tolerance of the table. Must be greater than 0.
+    */
+    void setUseLookupTable(bool useTable, double tolerance = 1e-8);
+
+    /** @returns True if the curve is evaluated from a lookup table. */
+    bool getUseLookupTable() const;
+
     /** Returns a SimTK::Vec2 containing the lower (0th element) and upper (1st
     element) bounds on the domain of the curve. Outside this domain, the curve
     is approximated using linear extrapolation.
@@ -349,6 +390,8 @@ private:
     void buildCurve();
 
     SmoothSegmentedFunction   m_curve;
+    bool   m_useLookupTable;
+    double m_lookupTableTolerance;
 
 };
 
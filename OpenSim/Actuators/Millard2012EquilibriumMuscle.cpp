@@ -21,6 +21,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 #include "Millard2012EquilibriumMuscle.h"
+#include "MuscleCurveBatch.h"
 #include <OpenSim/Common/SimmMacros.h>
 #include <OpenSim/Common/DebugUtilities.h>
 #include <OpenSim/Simulation/Model/Model.h>
@@ -38,11 +39,24 @@ const string Millard2012EquilibriumMuscle::
     STATE_FIBER_LENGTH_NAME = "fiber_length";
 const double MIN_NONZERO_DAMPING_COEFFICIENT = 0.001;
 
+// The curve derivatives and the tendon-force-length multiplier stored in
+// MuscleLengthInfo::userDefinedLengthExtras, for use in calcFiberVelocityInfo
+// and calcMuscleDynamicsInfo. The tendon entries are NaN for a rigid tendon.
+const static int MLIdfal  = 0;
+const static int MLIdfpe  = 1;
+const static int MLIfse   = 2;
+const static int MLIdfse  = 3;
+const static int MLISize  = 4;
+
 //==============================================================================
 // PROPERTIES
 //==============================================================================
 void Millard2012EquilibriumMuscle::setNull()
-{   setAuthors("Matthew Millard, Tom Uchida, Ajay Seth"); }
+{
+    setAuthors("Matthew Millard, Tom Uchida, Ajay Seth");
+    m_useCurveLookupTables = false;
+    m_curveLookupTableTolerance = 1e-8;
+}
 
 void Millard2012EquilibriumMuscle::constructProperties()
 {
@@ -142,6 +156,16 @@ void Millard2012EquilibriumMuscle::buildMuscle()
                                                eccForceMax,
                                                conCurviness,
                                                eccCurviness);
+        fvInvCurve.setUseLookupTable(m_useCurveLookupTables,
+                                     m_curveLookupTableTolerance);
+
+        // Curves that replaced those for which the lookup tables were set
+        if(m_useCurveLookupTables) {
+            falCurve.setUseLookupTable(true, m_curveLookupTableTolerance);
+            fvCurve.setUseLookupTable(true, m_curveLookupTableTolerance);
+            fpeCurve.setUseLookupTable(true, m_curveLookupTableTolerance);
+            fseCurve.setUseLookupTable(true, m_curveLookupTableTolerance);
+        }
 
         // Ensure all sub-objects are up-to-date
         penMdl.ensureModelUpToDate();
@@ -274,6 +298,9 @@ getActivationDerivative(const SimTK::State& s) const
     return activationDerivative;
 }
 
+bool Millard2012EquilibriumMuscle::getUseCurveLookupTables() const
+{   return m_useCurveLookupTables; }
+
 
 //==============================================================================
 // SET METHODS
@@ -300,6 +327,18 @@ void Millard2012EquilibriumMuscle::setFiberDamping(double dampingCoefficient)
     }
 }
 
+void Millard2012EquilibriumMuscle::
+setUseCurveLookupTables(bool useTables, double tolerance)
+{
+    upd_ActiveForceLengthCurve().setUseLookupTable(useTables, tolerance);
+    upd_ForceVelocityCurve().setUseLookupTable(useTables, tolerance);
+    upd_FiberForceLengthCurve().setUseLookupTable(useTables, tolerance);
+    upd_TendonForceLengthCurve().setUseLookupTable(useTables, tolerance);
+    fvInvCurve.setUseLookupTable(useTables, tolerance);
+    m_useCurveLookupTables = useTables;
+    m_curveLookupTableTolerance = tolerance;
+}
+
 void Millard2012EquilibriumMuscle::setDefaultActivation(double activation)
 {
     set_default_activation(clampActivation(activation));
@@ -384,6 +423,11 @@ setFiberLength(SimTK::State& s, double fiberLength) const
 double Millard2012EquilibriumMuscle::
 computeActuation(const SimTK::State& s) const
 {
+    // The first muscle of the batch to compute its force evaluates the curves
+    // of all of them.
+    if(_curveBatch && !isCacheVariableValid(s, _velInfoCV))
+        _curveBatch->realizeFiberVelocityInfo(s);
+
     const MuscleDynamicsInfo& mdi = getMuscleDynamicsInfo(s);
     setForce(s, mdi.tendonForce);
     return mdi.tendonForce;
@@ -674,42 +718,28 @@ calcActivationDerivative(double activation, double excitation) const
 void Millard2012EquilibriumMuscle::calcMuscleLengthInfo(const SimTK::State& s,
     MuscleLengthInfo& mli) const
 {
-    // Get musculotendon actuator properties.
-    double maxIsoForce    = getMaxIsometricForce();
-    double optFiberLength = getOptimalFiberLength();
-    double tendonSlackLen = getTendonSlackLength();
-
     try {
         // Get muscle-specific properties.
         const ActiveForceLengthCurve& falCurve = get_ActiveForceLengthCurve();
         const FiberForceLengthCurve&  fpeCurve = get_FiberForceLengthCurve();
         const TendonForceLengthCurve& fseCurve = get_TendonForceLengthCurve();
 
-        if(get_ignore_tendon_compliance()) {                //rigid tendon
-            mli.fiberLength = clampFiberLength(
-                                penMdl.calcFiberLength(getLength(s),
-                                tendonSlackLen));
-        } else {                                            // elastic tendon
-            mli.fiberLength = clampFiberLength(
-                                getStateVariable(s, STATE_FIBER_LENGTH_NAME));
-        }
-
-        mli.normFiberLength   = mli.fiberLength / optFiberLength;
-        mli.pennationAngle    = penMdl.calcPennationAngle(mli.fiberLength);
-        mli.cosPennationAngle = cos(mli.pennationAngle);
-        mli.sinPennationAngle = sin(mli.pennationAngle);
-        mli.fiberLengthAlongTendon = mli.fiberLength * mli.cosPennationAngle;
+        calcMuscleLengthInfoGeometry(s, mli);
 
-        // Necessary even for the rigid tendon, as it might have gone slack.
-        mli.tendonLength      = penMdl.calcTendonLength(mli.cosPennationAngle,
-                                    mli.fiberLength, getLength(s));
-        mli.normTendonLength  = mli.tendonLength / tendonSlackLen;
-        mli.tendonStrain      = mli.normTendonLength - 1.0;
+        double lceN = mli.normFiberLength;
+        mli.fiberPassiveForceLengthMultiplier = fpeCurve.calcValue(lceN);
+        mli.fiberActiveForceLengthMultiplier  = falCurve.calcValue(lceN);
 
-        mli.fiberPassiveForceLengthMultiplier =
-            fpeCurve.calcValue(mli.normFiberLength);
-        mli.fiberActiveForceLengthMultiplier =
-            falCurve.calcValue(mli.normFiberLength);
+        SimTK::Vector& extras = mli.userDefinedLengthExtras;
+        extras.resize(MLISize);
+        extras[MLIdfal] = falCurve.calcDerivative(lceN,1);
+        extras[MLIdfpe] = fpeCurve.calcDerivative(lceN,1);
+        extras[MLIfse]  = SimTK::NaN;
+        extras[MLIdfse] = SimTK::NaN;
+        if(!get_ignore_tendon_compliance()) {               // elastic tendon
+            extras[MLIfse]  = fseCurve.calcValue(mli.normTendonLength);
+            extras[MLIdfse] = fseCurve.calcDerivative(mli.normTendonLength,1);
+        }
 
     } catch(const std::exception &x) {
         std::string msg = "Exception caught in Millard2012EquilibriumMuscle::"
@@ -719,6 +749,198 @@ void Millard2012EquilibriumMuscle::calcMuscleLengthInfo(const SimTK::State& s,
     }
 }
 
+void Millard2012EquilibriumMuscle::
+    calcMuscleLengthInfoGeometry(const SimTK::State& s,
+                                 MuscleLengthInfo& mli) const
+{
+    // Get musculotendon actuator properties.
+    double optFiberLength = getOptimalFiberLength();
+    double tendonSlackLen = getTendonSlackLength();
+
+    if(get_ignore_tendon_compliance()) {                //rigid tendon
+        mli.fiberLength = clampFiberLength(
+                            penMdl.calcFiberLength(getLength(s),
+                            tendonSlackLen));
+    } else {                                            // elastic tendon
+        mli.fiberLength = clampFiberLength(
+                            getStateVariable(s, STATE_FIBER_LENGTH_NAME));
+    }
+
+    mli.normFiberLength   = mli.fiberLength / optFiberLength;
+    mli.pennationAngle    = penMdl.calcPennationAngle(mli.fiberLength);
+    mli.cosPennationAngle = cos(mli.pennationAngle);
+    mli.sinPennationAngle = sin(mli.pennationAngle);
+    mli.fiberLengthAlongTendon = mli.fiberLength * mli.cosPennationAngle;
+
+    // Necessary even for the rigid tendon, as it might have gone slack.
+    mli.tendonLength      = penMdl.calcTendonLength(mli.cosPennationAngle,
+                                mli.fiberLength, getLength(s));
+    mli.normTendonLength  = mli.tendonLength / tendonSlackLen;
+    mli.tendonStrain      = mli.normTendonLength - 1.0;
+}
+
+void Millard2012EquilibriumMuscle::
+    realizeMuscleLengthInfo(const SimTK::State& s, int n,
+                            const Millard2012EquilibriumMuscle* const* muscles)
+{
+    // Muscles are processed in blocks, gathering the inputs of the curves
+    // as structures of arrays. Only the muscles with an elastic tendon
+    // evaluate the tendon-force-length curve.
+    static const int BatchSize = 64;
+    const Millard2012EquilibriumMuscle* batch[BatchSize];
+    MuscleLengthInfo* info[BatchSize];
+    const SmoothSegmentedFunction* falCurves[BatchSize];
+    const SmoothSegmentedFunction* fpeCurves[BatchSize];
+    const SmoothSegmentedFunction* fseCurves[BatchSize];
+    int elastic[BatchSize];
+    double lceN[BatchSize], fal[BatchSize], dfal[BatchSize], 
+           fpe[BatchSize], dfpe[BatchSize];
+    double tlN[BatchSize], fse[BatchSize], dfse[BatchSize];
+
+    for(int start = 0; start < n; start += BatchSize) {
+        int end = std::min(n, start + BatchSize);
+
+        int m = 0;
+        int nElastic = 0;
+        for(int i = start; i < end; ++i) {
+            const Millard2012EquilibriumMuscle& muscle = *muscles[i];
+            if(muscle.isDisabled(s) ||
+               muscle.isCacheVariableValid(s, muscle._lengthInfoCV))
+                continue;
+
+            MuscleLengthInfo& mli = muscle.updMuscleLengthInfo(s);
+            try {
+                muscle.calcMuscleLengthInfoGeometry(s, mli);
+                falCurves[m] = &muscle.get_ActiveForceLengthCurve()
+                                        .getSmoothSegmentedFunction();
+                fpeCurves[m] = &muscle.get_FiberForceLengthCurve()
+                                        .getSmoothSegmentedFunction();
+                if(!muscle.get_ignore_tendon_compliance()) {
+                    fseCurves[nElastic] = &muscle.get_TendonForceLengthCurve()
+                                                .getSmoothSegmentedFunction();
+                    tlN[nElastic] = mli.normTendonLength;
+                    elastic[nElastic++] = m;
+                }
+            } catch(const std::exception &x) {
+                std::string msg = "Exception caught in Millard2012Equilibrium"
+                                  "Muscle::realizeMuscleLengthInfo from "
+                                  + muscle.getName() + "\n" + x.what();
+                throw OpenSim::Exception(msg);
+            }
+            batch[m] = &muscle;
+            info[m] = &mli;
+            lceN[m] = mli.normFiberLength;
+            ++m;
+        }
+
+        SmoothSegmentedFunction::calcValueAndDerivatives(m, falCurves, lceN,
+                                                         fal, dfal);
+        SmoothSegmentedFunction::calcValueAndDerivatives(m, fpeCurves, lceN,
+                                                         fpe, dfpe);
+        SmoothSegmentedFunction::calcValueAndDerivatives(nElastic, fseCurves,
+                                                         tlN, fse, dfse);
+
+        for(int j = 0; j < m; ++j) {
+            info[j]->fiberPassiveForceLengthMultiplier = fpe[j];
+            info[j]->fiberActiveForceLengthMultiplier  = fal[j];
+
+            SimTK::Vector& extras = info[j]->userDefinedLengthExtras;
+            extras.resize(MLISize);
+            extras[MLIdfal] = dfal[j];
+            extras[MLIdfpe] = dfpe[j];
+            extras[MLIfse]  = SimTK::NaN;
+            extras[MLIdfse] = SimTK::NaN;
+        }
+        for(int k = 0; k < nElastic; ++k) {
+            SimTK::Vector& extras = info[elastic[k]]->userDefinedLengthExtras;
+            extras[MLIfse]  = fse[k];
+            extras[MLIdfse] = dfse[k];
+        }
+        for(int j = 0; j < m; ++j)
+            batch[j]->markCacheVariableValid(s, batch[j]->_lengthInfoCV);
+    }
+}
+
+void Millard2012EquilibriumMuscle::
+    realizeFiberVelocityInfo(const SimTK::State& s, int n,
+                             const Millard2012EquilibriumMuscle* const* muscles)
+{
+    // Muscles are processed in blocks, gathering the inputs of the force-
+    // velocity curves, and of the inverse curves, as structures of arrays.
+    static const int BatchSize = 64;
+    const Millard2012EquilibriumMuscle* batch[BatchSize];
+    const MuscleLengthInfo* info[BatchSize];
+    double dlce[BatchSize], dlceN[BatchSize], fv[BatchSize];
+    const SmoothSegmentedFunction* fvCurves[BatchSize];
+    const SmoothSegmentedFunction* fvInvCurves[BatchSize];
+    int fvIndex[BatchSize], fvInvIndex[BatchSize];
+    double x[BatchSize], y[BatchSize];
+
+    const Millard2012EquilibriumMuscle* muscle = NULL;
+    try {
+        for(int start = 0; start < n; start += BatchSize) {
+            int end = std::min(n, start + BatchSize);
+
+            int m = 0;
+            int nFv = 0;
+            int nFvInv = 0;
+            for(int i = start; i < end; ++i) {
+                muscle = muscles[i];
+                if(muscle->isDisabled(s) ||
+                   muscle->isCacheVariableValid(s, muscle->_velInfoCV))
+                    continue;
+
+                info[m] = &muscle->getMuscleLengthInfo(s);
+                switch(muscle->calcFiberVelocityCurveInput(s, *info[m],
+                                                dlce[m], dlceN[m], fv[m])) {
+                case ForceVelocity:
+                    fvCurves[nFv] = &muscle->get_ForceVelocityCurve()
+                                            .getSmoothSegmentedFunction();
+                    fvIndex[nFv++] = m;
+                    break;
+                case ForceVelocityInverse:
+                    fvInvCurves[nFvInv] = &muscle->fvInvCurve
+                                            .getSmoothSegmentedFunction();
+                    fvInvIndex[nFvInv++] = m;
+                    break;
+                case NoCurve:
+                    break;
+                }
+                batch[m++] = muscle;
+            }
+            muscle = NULL;
+
+            for(int k = 0; k < nFv; ++k)
+                x[k] = dlceN[fvIndex[k]];
+            SmoothSegmentedFunction::calcValueAndDerivatives(nFv, fvCurves,
+                                                             x, y);
+            for(int k = 0; k < nFv; ++k)
+                fv[fvIndex[k]] = y[k];
+
+            for(int k = 0; k < nFvInv; ++k)
+                x[k] = fv[fvInvIndex[k]];
+            SmoothSegmentedFunction::calcValueAndDerivatives(nFvInv,
+                                                        fvInvCurves, x, y);
+            for(int k = 0; k < nFvInv; ++k)
+                dlceN[fvInvIndex[k]] = y[k];
+
+            for(int j = 0; j < m; ++j) {
+                muscle = batch[j];
+                muscle->calcFiberVelocityInfoFromCurve(s, *info[j], dlce[j],
+                    dlceN[j], fv[j], muscle->updFiberVelocityInfo(s));
+                muscle->markCacheVariableValid(s, muscle->_velInfoCV);
+            }
+            muscle = NULL;
+        }
+    } catch(const std::exception &e) {
+        std::string msg = "Exception caught in Millard2012EquilibriumMuscle::"
+                          "realizeFiberVelocityInfo";
+        if(muscle)
+            msg += " from " + muscle->getName();
+        throw OpenSim::Exception(msg + "\n" + e.what());
+    }
+}
+
 
 //==============================================================================
 // MUSCLE INFERFACE REQUIREMENTS -- MUSCLE POTENTIAL ENERGY INFO
@@ -785,160 +1007,184 @@ calcFiberVelocityInfo(const SimTK::State& s, FiberVelocityInfo& fvi) const
         // Get the quantities that we've already computed.
         const MuscleLengthInfo &mli = getMuscleLengthInfo(s);
 
-        // Get the static properties of this muscle.
-        double dlenMcl   = getLengtheningSpeed(s);
-        double optFibLen = getOptimalFiberLength();
-
-        //======================================================================
-        // Compute fv by inverting the force-velocity relationship in the
-        // equilibrium equations.
-        //======================================================================
         double dlce  = SimTK::NaN;
         double dlceN = SimTK::NaN;
         double fv    = SimTK::NaN;
 
-        // Calculate fiber velocity.
-        if(get_ignore_tendon_compliance()) {
-
-            // Rigid tendon.
+        switch(calcFiberVelocityCurveInput(s, mli, dlce, dlceN, fv)) {
+        case ForceVelocity:
+            fv = get_ForceVelocityCurve().calcValue(dlceN);
+            break;
+        case ForceVelocityInverse:
+            dlceN = fvInvCurve.calcValue(fv);
+            break;
+        case NoCurve:
+            break;
+        }
 
-            if(mli.tendonLength < getTendonSlackLength()
-                                  - SimTK::SignificantReal) {
-                // The tendon is buckling, so fiber velocity is zero.
-                dlce  = 0.0;
-                dlceN = 0.0;
-                fv    = 1.0;
-            } else {
-                dlce = penMdl.calcFiberVelocity(mli.cosPennationAngle,
-                                                dlenMcl, 0.0);
-                dlceN = dlce/(optFibLen*getMaxContractionVelocity());
-                fv = get_ForceVelocityCurve().calcValue(dlceN);
-            }
+        calcFiberVelocityInfoFromCurve(s, mli, dlce, dlceN, fv, fvi);
 
-        } else if(!get_ignore_tendon_compliance() && !use_fiber_damping) {
+    } catch(const std::exception &x) {
+        std::string msg = "Exception caught in Millard2012EquilibriumMuscle::"
+                          "calcFiberVelocityInfo from " + getName() + "\n"
+                           + x.what();
+        throw OpenSim::Exception(msg);
+    }
+}
 
-            // Elastic tendon, no damping.
+Millard2012EquilibriumMuscle::FiberVelocityCurve
+Millard2012EquilibriumMuscle::
+calcFiberVelocityCurveInput(const SimTK::State& s, const MuscleLengthInfo& mli,
+                            double& dlce, double& dlceN, double& fv) const
+{
+    // Get the static properties of this muscle.
+    double dlenMcl   = getLengtheningSpeed(s);
+    double optFibLen = getOptimalFiberLength();
+
+    //==========================================================================
+    // Compute fv by inverting the force-velocity relationship in the
+    // equilibrium equations.
+    //==========================================================================
+    dlce  = SimTK::NaN;
+    dlceN = SimTK::NaN;
+    fv    = SimTK::NaN;
+
+    // Calculate fiber velocity.
+    if(get_ignore_tendon_compliance()) {
+
+        // Rigid tendon.
+
+        if(mli.tendonLength < getTendonSlackLength()
+                              - SimTK::SignificantReal) {
+            // The tendon is buckling, so fiber velocity is zero.
+            dlce  = 0.0;
+            dlceN = 0.0;
+            fv    = 1.0;
+            return NoCurve;
+        }
+        dlce = penMdl.calcFiberVelocity(mli.cosPennationAngle,
+                                        dlenMcl, 0.0);
+        dlceN = dlce/(optFibLen*getMaxContractionVelocity());
+        return ForceVelocity;
 
-            double a = SimTK::NaN;
-            if(!get_ignore_activation_dynamics()) {
-                a = clampActivation(getStateVariable(s, STATE_ACTIVATION_NAME));
-            } else {
-                a = clampActivation(getControl(s));
-            }
+    } else if(!get_ignore_tendon_compliance() && !use_fiber_damping) {
 
-            const TendonForceLengthCurve& fseCurve =
-                get_TendonForceLengthCurve();
-            double fse = fseCurve.calcValue(mli.normTendonLength);
-
-            SimTK_ERRCHK_ALWAYS(mli.cosPennationAngle > SimTK::SignificantReal,
-                "calcFiberVelocityInfo",
-                "%s: Pennation angle is 90 degrees, causing a singularity");
-            SimTK_ERRCHK_ALWAYS(a > SimTK::SignificantReal,
-                "calcFiberVelocityInfo",
-                "%s: Activation is 0, causing a singularity");
-            SimTK_ERRCHK_ALWAYS(mli.fiberActiveForceLengthMultiplier >
-                                SimTK::SignificantReal,
-                "calcFiberVelocityInfo",
-                "%s: Active-force-length factor is 0, causing a singularity");
-
-            fv = calcFv(a, mli.fiberActiveForceLengthMultiplier,
-                        mli.fiberPassiveForceLengthMultiplier, fse,
-                        mli.cosPennationAngle);
-
-            // Evaluate the inverse force-velocity curve.
-            dlceN = fvInvCurve.calcValue(fv);
-            dlce  = dlceN*getMaxContractionVelocity()*optFibLen;
+        // Elastic tendon, no damping.
 
+        double a = SimTK::NaN;
+        if(!get_ignore_activation_dynamics()) {
+            a = clampActivation(getStateVariable(s, STATE_ACTIVATION_NAME));
         } else {
+            a = clampActivation(getControl(s));
+        }
 
-            // Elastic tendon, with damping.
+        double fse = mli.userDefinedLengthExtras[MLIfse];
 
-            double a = SimTK::NaN;
-            if(!get_ignore_activation_dynamics()) {
-                a = clampActivation(getStateVariable(s, STATE_ACTIVATION_NAME));
-            } else {
-                a = clampActivation(getControl(s));
-            }
+        SimTK_ERRCHK_ALWAYS(mli.cosPennationAngle > SimTK::SignificantReal,
+            "calcFiberVelocityInfo",
+            "%s: Pennation angle is 90 degrees, causing a singularity");
+        SimTK_ERRCHK_ALWAYS(a > SimTK::SignificantReal,
+            "calcFiberVelocityInfo",
+            "%s: Activation is 0, causing a singularity");
+        SimTK_ERRCHK_ALWAYS(mli.fiberActiveForceLengthMultiplier >
+                            SimTK::SignificantReal,
+            "calcFiberVelocityInfo",
+            "%s: Active-force-length factor is 0, causing a singularity");
+
+        fv = calcFv(a, mli.fiberActiveForceLengthMultiplier,
+                    mli.fiberPassiveForceLengthMultiplier, fse,
+                    mli.cosPennationAngle);
+
+        // The inverse force-velocity curve gives the fiber velocity.
+        return ForceVelocityInverse;
 
-            const TendonForceLengthCurve& fseCurve =
-                get_TendonForceLengthCurve();
-            double fse = fseCurve.calcValue(mli.normTendonLength);
-
-            // Newton solve for fiber velocity.
-            fv = 1.0;
-            dlce = -1;
-            dlceN = -1;
-            double beta = get_fiber_damping();
-
-            SimTK_ERRCHK_ALWAYS(beta > SimTK::SignificantReal,
-                "calcFiberVelocityInfo",
-                "Fiber damping coefficient must be greater than 0.");
-
-            SimTK::Vec3 fiberVelocityV = calcDampedNormFiberVelocity(
-                getMaxIsometricForce(), a, mli.fiberActiveForceLengthMultiplier,
-                mli.fiberPassiveForceLengthMultiplier, fse, beta,
-                mli.cosPennationAngle);
-
-            // If the Newton method converged, update the fiber velocity.
-            if(fiberVelocityV[2] > 0.5) { //flag is set to 0.0 or 1.0
-                dlceN = fiberVelocityV[0];
-                dlce  = dlceN*getOptimalFiberLength()
-                        *getMaxContractionVelocity();
-                fv = get_ForceVelocityCurve().calcValue(dlceN);
-            } else {
-                // Throw an exception here because there is no point integrating
-                // a muscle velocity that is invalid (it will end up producing
-                // invalid fiber lengths and will ultimately cause numerical
-                // problems). The idea is to produce an exception and catch this
-                // early before it can cause more damage.
-                throw (OpenSim::Exception(getName() +
-                       " Fiber velocity Newton method did not converge"));
-            }
-        }
+    } else {
 
-        // Compute the other velocity-related components.
-        double dphidt = penMdl.calcPennationAngularVelocity(
-            tan(mli.pennationAngle), mli.fiberLength, dlce);
-        double dlceAT = penMdl.calcFiberVelocityAlongTendon(mli.fiberLength,
-            dlce, mli.sinPennationAngle, mli.cosPennationAngle, dphidt);
-        double dmcldt = getLengtheningSpeed(s);
-        double dtl = 0;
+        // Elastic tendon, with damping.
 
-        if(!get_ignore_tendon_compliance()) {
-            dtl = penMdl.calcTendonVelocity(mli.cosPennationAngle,
-                mli.sinPennationAngle, dphidt, mli.fiberLength, dlce, dmcldt);
+        double a = SimTK::NaN;
+        if(!get_ignore_activation_dynamics()) {
+            a = clampActivation(getStateVariable(s, STATE_ACTIVATION_NAME));
+        } else {
+            a = clampActivation(getControl(s));
         }
 
-        // Check to see whether the fiber state is clamped.
-        double fiberStateClamped = 0.0;
-        if(isFiberStateClamped(mli.fiberLength,dlce)) {
-            dlce = 0.0;
-            dlceN = 0.0;
-            dlceAT = 0.0;
-            dphidt = 0.0;
-            dtl = dmcldt;
-            fv = 1.0; //to be consistent with a fiber velocity of 0
-            fiberStateClamped = 1.0;
+        double fse = mli.userDefinedLengthExtras[MLIfse];
+
+        // Newton solve for fiber velocity.
+        double beta = get_fiber_damping();
+
+        SimTK_ERRCHK_ALWAYS(beta > SimTK::SignificantReal,
+            "calcFiberVelocityInfo",
+            "Fiber damping coefficient must be greater than 0.");
+
+        SimTK::Vec3 fiberVelocityV = calcDampedNormFiberVelocity(
+            getMaxIsometricForce(), a, mli.fiberActiveForceLengthMultiplier,
+            mli.fiberPassiveForceLengthMultiplier, fse, beta,
+            mli.cosPennationAngle);
+
+        // If the Newton method converged, update the fiber velocity.
+        if(fiberVelocityV[2] > 0.5) { //flag is set to 0.0 or 1.0
+            dlceN = fiberVelocityV[0];
+            dlce  = dlceN*getOptimalFiberLength()
+                    *getMaxContractionVelocity();
+            return ForceVelocity;
         }
+        // Throw an exception here because there is no point integrating
+        // a muscle velocity that is invalid (it will end up producing
+        // invalid fiber lengths and will ultimately cause numerical
+        // problems). The idea is to produce an exception and catch this
+        // early before it can cause more damage.
+        throw (OpenSim::Exception(getName() +
+               " Fiber velocity Newton method did not converge"));
+    }
+}
 
-        // Populate the struct.
-        fvi.fiberVelocity                = dlce;
-        fvi.normFiberVelocity            = dlceN;
-        fvi.fiberVelocityAlongTendon     = dlceAT;
-        fvi.pennationAngularVelocity     = dphidt;
-        fvi.tendonVelocity               = dtl;
-        fvi.normTendonVelocity           = dtl/getTendonSlackLength();
-        fvi.fiberForceVelocityMultiplier = fv;
+void Millard2012EquilibriumMuscle::
+calcFiberVelocityInfoFromCurve(const SimTK::State& s,
+                               const MuscleLengthInfo& mli,
+                               double dlce, double dlceN, double fv,
+                               FiberVelocityInfo& fvi) const
+{
+    if(SimTK::isNaN(dlce))
+        dlce = dlceN*getMaxContractionVelocity()*getOptimalFiberLength();
 
-        fvi.userDefinedVelocityExtras.resize(1);
-        fvi.userDefinedVelocityExtras[0] = fiberStateClamped;
+    // Compute the other velocity-related components.
+    double dphidt = penMdl.calcPennationAngularVelocity(
+        tan(mli.pennationAngle), mli.fiberLength, dlce);
+    double dlceAT = penMdl.calcFiberVelocityAlongTendon(mli.fiberLength,
+        dlce, mli.sinPennationAngle, mli.cosPennationAngle, dphidt);
+    double dmcldt = getLengtheningSpeed(s);
+    double dtl = 0;
 
-    } catch(const std::exception &x) {
-        std::string msg = "Exception caught in Millard2012EquilibriumMuscle::"
-                          "calcFiberVelocityInfo from " + getName() + "\n"
-                           + x.what();
-        throw OpenSim::Exception(msg);
+    if(!get_ignore_tendon_compliance()) {
+        dtl = penMdl.calcTendonVelocity(mli.cosPennationAngle,
+            mli.sinPennationAngle, dphidt, mli.fiberLength, dlce, dmcldt);
+    }
+
+    // Check to see whether the fiber state is clamped.
+    double fiberStateClamped = 0.0;
+    if(isFiberStateClamped(mli.fiberLength,dlce)) {
+        dlce = 0.0;
+        dlceN = 0.0;
+        dlceAT = 0.0;
+        dphidt = 0.0;
+        dtl = dmcldt;
+        fv = 1.0; //to be consistent with a fiber velocity of 0
+        fiberStateClamped = 1.0;
     }
+
+    // Populate the struct.
+    fvi.fiberVelocity                = dlce;
+    fvi.normFiberVelocity            = dlceN;
+    fvi.fiberVelocityAlongTendon     = dlceAT;
+    fvi.pennationAngularVelocity     = dphidt;
+    fvi.tendonVelocity               = dtl;
+    fvi.normTendonVelocity           = dtl/getTendonSlackLength();
+    fvi.fiberForceVelocityMultiplier = fv;
+
+    fvi.userDefinedVelocityExtras.resize(1);
+    fvi.userDefinedVelocityExtras[0] = fiberStateClamped;
 }
 
 //==============================================================================
@@ -958,7 +1204,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
         double optFiberLen    = getOptimalFiberLength();
         double fiso           = getMaxIsometricForce();
         double penHeight      = penMdl.getParallelogramHeight();
-        const TendonForceLengthCurve& fseCurve = get_TendonForceLengthCurve();
+        const SimTK::Vector& extras = mli.userDefinedLengthExtras;
 
         // Compute dynamic quantities.
         double a = SimTK::NaN;
@@ -1017,14 +1263,14 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
             fmAT = fm * mli.cosPennationAngle;
             dFm_dlce = calcFiberStiffness(fiso, a,
                                           mvi.fiberForceVelocityMultiplier,
-                                          mli.normFiberLength, optFiberLen);
+                                          extras[MLIdfal], extras[MLIdfpe],
+                                          optFiberLen);
             dFmAT_dlceAT = calc_DFiberForceAT_DFiberLengthAT(dFm_dlce,
                 mli.sinPennationAngle, mli.cosPennationAngle, mli.fiberLength);
 
             // Compute the stiffness of the tendon.
             if(!get_ignore_tendon_compliance()) {
-                dFt_dtl = fseCurve.calcDerivative(mli.normTendonLength,1)
-                          *(fiso/tendonSlackLen);
+                dFt_dtl = extras[MLIdfse]*(fiso/tendonSlackLen);
 
                 // Compute the stiffness of the whole musculotendon actuator.
                 if (abs(dFmAT_dlceAT*dFt_dtl) > 0.0
@@ -1039,7 +1285,7 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
 
         double fse = 0.0;
         if(!get_ignore_tendon_compliance()) {
-            fse = fseCurve.calcValue(mli.normTendonLength);
+            fse = extras[MLIfse];
         } else {
             fse = fmAT/fiso;
         }
@@ -1091,6 +1337,9 @@ calcMuscleDynamicsInfo(const SimTK::State& s, MuscleDynamicsInfo& mdi) const
 void Millard2012EquilibriumMuscle::connectToModel(Model& model)
 {
     Super::connectToModel(model);
+
+    // Shared again when the system is built, with the muscles of this model.
+    _curveBatch.reset();
 }
 
 void Millard2012EquilibriumMuscle::
@@ -1101,6 +1350,11 @@ addToSystem(SimTK::MultibodySystem& system) const
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
         "Millard2012EquilibriumMuscle: Muscle properties are not up-to-date");
 
+    // The first muscle of the model to get here shares a batch among all of
+    // them. Derived types are not batched.
+    if(!_curveBatch && getConcreteClassName() == getClassName())
+        MuscleCurveBatch::shareAmongMuscles(getModel());
+
     double dummyValue = 0.0;
     if(!get_ignore_activation_dynamics()) {
         addStateVariable(STATE_ACTIVATION_NAME);
@@ -1298,9 +1552,20 @@ double Millard2012EquilibriumMuscle::calcFiberStiffness(double fiso,
 {
     const FiberForceLengthCurve& fpeCurve  = get_FiberForceLengthCurve();
     const ActiveForceLengthCurve& falCurve = get_ActiveForceLengthCurve();
+    return calcFiberStiffness(fiso, a, fv, falCurve.calcDerivative(lceN,1),
+                              fpeCurve.calcDerivative(lceN,1), optFibLen);
+}
+
+double Millard2012EquilibriumMuscle::calcFiberStiffness(double fiso,
+                                                        double a,
+                                                        double fv,
+                                                        double dfal_dlceN,
+                                                        double dfpe_dlceN,
+                                                        double optFibLen) const
+{
     double DlceN_Dlce = 1.0/optFibLen;
-    double Dfal_Dlce  = falCurve.calcDerivative(lceN,1) * DlceN_Dlce;
-    double Dfpe_Dlce  = fpeCurve.calcDerivative(lceN,1) * DlceN_Dlce;
+    double Dfal_Dlce  = dfal_dlceN * DlceN_Dlce;
+    double Dfpe_Dlce  = dfpe_dlceN * DlceN_Dlce;
 
     // DFm_Dlce
     return  fiso * (a*Dfal_Dlce*fv + Dfpe_Dlce);
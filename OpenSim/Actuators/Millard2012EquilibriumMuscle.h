@@ -43,6 +43,10 @@
 #include <OpenSim/Actuators/FiberForceLengthCurve.h>
 #include <OpenSim/Actuators/TendonForceLengthCurve.h>
 
+#ifndef SWIG
+#include <memory>
+#endif
+
 #ifdef SWIG
     #ifdef OSIMACTUATORS_API
         #undef OSIMACTUATORS_API
@@ -51,6 +55,9 @@
 #endif
 
 namespace OpenSim {
+
+class MuscleCurveBatch;
+
 /**
 This class implements a configurable equilibrium muscle model, as described in
 Millard et al.\ (2013). An equilibrium model assumes that the forces generated
@@ -324,6 +331,10 @@ public:
     @returns The time derivative of activation. */
     double getActivationDerivative(const SimTK::State& s) const;
 
+    /** @returns True if the curves of this muscle are evaluated from lookup
+    tables (see setUseCurveLookupTables()). */
+    bool getUseCurveLookupTables() const;
+
 //==============================================================================
 // SET METHODS
 //==============================================================================
@@ -339,6 +350,18 @@ public:
     /** @param dampingCoefficient Define the fiber damping coefficient. */
     void setFiberDamping(double dampingCoefficient);
 
+    /** Evaluates the active-force-length, force-velocity, fiber-force-length
+    and tendon-force-length curves of this muscle, and the inverse of the
+    force-velocity curve, from lookup tables built to the given relative error
+    tolerance (see SmoothSegmentedFunction::setUseLookupTable), or exactly.
+    The setting is not serialized, but it is kept by copies of the muscle and
+    applied to curves that are later replaced.
+        @param useTables Evaluate the curves from lookup tables (true) or
+    exactly.
+        @param tolerance The relative error tolerance of the tables (must be
+    greater than 0). */
+    void setUseCurveLookupTables(bool useTables, double tolerance = 1e-8);
+
     /** @param activation The default activation level that is used to
     initialize the muscle. */
     void setDefaultActivation(double activation);
@@ -410,6 +433,32 @@ public:
     void computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const 
         OVERRIDE_11;
 
+    /** Computes the MuscleLengthInfo of several muscles for one state in a
+    single pass, evaluating their active-force-length, passive-force-length
+    and tendon-force-length curves, and the derivatives of these curves, as
+    one batch (see SmoothSegmentedFunction::calcValueAndDerivatives). The
+    results are stored in the muscles' caches, where calcMuscleLengthInfo
+    would have stored them, so that the muscles use them when they compute
+    their forces. Muscles that are disabled, or whose MuscleLengthInfo is 
+    already valid for the state, are skipped. MuscleCurveBatch uses this to 
+    process all the muscles of a model.
+        @param s The state of the system.
+        @param n The number of muscles.
+        @param muscles The n muscles. */
+    static void realizeMuscleLengthInfo(const SimTK::State& s, int n,
+                            const Millard2012EquilibriumMuscle* const* muscles);
+
+    /** Computes the FiberVelocityInfo of several muscles for one state in a
+    single pass, evaluating their force-velocity curves, or the inverse 
+    curves for muscles with an elastic tendon and no fiber damping, as one 
+    batch. Muscles that are disabled, or whose FiberVelocityInfo is already
+    valid for the state, are skipped. 
+        @param s The state of the system.
+        @param n The number of muscles.
+        @param muscles The n muscles. */
+    static void realizeFiberVelocityInfo(const SimTK::State& s, int n,
+                            const Millard2012EquilibriumMuscle* const* muscles);
+
 //==============================================================================
 // TO BE DEPRECATED
 //==============================================================================
@@ -539,6 +588,40 @@ private:
     // Rebuilds muscle model if any of its properties have changed.
 	void finalizeFromProperties() OVERRIDE_11;
 
+    // Calculates the MuscleLengthInfo except for the curve values and
+    // derivatives, which are evaluated by the caller.
+    void calcMuscleLengthInfoGeometry(const SimTK::State& s,
+                                      MuscleLengthInfo& mli) const;
+
+    // The curve that remains to be evaluated to complete a FiberVelocityInfo.
+    enum FiberVelocityCurve { NoCurve, ForceVelocity, ForceVelocityInverse };
+
+    /* Calculates the fiber velocity, or the force-velocity multiplier, from
+    which the other completes a FiberVelocityInfo. Unknown values are NaN.
+        @param s the state of the system
+        @param mli the MuscleLengthInfo of the muscle for s
+        @param dlce the fiber velocity
+        @param dlceN the normalized fiber velocity
+        @param fv the force-velocity multiplier
+        @returns ForceVelocity if fv is to be evaluated at dlceN, 
+    ForceVelocityInverse if dlceN is to be evaluated at fv, and NoCurve if
+    both are known */
+    FiberVelocityCurve calcFiberVelocityCurveInput(const SimTK::State& s,
+                                                   const MuscleLengthInfo& mli,
+                                                   double& dlce,
+                                                   double& dlceN,
+                                                   double& fv) const;
+
+    // Completes the FiberVelocityInfo given the normalized fiber velocity and
+    // the force-velocity multiplier. The fiber velocity is calculated from
+    // the normalized one if it is NaN.
+    void calcFiberVelocityInfoFromCurve(const SimTK::State& s,
+                                        const MuscleLengthInfo& mli,
+                                        double dlce,
+                                        double dlceN,
+                                        double fv,
+                                        FiberVelocityInfo& fvi) const;
+
     /* Calculates the fiber velocity that satisfies the equilibrium equation
     given a fixed fiber length.
         @param fiso maximum isometric force
@@ -625,6 +708,17 @@ private:
                               double lceN,
                               double optFibLen) const;
 
+    /*  As above, given the derivatives of the active- and passive-force-length
+    curves at the normalized fiber length.
+        @param dfal_dlceN the derivative of the active-force-length curve
+        @param dfpe_dlceN the derivative of the passive-force-length curve */
+    double calcFiberStiffness(double fiso,
+                              double a,
+                              double fv,
+                              double dfal_dlceN,
+                              double dfpe_dlceN,
+                              double optFibLen) const;
+
     /*  @param fiso the maximum isometric force the fiber can generate
         @param a activation
         @param fal the fiber active-force-length multiplier
@@ -689,6 +783,19 @@ private:
     // Singularity-free inverse of ForceVelocityCurve.
     ForceVelocityInverseCurve fvInvCurve;
 
+    // Whether the curves are evaluated from lookup tables, and the tolerance
+    // of the tables. See setUseCurveLookupTables().
+    bool   m_useCurveLookupTables;
+    double m_curveLookupTableTolerance;
+
+    // The batch in which the curves of this muscle are evaluated with those
+    // of the model's other muscles. Shared among them by 
+    // MuscleCurveBatch::shareAmongMuscles in addToSystem().
+#ifndef SWIG
+    mutable std::shared_ptr<MuscleCurveBatch> _curveBatch;
+    friend class MuscleCurveBatch;
+#endif
+
     // Here, I'm using the 'm_' to prevent me from trashing this variable with a
     // poorly chosen local variable.
     double m_minimumFiberLength;
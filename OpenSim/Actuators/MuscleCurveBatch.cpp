@@ -0,0 +1,97 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  MuscleCurveBatch.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MuscleCurveBatch.h"
+#include "Millard2012EquilibriumMuscle.h"
+#include "Thelen2003Muscle.h"
+#include <OpenSim/Simulation/Model/Model.h>
+
+using namespace OpenSim;
+
+//==============================================================================
+// CONSTRUCTION
+//==============================================================================
+MuscleCurveBatch::MuscleCurveBatch()
+{
+}
+
+MuscleCurveBatch::MuscleCurveBatch(const Model& model)
+{
+    const Set<Muscle>& muscles = model.getMuscles();
+    for(int i = 0; i < muscles.getSize(); ++i)
+        addMuscle(muscles[i]);
+}
+
+bool MuscleCurveBatch::addMuscle(const Muscle& muscle)
+{
+    // Derived types may override how the curves are computed.
+    const std::string& type = muscle.getConcreteClassName();
+    if(type == Millard2012EquilibriumMuscle::getClassName()) {
+        _millardMuscles.push_back(
+            static_cast<const Millard2012EquilibriumMuscle*>(&muscle));
+        return true;
+    }
+    if(type == Thelen2003Muscle::getClassName()) {
+        _thelenMuscles.push_back(
+            static_cast<const Thelen2003Muscle*>(&muscle));
+        return true;
+    }
+    return false;
+}
+
+int MuscleCurveBatch::getNumMuscles() const
+{
+    return (int)(_millardMuscles.size() + _thelenMuscles.size());
+}
+
+void MuscleCurveBatch::shareAmongMuscles(const Model& model)
+{
+    std::shared_ptr<MuscleCurveBatch> batch(new MuscleCurveBatch(model));
+    for(unsigned i = 0; i < batch->_millardMuscles.size(); ++i)
+        batch->_millardMuscles[i]->_curveBatch = batch;
+    for(unsigned i = 0; i < batch->_thelenMuscles.size(); ++i)
+        batch->_thelenMuscles[i]->_curveBatch = batch;
+}
+
+//==============================================================================
+// COMPUTATION
+//==============================================================================
+void MuscleCurveBatch::realizeMuscleLengthInfo(const SimTK::State& s) const
+{
+    if(!_millardMuscles.empty())
+        Millard2012EquilibriumMuscle::realizeMuscleLengthInfo(s,
+            (int)_millardMuscles.size(), &_millardMuscles[0]);
+    if(!_thelenMuscles.empty())
+        Thelen2003Muscle::realizeMuscleLengthInfo(s,
+            (int)_thelenMuscles.size(), &_thelenMuscles[0]);
+}
+
+void MuscleCurveBatch::realizeFiberVelocityInfo(const SimTK::State& s) const
+{
+    realizeMuscleLengthInfo(s);
+    if(!_millardMuscles.empty())
+        Millard2012EquilibriumMuscle::realizeFiberVelocityInfo(s,
+            (int)_millardMuscles.size(), &_millardMuscles[0]);
+    if(!_thelenMuscles.empty())
+        Thelen2003Muscle::realizeFiberVelocityInfo(s,
+            (int)_thelenMuscles.size(), &_thelenMuscles[0]);
+}
@@ -0,0 +1,106 @@
+#ifndef OPENSIM_MUSCLE_CURVE_BATCH_H_
+#define OPENSIM_MUSCLE_CURVE_BATCH_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  MuscleCurveBatch.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimActuatorsDLL.h"
+#include "Simbody.h"
+
+namespace OpenSim {
+
+class Model;
+class Muscle;
+class Millard2012EquilibriumMuscle;
+class Thelen2003Muscle;
+
+/** A MuscleCurveBatch evaluates the curves of many muscles for one state in
+a single pass, rather than one muscle at a time as each muscle computes its
+force. It gathers the Millard2012EquilibriumMuscle and Thelen2003Muscle
+muscles of a model and, for a given state, computes the MuscleLengthInfo and
+FiberVelocityInfo of all of them. The results are left in the muscles' 
+caches, where the muscles use them to compute their MuscleDynamicsInfo and
+forces.
+
+For Millard2012EquilibriumMuscle, the active- and passive-force-length
+curves and the tendon-force-length curve, with the derivatives the fiber and
+tendon stiffnesses need, are evaluated as structures of arrays in the length
+pass (see SmoothSegmentedFunction::calcValueAndDerivatives), and the
+force-velocity curve or its inverse in the velocity pass. Thelen2003Muscle's
+curves are closed-form expressions, which are evaluated with its own curve
+functions in the same two passes. Muscles of derived types, which may 
+compute their curves differently, and other muscle types are ignored and 
+compute their MuscleLengthInfo and FiberVelocityInfo as usual. Disabled 
+muscles are skipped.
+
+A model's muscles share one batch, which they create when the model's system
+is built. The first of them to compute its force for a state realizes the
+batch, so realizing the Dynamics stage goes through the batch without any 
+change to the caller. A MuscleCurveBatch can also be created for a chosen set
+of muscles, for example to compute their lengths without realizing Dynamics.
+The muscles must not be removed from the model, or the model's system 
+rebuilt, while the batch is in use.
+
+@code
+MuscleCurveBatch batch(model);
+batch.realizeMuscleLengthInfo(s);
+double fiberLength = model.getMuscles()[0].getFiberLength(s);
+@endcode */
+class OSIMACTUATORS_API MuscleCurveBatch {
+public:
+    /** Creates an empty batch. */
+    MuscleCurveBatch();
+
+    /** Creates a batch of all the Millard2012EquilibriumMuscle and
+    Thelen2003Muscle muscles of a model. */
+    explicit MuscleCurveBatch(const Model& model);
+
+    /** Adds a muscle to the batch, if it is a Millard2012EquilibriumMuscle or
+    a Thelen2003Muscle, and not of a type derived from them.
+    @returns true if the muscle was added. */
+    bool addMuscle(const Muscle& muscle);
+
+    /** @returns the number of muscles in the batch. */
+    int getNumMuscles() const;
+
+    /** Computes the MuscleLengthInfo of all the enabled muscles in the batch,
+    whose MuscleLengthInfo is not yet valid, for state s. The state must be 
+    realized to at least the Position stage. */
+    void realizeMuscleLengthInfo(const SimTK::State& s) const;
+
+    /** Computes the MuscleLengthInfo and then the FiberVelocityInfo of all the
+    enabled muscles in the batch, whose info is not yet valid, for state s. 
+    The state must be realized to at least the Velocity stage. */
+    void realizeFiberVelocityInfo(const SimTK::State& s) const;
+
+    /** Creates a batch of all the muscles of a model that can be batched and 
+    has each of them use it when it computes its force. Called by the 
+    muscles when the model's system is built. */
+    static void shareAmongMuscles(const Model& model);
+
+private:
+    SimTK::Array_<const Millard2012EquilibriumMuscle*> _millardMuscles;
+    SimTK::Array_<const Thelen2003Muscle*> _thelenMuscles;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_MUSCLE_CURVE_BATCH_H_
@@ -222,6 +222,12 @@ OpenSim::Array<double> SpringGeneralizedForce::getRecordValues(const SimTK::Stat
 	values.append(computeForceMagnitude(state));
 	return values;
 };
+/**
+ * Write the value reported by getRecordValues() into rValues.
+ */
+void SpringGeneralizedForce::writeRecordValues(const SimTK::State& state, double* rValues) const {
+	rValues[0] = computeForceMagnitude(state);
+};
 
 /**
  * Given SimTK::State object Compute the (signed) magnitude of the force applied
@@ -98,6 +98,10 @@ public:
 	 * frame, etc. used in conjunction with getRecordLabels and should return same size Array
 	 */
 	OpenSim::Array<double> getRecordValues(const SimTK::State& state) const ;
+	/**
+	 * Write the values reported by getRecordValues() into rValues.
+	 */
+	void writeRecordValues(const SimTK::State& state, double* rValues) const ;
 
 	//--------------------------------------------------------------------------
 	// COMPUTATIONS
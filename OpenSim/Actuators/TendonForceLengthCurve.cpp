@@ -77,6 +77,8 @@ TendonForceLengthCurve::TendonForceLengthCurve(double strainAtOneNormForce)
 void TendonForceLengthCurve::setNull()
 {
     setAuthors("Matthew Millard and Ajay Seth");
+    m_useLookupTable = false;
+    m_lookupTableTolerance = 1e-8;
 }
 
 void TendonForceLengthCurve::constructProperties()
@@ -101,6 +103,8 @@ void TendonForceLengthCurve::buildCurve(bool computeIntegral)
                                      getName());
     m_curve = *f;
     delete f;
+    if(m_useLookupTable)
+        m_curve.setUseLookupTable(true, m_lookupTableTolerance);
     setObjectIsUpToDateWithProperties();
 }
 
@@ -235,6 +239,43 @@ double TendonForceLengthCurve::calcDerivative(double aNormLength,
     return m_curve.calcDerivative(aNormLength,order);
 }
 
+void TendonForceLengthCurve::
+    calcValueAndDerivatives(int n, const double* aNormLengths, 
+                            double* value, 
+                            double* firstDerivative, 
+                            double* secondDerivative) const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "TendonForceLengthCurve: Tendon is not up-to-date with its properties");
+
+    m_curve.calcValueAndDerivatives(n, aNormLengths, value, 
+                                    firstDerivative, secondDerivative);
+}
+
+const SmoothSegmentedFunction& TendonForceLengthCurve::
+    getSmoothSegmentedFunction() const
+{
+    SimTK_ASSERT(isObjectUpToDateWithProperties(),
+        "TendonForceLengthCurve: Tendon is not up-to-date with its properties");
+    return m_curve;
+}
+
+void TendonForceLengthCurve::setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "TendonForceLengthCurve::setUseLookupTable",
+        "tolerance must be greater than 0, but %e was entered", tolerance);
+
+    if(isObjectUpToDateWithProperties()) {
+        m_curve.setUseLookupTable(useTable, tolerance);
+    }
+    m_useLookupTable = useTable;
+    m_lookupTableTolerance = tolerance;
+}
+
+bool TendonForceLengthCurve::getUseLookupTable() const
+{   return m_useLookupTable; }
+
 double TendonForceLengthCurve::calcIntegral(double aNormLength) const
 {
     SimTK_ASSERT(isObjectUpToDateWithProperties(),
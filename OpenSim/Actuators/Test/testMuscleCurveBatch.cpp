@@ -0,0 +1,248 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  testMuscleCurveBatch.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testMuscleCurveBatch builds a model with many Millard2012EquilibriumMuscle
+//  and Thelen2003Muscle muscles and
+//  1. checks that a MuscleCurveBatch computes the same MuscleLengthInfo and
+//     FiberVelocityInfo as the muscles do one at a time, with and without 
+//     curve lookup tables,
+//  2. checks that the muscles compute the same forces when the Dynamics stage
+//     is realized, which goes through the batch the muscles share, as they
+//     do one at a time, and
+//  3. reports the time taken to compute the muscles' forces over many states
+//     with and without a batch.
+//==============================================================================
+#include <sstream>
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/osimActuators.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+Model* buildModel(int nMuscles, bool useLookupTables);
+void testMuscleInfo(int nMuscles, bool useLookupTables);
+void testPerformance(int nMuscles, int nFrames, bool useLookupTables);
+
+int main()
+{
+    try {
+        testMuscleInfo(100, false);
+        testMuscleInfo(100, true);
+        testPerformance(100, 2000, false);
+        testPerformance(100, 2000, true);
+    }
+    catch (const std::exception& e) {
+        cout << "testMuscleCurveBatch failed: " << e.what() << endl;
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
+
+/* A ball on a slider, pulled by nMuscles muscles from the ground. Half of the
+   muscles are Millard2012EquilibriumMuscle, with fiber damping, without fiber
+   damping or with a rigid tendon in turn, with their curves evaluated from
+   lookup tables or exactly, and half Thelen2003Muscle, each with slightly
+   different properties. */
+Model* buildModel(int nMuscles, bool useLookupTables)
+{
+    using SimTK::Vec3;
+
+    double ballMass = 10;
+    double ballRadius = 0.05;
+    double anchorWidth = 0.1;
+    double optimalFiberLength = 0.1;
+    double tendonSlackLength = 0.2;
+
+    Model* model = new Model();
+    model->setName("testMuscleCurveBatch");
+    Body& ground = model->getGroundBody();
+
+    OpenSim::Body* ball = new OpenSim::Body("ball", ballMass, Vec3(0),
+                            ballMass*SimTK::Inertia::sphere(ballRadius));
+    SliderJoint* slider = new SliderJoint("slider", ground, 
+                            Vec3(anchorWidth/2+optimalFiberLength
+                                 +tendonSlackLength, 0, 0), Vec3(0), 
+                            *ball, Vec3(0), Vec3(0));
+    slider->upd_CoordinateSet()[0].setName("tx");
+    slider->upd_CoordinateSet()[0].setRangeMin(-0.1);
+    slider->upd_CoordinateSet()[0].setRangeMax(0.1);
+    model->addBody(ball);
+    model->addJoint(slider);
+
+    for(int i=0; i<nMuscles; ++i){
+        ostringstream name;
+        name << "muscle" << i;
+        double scale = 0.9 + 0.2*i/nMuscles;
+        Muscle* muscle;
+        if(i%2 == 0){
+            Millard2012EquilibriumMuscle* millard = 
+                new Millard2012EquilibriumMuscle(name.str(), 100.0, 
+                            scale*optimalFiberLength, tendonSlackLength, 0.1);
+            if(i%6 == 2)
+                millard->setMuscleConfiguration(false, false, 0.0);
+            else if(i%6 == 4)
+                millard->setMuscleConfiguration(true, false, 0.1);
+            millard->setUseCurveLookupTables(useLookupTables);
+            muscle = millard;
+        }
+        else
+            muscle = new Thelen2003Muscle(name.str(), 100.0, 
+                            scale*optimalFiberLength, tendonSlackLength, 0.1);
+        muscle->addNewPathPoint(name.str()+"-origin", ground, 
+                                Vec3(anchorWidth/2, 0, 0));
+        muscle->addNewPathPoint(name.str()+"-insertion", *ball, 
+                                Vec3(-ballRadius, 0, 0));
+        model->addForce(muscle);
+    }
+    return model;
+}
+
+/* The quantities of each muscle that depend on its curves. */
+static const int NumValues = 9;
+static void getValues(const Muscle& muscle, const SimTK::State& s, 
+                      double* values)
+{
+    values[0] = muscle.getFiberLength(s);
+    values[1] = muscle.getTendonLength(s);
+    values[2] = muscle.getActiveForceLengthMultiplier(s);
+    values[3] = muscle.getPassiveForceMultiplier(s);
+    values[4] = muscle.getFiberVelocity(s);
+    values[5] = muscle.getForceVelocityMultiplier(s);
+    values[6] = muscle.getTendonForce(s);
+    values[7] = muscle.getFiberStiffness(s);
+    values[8] = muscle.getTendonStiffness(s);
+}
+
+static void assertValues(const SimTK::Vector& expected, 
+                         const Set<Muscle>& muscles, const SimTK::State& s,
+                         const string& how)
+{
+    static const char* names[NumValues] = { "fiber length", "tendon length",
+        "active force multiplier", "passive force multiplier", 
+        "fiber velocity", "force-velocity multiplier", "tendon force",
+        "fiber stiffness", "tendon stiffness" };
+    double found[NumValues];
+    for(int i=0; i<muscles.getSize(); ++i){
+        getValues(muscles[i], s, found);
+        for(int j=0; j<NumValues; ++j){
+            double e = expected[NumValues*i+j];
+            // Rigid tendons are infinitely stiff.
+            if(SimTK::isInf(e)){
+                ASSERT(found[j] == e, __FILE__, __LINE__, how + " " + 
+                    names[j] + " of " + muscles[i].getName() + " differs.");
+                continue;
+            }
+            ASSERT_EQUAL(e, found[j], 1e-10*std::max(1.0, std::abs(e)),
+                __FILE__, __LINE__, how + " " + names[j] + " of " 
+                + muscles[i].getName() + " differs.");
+        }
+    }
+}
+
+void testMuscleInfo(int nMuscles, bool useLookupTables)
+{
+    Model* model = buildModel(nMuscles, useLookupTables);
+    SimTK::State& s = model->initSystem();
+
+    MuscleCurveBatch batch(*model);
+    ASSERT(batch.getNumMuscles() == nMuscles, __FILE__, __LINE__);
+
+    const Coordinate& tx = model->getCoordinateSet()[0];
+    const Set<Muscle>& muscles = model->getMuscles();
+    const SimTK::MultibodySystem& system = model->getMultibodySystem();
+    SimTK::Vector expected(NumValues*nMuscles);
+    for(int k=0; k<50; ++k){
+        double q = -0.05 + 0.002*k;
+        double u = 0.05*(k%5 - 2);
+
+        // One muscle at a time
+        tx.setValue(s, q);
+        tx.setSpeedValue(s, u);
+        system.realize(s, SimTK::Stage::Velocity);
+        for(int i=0; i<nMuscles; ++i)
+            getValues(muscles[i], s, &expected[NumValues*i]);
+
+        // Setting the coordinate again invalidates the muscles' info
+        tx.setValue(s, q);
+        tx.setSpeedValue(s, u);
+        system.realize(s, SimTK::Stage::Velocity);
+        batch.realizeMuscleLengthInfo(s);
+        batch.realizeFiberVelocityInfo(s);
+        assertValues(expected, muscles, s, "Batched");
+
+        // Realizing Dynamics computes the forces through the muscles' batch
+        tx.setValue(s, q);
+        tx.setSpeedValue(s, u);
+        system.realize(s, SimTK::Stage::Dynamics);
+        assertValues(expected, muscles, s, "Realized");
+    }
+    delete model;
+
+    cout << "*********************** testMuscleInfo ***********************" << endl;
+    cout << nMuscles << " muscles, lookup tables " 
+         << (useLookupTables ? "on" : "off") << ": passed." << endl;
+}
+
+void testPerformance(int nMuscles, int nFrames, bool useLookupTables)
+{
+    Model* model = buildModel(nMuscles, useLookupTables);
+    SimTK::State& s = model->initSystem();
+
+    MuscleCurveBatch batch(*model);
+    const Coordinate& tx = model->getCoordinateSet()[0];
+    const Set<Muscle>& muscles = model->getMuscles();
+    const SimTK::MultibodySystem& system = model->getMultibodySystem();
+    tx.setSpeedValue(s, 0.01);
+
+    double force = 0;
+    double start = SimTK::realTime();
+    for(int k=0; k<nFrames; ++k){
+        tx.setValue(s, -0.05 + 0.1*k/nFrames);
+        system.realize(s, SimTK::Stage::Velocity);
+        for(int i=0; i<nMuscles; ++i)
+            force += muscles[i].getTendonForce(s);
+    }
+    double muscleTime = SimTK::realTime()-start;
+
+    start = SimTK::realTime();
+    for(int k=0; k<nFrames; ++k){
+        tx.setValue(s, -0.05 + 0.1*k/nFrames);
+        system.realize(s, SimTK::Stage::Velocity);
+        batch.realizeFiberVelocityInfo(s);
+        for(int i=0; i<nMuscles; ++i)
+            force -= muscles[i].getTendonForce(s);
+    }
+    double batchTime = SimTK::realTime()-start;
+    delete model;
+
+    ASSERT_EQUAL(0.0, force, 1e-6, __FILE__, __LINE__, 
+        "Batched tendon forces differ.");
+
+    cout << "*********************** testPerformance ***********************" << endl;
+    cout << nMuscles << " muscles, " << nFrames << " states, lookup tables " 
+         << (useLookupTables ? "on" : "off") << "." << endl;
+    cout << "Muscle forces: " << muscleTime << "s muscle by muscle, "
+         << batchTime << "s with MuscleCurveBatch." << endl;
+}
@@ -86,6 +86,8 @@ functioning
                 2: Correctness test: ensure that d/dt(KE+PE-W) = 0 
 @param testTolerance    the desired tolerance associated with the test
 @param printResults print the osim model associated with this test.
+@param integratorMethod the name of the integration method used by the 
+                Manager (see Manager::createIntegrator)
 */
 void simulateMuscle(const Muscle &aMuscle, 
                     double startX, 
@@ -95,16 +97,19 @@ void simulateMuscle(const Muscle &aMuscle,
 					double integrationAccuracy,
                     int testType,
                     double testTolerance,
-                    bool printResults);
+                    bool printResults,
+                    const string& integratorMethod = "RungeKuttaMerson");
 
 //void testPathActuator();
 void testRigidTendonMuscle();
 void testThelen2003Muscle_Deprecated();
 void testThelen2003Muscle();
 void testMillard2012EquilibriumMuscle();
+void testMillard2012EquilibriumMuscleLookupTables();
 void testMillard2012AccelerationMuscle();
 void testSchutte1993Muscle();
 void testDelp1990Muscle();
+void benchmarkIntegratorMethods();
 
 int main()
 {
@@ -158,12 +163,24 @@ int main()
         e.print(cerr);
         failures.push_back("testMillard2012EquilibriumMuscle");
     }
+    try { testMillard2012EquilibriumMuscleLookupTables();
+		cout << "Millard2012EquilibriumMuscle Lookup Table Test passed" << endl; 
+    }catch (const Exception& e){ 
+        e.print(cerr);
+        failures.push_back("testMillard2012EquilibriumMuscleLookupTables");
+    }
     try { testMillard2012AccelerationMuscle();
 		cout << "Millard2012AccelerationMuscle Test passed" << endl; 
     }catch (const Exception& e){ 
         e.print(cerr);
         failures.push_back("testMillard2012AccelerationMuscle");
     }
+    try { benchmarkIntegratorMethods();
+		cout << "Integrator method benchmark passed" << endl; 
+    }catch (const Exception& e){ 
+        e.print(cerr);
+        failures.push_back("benchmarkIntegratorMethods");
+    }
 
     printf("\n\n");
     cout <<"************************************************************"<<endl;
@@ -197,7 +214,8 @@ void simulateMuscle(
 		double integrationAccuracy,
         int testType,
         double testTolerance,
-        bool printResults)
+        bool printResults,
+        const string& integratorMethod)
 {
 	string prescribed = (motion == NULL) ? "." : " with Prescribed Motion.";
 
@@ -405,13 +423,12 @@ void simulateMuscle(
 // 4. SIMULATION Integration
 //==========================================================================
 
-	// Create the integrator
-	SimTK::RungeKuttaMersonIntegrator integrator(model.getMultibodySystem());
+	// Create the manager and its integrator
+	Manager manager(model);
+	manager.setIntegratorMethod(integratorMethod);
+	SimTK::Integrator& integrator = manager.getIntegrator();
 	integrator.setAccuracy(integrationAccuracy);
 
-	// Create the manager
-	Manager manager(model, integrator);
-
 	// Integrate from initial time to final time
 	manager.setInitialTime(initialTime);
 	manager.setFinalTime(finalTime);
@@ -419,11 +436,20 @@ void simulateMuscle(
 
 	// Start timing the simulation
 	const clock_t start = clock();
+	const double wallStart = SimTK::realTime();
 	// simulate
 	manager.integrate(si);
 
 	// how long did it take?
 	double comp_time = (double)(clock()-start)/CLOCKS_PER_SEC;
+	double wall_time = SimTK::realTime() - wallStart;
+
+	int numSteps = integrator.getNumStepsTaken();
+	int numRealizations = integrator.getNumRealizations();
+	printf("testMuscles: %s took %d steps and %d realizations "
+           "(%g realizations/s) in %f s wall time\n",
+            integratorMethod.c_str(), numSteps, numRealizations,
+            wall_time > 0 ? numRealizations/wall_time : 0.0, wall_time);
 
 	// Save the simulation results
 	Storage states(manager.getStateStorage());
@@ -811,6 +837,45 @@ void testMillard2012EquilibriumMuscle()
         false);
 }
 
+/*
+Simulates the Millard2012EquilibriumMuscle with curves that are evaluated from
+lookup tables, first with the exact curves for reference. The realtime 
+multipliers of the two simulations are printed by simulateMuscle.
+*/
+void testMillard2012EquilibriumMuscleLookupTables()
+{
+	double x0 = 0;
+	double act0 = 0.2;
+
+	Constant control(0.5);
+
+	Sine motion(0.1, SimTK::Pi, 0);
+
+    for(int useTables = 0; useTables < 2; ++useTables){
+        cout << "\nMillard2012EquilibriumMuscle curves evaluated "
+             << (useTables ? "from lookup tables" : "exactly") << endl;
+        Millard2012EquilibriumMuscle muscle("muscle",
+                                MaxIsometricForce0,
+                                OptimalFiberLength0,
+                                TendonSlackLength0,
+                                PennationAngle0);
+
+        muscle.setActivationTimeConstant(Activation0);
+        muscle.setDeactivationTimeConstant(Deactivation0);
+        muscle.setUseCurveLookupTables(useTables != 0);
+
+        simulateMuscle(muscle, 
+            x0, 
+            act0, 
+            &motion, 
+            &control, 
+            IntegrationAccuracy,
+            CorrectnessTest,
+            CorrectnessTestTolerance,
+            false);
+    }
+}
+
 void testMillard2012AccelerationMuscle()
 {
 	Millard2012AccelerationMuscle muscle("muscle",
@@ -916,3 +981,76 @@ void testDelp1990Muscle()
         false);
 
 }
+
+
+/*
+Simulates a stiff Millard2012EquilibriumMuscle (a stiff tendon and little fiber
+damping) with each integration method the Manager can create, reporting the
+steps taken, realizations per second and wall time of each. The higher-order
+error-controlled methods and CPodes must pass the correctness test; the
+low-order and fixed-step methods are only timed, and a failure to complete
+the simulation is reported rather than treated as a test failure.
+*/
+void benchmarkIntegratorMethods()
+{
+	Millard2012EquilibriumMuscle muscle("muscle",
+                            MaxIsometricForce0,
+                            OptimalFiberLength0,
+                            TendonSlackLength0,
+                            PennationAngle0);
+
+    muscle.setActivationTimeConstant(Activation0);
+    muscle.setDeactivationTimeConstant(Deactivation0);
+    muscle.setFiberDamping(0.01);
+
+    TendonForceLengthCurve tendonCurve = muscle.getTendonForceLengthCurve();
+    tendonCurve.setStrainAtOneNormForce(0.01);
+    muscle.setTendonForceLengthCurve(tendonCurve);
+
+	double x0 = 0;
+	double act0 = 0.2;
+    double accuracy = 1.0e-6;
+
+	Constant control(0.5);
+
+	Sine motion(0.1, SimTK::Pi, 0);
+
+    const int numTested = 4;
+    const string testedMethods[numTested] = { "RungeKuttaMerson", 
+        "RungeKuttaFeldberg", "RungeKutta3", "CPodes" };
+
+    for(int i=0; i<numTested; ++i){
+        simulateMuscle(muscle, 
+            x0, 
+            act0, 
+            &motion, 
+            &control, 
+            accuracy,
+            CorrectnessTest,
+            CorrectnessTestTolerance,
+            false,
+            testedMethods[i]);
+    }
+
+    const int numTimed = 5;
+    const string timedMethods[numTimed] = { "RungeKutta2", 
+        "SemiExplicitEuler2", "Verlet", "ExplicitEuler", "SemiExplicitEuler" };
+
+    for(int i=0; i<numTimed; ++i){
+        try {
+            simulateMuscle(muscle, 
+                x0, 
+                act0, 
+                &motion, 
+                &control, 
+                accuracy,
+                SimulationTest,
+                SimulationTestTolerance,
+                false,
+                timedMethods[i]);
+        } catch (const std::exception& e) {
+            cout << "testMuscles: " << timedMethods[i] 
+                 << " did not complete: " << e.what() << endl;
+        }
+    }
+}
@@ -25,6 +25,7 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Model.h>
 #include "Thelen2003Muscle.h"
+#include "MuscleCurveBatch.h"
 
 //=============================================================================
 // STATICS
@@ -33,6 +34,15 @@ using namespace std;
 using namespace OpenSim;
 using namespace SimTK;
 
+//The tendon-force-length multiplier and the curve derivatives stored in 
+//MuscleLengthInfo::userDefinedLengthExtras, for use in calcFiberVelocityInfo
+//and calcMuscleDynamicsInfo
+const static int MLIfse   = 0;
+const static int MLIdfse  = 1;
+const static int MLIdfal  = 2;
+const static int MLIdfpe  = 3;
+const static int MLISize  = 4;
+
 //=============================================================================
 // CONSTRUCTORS
 //=============================================================================
@@ -81,12 +91,20 @@ void Thelen2003Muscle::addToSystem(SimTK::MultibodySystem& system) const
 	string errMsg =  getConcreteClassName()+" "+ getName() +
 				  " is not up to date with its properties";
     SimTK_ASSERT(isObjectUpToDateWithProperties(), errMsg.c_str());
+
+    //The first muscle of the model to get here shares a batch among all of
+    //them. Derived types are not batched.
+    if(!_curveBatch && getConcreteClassName() == getClassName())
+        MuscleCurveBatch::shareAmongMuscles(getModel());
 }
 
 void Thelen2003Muscle::connectToModel(Model& aModel)
 {
     Super::connectToModel(aModel);
     ensureMuscleUpToDate();
+
+    //Shared again when the system is built, with the muscles of this model
+    _curveBatch.reset();
 }
 
 void Thelen2003Muscle::ensureMuscleUpToDate()
@@ -459,8 +477,11 @@ double  Thelen2003Muscle::computeActuation(const SimTK::State& s) const
                     "Thelen2003Muscle: Muscle is not"
                     " to date with properties");
 
-    const MuscleLengthInfo& mli = getMuscleLengthInfo(s);
-    const FiberVelocityInfo& mvi = getFiberVelocityInfo(s);
+    //The first muscle of the batch to compute its force evaluates the curves
+    //of all of them
+    if(_curveBatch && !isCacheVariableValid(s, _velInfoCV))
+        _curveBatch->realizeFiberVelocityInfo(s);
+
     const MuscleDynamicsInfo& mdi = getMuscleDynamicsInfo(s);
     setForce(s,         mdi.tendonForce);
     return( mdi.tendonForce );
@@ -600,16 +621,11 @@ void Thelen2003Muscle::calcMuscleLengthInfo(const SimTK::State& s,
                     "Thelen2003Muscle: Muscle is not"
                     " to date with properties");
 
-    double simTime = s.getTime(); //for debugging purposes
-
     try{
         double optFiberLength   = getOptimalFiberLength();
         double mclLength        = getLength(s);
         double tendonSlackLen   = getTendonSlackLength();
 
-        std::string caller      = getName();
-        caller.append("_Thelen2003Muscle::calcMuscleLengthInfo");
-
         //Clamp the minimum fiber length to its minimum physical value.
         mli.fiberLength  = penMdl.clampFiberLength(
                                 getStateVariable(s, STATE_FIBER_LENGTH_NAME));
@@ -626,11 +642,16 @@ void Thelen2003Muscle::calcMuscleLengthInfo(const SimTK::State& s,
                                                         mli.fiberLength,mclLength);
         mli.normTendonLength  = mli.tendonLength / tendonSlackLen;
         mli.tendonStrain      = mli.normTendonLength -  1.0;
-        
-
     
         mli.fiberPassiveForceLengthMultiplier= calcfpe(mli.normFiberLength);
         mli.fiberActiveForceLengthMultiplier = calcfal(mli.normFiberLength);
+
+        SimTK::Vector& extras = mli.userDefinedLengthExtras;
+        extras.resize(MLISize);
+        extras[MLIfse]  = calcfse(mli.normTendonLength);
+        extras[MLIdfse] = calcDfseDtlN(mli.normTendonLength);
+        extras[MLIdfal] = calcDfalDlceN(mli.normFiberLength);
+        extras[MLIdfpe] = calcDfpeDlceN(mli.normFiberLength);
     }catch(const std::exception &x){
         std::string msg = "Exception caught in Thelen2003Muscle::" 
                           "calcMuscleLengthInfo\n"                 
@@ -640,6 +661,36 @@ void Thelen2003Muscle::calcMuscleLengthInfo(const SimTK::State& s,
     }
 }
 
+void Thelen2003Muscle::realizeMuscleLengthInfo(const SimTK::State& s, int n,
+                                        const Thelen2003Muscle* const* muscles)
+{
+    //The curves are closed-form expressions of the muscles' properties, 
+    //evaluated by calcMuscleLengthInfo one muscle after the other
+    for(int i = 0; i < n; ++i){
+        const Thelen2003Muscle& muscle = *muscles[i];
+        if(muscle.isDisabled(s) || 
+           muscle.isCacheVariableValid(s, muscle._lengthInfoCV))
+            continue;
+
+        muscle.calcMuscleLengthInfo(s, muscle.updMuscleLengthInfo(s));
+        muscle.markCacheVariableValid(s, muscle._lengthInfoCV);
+    }
+}
+
+void Thelen2003Muscle::realizeFiberVelocityInfo(const SimTK::State& s, int n,
+                                        const Thelen2003Muscle* const* muscles)
+{
+    for(int i = 0; i < n; ++i){
+        const Thelen2003Muscle& muscle = *muscles[i];
+        if(muscle.isDisabled(s) || 
+           muscle.isCacheVariableValid(s, muscle._velInfoCV))
+            continue;
+
+        muscle.calcFiberVelocityInfo(s, muscle.updFiberVelocityInfo(s));
+        muscle.markCacheVariableValid(s, muscle._velInfoCV);
+    }
+}
+
 void Thelen2003Muscle::calcMusclePotentialEnergyInfo(const SimTK::State& s,
 		MusclePotentialEnergyInfo& mpei) const
 {
@@ -741,7 +792,7 @@ void Thelen2003Muscle::calcFiberVelocityInfo(const SimTK::State& s,
         //to its mimimum allowable value.
     
 
-        double fse  = calcfse(tl/tendonSlackLen);    
+        double fse  = mli.userDefinedLengthExtras[MLIfse];    
         double fal  = mli.fiberActiveForceLengthMultiplier;
         double fpe  = mli.fiberPassiveForceLengthMultiplier;
 
@@ -893,14 +944,18 @@ void Thelen2003Muscle::calcMuscleDynamicsInfo(const SimTK::State& s,
         if(fiberStateClamped < 0.5){        
             aFm          = calcActiveFm(a,fal,fv,fiso);
             Fm           = calcFm(a,fal,fv,fpe,fiso);
-            dFm_dlce     = calcDFmDlce(lce,a,fv,fiso,optFiberLen);
+            dFm_dlce     = calcDFmDlce(a,fv,
+                                mli.userDefinedLengthExtras[MLIdfal],
+                                mli.userDefinedLengthExtras[MLIdfpe],
+                                fiso,optFiberLen);
             dFmAT_dlce   = calcDFmATDlce(lce,phi,cosphi,Fm,dFm_dlce,penHeight);
 
             //The expression below is correct only because we are using a pennation
             //model that has a parallelogram of constant height.
             dFmAT_dlceAT= dFmAT_dlce*cosphi;
 
-            dFt_dtl = calcDFseDtl(tl, fiso, tendonSlackLen);
+            dFt_dtl = mli.userDefinedLengthExtras[MLIdfse]
+                      *(fiso/tendonSlackLen);
 
             //Compute the stiffness of the whole muscle/tendon complex
             Ke = (dFmAT_dlceAT*dFt_dtl)/(dFmAT_dlceAT+dFt_dtl);
@@ -1300,6 +1355,12 @@ double Thelen2003Muscle::calcDFmDlce(double lce, double ma, double fv,
             double dfal_d_lceN = calcDfalDlceN(lceN);
             double dfpe_d_lceN = calcDfpeDlceN(lceN);
 
+            return calcDFmDlce(ma, fv, dfal_d_lceN, dfpe_d_lceN, fiso, ofl);
+}
+
+double Thelen2003Muscle::calcDFmDlce(double ma, double fv, double dfal_d_lceN,
+                        double dfpe_d_lceN, double fiso, double ofl) const
+{
             double dFm_d_lce = ((ma*fv)*dfal_d_lceN + dfpe_d_lceN)*fiso
                               *(1/ofl);                   
             return dFm_d_lce;
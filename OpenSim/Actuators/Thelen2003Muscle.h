@@ -32,6 +32,10 @@
 #include <OpenSim/Actuators/MuscleFirstOrderActivationDynamicModel.h>
 #include <OpenSim/Actuators/MuscleFixedWidthPennationModel.h>
 
+#ifndef SWIG
+#include <memory>
+#endif
+
 #ifdef SWIG
     #ifdef OSIMACTUATORS_API
         #undef OSIMACTUATORS_API
@@ -40,6 +44,9 @@
 #endif
 
 namespace OpenSim {
+
+class MuscleCurveBatch;
+
 //==============================================================================
 //                          THELEN 2003 MUSCLE
 //==============================================================================
@@ -240,6 +247,30 @@ public:
     //Ajay: this is old. Can I stop calling it?
     virtual double computeActuation(const SimTK::State& s) const OVERRIDE_11;
 
+    /** Computes the MuscleLengthInfo of several muscles for one state in a
+    single pass, evaluating their active-force-length, passive-force-length
+    and tendon-force-length curves, and the derivatives of these curves, 
+    with calcMuscleLengthInfo. The results are stored in the muscles' caches,
+    so that the muscles use them when they compute their forces. Muscles 
+    that are disabled, or whose MuscleLengthInfo is already valid for the 
+    state, are skipped. MuscleCurveBatch uses this to process all the muscles
+    of a model.
+        @param s The state of the system.
+        @param n The number of muscles.
+        @param muscles The n muscles. */
+    static void realizeMuscleLengthInfo(const SimTK::State& s, int n,
+                                    const Thelen2003Muscle* const* muscles);
+
+    /** Computes the FiberVelocityInfo of several muscles for one state in a
+    single pass, inverting their force-velocity curves with 
+    calcFiberVelocityInfo. Muscles that are disabled, or whose 
+    FiberVelocityInfo is already valid for the state, are skipped.
+        @param s The state of the system.
+        @param n The number of muscles.
+        @param muscles The n muscles. */
+    static void realizeFiberVelocityInfo(const SimTK::State& s, int n,
+                                    const Thelen2003Muscle* const* muscles);
+
 
     /** Compute initial fiber length (velocity) such that muscle fiber and 
         tendon are in static equilibrium and update the state
@@ -319,6 +350,14 @@ private:
 
     //Fiber and Tendon Kinematics
     MuscleFixedWidthPennationModel penMdl;
+
+    //The batch in which the curves of this muscle are evaluated with those
+    //of the model's other muscles. Shared among them by 
+    //MuscleCurveBatch::shareAmongMuscles in addToSystem()
+#ifndef SWIG
+    mutable std::shared_ptr<MuscleCurveBatch> _curveBatch;
+    friend class MuscleCurveBatch;
+#endif
     
     //=====================================================================
     // Private Accessor names
@@ -346,6 +385,11 @@ private:
     double calcDFmDlce(double lce, double a,  double fv, 
                       double fiso, double ofl) const;
 
+    //As above, given the derivatives of the active and passive force-length
+    //curves at the normalized fiber length
+    double calcDFmDlce(double a, double fv, double dfal_d_lceN, 
+                       double dfpe_d_lceN, double fiso, double ofl) const;
+
     double calcDFmATDlce(double lce, double phi, double cosphi, 
     double Fm, double d_Fm_d_lce, double penHeight) const;
 
@@ -37,6 +37,7 @@
 #include "RigidTendonMuscle.h"
 #include "Millard2012EquilibriumMuscle.h"
 #include "Millard2012AccelerationMuscle.h"
+#include "MuscleCurveBatch.h"
 
 #include "McKibbenActuator.h"
 
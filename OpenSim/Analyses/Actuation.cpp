@@ -420,8 +420,8 @@ begin(SimTK::State& s)
 	if(!proceed()) return(0);
 
 	// NUMBER OF ACTUATORS
-	int na = _model->getActuators().getSize();
-	_na = na;
+	// Only enabled actuators are recorded, so the work array is sized for them.
+	_na = getNumEnabledActuators();
 	// WORK ARRAY
 	if (_fsp != NULL) delete[] _fsp;
 	_fsp = new double[_na];
@@ -438,6 +438,10 @@ begin(SimTK::State& s)
 	_forceStore->reset(s.getTime());
 	_speedStore->reset(s.getTime());
 	_powerStore->reset(s.getTime());
+	// Rows of a fixed width are appended straight into the columnar buffers.
+	_forceStore->setColumnar(true);
+	_speedStore->setColumnar(true);
+	_powerStore->setColumnar(true);
 
 	// RECORD
 	int status = 0;
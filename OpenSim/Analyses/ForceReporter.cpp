@@ -236,6 +236,33 @@ void ForceReporter::constructColumnLabels(const SimTK::State& s)
 }
 
 
+//_____________________________________________________________________________
+/**
+ * Allocate the row into which record() writes, sized for every Force and
+ * Constraint of the model so that the row fits whichever are enabled.
+ */
+void ForceReporter::allocateRecordRow()
+{
+	const ForceSet& forces = _model->getForceSet();
+	const ConstraintSet& constraints = _model->getConstraintSet();
+	int nf = forces.getSize();
+	int nc = _includeConstraintForces ? constraints.getSize() : 0;
+
+	_recordWidths.setSize(nf+nc);
+	int width = 0;
+	for(int i=0;i<nf;i++) {
+		_recordWidths[i] = forces[i].getNumRecordValues();
+		width += _recordWidths[i];
+	}
+	for(int i=0;i<nc;i++) {
+		_recordWidths[nf+i] = constraints[i].getNumRecordValues();
+		width += _recordWidths[nf+i];
+	}
+	// Keep a buffer even for an empty row so the time is still appended.
+	_recordRow.setSize(width>0 ? width : 1);
+}
+
+
 //=============================================================================
 // DESTRUCTION METHODS
 //=============================================================================
@@ -262,34 +289,36 @@ int ForceReporter::record(const SimTK::State& s)
 	// MAKE SURE ALL ForceReporter QUANTITIES ARE VALID
     _model->getMultibodySystem().realize(s, SimTK::Stage::Dynamics );
 
-	StateVector nextRow = StateVector(s.getTime());
-
 	// NUMBER OF Forces
 	const ForceSet& forces = _model->getForceSet(); // This does not contain gravity
 	int nf = forces.getSize();
+	int nc = _includeConstraintForces ? _model->getConstraintSet().getSize() : 0;
+	if(_recordWidths.getSize()!=nf+nc) allocateRecordRow();
 
+	// WRITE THE VALUES OF THE ENABLED FORCES INTO THE ROW
+	double *values = _recordRow.get();
+	int n = 0;
 	for(int i=0;i<nf;i++) {
 		// If body force we need to record six values for torque+force
 		// If muscle we record one scalar
-		OpenSim::Force& nextForce = (OpenSim::Force&)forces[i];
+		const OpenSim::Force& nextForce = forces[i];
 		if (nextForce.isDisabled(s)) continue;
-		Array<double> values = nextForce.getRecordValues(s);
-		nextRow.getData().append(values);
+		nextForce.writeRecordValues(s, &values[n]);
+		n += _recordWidths[i];
 	}
 
 	if(_includeConstraintForces){
 		// NUMBER OF Constraints
 		const ConstraintSet& constraints = _model->getConstraintSet(); // This does not contain gravity
-		int nc = constraints.getSize();
 
 		for(int i=0;i<nc;i++) {
-			OpenSim::Constraint& nextConstraint = (OpenSim::Constraint&)constraints[i];
+			const OpenSim::Constraint& nextConstraint = constraints[i];
 			if (nextConstraint.isDisabled(s)) continue;
-			Array<double> values = nextConstraint.getRecordValues(s);
-			nextRow.getData().append(values);
+			nextConstraint.writeRecordValues(s, &values[n]);
+			n += _recordWidths[nf+i];
 		}
 	}
-	_forceStore.append(nextRow);
+	_forceStore.append(s.getTime(),n,values);
 
 	return(0);
 }
@@ -318,6 +347,9 @@ begin(SimTK::State& s)
 	constructColumnLabels(s);
 	// RESET STORAGE
 	_forceStore.reset(s.getTime());
+	// Rows of a fixed width are appended straight into the columnar buffers.
+	_forceStore.setColumnar(true);
+	allocateRecordRow();
 
 	// RECORD
 	int status = 0;
@@ -65,6 +65,12 @@ protected:
 	/** Force storage. */
 	Storage _forceStore;
 
+	/** Number of values reported by each Force, followed by each Constraint,
+	of the model.  Fixed at begin(). */
+	Array<int> _recordWidths;
+	/** Row into which record() writes the values of a step. */
+	Array<double> _recordRow;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -82,6 +88,7 @@ private:
 	void allocateStorage();
 	void deleteStorage();
 	void tidyForceNames();
+	void allocateRecordRow();
 
 public:
 	//--------------------------------------------------------------------------
@@ -75,6 +75,7 @@ InducedAccelerations::InducedAccelerations(Model *aModel) :
 	_forceThreshold(_forceThresholdProp.getValueDbl()),
 	_computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
 	_reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+	_solveContributorsJointly(_solveContributorsJointlyProp.getValueBool()),
 	_bodySet(*new BodySet()),
 	_coordSet(*new CoordinateSet())
 {
@@ -103,6 +104,7 @@ InducedAccelerations::InducedAccelerations(const std::string &aFileName):
 	_forceThreshold(_forceThresholdProp.getValueDbl()),
 	_computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
 	_reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+	_solveContributorsJointly(_solveContributorsJointlyProp.getValueBool()),
 	_bodySet(*new BodySet()),
 	_coordSet(*new CoordinateSet())
 {
@@ -127,6 +129,7 @@ InducedAccelerations::InducedAccelerations(const InducedAccelerations &aInducedA
 	_forceThreshold(_forceThresholdProp.getValueDbl()),
 	_computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
 	_reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+	_solveContributorsJointly(_solveContributorsJointlyProp.getValueBool()),
 	_bodySet(*new BodySet()),
 	_coordSet(*new CoordinateSet())
 {
@@ -160,6 +163,7 @@ operator=(const InducedAccelerations &aInducedAccelerations)
 	_forceThreshold = aInducedAccelerations._forceThreshold;
 	_computePotentialsOnly = aInducedAccelerations._computePotentialsOnly;
 	_reportConstraintReactions = aInducedAccelerations._reportConstraintReactions;
+	_solveContributorsJointly = aInducedAccelerations._solveContributorsJointly;
 	_includeCOM = aInducedAccelerations._includeCOM;
 	return(*this);
 }
@@ -179,6 +183,7 @@ void InducedAccelerations::setNull()
 	_bodyNames[0] = CENTER_OF_MASS_NAME;
 	_computePotentialsOnly = false;
 	_reportConstraintReactions = false;
+	_solveContributorsJointly = false;
 	// Analysis does not own contents of these sets
 	_coordSet.setMemoryOwner(false);
 	_bodySet.setMemoryOwner(false);
@@ -221,6 +226,11 @@ void InducedAccelerations::setupProperties()
 	_reportConstraintReactionsProp.setName("report_constraint_reactions");
 	_reportConstraintReactionsProp.setComment("Report individual contributions to constraint reactions in addition to accelerations.");
 	_propertySet.append(&_reportConstraintReactionsProp);
+
+	_solveContributorsJointlyProp.setName("solve_contributors_jointly");
+	_solveContributorsJointlyProp.setComment("Factor the constrained dynamics once per time frame and solve for the accelerations induced by gravity and all actuators together. "
+		"Results are the same; this is much faster for models with many actuators. Ignored when constraint reactions are reported.");
+	_propertySet.append(&_solveContributorsJointlyProp);
 }
 
 //=============================================================================
@@ -545,9 +555,24 @@ int InducedAccelerations::record(const SimTK::State& s)
 	// DO NOT recreate the system, will lose location of constraint
 	_model->initStateWithoutRecreatingSystem(s_analysis);
 
+	// Gravity and the actuators act at the same configuration with zero
+	// velocity, so their induced accelerations can be solved for together.
+	bool solveJointly = _solveContributorsJointly && !_reportConstraintReactions;
+	SimTK::State s_joint;
+	SimTK::Matrix jointUDots;
+	if(solveJointly){
+		s_joint = s_analysis;
+		solveContributorsJointly(s, s_joint, jointUDots);
+	}
+
 	// Cycle through the force contributors to the system acceleration
 	for(int c=0; c< _contributors.getSize(); c++){			
 		//cout << "Solving for contributor: " << _contributors[c] << endl;
+		if(solveJointly && _contributors[c] != "total" && _contributors[c] != "velocity"){
+			appendAccelerationsFromUDot(s_joint, SimTK::Vector(jointUDots(c)));
+			continue;
+		}
+
 		// Need to be at the dynamics stage to disable a force
 		_model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Dynamics);
 		
@@ -795,6 +820,183 @@ int InducedAccelerations::record(const SimTK::State& s)
 	return(0);
 }
 
+/**
+ * Solve for the accelerations induced by gravity and by each actuator at
+ * once. The constrained equations of motion are linear in the applied
+ * forces at a given configuration, so they are factored once and each
+ * contributor's generalized forces are solved as one right-hand side.
+ *
+ * @param s State being analyzed.
+ * @param s_joint State with the contact constraints of this time frame;
+ * on return it holds the configuration with zero velocity at which the
+ * contributors were evaluated.
+ * @param rUDots Generalized accelerations, one column per contributor.
+ * Columns of contributors that are not solved for here are zero.
+ */
+void InducedAccelerations::solveContributorsJointly(const SimTK::State& s,
+	SimTK::State& s_joint, SimTK::Matrix& rUDots)
+{
+	const SimTK::MultibodySystem& system = _model->getMultibodySystem();
+	const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+	const SimTK::GeneralForceSubsystem& forceSubsystem = _model->getForceSubsystem();
+	int nu = _model->getNumSpeeds();
+	int nc = _contributors.getSize();
+
+	// Same conditions as each contributor's own realization: zero velocity
+	// and gravity off, but with all the actuators on.
+	s_joint.setTime(s.getTime());
+	s_joint.setQ(s.getQ());
+	s_joint.setU(SimTK::Vector(nu,0.0));
+	s_joint.setZ(s.getZ());
+	_model->updForceSubsystem().setForceIsDisabled(s_joint, _model->getGravityForce().getForceIndex(), true);
+
+	Set<Actuator> &actuators = _model->updActuators();
+	for(int f=0; f<actuators.getSize(); f++){
+		Actuator &actuator = actuators.get(f);
+		actuator.setDisabled(s_joint, false);
+		actuator.overrideForce(s_joint, false);
+		Muscle *muscle = dynamic_cast<Muscle *>(&actuator);
+		if(muscle && _computePotentialsOnly){
+			muscle->overrideForce(s_joint, true);
+			muscle->setOverrideForce(s_joint, 1.0);
+		}
+	}
+	system.realize(s_joint, SimTK::Stage::Dynamics);
+
+	// Generalized forces applied by everything that is enabled
+	SimTK::Vector appliedForces;
+	matter.multiplyBySystemJacobianTranspose(s_joint,
+		system.getRigidBodyForces(s_joint, SimTK::Stage::Dynamics), appliedForces);
+	appliedForces += system.getMobilityForces(s_joint, SimTK::Stage::Dynamics);
+
+	// Generalized forces of each contributor
+	SimTK::Matrix contributorForces(nu, nc, 0.0);
+	SimTK::Vector_<SimTK::SpatialVec> bodyForces;
+	SimTK::Vector_<SimTK::Vec3> particleForces;
+	SimTK::Vector mobilityForces, generalizedForces;
+	for(int c=0; c<nc; c++){
+		const SimTK::Force *force = NULL;
+		if(_contributors[c] == "gravity"){
+			force = &_model->getGravityForce();
+		}
+		else if(_contributors[c] != "total" && _contributors[c] != "velocity"){
+			int ai = actuators.getIndex(_contributors[c]);
+			if(ai<0)
+				throw Exception("InducedAcceleration: ERR- Could not find actuator '"+_contributors[c],__FILE__,__LINE__);
+			force = &forceSubsystem.getForce(actuators.get(ai).getForceIndex());
+		}
+		if(force == NULL) continue;
+
+		force->calcForceContribution(s_joint, bodyForces, particleForces, mobilityForces);
+		matter.multiplyBySystemJacobianTranspose(s_joint, bodyForces, generalizedForces);
+		generalizedForces += mobilityForces;
+		contributorForces(c) = generalizedForces;
+
+		// What remains once the actuators are removed from the applied
+		// forces are the passive forces present in every contributor.
+		if(_contributors[c] != "gravity")
+			appliedForces -= generalizedForces;
+	}
+
+	// Constraint equations: G*udot = -bias
+	SimTK::Matrix G;
+	matter.calcG(s_joint, G);
+	SimTK::Vector bias;
+	matter.calcBiasForAccelerationConstraints(s_joint, bias);
+	int nm = G.nrow();
+
+	// Factor [M ~G; G 0] once and solve all contributors with it
+	SimTK::Matrix M;
+	matter.calcM(s_joint, M);
+	SimTK::Matrix kkt(nu+nm, nu+nm, 0.0);
+	kkt.updBlock(0, 0, nu, nu) = M;
+	if(nm > 0){
+		kkt.updBlock(0, nu, nu, nm) = ~G;
+		kkt.updBlock(nu, 0, nm, nu) = G;
+	}
+
+	SimTK::Matrix rhs(nu+nm, nc, 0.0);
+	for(int c=0; c<nc; c++){
+		if(_contributors[c] == "total" || _contributors[c] == "velocity") continue;
+		for(int i=0; i<nu; i++) rhs(i,c) = contributorForces(i,c) + appliedForces[i];
+		for(int i=0; i<nm; i++) rhs(nu+i,c) = -bias[i];
+	}
+
+	SimTK::FactorQTZ factoredDynamics(kkt);
+	SimTK::Matrix solution;
+	factoredDynamics.solve(rhs, solution);
+	rUDots = solution.block(0, 0, nu, nc);
+}
+
+/**
+ * Append the induced accelerations that follow from the generalized
+ * accelerations udot of a contributor, at the zero velocity configuration
+ * of s_joint.
+ */
+void InducedAccelerations::appendAccelerationsFromUDot(const SimTK::State& s_joint,
+	const SimTK::Vector& udot)
+{
+	const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+
+	// Get Accelerations for kinematics of coordinates
+	for(int i=0;i<_coordSet.getSize();i++) {
+		const Coordinate &coord = _coordSet.get(i);
+		const SimTK::MobilizedBody &mobod = matter.getMobilizedBody(coord.getBodyIndex());
+		double acc = udot[mobod.getFirstUIndex(s_joint) + coord.getMobilizerQIndex()];
+
+		if(getInDegrees()) 
+			acc *= SimTK_RADIAN_TO_DEGREE;	
+		_coordIndAccs[i]->append(1, &acc);
+	}
+
+	if(_bodySet.getSize()==0 && !_includeCOM) return;
+
+	// With zero velocity, body accelerations follow from udot alone
+	SimTK::Vector_<SimTK::SpatialVec> A_GB;
+	matter.calcBodyAccelerationFromUDot(s_joint, udot, A_GB);
+
+	// VARIABLES
+	SimTK::Vec3 vec,angVec;
+
+	// Get Accelerations for kinematics of bodies
+	for(int i=0;i<_bodySet.getSize();i++) {
+		Body &body = _bodySet.get(i);
+		const SimTK::MobilizedBody &mobod = matter.getMobilizedBody(body.getIndex());
+		const SimTK::SpatialVec &A = A_GB[body.getIndex()];
+
+		// Acceleration of the mass center, expressed in ground
+		SimTK::Vec3 com = mobod.getBodyRotation(s_joint)*body.get_mass_center();
+		vec = A[1] + A[0] % com;
+		angVec = A[0];
+
+		// CONVERT TO DEGREES?
+		if(getInDegrees()) 
+			angVec *= SimTK_RADIAN_TO_DEGREE;	
+
+		// FILL KINEMATICS ARRAY
+		_bodyIndAccs[i]->append(3, &vec[0]);
+		_bodyIndAccs[i]->append(3, &angVec[0]);
+	}
+
+	// Get Accelerations for kinematics of COM
+	if(_includeCOM){
+		double mass = 0;
+		vec = SimTK::Vec3(0);
+		for(SimTK::MobilizedBodyIndex mbx(1); mbx<matter.getNumBodies(); ++mbx){
+			const SimTK::MobilizedBody &mobod = matter.getMobilizedBody(mbx);
+			const SimTK::SpatialVec &A = A_GB[mbx];
+			double m = mobod.getBodyMass(s_joint);
+			SimTK::Vec3 com = mobod.getBodyRotation(s_joint)*mobod.getBodyMassCenterStation(s_joint);
+			vec += m*(A[1] + A[0] % com);
+			mass += m;
+		}
+		vec /= mass;
+
+		// FILL KINEMATICS ARRAY
+		_comIndAccs.append(3, &vec[0]);
+	}
+}
+
 /**
  * This method is called at the beginning of an analysis so that any
  * necessary initializations may be performed.
@@ -104,6 +104,11 @@ protected:
 	PropertyBool _reportConstraintReactionsProp;
 	bool &_reportConstraintReactions;
 
+	/** Flag to factor the constrained dynamics once per time frame and solve
+	    for the accelerations induced by gravity and all actuators together. */
+	PropertyBool _solveContributorsJointlyProp;
+	bool &_solveContributorsJointly;
+
 	/** Storages for recording induced accelerations for specified coordinates and/or bodies. */
 	Array<Storage *> _storeInducedAccelerations;
 	Storage* _storeConstraintReactions;
@@ -188,6 +193,22 @@ public:
 	//-------------------------------------------------------------------------
 	virtual void setModel(Model &aModel);
 
+	/** Coordinates, or "all", for which the induced accelerations are
+	    recorded. */
+	const Array<std::string>& getCoordNames() const { return _coordNames; }
+	void setCoordNames(const Array<std::string>& aCoordNames) { _coordNames = aCoordNames; }
+	/** Bodies, "all" or center_of_mass, for which the induced accelerations
+	    are recorded. */
+	const Array<std::string>& getBodyNames() const { return _bodyNames; }
+	void setBodyNames(const Array<std::string>& aBodyNames) { _bodyNames = aBodyNames; }
+
+	/** Solve for the accelerations induced by gravity and the actuators
+	    together at each time frame, instead of realizing the model once
+	    for each of them. Does not apply when constraint reactions are
+	    reported. */
+	void setSolveContributorsJointly(bool aTrueFalse) { _solveContributorsJointly = aTrueFalse; }
+	bool getSolveContributorsJointly() const { return _solveContributorsJointly; }
+
 	//-------------------------------------------------------------------------
 	// INTEGRATION
 	//-------------------------------------------------------------------------
@@ -217,6 +238,8 @@ protected:
 	Array<std::string> constructColumnLabelsForCOM();
 	Array<std::string> constructColumnLabelsForConstraintReactions();
 	void setupStorage();
+	void solveContributorsJointly(const SimTK::State& s, SimTK::State& s_joint, SimTK::Matrix& rUDots);
+	void appendAccelerationsFromUDot(const SimTK::State& s_joint, const SimTK::Vector& udot);
 
 	Array<bool> applyConstraintsAccordingToExternalForces(SimTK::State &s);
 
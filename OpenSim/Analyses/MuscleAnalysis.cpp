@@ -33,6 +33,7 @@
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 #include <OpenSim/Simulation/Model/CoordinateSet.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
+#include <OpenSim/Actuators/MuscleCurveBatch.h>
 #include "MuscleAnalysis.h"
 
 using namespace OpenSim;
@@ -55,6 +56,8 @@ MuscleAnalysis::~MuscleAnalysis()
 {
 	// Individual storages where added to the Analysis' _storageList
 	// which takes ownerwhip of the Storage objects and deletes them.
+	delete _momentArmSolver;
+	delete _curveBatch;
 }
 //_____________________________________________________________________________
 /**
@@ -141,6 +144,9 @@ void MuscleAnalysis::setNull()
     _tendonPowerStore       =   NULL;
     _musclePowerStore       =   NULL;
 
+	_momentArmSolver = NULL;
+	_curveBatch = NULL;
+
 	// DEFAULT VALUES
 	_muscleListProp.getValueStrArray().setSize(1);
 	_muscleListProp.getValueStrArray().updElt(0) = "all";
@@ -211,6 +217,14 @@ void MuscleAnalysis::allocateStorageObjects()
 	_muscleArray.setMemoryOwner(false);
 	_muscleArray.setSize(0);
 
+	// The moment-arm solver holds a copy of the model's state, so it is
+	// recreated once the analysis is run on a (re)initialized model.
+	delete _momentArmSolver;
+	_momentArmSolver = NULL;
+	// The curve batch holds pointers to the active muscles.
+	delete _curveBatch;
+	_curveBatch = NULL;
+
 	// FOR MOMENT ARMS AND MOMEMTS
 	const CoordinateSet& qSet = _model->getCoordinateSet();
 	_coordinateList = _coordinateListProp.getValueStrArray();
@@ -535,6 +549,19 @@ int MuscleAnalysis::record(const SimTK::State& s)
 	bool forceWarning = false;
 	bool dynamicsWarning = false;
 
+	// Compute the length info of the muscles that support it in one pass.
+	// Muscles left out by an error are evaluated one at a time below.
+	if(_curveBatch) {
+		try{
+			_curveBatch->realizeMuscleLengthInfo(s);
+		}
+		catch (const std::exception& e) {
+			cout << "WARNING- MuscleAnalysis::record() unable to evaluate ";
+			cout << "muscle curves together at time " << s.getTime();
+			cout << " for reason: " << e.what() << endl;
+		}
+	}
+
 	for(int i=0; i<nm; ++i) {
 		try{
 			len[i] = _muscleArray[i]->getLength(s);
@@ -643,24 +670,33 @@ int MuscleAnalysis::record(const SimTK::State& s)
 	_musclePowerStore->append(tReal,muscPower.getSize(),&muscPower[0]);
 
 	if (_computeMoments){
-		// LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
-		Coordinate *q = NULL;
 		Storage *maStore=NULL, *mStore=NULL;
 		int nq = _momentArmStorageArray.getSize();
 		Array<double> ma(0.0,nm),m(0.0,nm);
 
+		// SOLVE FOR THE MOMENT ARMS OF ALL MUSCLES ABOUT ALL COORDINATES
+		Array<const Coordinate*> coords(NULL,nq);
+		Array<const GeometryPath*> paths(NULL,nm);
+		for(int i=0; i<nq; i++)
+			coords[i] = _momentArmStorageArray[i]->q;
+		for(int j=0; j<nm; j++)
+			paths[j] = &_muscleArray[j]->getGeometryPath();
+
+		_model->getMultibodySystem().realize(s, s.getSystemStage());
+		if(_momentArmSolver==NULL)
+			_momentArmSolver = new MomentArmSolver(*_model);
+		SimTK::Matrix momentArms;
+		_momentArmSolver->solve(s, coords, paths, momentArms);
+
+		// LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
 		for(int i=0; i<nq; i++) {
 
-			q = _momentArmStorageArray[i]->q;
 			maStore = _momentArmStorageArray[i]->momentArmStore;
 			mStore = _momentArmStorageArray[i]->momentStore;
-	       
-			bool locked = q->getLocked(s);
 
-			_model->getMultibodySystem().realize(s, s.getSystemStage());
 			// LOOP OVER MUSCLES
 			for(int j=0; j<nm; j++) {
-				ma[j] = _muscleArray[j]->computeMomentArm(s,*q);
+				ma[j] = momentArms(j,i);
 				m[j] = ma[j] * force[j];
 			}
 			maStore->append(s.getTime(),nm,&ma[0]);
@@ -690,6 +726,11 @@ int MuscleAnalysis::begin(SimTK::State& s )
 
 	allocateStorageObjects();
 
+	// BATCH THE CURVES OF THE ACTIVE MUSCLES
+	_curveBatch = new MuscleCurveBatch();
+	for(int i=0; i<_muscleArray.getSize(); ++i)
+		_curveBatch->addMuscle(*_muscleArray[i]);
+
 	// RESET STORAGE
 	Storage *store;
 	int size = _storageList.getSize();
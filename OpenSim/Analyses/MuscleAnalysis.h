@@ -32,6 +32,7 @@
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
 #include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Simulation/MomentArmSolver.h>
 
 
 #ifdef SWIG
@@ -45,6 +46,8 @@
 
 namespace OpenSim { 
 
+class MuscleCurveBatch;
+
 
 //=============================================================================
 //=============================================================================
@@ -141,6 +144,14 @@ private:
 	/** Array of active muscles. */
 	ArrayPtrs<Muscle> _muscleArray;
 
+	/** Solver for the moment-arms of all active muscles about all active
+	coordinates at once. */
+	MomentArmSolver *_momentArmSolver;
+
+	/** Batch that computes the length info of the active muscles in one
+	pass, built in begin(). */
+	MuscleCurveBatch *_curveBatch;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -209,6 +209,22 @@ void ProbeReporter::constructColumnLabels(const SimTK::State& s)
 }
 
 
+//_____________________________________________________________________________
+/**
+ * Allocate the row into which record() writes, sized for every Probe of the
+ * model so that the row fits whichever are enabled.
+ */
+void ProbeReporter::allocateRecordRow()
+{
+    const ProbeSet& probes = _model->getProbeSet();
+    int width = 0;
+    for(int i=0 ; i<probes.getSize() ; i++)
+        width += probes[i].getNumProbeInputs();
+    // Keep a buffer even for an empty row so the time is still appended.
+    _recordRow.setSize(width>0 ? width : 1);
+}
+
+
 //=============================================================================
 // DESTRUCTION METHODS
 //=============================================================================
@@ -235,25 +251,32 @@ int ProbeReporter::record(const SimTK::State& s)
     // MAKE SURE ALL ProbeReporter QUANTITIES ARE VALID
     _model->getMultibodySystem().realize(s, SimTK::Stage::Report );
 
-    StateVector nextRow = StateVector(s.getTime());
-
     // NUMBER OF Probes
     const ProbeSet& probes = _model->getProbeSet();
     int nP = probes.getSize();
 
+    // Probes may have been enabled since begin(); make sure the row fits.
+    int width = 0;
+    for(int i=0 ; i<nP ; i++) {
+        if (!probes[i].isDisabled()) width += probes[i].getNumProbeInputs();
+    }
+    if (width > _recordRow.getSize()) allocateRecordRow();
+
+    // WRITE THE VALUES OF THE ENABLED PROBES INTO THE ROW
+    double *values = _recordRow.get();
+    int n = 0;
     for(int i=0 ; i<nP ; i++) {
-        Probe& nextProbe = (Probe&)probes[i];
+        const Probe& nextProbe = probes[i];
 
         if (!nextProbe.isDisabled())
         {
             // Get probe values after the probe operation
-            SimTK::Vector values = nextProbe.getProbeOutputs(s);
-            for (int i=0; i<values.size(); i++)
-                nextRow.getData().append(values(i));
+            nextProbe.writeProbeOutputs(s, &values[n]);
+            n += nextProbe.getNumProbeInputs();
         }
     }
 
-    _probeStore.append(nextRow);
+    _probeStore.append(s.getTime(),n,values);
 
     return 0;
 }
@@ -281,6 +304,9 @@ begin(SimTK::State& s)
     constructColumnLabels(s);
     // RESET STORAGE
     _probeStore.reset(s.getTime());
+    // Rows of a fixed width are appended straight into the columnar buffers.
+    _probeStore.setColumnar(true);
+    allocateRecordRow();
 
     // RECORD
     int status = 0;
@@ -92,6 +92,8 @@ protected:
 
     /** Probe storage. */
     Storage _probeStore;
+    /** Row into which record() writes the values of a step. */
+    Array<double> _recordRow;
 
 //=============================================================================
 // METHODS
@@ -112,6 +114,7 @@ private:
     void constructColumnLabels(const SimTK::State& s);
     void allocateStorage();
     void deleteStorage();
+    void allocateRecordRow();
 
 public:
 
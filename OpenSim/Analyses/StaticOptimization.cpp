@@ -70,6 +70,8 @@ StaticOptimization::StaticOptimization(Model *aModel) :
 	_useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
 	_convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
 	_maximumIterations(_maximumIterationsProp.getValueInt()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_useWarmStart(_useWarmStartProp.getValueBool()),
 	_modelWorkingCopy(NULL),
 	_numCoordinateActuators(0)
 {
@@ -91,6 +93,8 @@ StaticOptimization::StaticOptimization(const StaticOptimization &aStaticOptimiza
 	_useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
 	_convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
 	_maximumIterations(_maximumIterationsProp.getValueInt()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_useWarmStart(_useWarmStartProp.getValueBool()),
 	_modelWorkingCopy(NULL),
 	_numCoordinateActuators(aStaticOptimization._numCoordinateActuators)
 {
@@ -123,6 +127,8 @@ operator=(const StaticOptimization &aStaticOptimization)
 	_activationExponent=aStaticOptimization._activationExponent;
 	_convergenceCriterion=aStaticOptimization._convergenceCriterion;
 	_maximumIterations=aStaticOptimization._maximumIterations;
+	_numThreads=aStaticOptimization._numThreads;
+	_useWarmStart=aStaticOptimization._useWarmStart;
 
 	_useMusclePhysiology=aStaticOptimization._useMusclePhysiology;
 	return(*this);
@@ -148,6 +154,8 @@ void StaticOptimization::setNull()
 	_numCoordinateActuators = 0;
 	_convergenceCriterion = 1e-4;
 	_maximumIterations = 100;
+	_numThreads = 1;
+	_useWarmStart = false;
 
 	setName("StaticOptimization");
 }
@@ -183,6 +191,22 @@ setupProperties()
 		"An integer for setting the maximum number of iterations the optimizer can use at each time.  ");
 	_maximumIterationsProp.setName("optimizer_max_iterations");
 	_propertySet.append(&_maximumIterationsProp);
+
+	_numThreadsProp.setComment(
+		"Number of threads used to solve the time frames. With 1 the frames are solved in sequence; "
+		"otherwise they are split into contiguous chunks solved in parallel, and threads left over "
+		"when there are fewer frames than threads compute the derivatives of each frame. "
+		"In parallel the first frame of each chunk starts from the default activations at the "
+		"beginning of the analysis and from zero, as do all frames unless use_warm_start is true. "
+		"0 uses all processors.");
+	_numThreadsProp.setName("number_of_threads");
+	_propertySet.append(&_numThreadsProp);
+
+	_useWarmStartProp.setComment(
+		"If true, the optimization at each time starts from the solution at the previous time "
+		"rather than from zero. When solving in parallel, the first time of each chunk starts from zero.");
+	_useWarmStartProp.setName("use_warm_start");
+	_propertySet.append(&_useWarmStartProp);
 }
 
 //=============================================================================
@@ -308,44 +332,53 @@ setStorageCapacityIncrements(int aIncrement)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Record the results.
+ * Solve the static optimization at one time frame.
+ *
+ * @param aModel Working copy of the model with which to solve.
+ * @param aForceSet Force set of aModel being solved for.
+ * @param aTime Time of the frame.
+ * @param aQ Generalized coordinates at the frame.
+ * @param aU Generalized speeds at the frame.
+ * @param aStatesSplineSet Splines of the states, used only by this call.
+ * @param rParameters Solved activations.  On input, the initial guess when
+ * warm starting.
+ * @param rForces Actuator forces for the solved activations.
+ * @param aOut Stream to which solver messages are written.
+ * @param aNumDerivativeThreads Number of threads over which the numerical
+ * derivatives of the constraints are computed.
  */
-int StaticOptimization::
-record(const SimTK::State& s)
+void StaticOptimization::
+solveFrame(Model &aModel, ForceSet &aForceSet, double aTime,
+	const SimTK::Vector &aQ, const SimTK::Vector &aU,
+	const GCVSplineSet &aStatesSplineSet,
+	SimTK::Vector &rParameters, SimTK::Vector &rForces, std::ostream &aOut,
+	int aNumDerivativeThreads) const
 {
-	if(!_modelWorkingCopy) return -1;
-
 	// Set model to whatever defaults have been updated to from the last iteration
-    SimTK::State& sWorkingCopy = _modelWorkingCopy->updWorkingState();
-	sWorkingCopy.setTime(s.getTime());
-	_modelWorkingCopy->initStateWithoutRecreatingSystem(sWorkingCopy); 
+    SimTK::State& sWorkingCopy = aModel.updWorkingState();
+	sWorkingCopy.setTime(aTime);
+	aModel.initStateWithoutRecreatingSystem(sWorkingCopy); 
 
 	// update Q's and U's
-	sWorkingCopy.setQ(s.getQ());
-	sWorkingCopy.setU(s.getU());
+	sWorkingCopy.setQ(aQ);
+	sWorkingCopy.setU(aU);
 
-	_modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
-	//_modelWorkingCopy->equilibrateMuscles(sWorkingCopy);
+	aModel.getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
+	//aModel.equilibrateMuscles(sWorkingCopy);
 
-    const Set<Actuator>& fs = _modelWorkingCopy->getActuators();
+    const Set<Actuator>& fs = aModel.getActuators();
 
 	int na = fs.getSize();
 	int nacc = _accelerationIndices.getSize();
 
-	// IPOPT
-	_numericalDerivativeStepSize = 0.0001;
-	_optimizerAlgorithm = "ipopt";
-	_printLevel = 0;
-	//_optimizationConvergenceTolerance = 1e-004;
-	//_maxIterations = 2000;
-
 	// Optimization target
-	_modelWorkingCopy->setAllControllersEnabled(false);
-	StaticOptimizationTarget target(sWorkingCopy,_modelWorkingCopy,na,nacc,_useMusclePhysiology);
+	aModel.setAllControllersEnabled(false);
+	StaticOptimizationTarget target(sWorkingCopy,&aModel,na,nacc,_useMusclePhysiology);
 	target.setStatesStore(_statesStore);
-	target.setStatesSplineSet(_statesSplineSet);
+	target.setStatesSplineSet(aStatesSplineSet);
 	target.setActivationExponent(_activationExponent);
 	target.setDX(_numericalDerivativeStepSize);
+	target.setNumThreads(aNumDerivativeThreads);
 
 	// Pick optimizer algorithm
 	SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
@@ -355,11 +388,11 @@ record(const SimTK::State& s)
 	SimTK::Optimizer *optimizer = new SimTK::Optimizer(target, algorithm);
 
 	// Optimizer options
-	//cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
+	//aOut<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
 	optimizer->setDiagnosticsLevel(_printLevel);
-	//cout<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
+	//aOut<<"Setting optimizer convergence criterion to "<<_convergenceCriterion<<".\n";
 	optimizer->setConvergenceTolerance(_convergenceCriterion);
-	//cout<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
+	//aOut<<"Setting optimizer maximum iterations to "<<_maximumIterations<<".\n";
 	optimizer->setMaxIterations(_maximumIterations);
 	optimizer->useNumericalGradient(false);
 	optimizer->useNumericalJacobian(false);
@@ -382,11 +415,12 @@ record(const SimTK::State& s)
 	
 	target.setParameterLimits(lowerBounds, upperBounds);
 
-	_parameters = 0; // Set initial guess to zeros
+	// Set initial guess to zeros unless warm starting from the last solution
+	if(!_useWarmStart) rParameters = 0;
 
 	// Static optimization
-	_modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
-	target.prepareToOptimize(sWorkingCopy, &_parameters[0]);
+	aModel.getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
+	target.prepareToOptimize(sWorkingCopy, &rParameters[0]);
 
 	//LARGE_INTEGER start;
 	//LARGE_INTEGER stop;
@@ -397,24 +431,24 @@ record(const SimTK::State& s)
 
 	try {
 		target.setCurrentState( &sWorkingCopy );
-		optimizer->optimize(_parameters);
+		optimizer->optimize(rParameters);
 	}
 	catch (const SimTK::Exception::Base& ex) {
-		cout << ex.getMessage() << endl;
-		cout << "OPTIMIZATION FAILED..." << endl;
-		cout << endl;
-		cout << "StaticOptimization.record:  WARN- The optimizer could not find a solution at time = " << s.getTime() << endl;
-		cout << endl;
+		aOut << ex.getMessage() << endl;
+		aOut << "OPTIMIZATION FAILED..." << endl;
+		aOut << endl;
+		aOut << "StaticOptimization.record:  WARN- The optimizer could not find a solution at time = " << aTime << endl;
+		aOut << endl;
 
 		double tolBounds = 1e-1;
 		bool weakModel = false;
 		string msgWeak = "The model appears too weak for static optimization.\nTry increasing the strength and/or range of the following force(s):\n";
 		for(int a=0;a<na;a++) {
-			Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(a));
+			Actuator* act = dynamic_cast<Actuator*>(&aForceSet.get(a));
             if( act ) {
-			    Muscle*  mus = dynamic_cast<Muscle*>(&_forceSet->get(a));
+			    Muscle*  mus = dynamic_cast<Muscle*>(&aForceSet.get(a));
  			    if(mus==NULL) {
-			    	if(_parameters(a) < (lowerBounds(a)+tolBounds)) {
+			    	if(rParameters(a) < (lowerBounds(a)+tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += act->getName();
 			    		msgWeak += " approaching lower bound of ";
@@ -423,7 +457,7 @@ record(const SimTK::State& s)
 			    		msgWeak += oLower.str();
 			    		msgWeak += "\n";
 			    		weakModel = true;
-			    	} else if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+			    	} else if(rParameters(a) > (upperBounds(a)-tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += act->getName();
 			    		msgWeak += " approaching upper bound of ";
@@ -434,7 +468,7 @@ record(const SimTK::State& s)
 			    		weakModel = true;
 			    	} 
 			    } else {
-			    	if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+			    	if(rParameters(a) > (upperBounds(a)-tolBounds)) {
 			    		msgWeak += "   ";
 			    		msgWeak += mus->getName();
 			    		msgWeak += " approaching upper bound of ";
@@ -447,15 +481,15 @@ record(const SimTK::State& s)
 			    }
             }
 		}
-		if(weakModel) cout << msgWeak << endl;
+		if(weakModel) aOut << msgWeak << endl;
 
 		if(!weakModel) {
 			double tolConstraints = 1e-6;
 			bool incompleteModel = false;
 			string msgIncomplete = "The model appears unsuitable for static optimization.\nTry appending the model with additional force(s) or locking joint(s) to reduce the following acceleration constraint violation(s):\n";
 			SimTK::Vector constraints;
-			target.constraintFunc(_parameters,true,constraints);
-			const CoordinateSet& coordSet = _modelWorkingCopy->getCoordinateSet();
+			target.constraintFunc(rParameters,true,constraints);
+			const CoordinateSet& coordSet = aModel.getCoordinateSet();
 			for(int acc=0;acc<nacc;acc++) {
 				if(fabs(constraints(acc)) > tolConstraints) {
 					const Coordinate& coord = coordSet.get(_accelerationIndices[acc]);
@@ -469,38 +503,219 @@ record(const SimTK::State& s)
 					incompleteModel = true;
 				}
 			}
-			if(incompleteModel) cout << msgIncomplete << endl;
+			if(incompleteModel) aOut << msgIncomplete << endl;
 		}
 	}
 
 	//QueryPerformanceCounter(&stop);
 	//double duration = (double)(stop.QuadPart-start.QuadPart)/(double)frequency.QuadPart;
-	//cout << "optimizer time = " << (duration*1.0e3) << " milliseconds" << endl;
+	//aOut << "optimizer time = " << (duration*1.0e3) << " milliseconds" << endl;
 
-	target.printPerformance(sWorkingCopy, &_parameters[0]);
+	target.printPerformance(sWorkingCopy, &rParameters[0], aOut);
 
 	//update defaults for use in the next step
 
-	const Set<Actuator>& actuators = _modelWorkingCopy->getActuators();
+	const Set<Actuator>& actuators = aModel.getActuators();
 	for(int k=0; k < actuators.getSize(); ++k){
 		ActivationFiberLengthMuscle *mus = dynamic_cast<ActivationFiberLengthMuscle*>(&actuators[k]);
 		if(mus){
-			mus->setDefaultActivation(_parameters[k]);
+			mus->setDefaultActivation(rParameters[k]);
 			// Don't send up red flags when the def
 			mus->setObjectIsUpToDateWithProperties();
 		}
 	}
 
-	_activationStorage->append(sWorkingCopy.getTime(),na,&_parameters[0]);
+	target.getActuation(sWorkingCopy, rParameters, rForces);
+
+	delete optimizer;
+}
+//_____________________________________________________________________________
+/**
+ * Record the results.
+ */
+int StaticOptimization::
+record(const SimTK::State& s)
+{
+	if(!_modelWorkingCopy) return -1;
+
+	// IPOPT
+	_numericalDerivativeStepSize = 0.0001;
+	_optimizerAlgorithm = "ipopt";
+	_printLevel = 0;
+	//_optimizationConvergenceTolerance = 1e-004;
+	//_maxIterations = 2000;
+
+	// Solve the recorded frames together in parallel at the end
+	if(_numThreads!=1) {
+		_frameTimes.append(s.getTime());
+		_frameQs.push_back(s.getQ());
+		_frameUs.push_back(s.getU());
+		return 0;
+	}
 
+	int na = _modelWorkingCopy->getActuators().getSize();
 	SimTK::Vector forces(na);
-	target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), _parameters,forces);
+	solveFrame(*_modelWorkingCopy,*_forceSet,s.getTime(),s.getQ(),s.getU(),
+		_statesSplineSet,_parameters,forces,cout);
 
-	_forceStorage->append(sWorkingCopy.getTime(),na,&forces[0]);
+	_activationStorage->append(s.getTime(),na,&_parameters[0]);
+	_forceStorage->append(s.getTime(),na,&forces[0]);
 
 	return 0;
 }
 //_____________________________________________________________________________
+/**
+ * Solves one contiguous chunk of the recorded frames per thread, each with
+ * its own working copy of the model and of the state splines.  The first
+ * frame of a chunk starts from the default activations at begin() and from
+ * a zero initial guess.  When warm starting, the later frames of the chunk
+ * start from the solution of the frame before, as in serial solving;
+ * otherwise they start like the first.
+ */
+class StaticOptimization::SolveFramesTask : 
+	public SimTK::ParallelExecutor::Task {
+public:
+	SolveFramesTask(const StaticOptimization &aAnalysis,
+		const std::vector<Model*> &aModels,
+		const std::vector<GCVSplineSet> &aSplineSets,
+		const SimTK::Vector &aDefaultActivations, int aNumDerivativeThreads,
+		std::vector<double> &rActivations, std::vector<double> &rForces,
+		std::vector<std::string> &rMessages, std::vector<std::string> &rErrors) :
+		_analysis(aAnalysis),_models(aModels),_splineSets(aSplineSets),
+		_defaultActivations(aDefaultActivations),
+		_na(aDefaultActivations.size()),
+		_numDerivativeThreads(aNumDerivativeThreads),
+		_activations(rActivations),_forces(rForces),
+		_messages(rMessages),_errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int nf = _analysis._frameTimes.getSize();
+		int numChunks = (int)_models.size();
+		int first = (int)(((long long)nf*aChunk)/numChunks);
+		int last = (int)(((long long)nf*(aChunk+1))/numChunks);
+		Model &model = *_models[aChunk];
+		const Set<Actuator>& actuators = model.getActuators();
+		SimTK::Vector parameters(_na), forces(_na);
+		try {
+			for(int f=first;f<last;f++) {
+				// Start cold, undoing the defaults and guess left by the
+				// previous frame, unless warm starting from it
+				if(f==first || !_analysis._useWarmStart) {
+					for(int k=0;k<_na;k++) {
+						ActivationFiberLengthMuscle *mus =
+							dynamic_cast<ActivationFiberLengthMuscle*>(&actuators[k]);
+						if(mus) {
+							mus->setDefaultActivation(_defaultActivations[k]);
+							mus->setObjectIsUpToDateWithProperties();
+						}
+					}
+					parameters = 0;
+				}
+				std::ostringstream out;
+				_analysis.solveFrame(model,model.updForceSet(),
+					_analysis._frameTimes[f],_analysis._frameQs[f],
+					_analysis._frameUs[f],_splineSets[aChunk],parameters,forces,
+					out,_numDerivativeThreads);
+				_messages[f] = out.str();
+				for(int i=0;i<_na;i++) {
+					_activations[(size_t)f*_na+i] = parameters[i];
+					_forces[(size_t)f*_na+i] = forces[i];
+				}
+			}
+		} catch(const std::exception &x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	const StaticOptimization &_analysis;
+	const std::vector<Model*> &_models;
+	const std::vector<GCVSplineSet> &_splineSets;
+	const SimTK::Vector &_defaultActivations;
+	int _na;
+	int _numDerivativeThreads;
+	std::vector<double> &_activations;
+	std::vector<double> &_forces;
+	std::vector<std::string> &_messages;
+	std::vector<std::string> &_errors;
+};
+//_____________________________________________________________________________
+/**
+ * Solve the frames recorded during the analysis in parallel, and append the
+ * results to the activation and force storages in time order.
+ */
+void StaticOptimization::
+solveRecordedFrames()
+{
+	int nf = _frameTimes.getSize();
+	if(nf<=0 || !_modelWorkingCopy) return;
+
+	int numThreads = _numThreads;
+	if(numThreads<=0) numThreads = SimTK::ParallelExecutor::getNumProcessors();
+	int numChunks = numThreads>nf ? nf : numThreads;
+	// Threads left over when there are fewer frames than threads compute the
+	// numerical derivatives of each frame in parallel.
+	int numDerivativeThreads = numThreads/numChunks;
+
+	// Default activations of the working copy, from which each chunk starts
+	const Set<Actuator>& actuators = _modelWorkingCopy->getActuators();
+	int na = actuators.getSize();
+	SimTK::Vector defaultActivations(na,0.0);
+	for(int k=0;k<na;k++) {
+		const ActivationFiberLengthMuscle *mus =
+			dynamic_cast<const ActivationFiberLengthMuscle*>(&actuators[k]);
+		if(mus) defaultActivations[k] = mus->getDefaultActivation();
+	}
+
+	// Give each chunk its own copy of the state splines and its own working
+	// copy of the model with the actuator forces overridden, as set up in
+	// begin().  The copies are made here, before any thread starts.
+	std::vector<GCVSplineSet> splineSets(numChunks,_statesSplineSet);
+	std::vector<Model*> models(numChunks,(Model*)NULL);
+	for(int c=0;c<numChunks;c++) {
+		models[c] = _modelWorkingCopy->clone();
+		SimTK::State& sWorkingCopy = models[c]->initSystem();
+		ForceSet& fs = models[c]->updForceSet();
+		for(int i=0;i<fs.getSize();i++) {
+			Actuator* act = dynamic_cast<Actuator*>(&fs.get(i));
+			if(act) act->overrideForce(sWorkingCopy,true);
+		}
+	}
+
+	std::vector<double> activations((size_t)nf*na), forces((size_t)nf*na);
+	std::vector<std::string> messages(nf), errors(numChunks);
+	SolveFramesTask task(*this,models,splineSets,defaultActivations,
+		numDerivativeThreads,activations,forces,messages,errors);
+	if(numChunks>1) {
+		SimTK::ParallelExecutor executor(numChunks);
+		executor.execute(task,numChunks);
+	} else {
+		task.execute(0);
+	}
+
+	for(int c=0;c<numChunks;c++) delete models[c];
+
+	std::string error;
+	for(int c=0;c<numChunks && error.empty();c++) error = errors[c];
+
+	// APPEND IN TIME ORDER
+	if(error.empty()) {
+		for(int f=0;f<nf;f++) {
+			cout << messages[f];
+			_activationStorage->append(_frameTimes[f],na,&activations[(size_t)f*na]);
+			_forceStorage->append(_frameTimes[f],na,&forces[(size_t)f*na]);
+		}
+	}
+
+	_frameTimes.setSize(0);
+	_frameQs.clear();
+	_frameUs.clear();
+
+	if(!error.empty())
+		throw Exception("StaticOptimization: ERROR- "+error,__FILE__,__LINE__);
+}
+//_____________________________________________________________________________
 /**
  * This method is called at the beginning of an analysis so that any
  * necessary initializations may be performed.
@@ -589,6 +804,10 @@ begin(SimTK::State& s )
 
 	_statesSplineSet=GCVSplineSet(5,_statesStore);
 
+	_frameTimes.setSize(0);
+	_frameQs.clear();
+	_frameUs.clear();
+
 	// DESCRIPTION AND LABELS
 	constructDescription();
 	constructColumnLabels();
@@ -652,6 +871,8 @@ end( SimTK::State& s )
 
 	record(s);
 
+	if(_numThreads!=1) solveRecordedFrames();
+
 	return(0);
 }
 
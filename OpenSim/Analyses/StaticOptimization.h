@@ -27,6 +27,8 @@
 //=============================================================================
 // INCLUDES
 //=============================================================================
+#include <iostream>
+#include <vector>
 #include "osimAnalysesDLL.h"
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
@@ -76,6 +78,19 @@ protected:
 	PropertyInt _maximumIterationsProp;
 	int &_maximumIterations;
 
+	/** Number of threads over which the time frames are solved. With 1 the
+	frames are solved in sequence as they are recorded; otherwise they are
+	solved at the end of the analysis in contiguous chunks, one per thread.
+	Zero or less uses one thread per processor. */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
+	/** Start the optimization of each frame from the solution of the 
+	previous frame, instead of from zero.  When frames are solved in
+	parallel, the first frame of each chunk starts from zero. */
+	PropertyBool _useWarmStartProp;
+	bool &_useWarmStart;
+
 	Storage *_activationStorage;
 	Storage *_forceStorage;
 	GCVSplineSet _statesSplineSet;
@@ -95,6 +110,13 @@ protected:
 
 	Model *_modelWorkingCopy;
 
+	// Frames recorded to be solved in parallel at the end of the analysis
+	Array<double> _frameTimes;
+	std::vector<SimTK::Vector> _frameQs;
+	std::vector<SimTK::Vector> _frameUs;
+
+	class SolveFramesTask;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -116,6 +138,12 @@ private:
 	void constructColumnLabels();
 	void allocateStorage();
 	void deleteStorage();
+	void solveFrame(Model &aModel, ForceSet &aForceSet, double aTime,
+		const SimTK::Vector &aQ, const SimTK::Vector &aU,
+		const GCVSplineSet &aStatesSplineSet,
+		SimTK::Vector &rParameters, SimTK::Vector &rForces,
+		std::ostream &aOut, int aNumDerivativeThreads=1) const;
+	void solveRecordedFrames();
 
 public:
 	//--------------------------------------------------------------------------
@@ -137,6 +165,10 @@ public:
 	double getConvergenceCriterion() { return _convergenceCriterion; }
 	void setMaxIterations( const int maxIt) { _maximumIterations = maxIt; }
 	int getMaxIterations() {return _maximumIterations; }
+	void setNumThreads(const int aNumThreads) { _numThreads = aNumThreads; }
+	int getNumThreads() const { return _numThreads; }
+	void setUseWarmStart(const bool useIt) { _useWarmStart = useIt; }
+	bool getUseWarmStart() const { return _useWarmStart; }
 	//--------------------------------------------------------------------------
 	// ANALYSIS
 	//--------------------------------------------------------------------------
@@ -35,6 +35,7 @@
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+#include <OpenSim/Common/OptimizationTarget.h>
 #include "StaticOptimizationTarget.h"
 #include <iostream>
 
@@ -48,6 +49,35 @@ using SimTK::Real;
 
 const double StaticOptimizationTarget::SMALLDX = 1.0e-14;
 //const double StaticOptimizationTarget::_activationExponent = 2.0;
+
+//______________________________________________________________________________
+/**
+ * The constraints as a function of the parameters applied to a state.  The
+ * target accelerations are evaluated once up front, so that the
+ * perturbations of the parameters can be evaluated in parallel.
+ */
+class StaticOptimizationTarget::ConstraintFunction :
+	public OpenSim::OptimizationTarget::StateFunction {
+public:
+	ConstraintFunction(const StaticOptimizationTarget &aTarget,
+		const SimTK::State &s) :
+		_target(aTarget), _targetAcceleration(aTarget.getNumConstraints())
+	{
+		_target.computeTargetAcceleration(s, _targetAcceleration);
+	}
+
+	int evaluate(SimTK::State &s, const Vector &parameters, Vector &constraints) const {
+		Vector actualAcceleration(_target.getNumConstraints());
+		_target.computeAcceleration(s, parameters, actualAcceleration);
+		for(int i=0; i<_target.getNumConstraints(); i++)
+			constraints[i] = _targetAcceleration[i] - actualAcceleration[i];
+		return(0);
+	}
+
+private:
+	const StaticOptimizationTarget &_target;
+	Vector _targetAcceleration;
+};
  
 //==============================================================================
 // CONSTRUCTOR
@@ -72,6 +102,7 @@ StaticOptimizationTarget(const SimTK::State& s, Model *aModel,int aNP,int aNC, b
 	_recipOptForceSquared.setSize(aNP);
 	_optimalForce.setSize(aNP);
 	_useMusclePhysiology=useMusclePhysiology;
+	_numThreads = 1;
 
 	setModel(*aModel);
 	setNumParams(aNP);
@@ -136,11 +167,26 @@ prepareToOptimize(SimTK::State& s, double *x)
 	pVector = 0;
 	computeConstraintVector(s, pVector,_constraintVector);
 
-	for(int p=0; p<np; p++) {
-		pVector[p] = 1;
-		computeConstraintVector(s, pVector, cVector);
-		for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-		pVector[p] = 0;
+	if(_numThreads==1) {
+		for(int p=0; p<np; p++) {
+			pVector[p] = 1;
+			computeConstraintVector(s, pVector, cVector);
+			for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
+			pVector[p] = 0;
+		}
+	} else {
+		// Unit forward differences give the same columns, with the
+		// parameters spread over threads. Each thread realizes its own copy
+		// of the state, which the model supports (see Model).
+		ConstraintFunction constraints(*this, s);
+		Array<double> dp(1.0,np);
+		int status = OptimizationTarget::ParallelForwardDifferences(
+			constraints, s, &dp[0], pVector, _constraintVector,
+			_constraintMatrix, _numThreads);
+		if(status<0)
+			throw Exception("StaticOptimizationTarget.prepareToOptimize: "
+				"ERROR- failed to compute the constraint matrix.",
+				__FILE__, __LINE__);
 	}
 #endif
 
@@ -316,15 +362,15 @@ validatePerturbationSize(double &aSize)
 /**
  */
 void StaticOptimizationTarget::
-printPerformance(const SimTK::State& s, double *parameters)
+printPerformance(const SimTK::State& s, double *parameters, std::ostream &aOut)
 {
 	double p;
 	setCurrentState( &s );
 	objectiveFunc(SimTK::Vector(getNumParameters(),parameters,true),true,p);
 	SimTK::Vector constraints(getNumConstraints());
 	constraintFunc(SimTK::Vector(getNumParameters(),parameters,true),true,constraints);
-	cout << endl;
-	cout << "time = " << s.getTime() <<" Performance =" << p << 
+	aOut << endl;
+	aOut << "time = " << s.getTime() <<" Performance =" << p << 
 	" Constraint violation = " << sqrt(~constraints*constraints) << endl;
 }
 
@@ -592,13 +638,11 @@ computeConstraintVector(SimTK::State& s, const Vector &parameters,Vector &constr
 	computeAcceleration(s, parameters, actualAcceleration);
 
 	// CONSTRAINTS
+	Vector targetAcceleration(getNumConstraints());
+	computeTargetAcceleration(s, targetAcceleration);
 	for(int i=0; i<getNumConstraints(); i++) {
-		Coordinate& coord = _model->getCoordinateSet().get(_accelerationIndices[i]);
-		Function& presribedFunc = _statesSplineSet.get(_statesStore->getStateIndex(coord.getSpeedName(),0));
-		std::vector<int> derivComponents(1,0); //take first derivative
-		double targetAcceleration = presribedFunc.calcDerivative(derivComponents,SimTK::Vector(1,s.getTime()));
-		//std::cout << "computeConstraintVector:" << targetAcceleration << " - " <<  actualAcceleration[i] << endl;
-		constraints[i] = targetAcceleration - actualAcceleration[i];
+		//std::cout << "computeConstraintVector:" << targetAcceleration[i] << " - " <<  actualAcceleration[i] << endl;
+		constraints[i] = targetAcceleration[i] - actualAcceleration[i];
 	}
 
 	//QueryPerformanceCounter(&stop);
@@ -649,6 +693,21 @@ constraintJacobian(const SimTK::Vector &parameters, const bool new_parameters, S
 //=============================================================================
 // ACCELERATION
 //=============================================================================
+//______________________________________________________________________________
+/**
+ * Compute the accelerations of the unconstrained coordinates prescribed by
+ * the states splines at the time of the state.
+ */
+void StaticOptimizationTarget::
+computeTargetAcceleration(const SimTK::State& s, SimTK::Vector &rAccel) const
+{
+	for(int i=0; i<getNumConstraints(); i++) {
+		Coordinate& coord = _model->getCoordinateSet().get(_accelerationIndices[i]);
+		Function& presribedFunc = _statesSplineSet.get(_statesStore->getStateIndex(coord.getSpeedName(),0));
+		std::vector<int> derivComponents(1,0); //take first derivative
+		rAccel[i] = presribedFunc.calcDerivative(derivComponents,SimTK::Vector(1,s.getTime()));
+	}
+}
 //
 void StaticOptimizationTarget::
 computeAcceleration(SimTK::State& s, const SimTK::Vector &parameters,SimTK::Vector &rAccel) const
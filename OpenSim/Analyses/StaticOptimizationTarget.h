@@ -26,6 +26,7 @@
 //=============================================================================
 // INCLUDES
 //=============================================================================
+#include <iostream>
 #include "osimAnalysesDLL.h"
 #include "OpenSim/Common/Array.h"
 #include <OpenSim/Common/GCVSplineSet.h>
@@ -74,6 +75,9 @@ protected:
 	bool   _useMusclePhysiology;
 	/** Perturbation size for computing numerical derivatives. */
 	Array<double> _dx;
+	/** Number of threads over which the perturbations of numerical
+	derivatives are spread. */
+	int _numThreads;
 	Array<int> _accelerationIndices;
 
 //=============================================================================
@@ -92,6 +96,8 @@ public:
 	void setDX(int aIndex,double aVal);
 	double getDX(int aIndex);
 	double* getDXArray();
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+	int getNumThreads() const { return _numThreads; }
 	void getActuation(SimTK::State& s, const SimTK::Vector &parameters, SimTK::Vector &forces);
 	void setActivationExponent(double aActivationExponent) { _activationExponent=aActivationExponent; }
 	double getActivationExponent() const { return _activationExponent; }
@@ -101,7 +107,8 @@ public:
 	// UTILITY
 	void validatePerturbationSize(double &aSize);
 
-	virtual void printPerformance(const SimTK::State& s, double *x);
+	virtual void printPerformance(const SimTK::State& s, double *x,
+		std::ostream &aOut=std::cout);
 
 	void computeActuatorAreas(const SimTK::State& s);
 
@@ -123,8 +130,10 @@ public:
 	int constraintJacobian(const SimTK::Vector &x, bool new_coefficients, SimTK::Matrix &jac) const;
 
 private:
+	class ConstraintFunction;
 	void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
 	void computeAcceleration(SimTK::State& s, const SimTK::Vector &aF,SimTK::Vector &rAccel) const;
+	void computeTargetAcceleration(const SimTK::State& s, SimTK::Vector &rAccel) const;
 	void cumulativeTime(double &aTime, double aIncrement);
 };
 
@@ -31,6 +31,7 @@
 #include "osimCommonDLL.h"
 #include <iostream>
 #include "Exception.h"
+#include "NameIndex.h"
 
 
 //=============================================================================
@@ -78,6 +79,22 @@ protected:
 	int _capacityIncrement;
 	/** Array of pointers to objects of type T. */
 	T **_array;
+	/** Index of the objects by name, built at the first lookup by name once
+	the array holds NameIndex::MIN_SIZE or more objects. */
+	NameIndex _nameIndex;
+
+private:
+	/** The names of the objects of an array, as seen by its name index. */
+	class ObjectNames : public NameIndex::Names {
+	public:
+		explicit ObjectNames(const ArrayPtrs<T> &aArray) : _arrayPtrs(aArray) {}
+		int getSize() const { return(_arrayPtrs._size); }
+		const std::string& getName(int aIndex) const {
+			return(_arrayPtrs._array[aIndex]->getName());
+		}
+	private:
+		const ArrayPtrs<T> &_arrayPtrs;
+	};
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // METHODS
@@ -166,6 +183,7 @@ void clearAndDestroy()
 	}
 
 	_size = 0;
+	_nameIndex.invalidate();
 }
 
 
@@ -207,6 +225,8 @@ ArrayPtrs<T>& operator=(const ArrayPtrs<T> &aArray)
 		if(aArray._array[i]!=NULL)  _array[i] = aArray._array[i]->clone();
 	}
 
+	_nameIndex.invalidate();
+
 	// TAKE OWNERSHIP OF MEMORY
 	_memoryOwner = true;
 
@@ -524,6 +544,7 @@ bool setSize(int aSize)
 			}
 		}
 		_size = aSize;
+		_nameIndex.invalidate();
 	}
 
 	return(true);
@@ -584,12 +605,17 @@ int getIndex(const T *aObject,int aStartIndex=0) const
  * its beginning.
  * @return Index of the object named aName.  If no such object exists in
  * the array, -1 is returned.
+ * @see NameIndex
  */
 int getIndex(const std::string &aName,int aStartIndex=0) const
 {
 	if(aStartIndex<0) aStartIndex=0;
 	if(aStartIndex>=getSize()) aStartIndex=0;
 
+	// HASHED SEARCH
+	if(_size>=NameIndex::MIN_SIZE && NameIndex::getEnabled())
+		return(_nameIndex.find(ObjectNames(*this),aName,aStartIndex));
+
 	// SEARCH STARTING FROM aStartIndex
 	int i;
 	for(i=aStartIndex;i<getSize();i++) {
@@ -634,6 +660,7 @@ bool append(T *aObject)
 	// SET
 	_array[_size] = aObject;
 	_size++;
+	_nameIndex.appended(ObjectNames(*this),_size-1);
 
 	return(true);
 }
@@ -714,6 +741,7 @@ bool insert(int aIndex,T *aObject)
 	// SET
 	_array[aIndex] = aObject;
 	_size++;
+	_nameIndex.invalidate();
 
 	return(true);
 }
@@ -754,6 +782,7 @@ bool remove(int aIndex)
 		_array[i] = _array[i+1];
 	}
 	_array[_size] = NULL;
+	_nameIndex.invalidate();
 
 	return(true);
 }
@@ -810,6 +839,7 @@ bool set(int aIndex,T *aObject)
 	// SET
 	if(getMemoryOwner() && (_array[aIndex]!=NULL)) delete _array[aIndex];
 	_array[aIndex] = aObject;
+	_nameIndex.invalidate();
 
 	return(true);
 }
@@ -692,6 +692,20 @@ void Component::
 SimTK::Vector Component::
 	getStateVariableValues(const SimTK::State& state) const
 {
+	// Gather the values using the table built at initialization
+	if(hasStateVariableTableFor(state)){
+		int nsv = (int)_stateVariableTable.size();
+		const Vector& y = state.getY();
+		Vector stateVariableValues(nsv);
+		for(int i=0; i<nsv; ++i){
+			const SimTK::SystemYIndex& yix =
+				_stateVariableTable[i]->getSystemYIndex();
+			stateVariableValues[i] = yix.isValid() ? y[yix]
+				: _stateVariableTable[i]->getValue(state);
+		}
+		return stateVariableValues;
+	}
+
 	int nsv = getNumStateVariables();
 	Array<std::string> names = getStateVariableNames();
 
@@ -717,6 +731,16 @@ void Component::
 	int nsv = getNumStateVariables();
 	SimTK_ASSERT(values.size() == nsv, 
 		"Component::setStateVariableValues() number values does not match number of state variables."); 
+
+	// Set each variable through its StateVariable so that any side effects
+	// of setting it (e.g. clamping a Coordinate) are preserved.
+	if(hasStateVariableTableFor(state)){
+		for(int i=0; i<nsv; ++i){
+			_stateVariableTable[i]->setValue(state, values[i]);
+		}
+		return;
+	}
+
 	Array<std::string> names = getStateVariableNames();
 
 	Vector stateVariableValues(nsv, SimTK::NaN);
@@ -911,6 +935,68 @@ getCacheVariableIndex(const std::string& name) const
     return it->second.index;
 }
 
+void Component::throwInvalidCacheVariableHandle() const
+{
+    std::stringstream msg;
+    msg << "Component::getCacheEntryIndex: ERR- cache variable handle is not "
+        << "valid or its cache variable has not been allocated.\n "
+        << "for component '"<< getName() << "' of type " 
+        << getConcreteClassName();
+    throw Exception(msg.str(),__FILE__,__LINE__);
+}
+
+/* Build the flat table of state variables used for getting and setting the
+ * values of all state variables at once.
+ *
+ * param state   a State realized to at least Stage::Model */
+void Component::
+buildStateVariableTable(const SimTK::State& state) const
+{
+	_stateVariableTable.clear();
+	appendStateVariables(_stateVariableTable);
+
+	// Record where each state variable lives in the System's Y vector
+	for(unsigned int i = 0; i < _stateVariableTable.size(); ++i){
+		_stateVariableTable[i]->setSystemYIndex(
+			_stateVariableTable[i]->computeSystemYIndex(state));
+	}
+
+	_stateVariableTableNQ = state.getNQ();
+	_stateVariableTableNU = state.getNU();
+	_stateVariableTableNZ = state.getNZ();
+}
+
+// Append the state variables of this Component and then those of its
+// subcomponents, in the order of getStateVariableNames().
+void Component::
+appendStateVariables(SimTK::Array_<StateVariable*>& rStateVariables) const
+{
+	unsigned int first = rStateVariables.size();
+	rStateVariables.resize(first + _namedStateVariableInfo.size());
+	std::map<std::string, StateVariableInfo>::const_iterator it;
+	for(it = _namedStateVariableInfo.begin(); 
+		it != _namedStateVariableInfo.end(); ++it){
+		rStateVariables[first + it->second.order] = it->second.stateVariable.get();
+	}
+
+	for(unsigned int i = 0; i < _components.size(); ++i){
+		_components[i]->appendStateVariables(rStateVariables);
+	}
+}
+
+// Whether the state variable table can be used to access the given State,
+// i.e. it has been built and the State's layout matches the one it was
+// built for.
+bool Component::
+hasStateVariableTableFor(const SimTK::State& state) const
+{
+	return !_stateVariableTable.empty() &&
+		state.getSystemStage() >= SimTK::Stage::Model &&
+		state.getNQ() == _stateVariableTableNQ &&
+		state.getNU() == _stateVariableTableNU &&
+		state.getNZ() == _stateVariableTableNZ;
+}
+
 Array<std::string> Component::
 getStateVariablesNamesAddedByComponent() const
 {
@@ -990,12 +1076,15 @@ void Component::realizeTopology(SimTK::State& s) const
 
     // Allocate Cache Entry in the State
     if(_namedCacheVariableInfo.size()>0){
+        _cacheVariableIndices.clear();
+        _cacheVariableIndices.resize(_namedCacheVariableInfo.size());
         std::map<std::string, CacheInfo>::iterator it;
         for (it = (mutableThis->_namedCacheVariableInfo).begin(); 
              it != _namedCacheVariableInfo.end(); ++it){
             CacheInfo& ci = it->second;
             ci.index = subSys.allocateLazyCacheEntry
                (s, ci.dependsOnStage, ci.prototype->clone());
+            _cacheVariableIndices[ci.slot] = ci.index;
         }
     }
 }
@@ -1080,6 +1169,18 @@ void Component::AddedStateVariable::setValue(SimTK::State& state, double value)
     throw Exception(msg.str(),__FILE__,__LINE__);
 }
 
+SimTK::SystemYIndex Component::AddedStateVariable::
+	computeSystemYIndex(const SimTK::State& state) const
+{
+	ZIndex zix(getVarIndex());
+	if(!getSubsysIndex().isValid() || !zix.isValid())
+		return SimTK::SystemYIndex();
+
+	// Y holds all q's, then all u's, then all z's
+	return SimTK::SystemYIndex(state.getNQ() + state.getNU()
+		+ state.getZStart(getSubsysIndex()) + zix);
+}
+
 double Component::AddedStateVariable::
 	getDerivative(const SimTK::State& state) const
 {
@@ -512,6 +512,25 @@ public:
      */
     void setDiscreteVariable(SimTK::State& state, const std::string& name, double value) const;
 
+    /**
+     * A handle to a cache variable of type T allocated by this Component. It
+     * is returned by addCacheVariable() and can be used in place of the cache
+     * variable's name to access it without searching for it by name. A handle
+     * is only valid for the Component that allocated the cache variable.
+     */
+    template <class T> class CacheVariableHandle {
+    public:
+        CacheVariableHandle() : slot(-1) {}
+        /** Whether the handle has been assigned by addCacheVariable(). */
+        bool isValid() const { return slot >= 0; }
+    private:
+        explicit CacheVariableHandle(int aSlot) : slot(aSlot) {}
+        // position of the cache variable in the Component's list of allocated
+        // cache entry indices
+        int slot;
+        friend class Component;
+    };
+
     /**
      * Get the value of a cache variable allocated by this Component by name.
      *
@@ -537,6 +556,20 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }
     }
+    /**
+     * Get the value of a cache variable allocated by this Component by handle.
+     *
+     * @param state  the State for which to set the value
+     * @param cv     the handle returned when the cache variable was added
+     * @return T	 const reference to the cache variable's value
+     */
+    template<typename T> const T& 
+    getCacheVariable(const SimTK::State& state, 
+                     const CacheVariableHandle<T>& cv) const
+    {
+        return SimTK::Value<T>::downcast(getDefaultSubsystem().getCacheEntry(
+            state, getCacheEntryIndex(cv.slot))).get();
+    }
     /**
      * Obtain a writable cache variable value allocated by this Component by name.
      * Do not forget to mark the cache value as valid after updating, otherwise it
@@ -567,6 +600,21 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }
     }
+    /**
+     * Obtain a writable cache variable value allocated by this Component by
+     * handle. Do not forget to mark the cache value as valid after updating.
+     *
+     * @param state  the State for which to set the value
+     * @param cv     the handle returned when the cache variable was added
+     * @return value modifiable reference to the cache variable's value
+     */
+    template<typename T> T& 
+    updCacheVariable(const SimTK::State& state, 
+                     const CacheVariableHandle<T>& cv) const
+    {
+        return SimTK::Value<T>::downcast(getDefaultSubsystem().updCacheEntry(
+            state, getCacheEntryIndex(cv.slot))).upd();
+    }
 
     /**
      * After updating a cache variable value allocated by this Component, you can
@@ -595,6 +643,15 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }
     }
+    /** Mark a cache variable value allocated by this Component as valid, given
+        its handle. @see markCacheVariableValid(const SimTK::State&, const std::string&) */
+    template<typename T> void 
+    markCacheVariableValid(const SimTK::State& state, 
+                           const CacheVariableHandle<T>& cv) const
+    {
+        getDefaultSubsystem().markCacheValueRealized(state, 
+            getCacheEntryIndex(cv.slot));
+    }
 
     /**
      * Mark a cache variable value allocated by this Component as invalid.
@@ -630,6 +687,15 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }
     }
+    /** Mark a cache variable value allocated by this Component as invalid, 
+        given its handle. @see markCacheVariableInvalid(const SimTK::State&, const std::string&) */
+    template<typename T> void 
+    markCacheVariableInvalid(const SimTK::State& state, 
+                             const CacheVariableHandle<T>& cv) const
+    {
+        getDefaultSubsystem().markCacheValueNotRealized(state, 
+            getCacheEntryIndex(cv.slot));
+    }
 
     /**
      * Enables the user to monitor the validity of the cache variable value using the
@@ -658,6 +724,15 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }
     }
+    /** Whether the value of a cache variable allocated by this Component is
+        valid, given its handle. @see isCacheVariableValid(const SimTK::State&, const std::string&) */
+    template<typename T> bool 
+    isCacheVariableValid(const SimTK::State& state, 
+                         const CacheVariableHandle<T>& cv) const
+    {
+        return getDefaultSubsystem().isCacheValueRealized(state, 
+            getCacheEntryIndex(cv.slot));
+    }
 
     /**
      *  Set cache variable value allocated by this Component by name.
@@ -690,6 +765,23 @@ public:
             throw Exception(msg.str(),__FILE__,__LINE__);
         }	
     }
+    /**
+     *  Set cache variable value allocated by this Component by handle, which
+     *  also marks the cache as valid.
+     *
+     * @param state  the State in which to store the new value
+     * @param cv     the handle returned when the cache variable was added
+     * @param value  the new value for this cache variable
+     */
+    template<typename T> void 
+    setCacheVariable(const SimTK::State& state, 
+                     const CacheVariableHandle<T>& cv, const T& value) const
+    {
+        const SimTK::CacheEntryIndex& ceIndex = getCacheEntryIndex(cv.slot);
+        SimTK::Value<T>::downcast(
+            getDefaultSubsystem().updCacheEntry(state, ceIndex)).upd() = value;
+        getDefaultSubsystem().markCacheValueRealized(state, ceIndex);
+    }
     // End of Model Component State Accessors.
     //@} 
 
@@ -1166,16 +1258,29 @@ template <class T> friend class ComponentMeasure;
     @param[in]      dependsOnStage		
         This is the highest computational stage on which this cache entry's
         value computation depends. State changes at this level or lower will
-        invalidate the cache entry. **/ 
-    template <class T> void 
+        invalidate the cache entry. 
+    @returns        
+        A handle with which to access the cache variable without looking it 
+        up by name. It can be kept by the Component (e.g. in a mutable member
+        assigned in addToSystem()) and used once the System has been 
+        realized to Stage::Topology. **/ 
+    template <class T> CacheVariableHandle<T> 
     addCacheVariable(const std::string&     cacheVariableName,
                      const T&               variablePrototype, 
                      SimTK::Stage           dependsOnStage) const
     {
+        // Re-adding a cache variable keeps its place in the list of indices.
+        std::map<std::string, CacheInfo>::const_iterator it =
+            _namedCacheVariableInfo.find(cacheVariableName);
+        int slot = (it != _namedCacheVariableInfo.end()) ? it->second.slot :
+            (int)_namedCacheVariableInfo.size();
+
         // Note, cache index is invalid until the actual allocation occurs 
         // during realizeTopology.
         _namedCacheVariableInfo[cacheVariableName] = 
-            CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage);
+            CacheInfo(new SimTK::Value<T>(variablePrototype), dependsOnStage,
+                      slot);
+        return CacheVariableHandle<T>(slot);
     }
 
 	
@@ -1238,6 +1343,17 @@ template <class T> friend class ComponentMeasure;
 
 	const StateVariable* findStateVariable(const std::string& name) const;
 
+    /** Build a flat table of the state variables of this Component and its
+        subcomponents, in the order returned by getStateVariableNames(). With
+        the table, getStateVariableValues() gathers the values straight from
+        the State's Y vector and setStateVariableValues() sets each variable
+        without looking it up by name. It also sets the System Y index of each
+        StateVariable, which getStateVariableSystemIndex() returns. The state
+        must be realized to at least Stage::Model.
+        Model::initializeState() builds the table for the Model;
+        it is discarded along with the other state allocations. */
+    void buildStateVariableTable(const SimTK::State& state) const;
+
     //@} 
 
 private:
@@ -1289,6 +1405,9 @@ private:
         _namedStateVariableInfo.clear();
         _namedDiscreteVariableInfo.clear();
         _namedCacheVariableInfo.clear();	
+        _cacheVariableIndices.clear();
+        _stateVariableTable.clear();
+        _stateVariableTableNQ = _stateVariableTableNU = _stateVariableTableNZ = 0;
     }
 
     // Reset by clearing underlying system indices, disconnecting connectors and
@@ -1335,7 +1454,8 @@ protected:
 		const int& getVarIndex() const { return varIndex; }
 		// return the index of the subsystem used to make resource allocations 
 		const SimTK::SubsystemIndex& getSubsysIndex() const { return subsysIndex; }
-		// return the index of the subsystem used to make resource allocations 
+		// return the index of the variable in the System's Y vector, set by
+		// Component::buildStateVariableTable() (see computeSystemYIndex())
 		const SimTK::SystemYIndex& getSystemYIndex() const { return sysYIndex; }
 
 		bool isHidden() const { return hidden; }
@@ -1347,6 +1467,10 @@ protected:
 		{
 			subsysIndex = sbsysix;
 		}
+		void setSystemYIndex(const SimTK::SystemYIndex& sysYIx)
+		{
+			sysYIndex = sysYIx;
+		}
 
 		//Concrete Components implement how the state variable value is evaluated
 		virtual double getValue(const SimTK::State& state) const = 0;
@@ -1356,6 +1480,13 @@ protected:
 		// change the state
 		virtual void setDerivative(const SimTK::State& state, double deriv) const = 0;
 
+		// The index of the variable in the System's Y vector, given a State
+		// realized to Stage::Model. Variables that are not held in Y return
+		// an invalid index and are accessed through getValue() instead.
+		virtual SimTK::SystemYIndex
+			computeSystemYIndex(const SimTK::State& state) const
+		{   return SimTK::SystemYIndex(); }
+
 	private:
 		std::string name;
 		SimTK::ReferencePtr<const Component> owner;
@@ -1443,6 +1574,8 @@ private:
 
 		double getDerivative(const SimTK::State& state) const OVERRIDE_11;
 		void setDerivative(const SimTK::State& state, double deriv) const OVERRIDE_11;
+		SimTK::SystemYIndex
+			computeSystemYIndex(const SimTK::State& state) const OVERRIDE_11;
 
 		private: // DATA
 		// Changes in state variables trigger recalculation of appropriate cache 
@@ -1492,13 +1625,16 @@ private:
 
     // Structure to hold related info about cache variables 
     struct CacheInfo {
-        CacheInfo() {}
+        CacheInfo() : slot(-1) {}
         CacheInfo(SimTK::AbstractValue* proto,
-                  SimTK::Stage          dependsOn)
-        :   prototype(proto), dependsOnStage(dependsOn) {}
+                  SimTK::Stage          dependsOn,
+                  int                   aSlot)
+        :   prototype(proto), dependsOnStage(dependsOn), slot(aSlot) {}
         // Model
         SimTK::ClonePtr<SimTK::AbstractValue>   prototype;
         SimTK::Stage                            dependsOnStage;
+        // Position in _cacheVariableIndices, see CacheVariableHandle
+        int                                     slot;
         // System
         SimTK::CacheEntryIndex                  index;
     };
@@ -1525,6 +1661,32 @@ private:
     // Map names of cache entries of the Component to their individual 
     // cache information.
     mutable std::map<std::string, CacheInfo>            _namedCacheVariableInfo;
+    // Allocated index of each cache variable, by the slot held by its 
+    // CacheVariableHandle.
+    mutable SimTK::Array_<SimTK::CacheEntryIndex>       _cacheVariableIndices;
+
+    // The allocated index of the cache variable in the given slot. Throws if
+    // the cache variable has not been allocated.
+    const SimTK::CacheEntryIndex& getCacheEntryIndex(int slot) const
+    {
+        if(slot < 0 || slot >= (int)_cacheVariableIndices.size() 
+            || !_cacheVariableIndices[slot].isValid())
+            throwInvalidCacheVariableHandle();
+        return _cacheVariableIndices[slot];
+    }
+    void throwInvalidCacheVariableHandle() const;
+
+    // Flat table of the state variables of this Component and all of its
+    // subcomponents, see buildStateVariableTable().
+    mutable SimTK::Array_<StateVariable*>           _stateVariableTable;
+    // Number of q's, u's and z's of the State the table was built for.
+    mutable int _stateVariableTableNQ;
+    mutable int _stateVariableTableNU;
+    mutable int _stateVariableTableNZ;
+
+    void appendStateVariables
+        (SimTK::Array_<StateVariable*>& rStateVariables) const;
+    bool hasStateVariableTableFor(const SimTK::State& state) const;
 //==============================================================================
 };	// END of class Component
 //==============================================================================
@@ -29,6 +29,7 @@
 // INCLUDES
 #include "Function.h"
 #include "PropertyDbl.h"
+#include <pthread.h>
 
 
 using namespace OpenSim;
@@ -39,7 +40,10 @@ using SimTK::Vector;
 //=============================================================================
 // STATICS
 //=============================================================================
-
+namespace {
+	// Guards the creation of the SimTK::Functions of all Functions.
+	pthread_mutex_t createFunctionLock = PTHREAD_MUTEX_INITIALIZER;
+}
 
 //=============================================================================
 // DESTRUCTOR AND CONSTRUCTORS
@@ -50,8 +54,7 @@ using SimTK::Vector;
  */
 Function::~Function()
 {
-    if (_function != NULL)
-        delete _function;
+    delete _function.load();
 }
 //_____________________________________________________________________________
 /**
@@ -160,37 +163,50 @@ evaluateTotalSecondDerivative(double aX,double aDxdt,double aD2xdt2)
 	return evaluate(1,aX) * aD2xdt2 + evaluate(2,aX) * aDxdt * aDxdt;
 }
 */
+const SimTK::Function& Function::getSimTKFunction() const
+{
+    // The acquire load pairs with the release store below, so a thread that
+    // sees the function also sees it fully constructed.
+    const SimTK::Function* function = _function.load(std::memory_order_acquire);
+    if (function == NULL) {
+        pthread_mutex_lock(&createFunctionLock);
+        SimTK::Function* created = _function.load(std::memory_order_relaxed);
+        if (created == NULL) {
+            try {
+                created = createSimTKFunction();
+            } catch (...) {
+                pthread_mutex_unlock(&createFunctionLock);
+                throw;
+            }
+            _function.store(created, std::memory_order_release);
+        }
+        pthread_mutex_unlock(&createFunctionLock);
+        function = created;
+    }
+    return *function;
+}
+
 double Function::calcValue(const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcValue(x);
+    return getSimTKFunction().calcValue(x);
 }
 
 double Function::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcDerivative(derivComponents, x);
+    return getSimTKFunction().calcDerivative(derivComponents, x);
 }
 
 int Function::getArgumentSize() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getArgumentSize();
+    return getSimTKFunction().getArgumentSize();
 }
 
 int Function::getMaxDerivativeOrder() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getMaxDerivativeOrder();
+    return getSimTKFunction().getMaxDerivativeOrder();
 }
 
 void Function::resetFunction()
 {
-    if (_function != NULL)
-        delete _function;
-    _function = NULL;
+    delete _function.exchange(NULL);
 }
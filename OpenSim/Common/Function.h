@@ -37,6 +37,9 @@
 #include "PropertyDbl.h"
 #include "Property.h"
 #include "SimTKmath.h"
+#ifndef SWIG
+#include <atomic>
+#endif
 
 
 //=============================================================================
@@ -64,8 +67,11 @@ OpenSim_DECLARE_ABSTRACT_OBJECT(Function, Object);
 // DATA
 //=============================================================================
 protected:
-    // The SimTK::Function object implementing this function.
-    mutable SimTK::Function* _function;
+#ifndef SWIG
+    // The SimTK::Function object implementing this function, created on first
+    // use. It is atomic so that, once created, it is read without locking.
+    mutable std::atomic<SimTK::Function*> _function;
+#endif
 
 //=============================================================================
 // METHODS
@@ -140,6 +146,13 @@ protected:
      */
     void resetFunction();
 
+private:
+    // Get _function, creating it on first use. Functions shared by models 
+    // simulated on several threads may be used for the first time on two
+    // threads at once, so creation is done under a lock; once created,
+    // _function is read without one.
+    const SimTK::Function& getSimTKFunction() const;
+
 //=============================================================================
 };	// END class Function
 
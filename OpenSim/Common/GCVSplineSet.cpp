@@ -28,6 +28,77 @@
 
 // INCLUDES
 #include "GCVSplineSet.h"
+#include "IO.h"
+#include "SimTKcommon.h"
+#include <vector>
+#include <cstdio>
+
+
+namespace {
+/**
+ * Fits a GCVSpline to each state (column) of a storage.  The columns are
+ * split into contiguous chunks so that each chunk can be fit by a separate
+ * thread; the storage is only read.
+ */
+class FitSplinesTask : public SimTK::ParallelExecutor::Task {
+public:
+	FitSplinesTask(int aDegree,const OpenSim::Storage &aStore,double aErrorVariance,
+		const OpenSim::Array<std::string> &aLabels,int aNumColumns,int aNumChunks,
+		std::vector<OpenSim::GCVSpline*> &rSplines,std::vector<int> &rNumTimes,
+		std::vector<int> &rNumData,std::vector<std::string> &rErrors) :
+		_degree(aDegree),_store(aStore),_errorVariance(aErrorVariance),
+		_labels(aLabels),_nc(aNumColumns),_numChunks(aNumChunks),
+		_splines(rSplines),_numTimes(rNumTimes),_numData(rNumData),
+		_errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int first = (int)(((long long)_nc*aChunk)/_numChunks);
+		int last = (int)(((long long)_nc*(aChunk+1))/_numChunks);
+		std::vector<double> times(_store.getSize()),data(_store.getSize());
+		double *t = &times[0], *y = &data[0];
+		try {
+			for(int i=first;i<last;i++) {
+				// GET TIMES AND DATA
+				_numTimes[i] = _store.getTimeColumn(t,i);
+				_numData[i] = _store.getDataColumn(i,y);
+				if(_numTimes[i]!=_numData[i] || _numData[i]==0) continue;
+
+				// GET COLUMN NAME
+				// Note that state i is in column i+1
+				std::string name;
+				if(i+1 < _labels.getSize()) {
+					name = _labels[i+1];
+				} else {
+					char tmp[32];
+					sprintf(tmp,"data_%d",i);
+					name = tmp;
+				}
+
+				// CONSTRUCT SPLINE
+				_splines[i] = new OpenSim::GCVSpline(_degree,_numData[i],t,y,
+					name,_errorVariance);
+				SimTK::Function* fp = _splines[i]->createSimTKFunction();
+				delete fp;
+			}
+		} catch(const std::exception &x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	int _degree;
+	const OpenSim::Storage &_store;
+	double _errorVariance;
+	const OpenSim::Array<std::string> &_labels;
+	int _nc;
+	int _numChunks;
+	std::vector<OpenSim::GCVSpline*> &_splines;
+	std::vector<int> &_numTimes;
+	std::vector<int> &_numData;
+	std::vector<std::string> &_errors;
+};
+}
 
 
 //=============================================================================
@@ -95,9 +166,9 @@ GCVSplineSet(int aDegree,const Storage *aStore,double aErrorVariance)
 	setName(aStore->getName());
 
 	// CAPACITY
-	StateVector *vec = aStore->getStateVector(0);
-	if(vec==NULL) return;
-	ensureCapacity(2*vec->getSize());
+	// Columnar data are sized without unpacking them into StateVectors.
+	if(aStore->getSize()<=0) return;
+	ensureCapacity(2*aStore->getLargestNumberOfStates());
 
 	// CONSTRUCT
 	construct(aDegree,aStore,aErrorVariance);
@@ -134,51 +205,46 @@ construct(int aDegree,const Storage *aStore,double aErrorVariance)
 
 	// GET COLUMN NAMES
 	const Array<std::string> &labels = aStore->getColumnLabels();
-	char tmp[32];
-	std::string name;
-
-	// LOOP THROUGHT THE STATES
-	int nTime=1,nData=1;
-	double *times=NULL,*data=NULL;
-	GCVSpline *spline;
-	//printf("GCVSplineSet.construct:  contructing splines...\n");
-	for(int i=0;nData>0;i++) {
-
-		// GET TIMES AND DATA
-		nTime = aStore->getTimeColumn(times,i);
-		nData = aStore->getDataColumn(i,data);
 
-		// CHECK
-		if(nTime!=nData) {
-			std::cout << "\nGCVSplineSet.construct: ERR- number of times (" << nTime << ")"
-				  << " and number of data (" << nData << ") don't agree.\n";
+	// FIT THE SPLINES
+	// Each state is fit independently, so the states are spread over
+	// IO::GetNumThreads() threads.
+	int nc = aStore->getLargestNumberOfStates();
+	if(nc<=0 || aStore->getSize()<=0) return;
+	int numChunks = IO::GetNumThreads();
+	if(numChunks>nc) numChunks = nc;
+	std::vector<GCVSpline*> splines(nc,(GCVSpline*)NULL);
+	std::vector<int> nTime(nc,0),nData(nc,0);
+	std::vector<std::string> errors(numChunks);
+	FitSplinesTask task(aDegree,*aStore,aErrorVariance,labels,nc,numChunks,
+		splines,nTime,nData,errors);
+	if(numChunks>1) {
+		SimTK::ParallelExecutor executor(numChunks);
+		executor.execute(task,numChunks);
+	} else {
+		task.execute(0);
+	}
+	std::string error;
+	for(int c=0;c<numChunks && error.empty();c++) error = errors[c];
+
+	// ADD SPLINES
+	// States are added in order up to the first one that cannot be fit.
+	int i;
+	for(i=0;i<nc && error.empty();i++) {
+		if(nTime[i]!=nData[i]) {
+			std::cout << "\nGCVSplineSet.construct: ERR- number of times (" << nTime[i] << ")"
+				  << " and number of data (" << nData[i] << ") don't agree.\n";
 			break;
 		}
-		if(nData==0) break;
-
-		// GET COLUMN NAME
-		// Note that state i is in column i+1
-		if(i+1 < labels.getSize()) {
-			name = labels[i+1];
-		} else {
-			sprintf(tmp,"data_%d",i);
-			name = tmp;
-		}
-
-		// CONSTRUCT SPLINE
-		//printf("%s\t",name);
-		spline = new GCVSpline(aDegree,nData,times,data,name,aErrorVariance);
-		SimTK::Function* fp = spline->createSimTKFunction();
-		delete fp;  
-
-		// ADD SPLINE
-		adoptAndAppend(spline);
+		if(nData[i]==0) break;
+		adoptAndAppend(splines[i]);
+		splines[i] = NULL;
 	}
-	//printf("\n%d splines constructed.\n\n",i);
 
 	// CLEANUP
-	if(times!=NULL) delete[] times;
-	if(data!=NULL) delete[] data;
+	for(i=0;i<nc;i++) delete splines[i];
+	if(!error.empty())
+		throw Exception("GCVSplineSet.construct: "+error,__FILE__,__LINE__);
 }
 
 
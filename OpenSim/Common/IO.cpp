@@ -32,8 +32,14 @@
 #include <math.h>
 #include <string>
 #include <climits>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <set>
+#include <pthread.h>
 
 #include "IO.h"
+#include "SimTKcommon.h"
 #if defined(__linux__) || defined(__APPLE__)
 	#include <sys/stat.h>
 	#include <sys/types.h>
@@ -62,8 +68,21 @@ bool IO::_Scientific = false;
 bool IO::_GFormatForDoubleOutput = false;
 int IO::_Pad = 8;
 int IO::_Precision = 8;
-char IO::_DoubleFormat[] = "%16.8lf";
+const char* IO::_DoubleFormat = "%16.8lf";
 bool IO::_PrintOfflineDocuments = true;
+int IO::_NumThreads = 0;
+
+namespace {
+	// Guards the set of double output formats.
+	pthread_mutex_t formatLock = PTHREAD_MUTEX_INITIALIZER;
+
+	// Every double output format constructed so far.
+	std::set<std::string>& getDoubleOutputFormats()
+	{
+		static std::set<std::string> formats;
+		return formats;
+	}
+}
 
 
 //=============================================================================
@@ -83,16 +102,21 @@ char* IO::
 ConstructDateAndTimeStamp()
 {
 	// GET DATE AND TIME
+	// (localtime() returns a static buffer; use the reentrant versions.)
 	time_t timeInSeconds;
-	struct tm *timeStruct;
+	struct tm timeStruct;
 	time(&timeInSeconds);
-	timeStruct = localtime(&timeInSeconds);
+#ifdef _MSC_VER
+	localtime_s(&timeStruct,&timeInSeconds);
+#else
+	localtime_r(&timeInSeconds,&timeStruct);
+#endif
 
 	// CONSTRUCT STAMP
 	char *stamp = new char[64];
 	sprintf(stamp,"%d%02d%02d_%02d%02d%02d",
-		timeStruct->tm_year+1900,timeStruct->tm_mon+1,timeStruct->tm_mday,
-		timeStruct->tm_hour,timeStruct->tm_min,timeStruct->tm_sec);
+		timeStruct.tm_year+1900,timeStruct.tm_mon+1,timeStruct.tm_mday,
+		timeStruct.tm_hour,timeStruct.tm_min,timeStruct.tm_sec);
 
 	return(stamp);
 }
@@ -281,21 +305,28 @@ GetDoubleOutputFormat()
 void IO::
 ConstructDoubleOutputFormat()
 {
+	char format[256];
 	if(_GFormatForDoubleOutput) {
-		sprintf(_DoubleFormat,"%%g");
+		sprintf(format,"%%g");
 	} else if(_Scientific) {
 		if(_Pad<0) {
-			sprintf(_DoubleFormat,"%%.%dle",_Precision);
+			sprintf(format,"%%.%dle",_Precision);
 		} else {
-			sprintf(_DoubleFormat,"%%%d.%dle",_Pad+_Precision,_Precision);
+			sprintf(format,"%%%d.%dle",_Pad+_Precision,_Precision);
 		}
 	} else {
 		if(_Pad<0) {
-			sprintf(_DoubleFormat,"%%.%dlf",_Precision);
+			sprintf(format,"%%.%dlf",_Precision);
 		} else {
-			sprintf(_DoubleFormat,"%%%d.%dlf",_Pad+_Precision,_Precision);
+			sprintf(format,"%%%d.%dlf",_Pad+_Precision,_Precision);
 		}
 	}
+
+	// The format is switched, never overwritten, so threads printing with
+	// the previous format are not affected.
+	pthread_mutex_lock(&formatLock);
+	_DoubleFormat = getDoubleOutputFormats().insert(format).first->c_str();
+	pthread_mutex_unlock(&formatLock);
 }
 
 //=============================================================================
@@ -321,6 +352,38 @@ GetPrintOfflineDocuments()
 {
 	return _PrintOfflineDocuments;
 }
+
+//=============================================================================
+// THREADS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set the number of threads used to read data files and to process their
+ * columns (e.g., Storage::lowpassIIR()).  The results do not depend on
+ * the number of threads.
+ *
+ * @param aNumThreads Number of threads.  0 or less uses one thread per
+ * processor, which is the default.
+ */
+void IO::
+SetNumThreads(int aNumThreads)
+{
+	_NumThreads = aNumThreads;
+}
+//_____________________________________________________________________________
+/**
+ * Get the number of threads used to read data files and to process their
+ * columns.
+ *
+ * @return Number of threads, always at least 1.
+ */
+int IO::
+GetNumThreads()
+{
+	if(_NumThreads>0) return(_NumThreads);
+	int numProcessors = SimTK::ParallelExecutor::getNumProcessors();
+	return(numProcessors>0 ? numProcessors : 1);
+}
 //=============================================================================
 // READ
 //=============================================================================
@@ -401,6 +464,123 @@ ComputeNumberOfSteps(double aTI,double aTF,double aDT)
 	return(ns);
 }
 //_____________________________________________________________________________
+/**
+ * Parse a floating point number from a character buffer.
+ *
+ * Leading spaces and tabs are skipped, and the number must be followed by
+ * white space or by the end of the buffer.  Besides ordinary decimal and
+ * exponential notation, "nan" and "inf"/"infinity" (any case, optionally
+ * signed) are accepted.  The parse does not depend on the current locale,
+ * and the result is correctly rounded, so it is identical to what the
+ * standard stream operators produce for the same text.
+ *
+ * @param rPos Position at which to start parsing.  On success, it is
+ * advanced past the number.
+ * @param aEnd End of the buffer.
+ * @param rValue Parsed value.
+ * @return true if a number was parsed, false otherwise.
+ */
+bool IO::
+ParseDouble(const char *&rPos,const char *aEnd,double &rValue)
+{
+	// Powers of ten that are exactly representable as doubles.
+	static const double pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+		1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+		1e20, 1e21, 1e22 };
+
+	const char *p = rPos;
+	while(p<aEnd && (*p==' ' || *p=='\t')) p++;
+	const char *start = p;
+
+	// SIGN
+	bool negative = false;
+	if(p<aEnd && (*p=='-' || *p=='+')) {
+		negative = (*p=='-');
+		p++;
+	}
+
+	// NaN AND INFINITY
+	double value;
+	if(p<aEnd && (*p=='n' || *p=='N' || *p=='i' || *p=='I')) {
+		string word;
+		while(p<aEnd && isalpha((unsigned char)*p) && word.size()<8) word += (char)tolower(*p++);
+		if(word=="nan") value = numeric_limits<double>::quiet_NaN();
+		else if(word=="inf" || word=="infinity") value = numeric_limits<double>::infinity();
+		else return(false);
+		if(p<aEnd && !isspace((unsigned char)*p)) return(false);
+		rValue = negative ? -value : value;
+		rPos = p;
+		return(true);
+	}
+
+	// SIGNIFICAND
+	// At most 19 significant digits fit in the integer accumulator; any
+	// further digits are dropped and only shift the decimal exponent.
+	unsigned long long mantissa = 0;
+	int nSignificant = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+	bool truncated = false;
+	for(; p<aEnd && *p>='0' && *p<='9'; p++) {
+		anyDigits = true;
+		if(nSignificant<19) {
+			mantissa = 10*mantissa + (*p-'0');
+			if(mantissa>0) nSignificant++;
+		} else {
+			exponent++;
+			if(*p!='0') truncated = true;
+		}
+	}
+	if(p<aEnd && *p=='.') {
+		for(p++; p<aEnd && *p>='0' && *p<='9'; p++) {
+			anyDigits = true;
+			if(nSignificant<19) {
+				mantissa = 10*mantissa + (*p-'0');
+				if(mantissa>0) nSignificant++;
+				exponent--;
+			} else if(*p!='0') {
+				truncated = true;
+			}
+		}
+	}
+	if(!anyDigits) return(false);
+
+	// EXPONENT
+	if(p<aEnd && (*p=='e' || *p=='E')) {
+		p++;
+		bool negativeExponent = false;
+		if(p<aEnd && (*p=='-' || *p=='+')) {
+			negativeExponent = (*p=='-');
+			p++;
+		}
+		if(p>=aEnd || *p<'0' || *p>'9') return(false);
+		int e = 0;
+		for(; p<aEnd && *p>='0' && *p<='9'; p++) {
+			if(e<100000) e = 10*e + (*p-'0');
+		}
+		exponent += negativeExponent ? -e : e;
+	}
+	if(p<aEnd && !isspace((unsigned char)*p)) return(false);
+
+	// CONVERT
+	// When the significand and the power of ten are both exact doubles, a
+	// single multiplication or division is correctly rounded. Otherwise
+	// defer to strtod on the token.
+	if(!truncated && mantissa<=(1ULL<<53) && exponent>=-22 && exponent<=22) {
+		value = (double)mantissa;
+		if(exponent<0) value /= pow10[-exponent];
+		else value *= pow10[exponent];
+		if(negative) value = -value;
+	} else {
+		string token(start,p);
+		value = strtod(token.c_str(),NULL);
+	}
+
+	rValue = value;
+	rPos = p;
+	return(true);
+}
+//_____________________________________________________________________________
 /**
  * Read a specified number of characters from file.
  *
@@ -60,10 +60,14 @@ private:
 	static int _Pad;
 	/** Specifies the precision of number output. */
 	static int _Precision;
-	/** The output format string. */
-	static char _DoubleFormat[256];
+	/** The output format string. Formats are kept until the program exits,
+	so the format returned by GetDoubleOutputFormat() remains valid when the
+	format is changed, even on another thread. */
+	static const char* _DoubleFormat;
 	/** Whether offline documents should also be printed when Object::print is called. */
 	static bool _PrintOfflineDocuments;
+	/** Number of threads used to read and process data. */
+	static int _NumThreads;
 
 
 //=============================================================================
@@ -91,12 +95,16 @@ public:
 	// Object printing
 	static void SetPrintOfflineDocuments(bool aTrueFalse);
 	static bool GetPrintOfflineDocuments();
+	// Threads
+	static void SetNumThreads(int aNumThreads);
+	static int GetNumThreads();
 	// READ
 #ifndef SWIG
 	static std::string ReadToTokenLine(std::istream &aIS,const std::string &aToken);
 	static std::string ReadLine(std::istream &aIS);
 	static int ComputeNumberOfSteps(double aTI,double aTF,double aDT);
 	static std::string ReadCharacters(std::istream &aIS,int aNChar);
+	static bool ParseDouble(const char *&rPos,const char *aEnd,double &rValue);
 	static FILE* OpenFile(const std::string &aFileName,const std::string &aMode);
 	static std::ifstream* OpenInputFile(const std::string &aFileName,std::ios_base::openmode mode=std::ios_base::in);
 	static std::ofstream* OpenOutputFile(const std::string &aFileName,std::ios_base::openmode mode=std::ios_base::out);
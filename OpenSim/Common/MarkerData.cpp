@@ -26,9 +26,14 @@
 //=============================================================================
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <math.h>
 #include <float.h>
+#include <string.h>
+#include <pthread.h>
 #include "MarkerData.h"
+#include "IO.h"
+#include "MemoryMappedFile.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
 #include "SimTKcommon.h"
@@ -40,6 +45,129 @@ using namespace std;
 using namespace OpenSim;
 using SimTK::Vec3;
 
+// Binary marker files start with these 8 bytes.
+const char MarkerData::BINARY_FILE_MAGIC[8] = { 'O','S','I','M','T','R','B','F' };
+const int MarkerData::BinaryVersion = 1;
+
+namespace {
+/** Size in bytes of the fixed part of a binary marker file header. */
+const int BINARY_PREAMBLE_SIZE = 64;
+/** Written in native byte order so that a reader can detect a mismatch. */
+const unsigned int BINARY_BYTE_ORDER_MARK = 0x01020304;
+
+/** Guards the frames made on demand by getFrame(). */
+pthread_mutex_t frameLock = PTHREAD_MUTEX_INITIALIZER;
+
+void appendString(std::vector<char> &rBuffer, const std::string &aString)
+{
+	int size = (int)aString.size();
+	const char *bytes = (const char*)&size;
+	rBuffer.insert(rBuffer.end(), bytes, bytes+sizeof(size));
+	rBuffer.insert(rBuffer.end(), aString.begin(), aString.end());
+}
+bool readString(const char *&rPos, const char *aEnd, std::string &rString)
+{
+	int size;
+	if (aEnd-rPos < (long long)sizeof(size)) return false;
+	memcpy(&size, rPos, sizeof(size));
+	rPos += sizeof(size);
+	if (size < 0 || aEnd-rPos < size) return false;
+	rString.assign(rPos, size);
+	rPos += size;
+	return true;
+}
+
+/**
+ * Read the XYZ coordinates of aNumMarkers markers from the remainder of a
+ * line of a TRC file. The coordinates are separated by tabs, and 3 tabs in
+ * a row mean that a marker is missing. Missing markers, coordinates that
+ * are not numbers, and markers missing from the end of the line are set to
+ * NaN. Coordinates beyond the last marker are ignored.
+ */
+void readTRCCoordinates(const char *aPos, const char *aEnd, int aNumMarkers, Vec3 *rMarkers)
+{
+	const char *pos = aPos;
+	for (int i = 0; i < aNumMarkers; i++)
+	{
+		Vec3& marker = rMarkers[i];
+		int numTabs = 0, numCoords = 0;
+		while (pos < aEnd && numCoords < 3)
+		{
+			if (*pos == '\t')
+			{
+				pos++;
+				if (++numTabs == 3)
+				{
+					marker = Vec3(SimTK::NaN);
+					numCoords = 3;
+				}
+			}
+			else if (*pos == ' ' || *pos == '\r')
+			{
+				pos++;
+			}
+			else
+			{
+				const char *fieldEnd = (const char*)memchr(pos, '\t', aEnd-pos);
+				if (fieldEnd == NULL) fieldEnd = aEnd;
+				if (!IO::ParseDouble(pos, fieldEnd, marker[numCoords]))
+					marker[numCoords] = SimTK::NaN;
+				pos = fieldEnd;
+				numCoords++;
+				numTabs = 0;
+			}
+		}
+		if (numCoords < 3)
+			marker = Vec3(SimTK::NaN);
+	}
+}
+
+/**
+ * Parses the frames of a TRC file, one frame per line, into the contiguous
+ * arrays of MarkerData. The lines are split into contiguous chunks so that
+ * each chunk can be parsed by a separate thread.
+ */
+class ParseFramesTask : public SimTK::ParallelExecutor::Task {
+public:
+	ParseFramesTask(const std::vector<const char*> &aLineStarts, const char *aEnd,
+		int aNumMarkers, int aNumChunks, int *rFrameNumbers, double *rTimes,
+		Vec3 *rCoordinates, std::vector<std::string> &rErrors) :
+		_lineStarts(aLineStarts), _end(aEnd), _numMarkers(aNumMarkers),
+		_numChunks(aNumChunks), _frameNumbers(rFrameNumbers), _times(rTimes),
+		_coordinates(rCoordinates), _errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int nr = (int)_lineStarts.size();
+		int first = (int)(((long long)nr*aChunk)/_numChunks);
+		int last = (int)(((long long)nr*(aChunk+1))/_numChunks);
+		for (int r = first; r < last; r++) {
+			const char *pos = _lineStarts[r];
+			const char *eol = (const char*)memchr(pos, '\n', _end-pos);
+			if (eol == NULL) eol = _end;
+			double frameNumber;
+			if (!IO::ParseDouble(pos, eol, frameNumber) || !IO::ParseDouble(pos, eol, _times[r])) {
+				std::ostringstream msg;
+				msg << "could not read the frame number and time of data row " << r+1;
+				_errors[aChunk] = msg.str();
+				return;
+			}
+			_frameNumbers[r] = (int)frameNumber;
+			readTRCCoordinates(pos, eol, _numMarkers, _coordinates + (size_t)r*_numMarkers);
+		}
+	}
+
+private:
+	const std::vector<const char*> &_lineStarts;
+	const char *_end;
+	int _numMarkers;
+	int _numChunks;
+	int *_frameNumbers;
+	double *_times;
+	Vec3 *_coordinates;
+	std::vector<std::string> &_errors;
+};
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -50,6 +178,12 @@ using SimTK::Vec3;
 MarkerData::MarkerData() :
 	_numFrames(0),
 	_numMarkers(0),
+	_firstFrameNumber(1),
+	_dataRate(0.0),
+	_cameraRate(0.0),
+	_originalDataRate(0.0),
+	_originalStartFrame(1),
+	_originalNumFrames(0),
 	_markerNames("")
 {
 }
@@ -61,6 +195,12 @@ MarkerData::MarkerData() :
 MarkerData::MarkerData(const string& aFileName) :
 	_numFrames(0),
 	_numMarkers(0),
+	_firstFrameNumber(1),
+	_dataRate(0.0),
+	_cameraRate(0.0),
+	_originalDataRate(0.0),
+	_originalStartFrame(1),
+	_originalNumFrames(0),
 	_markerNames("")
 {
 
@@ -74,13 +214,15 @@ MarkerData::MarkerData(const string& aFileName) :
    }
 #endif
 
-   /* Check if the suffix is TRC or TRB. Will read TRC by default */
+   /* Check if the suffix is TRC, TRB or STO. */
 	string suffix;
    int dot = (int)aFileName.find_last_of(".");
    suffix.assign(aFileName, dot+1, 3);
    SimTK::String sExtension(suffix);
    if (sExtension.toLower() == "trc") 
       readTRCFile(aFileName, *this);
+   else if (sExtension.toLower() == "trb")
+      readTRBFile(aFileName, *this);
    else if (sExtension.toLower() == "sto")
        readStoFile(aFileName);
    else
@@ -91,12 +233,65 @@ MarkerData::MarkerData(const string& aFileName) :
 	cout << "Loaded marker file " << _fileName << " (" << _numMarkers << " markers, " << _numFrames << " frames)" << endl;
 }
 
+//_____________________________________________________________________________
+/**
+ * Copy constructor. The frames made by getFrame() are not copied.
+ */
+MarkerData::MarkerData(const MarkerData& aMarkerData) :
+	Object(aMarkerData),
+	_markerNames("")
+{
+	copyData(aMarkerData);
+}
+
 //_____________________________________________________________________________
 /**
  * Destructor.
  */
 MarkerData::~MarkerData()
 {
+	deleteFrames();
+}
+
+//_____________________________________________________________________________
+/**
+ * Copy the data members of another MarkerData.
+ */
+void MarkerData::copyData(const MarkerData& aMarkerData)
+{
+	_numFrames = aMarkerData._numFrames;
+	_numMarkers = aMarkerData._numMarkers;
+	_firstFrameNumber = aMarkerData._firstFrameNumber;
+	_dataRate = aMarkerData._dataRate;
+	_cameraRate = aMarkerData._cameraRate;
+	_originalDataRate = aMarkerData._originalDataRate;
+	_originalStartFrame = aMarkerData._originalStartFrame;
+	_originalNumFrames = aMarkerData._originalNumFrames;
+	_fileName = aMarkerData._fileName;
+	_units = aMarkerData._units;
+	_markerNames = aMarkerData._markerNames;
+	_coordinates = aMarkerData._coordinates;
+	_frameTimes = aMarkerData._frameTimes;
+	_frameNumbers = aMarkerData._frameNumbers;
+}
+
+//=============================================================================
+// OPERATORS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Assignment operator.
+ */
+MarkerData& MarkerData::operator=(const MarkerData& aMarkerData)
+{
+	if (&aMarkerData == this)
+		return *this;
+
+	Object::operator=(aMarkerData);
+	deleteFrames();
+	copyData(aMarkerData);
+
+	return *this;
 }
 
 //=============================================================================
@@ -112,10 +307,6 @@ MarkerData::~MarkerData()
 void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 {
    ifstream in;
-   string line, buffer;
-   int frameNum, coordsRead;
-   double time;
-	SimTK::Vec3 coords;
 
 	if (aFileName.empty())
 		throw Exception("MarkerData.readTRCFile: ERROR- Marker file name is empty",__FILE__,__LINE__);
@@ -131,125 +322,91 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 
    readTRCFileHeader(in, aFileName, aSMD);
 
-   /* read frame data */
-   while (getline(in, line))
-   {
-      /* skip over any blank lines */
-      if (findFirstNonWhiteSpace(line) == -1)
-         continue;
-
-		if (aSMD._frames.getSize() == aSMD._numFrames)
-		{
-#if 0
-			if (gUseGlobalMessages)
-			{
-				gErrorBuffer += "Extra data found at end of tracked marker file. ";
-				gErrorBuffer += "Header declared only " + intToString(trc->header.numFrames) + " frames.\n";
-			}
-			rc = smFileWarning;
-#endif
-			break;
-		}
-
-      if (!readIntegerFromString(line, &frameNum))
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += "Could not read frame number in tracked marker file.\n";
-         rc = smFileError;
-         goto cleanup;
-#endif
-      }
-
-      if (!readDoubleFromString(line, &time))
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += "Could not read time in tracked marker file.\n";
-         rc = smFileError;
-         goto cleanup;
-#endif
-      }
+	/* The frame data follow the header. They are parsed in place rather
+	 * than through the stream.
+	 */
+	long long dataOffset = (long long)in.tellg();
+   in.close();
 
-		MarkerFrame *frame = new MarkerFrame(aSMD._numMarkers, frameNum, time, aSMD._units);
+	readTRCFileData(aFileName, dataOffset, aSMD);
+}
 
-      /* keep reading sets of coordinates until the end of the line is
-       * reached. If more coordinates were read than there are markers,
-       * return an error.
-       */
-      coordsRead = 0;
-	  bool allowNaNs = true;
-      while (readCoordinatesFromString(line, &coords[0], allowNaNs))
-      {
-         if (coordsRead >= aSMD._numMarkers)
-         {
-            break;
-
-#if 0  // Don't return an error because many TRC files have extra data at the ends of rows
-            if (gUseGlobalMessages)
-               gErrorBuffer += "Extra data found in frame number " + intToString(frameNum) +
-                               " in tracked marker file.\n";
-            rc = smFileError;
-            // delete the current markerCoordList because framesRead has not been incremented yet.
-            delete [] f->markerCoordList;
-            goto cleanup;
-#endif
-         }
-         if (coordsRead < aSMD._numMarkers)
-				frame->addMarker(coords);
-         coordsRead++;
-      }
+//_____________________________________________________________________________
+/**
+ * Read the frame data of a TRC file by memory mapping the file and parsing
+ * its lines in parallel. Each line holds the frame number, the time, and
+ * the XYZ coordinates of each marker, separated by tabs (see
+ * readTRCCoordinates() for missing markers). Blank lines are skipped, and
+ * lines beyond the number of frames in the header are ignored.
+ *
+ * @param aFileName name of TRC file.
+ * @param aDataOffset offset in bytes of the first frame in the file, or -1
+ * if the file ends with the header.
+ * @param aSMD MarkerData object to hold the file contents
+ */
+void MarkerData::readTRCFileData(const string& aFileName, long long aDataOffset, MarkerData& aSMD)
+{
+	MemoryMappedFile file(aFileName);
+	if (!file.isOpen())
+		throw Exception("Unable to open marker file " + aFileName,__FILE__,__LINE__);
+	const char *end = file.getData() + file.getSize();
+
+	/* Locate the start of each frame. */
+	std::vector<const char*> lineStarts;
+	const char *pos = (aDataOffset < 0 || (size_t)aDataOffset > file.getSize()) ? end : file.getData() + aDataOffset;
+	while (pos < end && (int)lineStarts.size() < aSMD._numFrames)
+	{
+		const char *eol = (const char*)memchr(pos, '\n', end-pos);
+		if (eol == NULL) eol = end;
+		const char *p = pos;
+		while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+		if (p < eol) lineStarts.push_back(pos);
+		pos = eol + 1;
+	}
 
-      if (coordsRead < aSMD._numMarkers)
-      {
-#if 0
-         if (gUseGlobalMessages)
-            gErrorBuffer += " Missing data in frame number " + intToString(frameNum) +
-                            " in tracked marker file.\n";
-         rc = smFileError;
-         // delete the current markerCoordList because framesRead has not been incremented yet.
-         delete [] f->markerCoordList;
-         goto cleanup;
-#endif
-      }
-		aSMD._frames.append(frame);
-   }
+	/* If there are fewer frames than the header declares, keep the ones
+	 * that were found.
+	 */
+	int numFrames = (int)lineStarts.size();
+	aSMD.setSize(numFrames);
+	if (numFrames == 0)
+		return;
 
-   if (aSMD._frames.getSize() < aSMD._numFrames)
-   {
-#if 0
-      if (gUseGlobalMessages)
-         gErrorBuffer += "Missing data in tracked marker file. Only " + intToString(framesRead) + " of " +
-                         intToString(trc->header.numFrames) + " frames found.\n";
-      rc = smFileError;
-      goto cleanup;
-#endif
-		aSMD._numFrames = aSMD._frames.getSize();
-   }
+	/* Small files are not worth the overhead of dispatching threads. */
+	int numChunks = 1;
+	if ((long long)numFrames*aSMD._numMarkers*3 >= 100000)
+	{
+		numChunks = 4*IO::GetNumThreads();
+		if (numChunks > numFrames/256+1) numChunks = numFrames/256+1;
+	}
+	std::vector<std::string> errors(numChunks);
+	ParseFramesTask task(lineStarts, end, aSMD._numMarkers, numChunks, &aSMD._frameNumbers[0],
+		&aSMD._frameTimes[0], aSMD._coordinates.begin(), errors);
+	if (numChunks > 1)
+	{
+		SimTK::ParallelExecutor executor(IO::GetNumThreads());
+		executor.execute(task, numChunks);
+	}
+	else
+	{
+		task.execute(0);
+	}
+	for (int i = 0; i < numChunks; i++)
+	{
+		if (!errors[i].empty())
+			throw Exception("MarkerData: ERROR- " + errors[i] + " in marker file " + aFileName,__FILE__,__LINE__);
+	}
 
    /* If the user-defined frame numbers are not continguous from the first frame to the
     * last, reset them to a contiguous array. This is necessary because the user-defined
     * numbers are used to index the array of frames.
     */
-	if (aSMD._frames[aSMD._numFrames-1]->getFrameNumber() - aSMD._frames[0]->getFrameNumber() !=
-		 aSMD._numFrames - 1)
-   {
-		int firstIndex = aSMD._frames[0]->getFrameNumber();
-      for (int i = 1; i < aSMD._numFrames; i++)
-			aSMD._frames[i]->setFrameNumber(firstIndex + i);
-   }
-
-#if 0
-   if (gUseGlobalMessages)
+	if (aSMD._frameNumbers[numFrames-1] - aSMD._frameNumbers[0] != numFrames - 1)
    {
-      gMessage += "TRC file " + actualFileName + "\n\t" + intToString(trc->header.numFrames)
-                  + " frames\n\t" + intToString(trc->header.numMarkers) + " markers/frame\n";
-      gMessage += "Read " + intToString(framesRead) + " frames.\n";
+		int firstIndex = aSMD._frameNumbers[0];
+      for (int i = 1; i < numFrames; i++)
+			aSMD._frameNumbers[i] = firstIndex + i;
    }
-#endif
-
-//cleanup:
-   in.close();
 }
 
 //_____________________________________________________________________________
@@ -392,83 +549,140 @@ void MarkerData::readTRCFileHeader(ifstream &aStream, const string& aFileName, M
 
 //_____________________________________________________________________________
 /**
- * Read TRB file.
+ * Read TRB file (see printBinary()).
+ *
+ * The file is memory mapped and the frames are copied from it in blocks,
+ * so no parsing is needed.
  *
  * @param aFileName name of file to read.
  * @param aSMD MarkerData object to hold the file contents
  */
 void MarkerData::readTRBFile(const string& aFileName, MarkerData& aSMD)
 {
-#if 0
-   int i, j, index, headerSize, numMarkersThisFrame;
-   unsigned short header[6];
-   long data[100];
-   FILE* file;
-
-   trc->filename = new char [actualFileName.size() + 1];
-   strcpy(trc->filename, actualFileName.c_str());
-
-   readTRBFileHeader(actualFileName, &trc->header, headerSize);
-
-   file = fopen(actualFileName.c_str(), "rb");
-
-   trc->frameList = new smTRCFrame [trc->header.numFrames];
-
-   fseek(file, headerSize, SEEK_SET);
-
-   for (i = 0; i < trc->header.numFrames; i++)
-   {
-      trc->frameList[i].frameNum = i;
-      trc->frameList[i].time = (double) i / trc->header.dataRate;
-      trc->frameList[i].units = trc->header.units;
-
-      trc->frameList[i].numMarkers = trc->header.numMarkers;
-      trc->frameList[i].markerCoordList = new smPoint3 [trc->frameList[i].numMarkers];
-
-      // initialize all the markers to UNDEFINED
-      for (j = 0; j < trc->frameList[i].numMarkers; j++)
-      {
-         trc->frameList[i].markerCoordList[j][0] = UNDEFINED_DOUBLE;
-         trc->frameList[i].markerCoordList[j][1] = UNDEFINED_DOUBLE;
-         trc->frameList[i].markerCoordList[j][2] = UNDEFINED_DOUBLE;
-      }
-
-      // now read the header to see how many markers are present
-      for (j = 0; j < 6; j++)
-         header[j] = _read_binary_unsigned_short(file);
-
-      numMarkersThisFrame = (header[4] - 3) / 6;
-
-      for (j = 0; j < numMarkersThisFrame; j++)
-      {
-         fread(data, 6*4, 1, file);
-
-         // the index of this marker is stored in the first data element
-         index = data[0] - 1;
-
-         // if the index is good, copy the marker coordinates
-         if (index >= 0 && index < trc->frameList[i].numMarkers)
-         {
-            trc->frameList[i].markerCoordList[index][0] = *(float *)(&data[1]);
-            trc->frameList[i].markerCoordList[index][1] = *(float *)(&data[2]);
-            trc->frameList[i].markerCoordList[index][2] = *(float *)(&data[3]);
-         }
-      }
-   }
-
-   goto finish;
-
-//invalid:
-   if (gUseGlobalMessages)
-      gErrorBuffer += "Cannot read " + actualFileName + ". File format is invalid.";
-   return smFormatError;
+	if (aFileName.empty())
+		throw Exception("MarkerData.readTRBFile: ERROR- Marker file name is empty",__FILE__,__LINE__);
+
+	MemoryMappedFile file(aFileName);
+	if (!file.isOpen())
+		throw Exception("Unable to open marker file " + aFileName,__FILE__,__LINE__);
+	const char *begin = file.getData();
+	const char *end = begin + file.getSize();
+
+	/* Preamble */
+	int fields[8];
+	double rates[3];
+	bool ok = file.getSize() >= (size_t)BINARY_PREAMBLE_SIZE &&
+		memcmp(begin, BINARY_FILE_MAGIC, sizeof(BINARY_FILE_MAGIC)) == 0;
+	if (ok)
+	{
+		memcpy(fields, begin+8, sizeof(fields));
+		memcpy(rates, begin+40, sizeof(rates));
+		ok = (unsigned int)fields[1] == BINARY_BYTE_ORDER_MARK;
+	}
+	if (!ok)
+		throw Exception("MarkerData: ERR- File "+aFileName+" does not appear to be a valid TRB file",__FILE__,__LINE__);
+	if (fields[0] < 1 || fields[0] > BinaryVersion)
+		throw Exception("MarkerData: ERROR- unsupported TRB file version in file "+aFileName,__FILE__,__LINE__);
+	int numFrames = fields[3];
+	int numMarkers = fields[4];
+
+	/* Marker names */
+	const char *pos = begin + BINARY_PREAMBLE_SIZE;
+	Array<string> markerNames("");
+	string name;
+	ok = numFrames >= 0 && numMarkers >= 0;
+	for (int i = 0; ok && i < numMarkers; i++)
+	{
+		ok = readString(pos, end, name);
+		markerNames.append(name);
+	}
 
-   smFreeTRCStruct(trc);
+	/* The frames start at the first 64 byte boundary after the names, with
+	 * the times, then the coordinates, then the frame numbers.
+	 */
+	long long dataOffset = ((pos-begin+63)/64)*64;
+	long long bytesPerFrame = sizeof(double) + 3*sizeof(double)*(long long)numMarkers + sizeof(int);
+	ok = ok && dataOffset <= (long long)file.getSize() &&
+		numFrames <= ((long long)file.getSize()-dataOffset)/bytesPerFrame;
+	if (!ok)
+		throw Exception("MarkerData: ERROR- failed to read TRB file "+aFileName,__FILE__,__LINE__);
+
+	aSMD._numMarkers = numMarkers;
+	aSMD._markerNames = markerNames;
+	aSMD._units = Units((Units::UnitType)fields[2]);
+	aSMD._originalStartFrame = fields[5];
+	aSMD._originalNumFrames = fields[6];
+	aSMD._firstFrameNumber = fields[7];
+	aSMD._dataRate = rates[0];
+	aSMD._cameraRate = rates[1];
+	aSMD._originalDataRate = rates[2];
+	aSMD.setSize(numFrames);
+
+	const char *data = begin + dataOffset;
+	size_t numValues = (size_t)numFrames*numMarkers*3;
+	if (numFrames > 0)
+		memcpy(&aSMD._frameTimes[0], data, numFrames*sizeof(double));
+	data += numFrames*sizeof(double);
+	if (numValues > 0)
+		memcpy(aSMD._coordinates.begin(), data, numValues*sizeof(double));
+	data += numValues*sizeof(double);
+	if (numFrames > 0)
+		memcpy(&aSMD._frameNumbers[0], data, numFrames*sizeof(int));
+}
 
-finish:
-   fclose(file);
-   return smNoError;
-#endif
+//_____________________________________________________________________________
+/**
+ * Write the marker data to a binary (TRB) file, which can be read back
+ * much faster than a TRC file since it needs no parsing.
+ *
+ * The file starts with a fixed 64 byte preamble (format identifier,
+ * version, byte order mark, units, number of frames, number of markers,
+ * original start frame, original number of frames, first frame number,
+ * data rate, camera rate, and original data rate), followed by the marker
+ * names. The frames follow at a 64 byte aligned offset as a block of
+ * float64 times, a block of float64 XYZ coordinates (all markers of the
+ * first frame, then all markers of the second frame, and so on), and a
+ * block of int32 frame numbers. Files are written in the byte order of the
+ * machine.
+ *
+ * This is not the Motion Analysis TRB format.
+ *
+ * @param aFileName name of file to write.
+ * @return true if the file was written, false otherwise.
+ */
+bool MarkerData::printBinary(const string& aFileName) const
+{
+	/* Header */
+	std::vector<char> header(BINARY_PREAMBLE_SIZE, 0);
+	memcpy(&header[0], BINARY_FILE_MAGIC, sizeof(BINARY_FILE_MAGIC));
+	int fields[8] = { BinaryVersion, (int)BINARY_BYTE_ORDER_MARK, (int)_units.getType(),
+		_numFrames, _numMarkers, _originalStartFrame, _originalNumFrames, _firstFrameNumber };
+	double rates[3] = { _dataRate, _cameraRate, _originalDataRate };
+	memcpy(&header[8], fields, sizeof(fields));
+	memcpy(&header[40], rates, sizeof(rates));
+	for (int i = 0; i < _numMarkers; i++)
+		appendString(header, _markerNames[i]);
+	header.resize(((header.size()+63)/64)*64, 0);
+
+	FILE *fp = IO::OpenFile(aFileName, "wb");
+	if (fp == NULL)
+		return false;
+	bool ok = fwrite(&header[0], 1, header.size(), fp) == header.size();
+
+	/* Frames */
+	size_t numValues = (size_t)_numFrames*_numMarkers*3;
+	if (ok && _numFrames > 0)
+		ok = fwrite(&_frameTimes[0], sizeof(double), _numFrames, fp) == (size_t)_numFrames;
+	if (ok && numValues > 0)
+		ok = fwrite(_coordinates.begin(), sizeof(double), numValues, fp) == numValues;
+	if (ok && _numFrames > 0)
+		ok = fwrite(&_frameNumbers[0], sizeof(int), _numFrames, fp) == (size_t)_numFrames;
+
+	if (fclose(fp) != 0)
+		ok = false;
+	if (!ok)
+		cout << "MarkerData.printBinary: error writing to " << aFileName << endl;
+	return ok;
 }
 
 //_____________________________________________________________________________
@@ -512,20 +726,19 @@ void MarkerData::readStoFile(const string& aFileName)
 	_fileName = aFileName;
 	_units = Units(Units::Meters);
 
-    double time;
     int sz = store.getSize();
+    setSize(sz);
     for (int i=0; i < sz; i++){
         StateVector* nextRow = store.getStateVector(i);
-        time = nextRow->getTime();
-        int frameNum = i+1;
-        MarkerFrame *frame = new MarkerFrame(_numMarkers, frameNum, time, _units);
+        _frameTimes[i] = nextRow->getTime();
+        _frameNumbers[i] = i+1;
         const Array<double>& rowData = nextRow->getData();
+        Vec3* markers = _coordinates.begin() + (size_t)i*_numMarkers;
         // Cycle thru map and add Marker coordinates to the frame. Same order as header.
         for (iter = markerIndices.begin(); iter != markerIndices.end(); iter++) {
             int startIndex = iter->first; // startIndex includes time but data doesn't!
-            frame->addMarker(SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]));
+            *markers++ = SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]);
         }
-        _frames.append(frame);
    }
    
 }
@@ -570,8 +783,6 @@ void MarkerData::buildMarkerMap(const Storage& storageToReadFrom, std::map<int,
  */
 void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartFrame, int& rEndFrame) const
 {
-	int i;
-
 	rStartFrame = 0;
 	rEndFrame = _numFrames - 1;
 
@@ -580,23 +791,77 @@ void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartF
 		throw Exception("MarkerData: findFrameRange start time is past end time.");
 	}
 
-	for (i = _numFrames - 1; i >= 0 ; i--)
+	if (_numFrames <= 0)
+		return;
+
+	// Last frame at or before the start time
+	int i = findFrameAtOrBefore(aStartTime);
+	if (i >= 0)
+		rStartFrame = i;
+
+	// First frame at or after the end time, but not before the start frame
+	if (_frameTimes[rStartFrame] >= aEndTime - SimTK::Zero)
 	{
-		if (_frames[i]->getFrameTime() <= aStartTime)
-		{
-			rStartFrame = i;
-			break;
-		}
+		rEndFrame = rStartFrame;
+		return;
 	}
 
-	for (i = rStartFrame; i < _numFrames; i++)
+	i = findFrameAtOrBefore(aEndTime - SimTK::Zero);
+	if (_frameTimes[i] < aEndTime - SimTK::Zero)
+		i++;
+	else
+		while (i > rStartFrame && _frameTimes[i-1] >= aEndTime - SimTK::Zero)
+			i--;
+
+	if (i < _numFrames)
+		rEndFrame = i;
+}
+//_____________________________________________________________________________
+/**
+ * Find the index of the last frame whose time is at or before a given time.
+ * Frames are assumed to be in increasing order of time. Since marker data is
+ * almost always sampled at a uniform rate, the frame is first predicted from
+ * the time span of the data, and only if the prediction misses is a binary
+ * search performed. Lookups are therefore O(1) for uniformly sampled data and
+ * O(log n) otherwise.
+ *
+ * @param aTime Time of interest.
+ * @return Index of the frame, or -1 if aTime is before the first frame.
+ */
+int MarkerData::findFrameAtOrBefore(double aTime) const
+{
+	if (_numFrames <= 0 || aTime < _frameTimes[0])
+		return -1;
+
+	int last = _numFrames - 1;
+	double firstTime = _frameTimes[0];
+	double lastTime = _frameTimes[last];
+
+	if (aTime >= lastTime)
+		return last;
+
+	// Uniform sample rate: predict the frame and check it and its neighbors
+	int guess = (int)((aTime - firstTime) / (lastTime - firstTime) * last);
+	if (guess < 0) guess = 0;
+	if (guess > last - 1) guess = last - 1;
+	for (int i = SimTK::max(guess - 1, 0); i <= SimTK::min(guess + 1, last - 1); i++)
 	{
-		if (_frames[i]->getFrameTime() >= aEndTime - SimTK::Zero)
-		{
-			rEndFrame = i;
-			break;
-		}
+		if (_frameTimes[i] <= aTime && _frameTimes[i+1] > aTime)
+			return i;
 	}
+
+	// Binary search keeping time(low) <= aTime < time(high)
+	int low = 0, high = last;
+	while (high - low > 1)
+	{
+		int mid = (low + high) / 2;
+		if (_frameTimes[mid] <= aTime)
+			low = mid;
+		else
+			high = mid;
+	}
+
+	return low;
 }
 //_____________________________________________________________________________
 /**
@@ -610,7 +875,7 @@ double MarkerData::getStartFrameTime() const
 	if (_numFrames<=0)
 		return SimTK::NaN;
 
-	return(_frames[0]->getFrameTime());
+	return(_frameTimes[0]);
 
 }
 /**
@@ -623,7 +888,7 @@ double MarkerData::getLastFrameTime() const
 	if (_numFrames<=0)
 		return SimTK::NaN;
 
-	return(_frames[_numFrames-1]->getFrameTime());
+	return(_frameTimes[_numFrames-1]);
 }
 
 //_____________________________________________________________________________
@@ -650,7 +915,7 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
 	double *minX = NULL, *minY = NULL, *minZ = NULL, *maxX = NULL, *maxY = NULL, *maxZ = NULL;
 
 	findFrameRange(aStartTime, aEndTime, startIndex, endIndex);
-	MarkerFrame *averagedFrame = new MarkerFrame(*_frames[startIndex]);
+	SimTK::Array_<Vec3> averagedMarkers(_numMarkers);
 
 	/* If aThreshold is greater than zero, then calculate
 	 * the movement of each marker so you can check if it
@@ -673,21 +938,21 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
 
 	/* Initialize all the averaged marker locations to 0,0,0. Then
 	 * loop through the frames to be averaged, adding each marker location
-	 * to averagedFrame. Keep track of the min/max XYZ for each marker
+	 * to averagedMarkers. Keep track of the min/max XYZ for each marker
 	 * so you can compare it to aThreshold when you're done.
 	 */
 	for (int i = 0; i < _numMarkers; i++)
 	{
 		int numFrames = 0;
-		Vec3& avePt = averagedFrame->updMarker(i);
+		Vec3& avePt = averagedMarkers[i];
 		avePt = Vec3(0);
 
 		for (int j = startIndex; j <= endIndex; j++)
 		{
-			Vec3& pt = _frames[j]->updMarker(i);
+			const Vec3& pt = getFrameMarkers(j)[i];
 			if (!pt.isNaN())
 			{
-				Vec3& coords = pt; //.get();
+				const Vec3& coords = pt;
 				avePt += coords;
 				numFrames++;
 				if (aThreshold > 0.0)
@@ -718,20 +983,23 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
 	/* Store the indices from the file of the first frame and
 	 * last frame that were averaged, so you can report them later.
 	 */
-	int startUserIndex = _frames[startIndex]->getFrameNumber();
-	int endUserIndex = _frames[endIndex]->getFrameNumber();
+	int startUserIndex = _frameNumbers[startIndex];
+	int endUserIndex = _frameNumbers[endIndex];
+	double startTime = _frameTimes[startIndex];
 
 	/* Now delete all the existing frames and insert the averaged one. */
-	_frames.clearAndDestroy();
-	_frames.append(averagedFrame);
-	_numFrames = 1;
-	_firstFrameNumber = _frames[0]->getFrameNumber();
+	setSize(1);
+	_frameTimes[0] = startTime;
+	_frameNumbers[0] = startUserIndex;
+	for (int i = 0; i < _numMarkers; i++)
+		_coordinates[i] = averagedMarkers[i];
+	_firstFrameNumber = startUserIndex;
 
 	if (aThreshold > 0.0)
 	{
 		for (int i = 0; i < _numMarkers; i++)
 		{
-			Vec3& pt = _frames[0]->updMarker(i);
+			const Vec3& pt = _coordinates[i];
 
 			if (pt.isNaN())
 			{
@@ -788,24 +1056,13 @@ void MarkerData::makeRdStorage(Storage& rStorage)
 	}
 	rStorage.setColumnLabels(columnLabels);
 
-	/* Store the marker coordinates in an array of doubles
-	 * and add it to the Storage.
+	/* The marker coordinates of a frame are already a row of
+	 * doubles, so add them to the Storage directly.
 	 */
 	int numColumns = _numMarkers * 3;
-	double* row = new double [numColumns];
 
 	for (int i = 0; i < _numFrames; i++)
-	{
-		for (int j = 0, index = 0; j < _numMarkers; j++)
-		{
-			SimTK::Vec3& marker = _frames[i]->updMarker(j);
-			for (int k = 0; k < 3; k++)
-				row[index++] = marker[k];
-		}
-		rStorage.append(_frames[i]->getFrameTime(), numColumns, row);
-	}
-
-	delete [] row;
+		rStorage.append(_frameTimes[i], numColumns, (const double*)getFrameMarkers(i));
 }
 
 //_____________________________________________________________________________
@@ -823,8 +1080,8 @@ void MarkerData::convertToUnits(const Units& aUnits)
 	if (!SimTK::isNaN(scaleFactor))
 	{
 		/* Scale all marker locations by the conversion factor. */
-		for (int i = 0; i < _frames.getSize(); i++)
-			_frames[i]->scale(scaleFactor);
+		for (unsigned int i = 0; i < _coordinates.size(); i++)
+			_coordinates[i] *= scaleFactor;
 
 		/* Change the units for this object to the new ones. */
 		_units = aUnits;
@@ -838,17 +1095,57 @@ void MarkerData::convertToUnits(const Units& aUnits)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Get a frame of marker data.
+ * Get a frame of marker data. The frame is made the first time it is
+ * requested and refers to the marker coordinates held by this object, so
+ * getFrameTime() and getFrameMarkers() are cheaper when only the values
+ * are needed.
  *
  * @param aIndex index of the row to get.
- * @return Pointer to the frame of data.
+ * @return Reference to the frame of data.
  */
 const MarkerFrame& MarkerData::getFrame(int aIndex) const
 {
 	if (aIndex < 0 || aIndex >= _numFrames)
 		throw Exception("MarkerData::getFrame() invalid frame index.");
 
-	return *_frames[aIndex];
+	pthread_mutex_lock(&frameLock);
+	if (_frames.empty())
+		_frames.assign(_numFrames, (MarkerFrame*)NULL);
+	MarkerFrame*& frame = _frames[aIndex];
+	if (frame == NULL)
+		frame = new MarkerFrame(_numMarkers, _frameNumbers[aIndex], _frameTimes[aIndex], _units,
+			const_cast<Vec3*>(getFrameMarkers(aIndex)));
+	pthread_mutex_unlock(&frameLock);
+
+	return *frame;
+}
+
+//_____________________________________________________________________________
+/**
+ * Set the number of frames, discarding the frames made by getFrame().
+ * The times, frame numbers, and marker coordinates of the frames are not
+ * initialized.
+ *
+ * @param aNumFrames number of frames.
+ */
+void MarkerData::setSize(int aNumFrames)
+{
+	deleteFrames();
+	_numFrames = aNumFrames;
+	_frameTimes.resize(aNumFrames);
+	_frameNumbers.resize(aNumFrames);
+	_coordinates.resize(aNumFrames*_numMarkers);
+}
+
+//_____________________________________________________________________________
+/**
+ * Delete the frames made by getFrame().
+ */
+void MarkerData::deleteFrames()
+{
+	for (unsigned int i = 0; i < _frames.size(); i++)
+		delete _frames[i];
+	_frames.clear();
 }
 
 //_____________________________________________________________________________
@@ -27,6 +27,7 @@
 // INCLUDE
 #include <iostream>
 #include <string>
+#include <vector>
 #include "osimCommonDLL.h"
 #include "Object.h"
 #include "Storage.h"
@@ -41,6 +42,12 @@ namespace OpenSim {
 /**
  * A class implementing a sequence of marker frames from a TRC/TRB file.
  *
+ * The marker coordinates of all frames are held in one contiguous block,
+ * frame after frame, with the markers of a frame in the order of
+ * getMarkerNames(). TRC files are memory mapped and their lines parsed in
+ * parallel. TRB files hold the same block in binary (see printBinary()), so
+ * they are read without any parsing.
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -62,7 +69,18 @@ private:
 	std::string _fileName;
 	Units _units;
 	Array<std::string> _markerNames;
-	ArrayPtrs<MarkerFrame> _frames;
+	/** Marker coordinates of all frames, _numMarkers per frame. */
+	SimTK::Array_<SimTK::Vec3> _coordinates;
+	/** Time of each frame. */
+	SimTK::Array_<double> _frameTimes;
+	/** Frame number of each frame. */
+	SimTK::Array_<int> _frameNumbers;
+	/** Frames referring to _coordinates, made on demand by getFrame(). */
+	mutable std::vector<MarkerFrame*> _frames;
+	/** Identifies a binary marker (TRB) file. */
+	static const char BINARY_FILE_MAGIC[8];
+	/** Version of the binary marker file format. */
+	static const int BinaryVersion;
 
 //=============================================================================
 // METHODS
@@ -73,13 +91,22 @@ private:
 public:
 	MarkerData();
 	explicit MarkerData(const std::string& aFileName) SWIG_DECLARE_EXCEPTION;
+	MarkerData(const MarkerData& aMarkerData);
 	virtual ~MarkerData();
 
+	MarkerData& operator=(const MarkerData& aMarkerData);
+
 	void findFrameRange(double aStartTime, double aEndTime, int& rStartFrame, int& rEndFrame) const;
 	void averageFrames(double aThreshold = -1.0, double aStartTime = -SimTK::Infinity, double aEndTime = SimTK::Infinity);
 	const std::string& getFileName() const { return _fileName; }
 	void makeRdStorage(Storage& rStorage);
 	const MarkerFrame& getFrame(int aIndex) const;
+	double getFrameTime(int aIndex) const { return _frameTimes[aIndex]; }
+	int getFrameNumber(int aIndex) const { return _frameNumbers[aIndex]; }
+#ifndef SWIG
+	/** Marker coordinates of a frame, in the order of getMarkerNames(). */
+	const SimTK::Vec3* getFrameMarkers(int aIndex) const { return _coordinates.begin() + (size_t)aIndex*_numMarkers; }
+#endif
 	int getMarkerIndex(const std::string& aName) const;
 	const Units& getUnits() const { return _units; }
 	void convertToUnits(const Units& aUnits);
@@ -90,13 +117,19 @@ public:
 	double getLastFrameTime() const;
 	double getDataRate() const { return _dataRate; }
 	double getCameraRate() const { return _cameraRate; }
+	bool printBinary(const std::string& aFileName) const;
 
 private:
 	void readTRCFile(const std::string& aFileName, MarkerData& aSMD);
 	void readTRCFileHeader(std::ifstream &in, const std::string& aFileName, MarkerData& aSMD);
+	void readTRCFileData(const std::string& aFileName, long long aDataOffset, MarkerData& aSMD);
 	void readTRBFile(const std::string& aFileName, MarkerData& aSMD);
     void readStoFile(const std::string& aFileName);
     void buildMarkerMap(const Storage& storageToReadFrom, std::map<int, std::string>& markerNames);
+	int findFrameAtOrBefore(double aTime) const;
+	void setSize(int aNumFrames);
+	void deleteFrames();
+	void copyData(const MarkerData& aMarkerData);
 
 //=============================================================================
 };	// END of class MarkerData
@@ -65,6 +65,28 @@ MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units&
 	setNull();
 }
 
+//_____________________________________________________________________________
+/**
+ * Constructor for a frame whose marker coordinates are held elsewhere (e.g.,
+ * by MarkerData) rather than copied into the frame. The coordinates must
+ * outlive the frame. Copies of the frame own their coordinates.
+ *
+ * @param aNumMarkers the number of markers in the frame
+ * @param aFrameNumber the frame number
+ * @param aTime the time of the frame
+ * @param aUnits the units of the XYZ marker coordinates
+ * @param aMarkers the XYZ coordinates of the aNumMarkers markers
+ */
+MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, const Units& aUnits, SimTK::Vec3* aMarkers) :
+	_numMarkers(aNumMarkers),
+	_frameNumber(aFrameNumber),
+	_frameTime(aTime),
+	_units(aUnits)
+{
+	setNull();
+	_markers.shareData(aMarkers, aMarkers + aNumMarkers);
+}
+
 /**
  * Copy constructor.
  */
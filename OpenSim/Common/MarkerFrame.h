@@ -64,6 +64,7 @@ private:
 public:
 	MarkerFrame();
 	MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units& aUnits);
+	MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, const Units& aUnits, SimTK::Vec3* aMarkers);
 	MarkerFrame(const MarkerFrame& aFrame);
 	virtual ~MarkerFrame();
 
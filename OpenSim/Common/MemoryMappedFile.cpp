@@ -0,0 +1,139 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  MemoryMappedFile.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "MemoryMappedFile.h"
+#include <fstream>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Open a file and make its contents available.
+ *
+ * @param aFileName Name of the file.  Use isOpen() to check whether the
+ * file could be opened.
+ */
+MemoryMappedFile::MemoryMappedFile(const string &aFileName) :
+	_data(NULL),
+	_size(0),
+	_open(false),
+	_mapped(false)
+{
+#ifdef _WIN32
+	_fileHandle = INVALID_HANDLE_VALUE;
+	_mappingHandle = NULL;
+	HANDLE file = CreateFileA(aFileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file!=INVALID_HANDLE_VALUE) {
+		_fileHandle = file;
+		LARGE_INTEGER size;
+		if(GetFileSizeEx(file, &size)) {
+			_size = (size_t)size.QuadPart;
+			_open = true;
+			if(_size>0) {
+				HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+				if(mapping!=NULL) {
+					_mappingHandle = mapping;
+					_data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					_mapped = (_data!=NULL);
+				}
+			}
+		}
+	}
+#else
+	_fd = ::open(aFileName.c_str(), O_RDONLY);
+	if(_fd>=0) {
+		struct stat st;
+		if(fstat(_fd, &st)==0) {
+			_size = (size_t)st.st_size;
+			_open = true;
+			if(_size>0) {
+				void *addr = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+				if(addr!=MAP_FAILED) {
+					_data = (const char*)addr;
+					_mapped = true;
+#ifdef MADV_SEQUENTIAL
+					madvise(addr, _size, MADV_SEQUENTIAL);
+#endif
+				}
+			}
+		}
+	}
+#endif
+
+	// FALL BACK ON READING THE WHOLE FILE
+	if(_open && _size>0 && !_mapped) {
+		close();
+		ifstream in(aFileName.c_str(), ios::in|ios::binary);
+		_open = in.good();
+		if(_open) {
+			_buffer.resize(_size);
+			in.read(&_buffer[0], _size);
+			_size = (size_t)in.gcount();
+			_data = &_buffer[0];
+		}
+	}
+}
+//_____________________________________________________________________________
+/**
+ * Destructor.  Unmaps and closes the file.
+ */
+MemoryMappedFile::~MemoryMappedFile()
+{
+	close();
+}
+//_____________________________________________________________________________
+/**
+ * Release the mapping and the file handle, if any.
+ */
+void MemoryMappedFile::close()
+{
+#ifdef _WIN32
+	if(_mapped) UnmapViewOfFile(_data);
+	if(_mappingHandle!=NULL) CloseHandle((HANDLE)_mappingHandle);
+	if(_fileHandle!=INVALID_HANDLE_VALUE) CloseHandle((HANDLE)_fileHandle);
+	_mappingHandle = NULL;
+	_fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if(_mapped) munmap((void*)_data, _size);
+	if(_fd>=0) ::close(_fd);
+	_fd = -1;
+#endif
+	if(_mapped) _data = NULL;
+	_mapped = false;
+}
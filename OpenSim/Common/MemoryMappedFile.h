@@ -0,0 +1,94 @@
+#ifndef _MemoryMappedFile_h_
+#define _MemoryMappedFile_h_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  MemoryMappedFile.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <string>
+#include <vector>
+
+namespace OpenSim { 
+
+//=============================================================================
+//=============================================================================
+/**
+ * A read-only view of the complete contents of a file.
+ *
+ * The file is memory mapped so that its pages are only brought in when they
+ * are touched, which lets readers of large data files (e.g., Storage) parse
+ * or index the file in place without copying it through a stream.  If the
+ * file cannot be mapped, its contents are read into a buffer instead, so
+ * callers never need to handle the two cases differently.
+ */
+class OSIMCOMMON_API MemoryMappedFile
+{
+//=============================================================================
+// DATA
+//=============================================================================
+private:
+	/** First byte of the file contents. */
+	const char *_data;
+	/** Number of bytes in the file. */
+	size_t _size;
+	/** Whether the file was opened and its contents are available. */
+	bool _open;
+	/** Whether _data refers to a mapping (true) or to _buffer (false). */
+	bool _mapped;
+	/** Contents of the file when it could not be mapped. */
+	std::vector<char> _buffer;
+#ifdef _WIN32
+	void *_fileHandle;
+	void *_mappingHandle;
+#else
+	int _fd;
+#endif
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	explicit MemoryMappedFile(const std::string &aFileName);
+	~MemoryMappedFile();
+
+	/** Was the file opened successfully? */
+	bool isOpen() const { return _open; }
+	/** Is the file accessed through a memory mapping? */
+	bool isMapped() const { return _mapped; }
+	/** First byte of the file contents. */
+	const char* getData() const { return _data; }
+	/** Number of bytes in the file. */
+	size_t getSize() const { return _size; }
+
+private:
+	void close();
+	// Not copyable.
+	MemoryMappedFile(const MemoryMappedFile&);
+	MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+//=============================================================================
+};	// END of class MemoryMappedFile
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif //__MemoryMappedFile_h__
@@ -45,6 +45,27 @@ double** Mtx::_P2Space = NULL;
 double*  Mtx::_WSpace = NULL;
 static const double eps = std::numeric_limits<double>::epsilon();
 
+namespace {
+	// Work space of a single call, on the stack when it is small (as it is
+	// for the 3x3 and 4x4 matrices of the wrapping code) and on the heap
+	// otherwise. Multiply(), Invert() and Transpose() use these rather than
+	// the static work spaces, so that they may be called from several
+	// threads at once.
+	template <class T>
+	class ScratchSpace {
+	public:
+		explicit ScratchSpace(int aN) : _space(aN<=LocalSize ? _local : new T[aN]) {}
+		~ScratchSpace() { if(_space!=_local) delete[] _space; }
+		T* get() { return _space; }
+	private:
+		enum { LocalSize = 64 };
+		T _local[LocalSize];
+		T* _space;
+		ScratchSpace(const ScratchSpace&);
+		ScratchSpace& operator=(const ScratchSpace&);
+	};
+}
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
@@ -362,11 +383,9 @@ Multiply(int aNR1,int aNCR,int aNC2,const double *aM1,const double *aM2,
 	if(aNCR<=0) return(-1);
 	if(aNC2<=0) return(-1);
 
-	// ENSURE WORKSPACE CAPACITY
-	EnsureWorkSpaceCapacity(aNR1*aNC2);
-
-	// SET POINTER INTO WORKSPACE
-	double *m = _WSpace;
+	// WORKSPACE
+	ScratchSpace<double> workSpace(aNR1*aNC2);
+	double *m = workSpace.get();
 
 	// MULTIPLY
 	const double *ij1=NULL,*ij2=NULL;
@@ -414,13 +433,13 @@ Invert(int aN,const double *aM,double *rMInv)
 	double *M,**Mp,**Mr,**Ip,**Ir,*Mrj,*Irj,*Mij,*Iij,d;
 	int r,i,j,n;
 
-	// ENSURE WORKSPACE CAPACITY
-	EnsureWorkSpaceCapacity(aN*aN);
-	EnsurePointerSpaceCapacity(aN);
+	// WORKSPACE
+	ScratchSpace<double> workSpace(aN*aN);
+	ScratchSpace<double*> p1Space(aN), p2Space(aN);
 
 	// INITIALIZE M (A COPY OF aM)
 	n = aN*aN*sizeof(double);
-	M = _WSpace;
+	M = workSpace.get();
 	memcpy(M,aM,n);
 
 	// INITIALIZE rMInv TO THE IDENTITY MATRIX
@@ -428,10 +447,10 @@ Invert(int aN,const double *aM,double *rMInv)
 	for(r=0,Irj=rMInv,n=aN+1;r<aN;r++,Irj+=n)  *Irj=1.0;
 
 	// INITIALIZE ROW POINTERS
-	Mp = _P1Space;		// POINTER TO BEGINNING OF POINTER1 SPACE
-	Mr = _P1Space;		// ROW POINTERS INTO M
-	Ip	= _P2Space;		// POINTER TO BEGINNING OF POINTER2 SPACE
-	Ir = _P2Space;		// ROW POINTERS INTO aMInv
+	Mp = p1Space.get();	// POINTER TO BEGINNING OF POINTER1 SPACE
+	Mr = Mp;		// ROW POINTERS INTO M
+	Ip	= p2Space.get();	// POINTER TO BEGINNING OF POINTER2 SPACE
+	Ir = Ip;		// ROW POINTERS INTO aMInv
 	for(r=0;r<aN;r++,Mr++,Ir++) {
 		i = r*aN;
 		*Mr = M + i;
@@ -501,15 +520,15 @@ Transpose(int aNR,const int aNC,const double *aM,double *rMT)
 	if(aM==NULL) return(-1);
 	if(rMT==NULL) return(-1);
 
-	// ENSURE WORKSPACE CAPACITY
+	// WORKSPACE
 	int n = aNR*aNC;
-	EnsureWorkSpaceCapacity(n);
+	ScratchSpace<double> workSpace(n);
 
 	// SET UP COUNTERS AND POINTERS
 	int r,c;
 	const double *Mrc;
 	double *Mcr;
-	double *MT = _WSpace;
+	double *MT = workSpace.get();
 
 	// TRANSPOSE
 	for(r=0,Mrc=aM;r<aNR;r++) {
@@ -0,0 +1,220 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  NameIndex.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "NameIndex.h"
+#include <pthread.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// STATICS
+//=============================================================================
+bool NameIndex::_enabled = true;
+
+namespace {
+	// Indices are locked through a fixed pool of mutexes chosen by address,
+	// so that the many small arrays of a model need no mutex of their own.
+	const int NUM_LOCKS = 64;
+	pthread_mutex_t indexLocks[NUM_LOCKS];
+	pthread_once_t indexLocksInitialized = PTHREAD_ONCE_INIT;
+
+	void initializeIndexLocks()
+	{
+		for(int i=0;i<NUM_LOCKS;i++) pthread_mutex_init(&indexLocks[i],NULL);
+	}
+
+	pthread_mutex_t* getIndexLock(const void *aIndex)
+	{
+		pthread_once(&indexLocksInitialized,initializeIndexLocks);
+		size_t address = (size_t)aIndex;
+		return(&indexLocks[((address>>4)^(address>>12)) % NUM_LOCKS]);
+	}
+
+	// Holds a mutex for the lifetime of the lock, including when an
+	// exception is thrown.
+	class Lock {
+	public:
+		explicit Lock(pthread_mutex_t *aMutex) : _mutex(aMutex) {
+			pthread_mutex_lock(_mutex);
+		}
+		~Lock() { pthread_mutex_unlock(_mutex); }
+	private:
+		Lock(const Lock&);
+		Lock& operator=(const Lock&);
+		pthread_mutex_t *_mutex;
+	};
+
+	// 32 bit FNV-1a
+	unsigned int hashName(const string &aName)
+	{
+		unsigned int hash = 2166136261u;
+		for(string::size_type i=0;i<aName.size();i++) {
+			hash ^= (unsigned char)aName[i];
+			hash *= 16777619u;
+		}
+		return(hash);
+	}
+}
+
+
+//=============================================================================
+// ENABLING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Enable or disable the use of name indices by all arrays.
+ */
+void NameIndex::
+setEnabled(bool aTrueFalse)
+{
+	_enabled = aTrueFalse;
+}
+
+
+//=============================================================================
+// LOOKUP
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Find an object by name. The table is rebuilt first if the array has
+ * changed size since it was built.
+ *
+ * A name not in the table may belong to an object renamed since the table
+ * was built, so the array is then searched linearly, and the table rebuilt
+ * if the name is found there.
+ *
+ * The table holds the first occurrence of each name. Only if a name occurs
+ * more than once, and its first occurrence precedes aStartIndex, is the rest
+ * of the array searched for a later one.
+ *
+ * @param aNames Names of the objects of the array.
+ * @param aName Name of the object sought.
+ * @param aStartIndex Position at which to start searching.
+ * @return Position of the first object named aName at or following
+ * aStartIndex or, if there is none, of the first object named aName.  If
+ * there is no object named aName, -1 is returned.
+ */
+int NameIndex::
+find(const Names &aNames,const string &aName,int aStartIndex) const
+{
+	Lock lock(getIndexLock(this));
+	if(_size!=aNames.getSize()) build(aNames);
+	int index = search(aNames,aName);
+	if(index<0) {
+		int i;
+		for(i=0;i<_size;i++) if(aNames.getName(i)==aName) break;
+		if(i==_size) return(-1);
+		build(aNames);
+		index = search(aNames,aName);
+	}
+	if(index>=aStartIndex || !_duplicates) return(index);
+
+	for(int i=aStartIndex;i<_size;i++) {
+		if(aNames.getName(i)==aName) return(i);
+	}
+	return(index);
+}
+//_____________________________________________________________________________
+/**
+ * Account for an object appended to the array. The object is added to the
+ * table if the table covered the array before the append and has room for
+ * it; otherwise the table is rebuilt at the next lookup.
+ *
+ * @param aNames Names of the objects of the array, including the new one.
+ * @param aIndex Position of the appended object.
+ */
+void NameIndex::
+appended(const Names &aNames,int aIndex)
+{
+	if(_size<0) return;
+	if(_size!=aIndex || 4*(aIndex+1)>2*(int)_table.size()) {
+		invalidate();
+		return;
+	}
+	place(aNames,aIndex);
+	_size = aIndex+1;
+}
+//_____________________________________________________________________________
+/**
+ * Discard the table; it is rebuilt at the next lookup.
+ */
+void NameIndex::
+invalidate()
+{
+	_size = -1;
+}
+
+//_____________________________________________________________________________
+/**
+ * Build the table for all objects of the array, with room for the array
+ * to double in size by appends before it must be rebuilt.
+ */
+void NameIndex::
+build(const Names &aNames) const
+{
+	int size = aNames.getSize();
+	int tableSize = 32;
+	while(tableSize<4*size) tableSize *= 2;
+	_table.assign(tableSize,-1);
+	_duplicates = false;
+	for(int i=0;i<size;i++) place(aNames,i);
+	_size = size;
+}
+//_____________________________________________________________________________
+/**
+ * Add the object at aIndex to the table, unless an object of the same name
+ * at an earlier position is already there.
+ */
+void NameIndex::
+place(const Names &aNames,int aIndex) const
+{
+	const string &name = aNames.getName(aIndex);
+	unsigned int mask = (unsigned int)_table.size()-1;
+	unsigned int slot = hashName(name) & mask;
+	while(_table[slot]>=0) {
+		if(aNames.getName(_table[slot])==name) {
+			_duplicates = true;
+			return;
+		}
+		slot = (slot+1) & mask;
+	}
+	_table[slot] = aIndex;
+}
+//_____________________________________________________________________________
+/**
+ * Probe the table for aName.
+ */
+int NameIndex::
+search(const Names &aNames,const string &aName) const
+{
+	unsigned int mask = (unsigned int)_table.size()-1;
+	unsigned int slot = hashName(aName) & mask;
+	while(_table[slot]>=0) {
+		if(aNames.getName(_table[slot])==aName) return(_table[slot]);
+		slot = (slot+1) & mask;
+	}
+	return(-1);
+}
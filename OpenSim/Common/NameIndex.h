@@ -0,0 +1,126 @@
+#ifndef _NameIndex_h_
+#define _NameIndex_h_
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  NameIndex.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#pragma warning( disable : 4251 )	// VC2010 no-dll export of std::vector
+#endif
+
+namespace OpenSim { 
+
+//=============================================================================
+//=============================================================================
+/**
+ * A hash index from names to positions in an array of named objects. It is
+ * used by ArrayPtrs, and hence Set, to find objects by name without searching
+ * the whole array.
+ *
+ * The index holds positions only; names are read from the array as it is
+ * probed, so a position found in the table is returned only if the object
+ * there still has the name sought. The owner of the index calls appended()
+ * or invalidate() whenever its array changes, but the index is not told when
+ * objects are renamed (deserialization, for one, names objects after they
+ * are appended). A name missing from the table is therefore searched for
+ * linearly, and if it is found the table is rebuilt. Renamed objects are
+ * thus always found by their new names and never by their old ones.
+ *
+ * Where a name occurs more than once, lookups return the same occurrence as
+ * the linear search of ArrayPtrs::getIndex(), with one exception: if an
+ * object is renamed to the name of another object of the array, lookups of
+ * that name may return either of them until the array next changes.
+ *
+ * Lookups may be made from several threads at once; they are serialized on a
+ * lock held only while the index is searched or rebuilt.
+ */
+class OSIMCOMMON_API NameIndex
+{
+//=============================================================================
+// NESTED CLASSES
+//=============================================================================
+public:
+	/** The names of the objects of the indexed array. */
+	class Names {
+	public:
+		virtual ~Names() {}
+		virtual int getSize() const = 0;
+		virtual const std::string& getName(int aIndex) const = 0;
+	};
+
+//=============================================================================
+// DATA
+//=============================================================================
+public:
+	/** Arrays with fewer objects than this are always searched linearly. */
+	static const int MIN_SIZE = 16;
+
+private:
+	/** Slots of the open addressing table holding array positions, -1 if
+	empty. Its size is a power of two at least twice the array size. */
+	mutable std::vector<int> _table;
+	/** Size of the array covered by the table, -1 if there is no table. */
+	mutable int _size;
+	/** Whether any name occurs more than once in the array. */
+	mutable bool _duplicates;
+
+	static bool _enabled;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+	NameIndex() : _size(-1), _duplicates(false) {}
+	/** Copies start without a table; it is built at their first lookup. */
+	NameIndex(const NameIndex &aIndex) : _size(-1), _duplicates(false) {}
+	NameIndex& operator=(const NameIndex &aIndex) { invalidate(); return(*this); }
+
+	/** Find the position of the first object named aName at or following
+	aStartIndex or, if there is none, the first before it; -1 if none. */
+	int find(const Names &aNames,const std::string &aName,
+		int aStartIndex=0) const;
+	/** Account for an object appended at position aIndex of the array. */
+	void appended(const Names &aNames,int aIndex);
+	/** Discard the table after objects were inserted, removed or replaced. */
+	void invalidate();
+
+	/** Enable or disable the use of indices by all arrays (the default is
+	enabled). Disabled arrays are searched linearly. */
+	static void setEnabled(bool aTrueFalse);
+	static bool getEnabled() { return(_enabled); }
+
+private:
+	void build(const Names &aNames) const;
+	void place(const Names &aNames,int aIndex) const;
+	int search(const Names &aNames,const std::string &aName) const;
+
+//=============================================================================
+};	// END of class NameIndex
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+#endif // _NameIndex_h_
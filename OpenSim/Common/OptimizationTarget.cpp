@@ -32,7 +32,10 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "OptimizationTarget.h"
+#include "Exception.h"
 #include <iostream>
+#include <string>
+#include <vector>
 
 //=============================================================================
 // EXPORTED STATIC CONSTANTS
@@ -54,7 +57,8 @@ const double OptimizationTarget::SMALLDX = 1.0e-14;
  * @param aNX The number of controls.
  */
 OptimizationTarget::
-OptimizationTarget(int aNX)
+OptimizationTarget(int aNX) :
+	_numThreads(1)
 {
 	if(aNX>0) setNumParameters(aNX); // OptimizerSystem
 }
@@ -310,4 +314,154 @@ ForwardDifferences(const OptimizationTarget *aTarget,
 	}
 
 	return(status);
-}
\ No newline at end of file
+}
+//_____________________________________________________________________________
+namespace {
+/* Perturbs one contiguous chunk of the parameters per thread, evaluating the
+ * function on the thread's own copy of the State, and fills in the
+ * corresponding columns of the Jacobian. With a nominal value the
+ * derivatives are forward differences, otherwise central differences. */
+class PerturbParametersTask : public SimTK::ParallelExecutor::Task {
+public:
+	PerturbParametersTask(const OptimizationTarget::StateFunction &aFunction,
+		const SimTK::State &aState,const double *aDX,const Vector &aX,
+		const Vector *aF,int aNumChunks,Matrix &rJacobian,
+		std::vector<int> &rStatus,std::vector<std::string> &rErrors) :
+		_function(aFunction),_state(aState),_dx(aDX),_x(aX),_f(aF),
+		_numChunks(aNumChunks),_jacobian(rJacobian),
+		_status(rStatus),_errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int nx = _x.size();
+		int nc = _jacobian.nrow();
+		int first = (int)(((long long)nx*aChunk)/_numChunks);
+		int last = (int)(((long long)nx*(aChunk+1))/_numChunks);
+		if(first>=last) return;
+
+		try {
+			SimTK::State s = _state;
+			Vector xp=_x;
+			Vector cf(nc),cb(nc);
+			for(int i=first;i<last;i++) {
+
+				// PERTURB FORWARD
+				xp[i] = _x[i] + _dx[i];
+				_status[aChunk] = _function.evaluate(s,xp,cf);
+				if(_status[aChunk]<0) return;
+
+				if(_f) {
+					// FORWARD DIFFERENCES
+					for(int j=0;j<nc;j++) _jacobian(j,i) = (cf[j]-(*_f)[j])/_dx[i];
+				} else {
+					// PERTURB BACKWARD
+					xp[i] = _x[i] - _dx[i];
+					_status[aChunk] = _function.evaluate(s,xp,cb);
+					if(_status[aChunk]<0) return;
+
+					// CENTRAL DIFFERENCES
+					double rdx = 0.5 / _dx[i];
+					for(int j=0;j<nc;j++) _jacobian(j,i) = rdx*(cf[j]-cb[j]);
+				}
+
+				// RESTORE CONTROLS
+				xp[i] = _x[i];
+			}
+		} catch(const std::exception &x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	const OptimizationTarget::StateFunction &_function;
+	const SimTK::State &_state;
+	const double *_dx;
+	const Vector &_x;
+	const Vector *_f;
+	int _numChunks;
+	Matrix &_jacobian;
+	std::vector<int> &_status;
+	std::vector<std::string> &_errors;
+};
+
+int perturbParameters(const OptimizationTarget::StateFunction &aFunction,
+	const SimTK::State &s,const double *dx,const Vector &x,const Vector *f,
+	Matrix &jacobian,int aNumThreads)
+{
+	int nx = x.size(); if(nx<=0) return(-1);
+	if(jacobian.nrow()<=0 || jacobian.ncol()!=nx) return(-1);
+
+	if(aNumThreads<=0) aNumThreads = SimTK::ParallelExecutor::getNumProcessors();
+	if(aNumThreads>nx) aNumThreads = nx;
+
+	std::vector<int> status(aNumThreads,0);
+	std::vector<std::string> errors(aNumThreads);
+	PerturbParametersTask task(aFunction,s,dx,x,f,aNumThreads,jacobian,
+		status,errors);
+	if(aNumThreads>1) {
+		SimTK::ParallelExecutor executor(aNumThreads);
+		executor.execute(task,aNumThreads);
+	} else {
+		task.execute(0);
+	}
+
+	for(int c=0;c<aNumThreads;c++) {
+		if(!errors[c].empty())
+			throw Exception("OptimizationTarget: ERROR- "+errors[c],__FILE__,__LINE__);
+	}
+	for(int c=0;c<aNumThreads;c++) {
+		if(status[c]<0) return(status[c]);
+	}
+	return(0);
+}
+}
+//_____________________________________________________________________________
+/**
+ * Compute the Jacobian of a function of the controls by central differences,
+ * spreading the perturbations of the controls over a pool of threads.  Each
+ * thread evaluates the function on its own copy of the state, so the result
+ * does not depend on the number of threads.  The Jacobian should be
+ * allocated as jacobian(nf,nx).
+ *
+ * @param aFunction Function whose derivatives are computed.
+ * @param s State at which the function is evaluated.
+ * @param dx An array of control perturbation values.
+ * @param x Values of the controls at time t.
+ * @param jacobian The derivatives of the function.
+ * @param aNumThreads Number of threads; 0 uses all processors.
+ *
+ * @return -1 if an error is encountered, 0 otherwize.
+ */
+int OptimizationTarget::
+ParallelCentralDifferences(const StateFunction &aFunction,
+	const SimTK::State &s,const double *dx,const Vector &x,
+	Matrix &jacobian,int aNumThreads)
+{
+	return perturbParameters(aFunction,s,dx,x,NULL,jacobian,aNumThreads);
+}
+//_____________________________________________________________________________
+/**
+ * Compute the Jacobian of a function of the controls by forward differences,
+ * spreading the perturbations of the controls over a pool of threads.  Each
+ * thread evaluates the function on its own copy of the state, so the result
+ * does not depend on the number of threads.  The Jacobian should be
+ * allocated as jacobian(nf,nx).
+ *
+ * @param aFunction Function whose derivatives are computed.
+ * @param s State at which the function is evaluated.
+ * @param dx An array of control perturbation values.
+ * @param x Values of the controls at time t.
+ * @param f Value of the function at x.
+ * @param jacobian The derivatives of the function.
+ * @param aNumThreads Number of threads; 0 uses all processors.
+ *
+ * @return -1 if an error is encountered, 0 otherwize.
+ */
+int OptimizationTarget::
+ParallelForwardDifferences(const StateFunction &aFunction,
+	const SimTK::State &s,const double *dx,const Vector &x,const Vector &f,
+	Matrix &jacobian,int aNumThreads)
+{
+	if(f.size()!=jacobian.nrow()) return(-1);
+	return perturbParameters(aFunction,s,dx,x,&f,jacobian,aNumThreads);
+}
@@ -55,9 +55,30 @@ class OSIMCOMMON_API OptimizationTarget : public SimTK::OptimizerSystem
 public:
 	/** Smallest allowable perturbation size for computing derivatives. */
 	static const double SMALLDX;
+
+	/**
+	 * A vector function of the parameters that is evaluated on a State.
+	 * ParallelCentralDifferences() and ParallelForwardDifferences() call
+	 * evaluate() concurrently, each thread on its own copy of the State, so
+	 * an implementation may change nothing but that State and its result.
+	 * Realizing and computing the forces of an OpenSim Model qualifies, as
+	 * the Model keeps what it computes in the State.
+	 */
+	class OSIMCOMMON_API StateFunction {
+	public:
+		virtual ~StateFunction() {}
+		/** Evaluate the function at x.
+		 * @return Status (normal termination = 0, error < 0). */
+		virtual int evaluate(SimTK::State &s,const SimTK::Vector &x,
+			SimTK::Vector &f) const = 0;
+	};
+
 protected:
 	/** Perturbation size for computing numerical derivatives. */
 	Array<double> _dx;
+	/** Number of threads over which the perturbations of numerical
+	derivatives are spread. */
+	int _numThreads;
 
 //=============================================================================
 // METHODS
@@ -71,6 +92,8 @@ public:
 	void setDX(int aIndex,double aVal);
 	double getDX(int aIndex);
 	double* getDXArray();
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+	int getNumThreads() const { return _numThreads; }
 
 	// UTILITY
 	void validatePerturbationSize(double &aSize);
@@ -87,6 +110,14 @@ public:
 	static int
 		ForwardDifferences(const OptimizationTarget *aTarget,
 		double *dx,const SimTK::Vector &x,SimTK::Vector &dpdx);
+	static int
+		ParallelCentralDifferences(const StateFunction &aFunction,
+		const SimTK::State &s,const double *dx,const SimTK::Vector &x,
+		SimTK::Matrix &jacobian,int aNumThreads=0);
+	static int
+		ParallelForwardDifferences(const StateFunction &aFunction,
+		const SimTK::State &s,const double *dx,const SimTK::Vector &x,
+		const SimTK::Vector &f,SimTK::Matrix &jacobian,int aNumThreads=0);
 
 };
 
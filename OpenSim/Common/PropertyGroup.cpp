@@ -92,7 +92,7 @@ PropertyGroup(const PropertyGroup &aGroup) :
 void PropertyGroup::
 copyData(const PropertyGroup &aGroup)
 {
-	_name = aGroup._name;
+	setName(aGroup._name);
 	_properties = aGroup._properties;
 }
 
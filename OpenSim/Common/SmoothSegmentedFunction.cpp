@@ -37,6 +37,11 @@ static double UTOL = (double)SimTK::Eps*1e2;
 static double INTTOL = (double)SimTK::Eps*1e2;
 static int MAXITER = 20;
 static int NUM_SAMPLE_PTS = 100;
+//Lookup table: intervals per Bezier section are doubled from the minimum up to
+//the maximum, and the error is tested at this many points inside each interval
+static int TABLE_MIN_INTERVALS = 8;
+static int TABLE_MAX_INTERVALS = 4096;
+static int TABLE_TEST_PTS = 8;
 //=============================================================================
 // UTILITY FUNCTIONS
 //=============================================================================
@@ -159,6 +164,10 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
 		_mXVec[s] = mX(s); 
 		_mYVec[s] = mY(s); 
 	}
+
+    _useLookupTable = false;
+    _lookupTableTolerance = SimTK::NaN;
+    _lookupTableMaxError = SimTK::Vec3(SimTK::NaN);
 }
 
  SmoothSegmentedFunction::SmoothSegmentedFunction():
@@ -171,6 +180,9 @@ _x0(x0),_x1(x1),_y0(y0),_y1(y1),_dydx0(dydx0),_dydx1(dydx1),
 		_mYVec.resize(0);
         _splineYintX = SimTK::Spline();
         _numBezierSections = (int)SimTK::NaN;
+        _useLookupTable = false;
+        _lookupTableTolerance = SimTK::NaN;
+        _lookupTableMaxError = SimTK::Vec3(SimTK::NaN);
        
  }
 
@@ -198,7 +210,9 @@ ________________________________________________________________________
 double SmoothSegmentedFunction::calcValue(double x) const
 {
     double yVal = 0;
-    if(x >= _x0 && x <= _x1 )
+    if(_useLookupTable && x >= _x0 && x <= _x1){
+        yVal = calcLookupTable(x,0);
+    }else if(x >= _x0 && x <= _x1 )
     {
         int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
         double u = SegmentedQuinticBezierToolkit::
@@ -266,6 +280,8 @@ double SmoothSegmentedFunction::calcDerivative(double x, int order) const
     
     if(order==0){
                 yVal = calcValue(x);
+    }else if(order <= 2 && _useLookupTable && x >= _x0 && x <= _x1){
+                yVal = calcLookupTable(x,order);
     }else{
             if(x >= _x0 && x <= _x1){        
         		int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
@@ -429,6 +445,318 @@ SimTK::Vec2 SmoothSegmentedFunction::getCurveDomain() const
     return xrange;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Lookup table
+///////////////////////////////////////////////////////////////////////////////
+
+/*Evaluates the order'th derivative with respect to t of the quintic 
+  polynomial with coefficients c at t, using Horner's rule.*/
+static double calcQuintic(const SimTK::Vec6& c, double t, int order)
+{
+    switch(order){
+        case 0: return c[0]+t*(c[1]+t*(c[2]+t*(c[3]+t*(c[4]+t*c[5]))));
+        case 1: return c[1]+t*(2*c[2]+t*(3*c[3]+t*(4*c[4]+t*5*c[5])));
+        default: return 2*c[2]+t*(6*c[3]+t*(12*c[4]+t*20*c[5]));
+    }
+}
+
+/*Computes the coefficients of the quintic polynomial in t on [0,1] that 
+  matches the values, first and second derivatives (with respect to x) of
+  a and b at its ends, for an interval of width h.*/
+static SimTK::Vec6 calcQuinticHermite(const SimTK::Vec3& a, 
+                                      const SimTK::Vec3& b, double h)
+{
+    double dy = b[0]-a[0];
+    double d0 = h*a[1],   d1 = h*b[1];
+    double s0 = h*h*a[2], s1 = h*h*b[2];
+
+    SimTK::Vec6 c;
+    c[0] = a[0];
+    c[1] = d0;
+    c[2] = 0.5*s0;
+    c[3] =  10*dy - 6*d0 - 4*d1 - 1.5*s0 + 0.5*s1;
+    c[4] = -15*dy + 8*d0 + 7*d1 + 1.5*s0 -     s1;
+    c[5] =   6*dy - 3*d0 - 3*d1 - 0.5*s0 + 0.5*s1;
+    return c;
+}
+
+void SmoothSegmentedFunction::
+    calcSectionExact(int s, double x, SimTK::Vec3& yDerivs) const
+{
+    double u = SegmentedQuinticBezierToolkit::
+                calcU(x,_mXVec[s], _arraySplineUX[s], UTOL,MAXITER);
+    yDerivs[0] = SegmentedQuinticBezierToolkit::
+                calcQuinticBezierCurveVal(u,_mYVec[s]);
+    yDerivs[1] = SegmentedQuinticBezierToolkit::
+                calcQuinticBezierCurveDerivDYDX(u,_mXVec[s],_mYVec[s],1);
+    yDerivs[2] = SegmentedQuinticBezierToolkit::
+                calcQuinticBezierCurveDerivDYDX(u,_mXVec[s],_mYVec[s],2);
+}
+
+const SimTK::Vec6& SmoothSegmentedFunction::
+    findLookupTableInterval(double x, double& t, double& invH) const
+{
+    int s = 0;
+    while(s < _numBezierSections-1 && x >= _tableX0[s+1]){
+        s++;
+    }
+
+    const SimTK::Array_<SimTK::Vec6>& coefs = _tableCoefs[s];
+    invH = _tableInvH[s];
+    double xi = (x-_tableX0[s])*invH;
+    int i = (int)xi;
+    if(i < 0){
+        i = 0;
+    }else if(i >= (int)coefs.size()){
+        i = (int)coefs.size()-1;
+    }
+    t = xi-i;
+    return coefs[i];
+}
+
+double SmoothSegmentedFunction::calcLookupTable(double x, int order) const
+{
+    double t, invH;
+    const SimTK::Vec6& coefs = findLookupTableInterval(x, t, invH);
+
+    double yVal = calcQuintic(coefs, t, order);
+    if(order == 1){
+        yVal *= invH;
+    }else if(order == 2){
+        yVal *= invH*invH;
+    }
+    return yVal;
+}
+
+void SmoothSegmentedFunction::buildLookupTable(double tolerance)
+{
+    //The scale of y and of its first two derivatives over the curve domain,
+    //sampled directly from the Bezier curves
+    SimTK::Vec3 scale(1.0);
+    for(int s=0; s < _numBezierSections; s++){
+        for(int i=0; i < NUM_SAMPLE_PTS; i++){
+            double u = ( (double)i )/( (double)(NUM_SAMPLE_PTS-1) );
+            SimTK::Vec3 yDerivs(
+                SegmentedQuinticBezierToolkit::
+                    calcQuinticBezierCurveVal(u,_mYVec[s]),
+                SegmentedQuinticBezierToolkit::
+                    calcQuinticBezierCurveDerivDYDX(u,_mXVec[s],_mYVec[s],1),
+                SegmentedQuinticBezierToolkit::
+                    calcQuinticBezierCurveDerivDYDX(u,_mXVec[s],_mYVec[s],2));
+            for(int k=0; k < 3; k++){
+                scale[k] = max(scale[k], abs(yDerivs[k]));
+            }
+        }
+    }
+    SimTK::Vec3 maxAllowedError = tolerance*scale;
+
+    //The table is built aside, so that the current one is kept if the 
+    //tolerance cannot be met
+    SimTK::Array_<double> tableX0(_numBezierSections);
+    SimTK::Array_<double> tableInvH(_numBezierSections);
+    SimTK::Array_< SimTK::Array_<SimTK::Vec6> > tableCoefs(_numBezierSections);
+    SimTK::Vec3 maxError(0.0);
+
+    SimTK::Array_<SimTK::Vec3> knots;
+    SimTK::Vec3 yExact;
+    for(int s=0; s < _numBezierSections; s++){
+        double xs0 = _mXVec[s](0);
+        double xs1 = _mXVec[s](_mXVec[s].size()-1);
+        bool converged = false;
+
+        for(int n=TABLE_MIN_INTERVALS; n <= TABLE_MAX_INTERVALS && !converged;
+            n *= 2){
+            double h = (xs1-xs0)/n;
+            knots.resize(n+1);
+            for(int i=0; i <= n; i++){
+                calcSectionExact(s, (i < n) ? xs0 + i*h : xs1, knots[i]);
+            }
+
+            SimTK::Array_<SimTK::Vec6>& coefs = tableCoefs[s];
+            coefs.resize(n);
+            for(int i=0; i < n; i++){
+                coefs[i] = calcQuinticHermite(knots[i],knots[i+1],h);
+            }
+
+            //Sample the error between the knots
+            SimTK::Vec3 error(0.0);
+            for(int i=0; i < n; i++){
+                for(int j=1; j <= TABLE_TEST_PTS; j++){
+                    double t = ((double)j)/((double)(TABLE_TEST_PTS+1));
+                    calcSectionExact(s, xs0 + (i+t)*h, yExact);
+                    error[0] = max(error[0], 
+                        abs(calcQuintic(coefs[i],t,0)-yExact[0]));
+                    error[1] = max(error[1], 
+                        abs(calcQuintic(coefs[i],t,1)/h-yExact[1]));
+                    error[2] = max(error[2], 
+                        abs(calcQuintic(coefs[i],t,2)/(h*h)-yExact[2]));
+                }
+            }
+
+            converged = error[0] <= maxAllowedError[0]
+                     && error[1] <= maxAllowedError[1]
+                     && error[2] <= maxAllowedError[2];
+            if(converged){
+                tableX0[s] = xs0;
+                tableInvH[s] = 1.0/h;
+                for(int k=0; k < 3; k++){
+                    maxError[k] = max(maxError[k], error[k]);
+                }
+            }
+        }
+
+        SimTK_ERRCHK3_ALWAYS(converged,
+            "SmoothSegmentedFunction::setUseLookupTable",
+            "%s: a lookup table with %i intervals per section does not meet "
+            "the tolerance of %e; use a larger tolerance",
+            _name.c_str(), TABLE_MAX_INTERVALS, tolerance);
+    }
+
+    _tableX0.swap(tableX0);
+    _tableInvH.swap(tableInvH);
+    _tableCoefs.swap(tableCoefs);
+    _lookupTableTolerance = tolerance;
+    _lookupTableMaxError = maxError;
+}
+
+void SmoothSegmentedFunction::
+    setUseLookupTable(bool useTable, double tolerance)
+{
+    SimTK_ERRCHK2_ALWAYS(tolerance > 0,
+        "SmoothSegmentedFunction::setUseLookupTable",
+        "%s: tolerance must be greater than 0, but %e was entered",
+        _name.c_str(), tolerance);
+    SimTK_ERRCHK1_ALWAYS(!useTable || !_mXVec.empty(),
+        "SmoothSegmentedFunction::setUseLookupTable",
+        "%s: the curve has not been constructed", _name.c_str());
+
+    if(useTable && tolerance != _lookupTableTolerance){
+        buildLookupTable(tolerance);
+    }
+    _useLookupTable = useTable;
+}
+
+bool SmoothSegmentedFunction::getUseLookupTable() const
+{
+    return _useLookupTable;
+}
+
+SimTK::Vec3 SmoothSegmentedFunction::getLookupTableMaxError() const
+{
+    return _lookupTableMaxError;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Batch evaluation
+///////////////////////////////////////////////////////////////////////////////
+
+void SmoothSegmentedFunction::calcValueAndDerivatives(int n, const double* x,
+                        double* y, double* dydx, double* d2ydx2) const
+{
+    const SmoothSegmentedFunction* self = this;
+    calcValueAndDerivatives(n, &self, 0, x, y, dydx, d2ydx2);
+}
+
+void SmoothSegmentedFunction::calcValueAndDerivatives(int n, 
+                        const SmoothSegmentedFunction* const* functions,
+                        const double* x, double* y, 
+                        double* dydx, double* d2ydx2)
+{
+    calcValueAndDerivatives(n, functions, 1, x, y, dydx, d2ydx2);
+}
+
+/*The points are processed in blocks of BATCH_SIZE. Points within the curve
+  domain of a function without a lookup table are inverted once for all the
+  requested quantities. Points that use a lookup table are first gathered 
+  into a structure of arrays (the coefficients of their intervals, their 
+  position within them and the interval widths), which is then evaluated 
+  with the same operations as calcLookupTable by loops without branches, and 
+  the results scattered back. Everything else (the linear extrapolation) 
+  goes through calcValue and calcDerivative.*/
+static const int BATCH_SIZE = 64;
+
+void SmoothSegmentedFunction::calcValueAndDerivatives(int n, 
+                        const SmoothSegmentedFunction* const* functions,
+                        int functionStride, const double* x, double* y, 
+                        double* dydx, double* d2ydx2)
+{
+    double c0[BATCH_SIZE], c1[BATCH_SIZE], c2[BATCH_SIZE], 
+           c3[BATCH_SIZE], c4[BATCH_SIZE], c5[BATCH_SIZE];
+    double t[BATCH_SIZE], invH[BATCH_SIZE], val[BATCH_SIZE];
+    int lane[BATCH_SIZE];
+
+    for(int start=0; start < n; start += BATCH_SIZE){
+        int end = min(n, start+BATCH_SIZE);
+
+        //Gather the points that use a lookup table, evaluate the rest
+        int m = 0;
+        for(int i=start; i < end; i++){
+            const SmoothSegmentedFunction& f = *functions[i*functionStride];
+            double xi = x[i];
+            if(xi >= f._x0 && xi <= f._x1 && f._useLookupTable){
+                const SimTK::Vec6& c = 
+                    f.findLookupTableInterval(xi, t[m], invH[m]);
+                c0[m] = c[0]; c1[m] = c[1]; c2[m] = c[2];
+                c3[m] = c[3]; c4[m] = c[4]; c5[m] = c[5];
+                lane[m] = i;
+                m++;
+            }else if(xi >= f._x0 && xi <= f._x1){
+                int idx  = SegmentedQuinticBezierToolkit::calcIndex(xi,f._mXVec);
+                double u = SegmentedQuinticBezierToolkit::
+                    calcU(xi,f._mXVec[idx], f._arraySplineUX[idx], 
+                    UTOL,MAXITER);
+                if(y != NULL){
+                    y[i] = SegmentedQuinticBezierToolkit::
+                        calcQuinticBezierCurveVal(u,f._mYVec[idx]);
+                }
+                if(dydx != NULL){
+                    dydx[i] = SegmentedQuinticBezierToolkit::
+                        calcQuinticBezierCurveDerivDYDX(u, f._mXVec[idx], 
+                        f._mYVec[idx], 1);
+                }
+                if(d2ydx2 != NULL){
+                    d2ydx2[i] = SegmentedQuinticBezierToolkit::
+                        calcQuinticBezierCurveDerivDYDX(u, f._mXVec[idx], 
+                        f._mYVec[idx], 2);
+                }
+            }else{
+                if(y != NULL)      y[i]      = f.calcValue(xi);
+                if(dydx != NULL)   dydx[i]   = f.calcDerivative(xi,1);
+                if(d2ydx2 != NULL) d2ydx2[i] = f.calcDerivative(xi,2);
+            }
+        }
+
+        //Evaluate the lookup table points
+        if(y != NULL){
+            for(int j=0; j < m; j++){
+                val[j] = c0[j]+t[j]*(c1[j]+t[j]*(c2[j]+t[j]*(c3[j]
+                        +t[j]*(c4[j]+t[j]*c5[j]))));
+            }
+            for(int j=0; j < m; j++){
+                y[lane[j]] = val[j];
+            }
+        }
+        if(dydx != NULL){
+            for(int j=0; j < m; j++){
+                val[j] = (c1[j]+t[j]*(2*c2[j]+t[j]*(3*c3[j]
+                        +t[j]*(4*c4[j]+t[j]*5*c5[j]))))*invH[j];
+            }
+            for(int j=0; j < m; j++){
+                dydx[lane[j]] = val[j];
+            }
+        }
+        if(d2ydx2 != NULL){
+            for(int j=0; j < m; j++){
+                val[j] = (2*c2[j]+t[j]*(6*c3[j]+t[j]*(12*c4[j]
+                        +t[j]*20*c5[j])))*(invH[j]*invH[j]);
+            }
+            for(int j=0; j < m; j++){
+                d2ydx2[lane[j]] = val[j];
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Utility functions
 ///////////////////////////////////////////////////////////////////////////////
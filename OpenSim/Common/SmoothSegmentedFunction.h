@@ -124,6 +124,41 @@ namespace OpenSim {
        */
        double calcDerivative(double x, int order) const;       
 
+       /**Calculates the value and the first and second derivatives of the 
+       curve at n domain points together. The curve is inverted once per 
+       point for all three quantities, and points that are evaluated from the
+       lookup table (see setUseLookupTable) are evaluated as a structure of 
+       arrays in loops without branches, which the compiler vectorizes. The 
+       results agree with those of calcValue and calcDerivative to within 
+       rounding error.
+
+       @param n       The number of domain points
+       @param x       The n domain points of interest
+       @param y       The n values of y(x), or NULL if they are not needed
+       @param dydx    The n values of dy/dx, or NULL if they are not needed
+       @param d2ydx2  The n values of d2y/dx2, or NULL if they are not needed
+       */
+       void calcValueAndDerivatives(int n, const double* x, double* y, 
+                        double* dydx = NULL, double* d2ydx2 = NULL) const;
+
+       /**Calculates the value and the first and second derivatives of a 
+       different curve at each of n domain points together, as above: point i
+       is evaluated on curve functions[i]. This evaluates, for example, the 
+       force-length curves of all the muscles of a model in one pass.
+
+       @param n         The number of domain points
+       @param functions The n curves to evaluate
+       @param x         The n domain points of interest
+       @param y         The n values of y(x), or NULL if they are not needed
+       @param dydx      The n values of dy/dx, or NULL if they are not needed
+       @param d2ydx2    The n values of d2y/dx2, or NULL if they are not 
+                        needed
+       */
+       static void calcValueAndDerivatives(int n, 
+                        const SmoothSegmentedFunction* const* functions,
+                        const double* x, double* y, 
+                        double* dydx = NULL, double* d2ydx2 = NULL);
+
        
 
      
@@ -191,6 +226,61 @@ namespace OpenSim {
                   derivative) linear extrapolation*/
        SimTK::Vec2 getCurveDomain() const;
 
+       /**Enables or disables the evaluation of calcValue and calcDerivative 
+       (up to the second derivative) from a precomputed table. The table 
+       replaces the Newton iteration that inverts x(u) on every call with the 
+       evaluation of a single polynomial, and is built the first time it is 
+       enabled (or when the tolerance changes).
+
+       <B>Accuracy</B>
+       Each Bezier section is divided into intervals of equal width, and on 
+       each interval y(x) is replaced by the quintic polynomial that matches
+       the exact y, dy/dx and d2y/dx2 at both of its ends. The table is 
+       therefore C2 continuous and exact at every interval end. The number of
+       intervals in a section is doubled until, sampled at 8 points inside 
+       every interval, the errors of the value and of the first and second 
+       derivatives against the exact curve satisfy
+
+       \verbatim
+            |error in d^k y/dx^k| <= tolerance * max(1, max|d^k y/dx^k|)
+                                                               for k = 0,1,2
+       \endverbatim
+
+       where the maximum is taken over the curve domain, so that the tolerance
+       is relative to the scale of each quantity. This is an estimate from 
+       the samples, not a bound: the error between the samples can be larger,
+       though as it varies smoothly (as h^6, h^5 and h^4 for an interval width
+       h) it stays close to the sampled maximum, and the curve tests accept 
+       twice the tolerance. The largest errors sampled are returned by 
+       getLookupTableMaxError(). Outside the curve domain the linear 
+       extrapolation is evaluated exactly, as without the table, and 
+       derivatives higher than the second are always computed exactly.
+
+       <B>Computational Costs</B>
+       \verbatim
+            x in curve domain  : ~25 flops (value), ~30 flops (derivative)
+            building the table : ~3,000 flops per interval
+       \endverbatim
+
+       @param useTable  true to evaluate from the table, false to evaluate 
+                        the Bezier curves exactly
+       @param tolerance the relative error tolerance described above
+       @throws OpenSim::Exception
+        -If tolerance is not greater than 0
+        -If the tolerance cannot be met with 4096 intervals per section, in
+         which case the curve is left as it was
+       */
+       void setUseLookupTable(bool useTable, double tolerance = 1e-8);
+
+       /**@return true if calcValue and calcDerivative are evaluated from 
+       the precomputed table (see setUseLookupTable)*/
+       bool getUseLookupTable() const;
+
+       /**@return the largest errors of the value, first and second derivative
+       of the lookup table sampled against the exact curve while the table was
+       built, or NaN if no table has been built*/
+       SimTK::Vec3 getLookupTableMaxError() const;
+
        /**This function will generate a csv file (of 'name_curveName.csv', where 
        name is the one used in the constructor) of the muscle curve, and 
        'curveName' corresponds to the function that was called from
@@ -338,6 +428,46 @@ namespace OpenSim {
         bool _intx0x1;
         /**The name of the function**/
         std::string _name;
+
+        /**True when calcValue and calcDerivative (up to the second 
+        derivative) are evaluated from the lookup table*/
+        bool _useLookupTable;
+        /**The tolerance the lookup table was built to, or NaN if no table 
+        has been built*/
+        double _lookupTableTolerance;
+        /**The largest errors of the value, first and second derivative of 
+        the lookup table sampled while it was built*/
+        SimTK::Vec3 _lookupTableMaxError;
+        /**For each Bezier section, the x at which its table starts and the
+        reciprocal of the width of its intervals*/
+        SimTK::Array_<double> _tableX0;
+        SimTK::Array_<double> _tableInvH;
+        /**For each Bezier section, the coefficients of the quintic polynomial
+        y(t) on each interval, where t goes from 0 to 1 over the interval*/
+        SimTK::Array_< SimTK::Array_<SimTK::Vec6> > _tableCoefs;
+
+        /**Builds the lookup table to the given tolerance, replacing the 
+        current table only if it succeeds. Refer to setUseLookupTable for 
+        details*/
+        void buildLookupTable(double tolerance);
+
+        /**Evaluates y(x) or its first or second derivative, where x is within
+        the Bezier section s, exactly or from the lookup table*/
+        void calcSectionExact(int s, double x, SimTK::Vec3& yDerivs) const;
+        double calcLookupTable(double x, int order) const;
+
+        /**Finds the lookup table interval that contains x, which must be in
+        the curve domain, returning its coefficients, the position t of x
+        within it and the reciprocal of its width*/
+        const SimTK::Vec6& findLookupTableInterval(double x, double& t, 
+                                                   double& invH) const;
+
+        /**Implements calcValueAndDerivatives, where point i is evaluated on 
+        curve functions[i*functionStride]*/
+        static void calcValueAndDerivatives(int n, 
+                        const SmoothSegmentedFunction* const* functions,
+                        int functionStride, const double* x, double* y, 
+                        double* dydx, double* d2ydx2);
             
         /**No human should be constructing a SmoothSegmentedFunction, so the
         constructor is made private so that mere mortals cannot look at it. 
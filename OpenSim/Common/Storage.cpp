@@ -36,7 +36,10 @@
 #include "GCVSplineSet.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
+#include "MemoryMappedFile.h"
 #include "SimTKcommon.h"
+#include <cstring>
+#include <climits>
 
 using namespace OpenSim;
 using namespace std;
@@ -71,6 +74,270 @@ int numSimmReservedKeys=10;	// Keep this number in sync with above array size
 // up version to 20301 for separation of RRATool, CMCTool
 const int Storage::LatestVersion = 1;	
 
+// Binary storage files start with these 8 bytes.
+const char Storage::BINARY_FILE_MAGIC[8] = { 'O','S','I','M','S','T','O','B' };
+const int Storage::BinaryVersion = 1;
+
+//============================================================================
+// FILE PARSING
+//============================================================================
+namespace {
+/** Size in bytes of the fixed part of a binary storage file header. */
+const int BINARY_PREAMBLE_SIZE = 64;
+/** Written in native byte order so that a reader can detect a mismatch. */
+const unsigned int BINARY_BYTE_ORDER_MARK = 0x01020304;
+
+void appendBytes(std::vector<char> &rBuffer,const void *aBytes,size_t aSize)
+{
+	const char *bytes = (const char*)aBytes;
+	rBuffer.insert(rBuffer.end(),bytes,bytes+aSize);
+}
+void appendString(std::vector<char> &rBuffer,const std::string &aString)
+{
+	int size = (int)aString.size();
+	appendBytes(rBuffer,&size,sizeof(size));
+	appendBytes(rBuffer,aString.data(),aString.size());
+}
+bool readString(const char *&rPos,const char *aEnd,std::string &rString)
+{
+	int size;
+	if(aEnd-rPos<(long long)sizeof(size)) return(false);
+	memcpy(&size,rPos,sizeof(size));
+	rPos += sizeof(size);
+	if(size<0 || aEnd-rPos<size) return(false);
+	rString.assign(rPos,size);
+	rPos += size;
+	return(true);
+}
+
+/**
+ * Parses a block of data lines of a storage file straight into the columnar
+ * buffers of a Storage: the time (or the row index, if the file has no time
+ * column) of each row into one array and the remaining values column-major
+ * into another.  The lines are split into contiguous chunks so that each
+ * chunk can be parsed by a separate thread.
+ */
+class ParseLinesTask : public SimTK::ParallelExecutor::Task {
+public:
+	ParseLinesTask(const std::vector<const char*> &aLineStarts,const char *aEnd,
+		int aNumColumns,bool aHasTime,int aNumChunks,double *rTimes,
+		double *rData,int aCapacity,std::vector<char> &rFailed) :
+		_lineStarts(aLineStarts),_end(aEnd),_nc(aNumColumns),
+		_hasTime(aHasTime),_numChunks(aNumChunks),_times(rTimes),
+		_data(rData),_capacity(aCapacity),_failed(rFailed) {}
+
+	void execute(int aChunk) {
+		int nr = (int)_lineStarts.size();
+		int first = (int)(((long long)nr*aChunk)/_numChunks);
+		int last = (int)(((long long)nr*(aChunk+1))/_numChunks);
+		int ny = _hasTime ? _nc-1 : _nc;
+		for(int r=first;r<last;r++) {
+			const char *pos = _lineStarts[r];
+			const char *eol = (const char*)memchr(pos,'\n',_end-pos);
+			if(eol==NULL) eol = _end;
+			if(!_hasTime) _times[r] = (double)r;
+			else if(!OpenSim::IO::ParseDouble(pos,eol,_times[r])) {
+				_failed[aChunk] = 1;
+				return;
+			}
+			double *y = _data + r;
+			for(int c=0;c<ny;c++,y+=_capacity) {
+				if(!OpenSim::IO::ParseDouble(pos,eol,*y)) {
+					_failed[aChunk] = 1;
+					return;
+				}
+			}
+			// Only trailing white space may follow the last value.
+			for(;pos<eol;pos++) {
+				if(*pos!=' ' && *pos!='\t' && *pos!='\r') {
+					_failed[aChunk] = 1;
+					return;
+				}
+			}
+		}
+	}
+
+private:
+	const std::vector<const char*> &_lineStarts;
+	const char *_end;
+	int _nc;
+	bool _hasTime;
+	int _numChunks;
+	double *_times;
+	double *_data;
+	int _capacity;
+	std::vector<char> &_failed;
+};
+
+/**
+ * Applies one of the filters of Signal to each column of columnar data, in
+ * place.  The columns are split into contiguous chunks so that each chunk
+ * can be filtered by a separate thread.  Every column is filtered exactly
+ * as it would be on its own, so the result does not depend on the number
+ * of chunks.
+ */
+class FilterColumnsTask : public SimTK::ParallelExecutor::Task {
+public:
+	enum Filter { SMOOTH_SPLINE, LOWPASS_IIR, LOWPASS_FIR };
+
+	FilterColumnsTask(Filter aFilter,int aOrder,double aDT,double aCutoffFrequency,
+		int aSize,const double *aTimes,double *rData,int aCapacity,
+		int aNumColumns,int aNumChunks,std::vector<std::string> &rErrors) :
+		_filter(aFilter),_order(aOrder),_dt(aDT),_cutoff(aCutoffFrequency),
+		_size(aSize),_times(aTimes),_data(rData),_capacity(aCapacity),
+		_nc(aNumColumns),_numChunks(aNumChunks),_errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int first = (int)(((long long)_nc*aChunk)/_numChunks);
+		int last = (int)(((long long)_nc*(aChunk+1))/_numChunks);
+		// Like the filtered column of the serial loop, the output is reused
+		// from one column to the next.
+		std::vector<double> filt(_size,0.0);
+		try {
+			for(int c=first;c<last;c++) {
+				double *signal = _data + (size_t)c*_capacity;
+				switch(_filter) {
+				case SMOOTH_SPLINE:
+					Signal::SmoothSpline(_order,_dt,_cutoff,_size,
+						const_cast<double*>(_times),signal,&filt[0]);
+					break;
+				case LOWPASS_IIR:
+					Signal::LowpassIIR(_dt,_cutoff,_size,signal,&filt[0]);
+					break;
+				case LOWPASS_FIR:
+					Signal::LowpassFIR(_order,_dt,_cutoff,_size,signal,&filt[0]);
+					break;
+				}
+				memcpy(signal,&filt[0],_size*sizeof(double));
+			}
+		} catch(const std::exception &x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	Filter _filter;
+	int _order;
+	double _dt;
+	double _cutoff;
+	int _size;
+	const double *_times;
+	double *_data;
+	int _capacity;
+	int _nc;
+	int _numChunks;
+	std::vector<std::string> &_errors;
+};
+
+/**
+ * Pads each column of columnar data (see Signal::Pad()) into a new
+ * column-major buffer.  The columns are split into contiguous chunks so
+ * that each chunk can be padded by a separate thread.
+ */
+class PadColumnsTask : public SimTK::ParallelExecutor::Task {
+public:
+	PadColumnsTask(int aPadSize,int aSize,const double *aData,int aCapacity,
+		int aNumColumns,int aNumChunks,int aNewSize,double *rPadded) :
+		_padSize(aPadSize),_size(aSize),_data(aData),_capacity(aCapacity),
+		_nc(aNumColumns),_numChunks(aNumChunks),_newSize(aNewSize),
+		_padded(rPadded) {}
+
+	void execute(int aChunk) {
+		int first = (int)(((long long)_nc*aChunk)/_numChunks);
+		int last = (int)(((long long)_nc*(aChunk+1))/_numChunks);
+		OpenSim::Array<double> signal(0.0,_size);
+		for(int c=first;c<last;c++) {
+			signal.setSize(_size);
+			memcpy(signal.get(),_data+(size_t)c*_capacity,_size*sizeof(double));
+			Signal::Pad(_padSize,signal);
+			memcpy(_padded+(size_t)c*_newSize,signal.get(),_newSize*sizeof(double));
+		}
+	}
+
+private:
+	int _padSize;
+	int _size;
+	const double *_data;
+	int _capacity;
+	int _nc;
+	int _numChunks;
+	int _newSize;
+	double *_padded;
+};
+
+/**
+ * Evaluates the splines of a GCVSplineSet at a sequence of times, one
+ * column of columnar data per spline.  The columns are split into
+ * contiguous chunks so that each chunk can be evaluated by a separate
+ * thread.
+ */
+class EvaluateSplinesTask : public SimTK::ParallelExecutor::Task {
+public:
+	EvaluateSplinesTask(const GCVSplineSet &aSplineSet,const double *aTimes,
+		int aSize,double *rData,int aCapacity,int aNumColumns,int aNumChunks,
+		std::vector<std::string> &rErrors) :
+		_splineSet(aSplineSet),_times(aTimes),_size(aSize),_data(rData),
+		_capacity(aCapacity),_nc(aNumColumns),_numChunks(aNumChunks),
+		_errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int first = (int)(((long long)_nc*aChunk)/_numChunks);
+		int last = (int)(((long long)_nc*(aChunk+1))/_numChunks);
+		SimTK::Vector x(1);
+		try {
+			for(int c=first;c<last;c++) {
+				const OpenSim::Function &spline = _splineSet.get(c);
+				double *y = _data + (size_t)c*_capacity;
+				for(int r=0;r<_size;r++) {
+					x[0] = _times[r];
+					y[r] = spline.calcValue(x);
+				}
+			}
+		} catch(const std::exception &x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	const GCVSplineSet &_splineSet;
+	const double *_times;
+	int _size;
+	double *_data;
+	int _capacity;
+	int _nc;
+	int _numChunks;
+	std::vector<std::string> &_errors;
+};
+
+/**
+ * Executes aNumChunks chunks of a task on IO::GetNumThreads() threads, or
+ * on the calling thread when there is only one chunk.
+ */
+void executeChunks(SimTK::ParallelExecutor::Task &aTask,int aNumChunks)
+{
+	if(aNumChunks>1) {
+		SimTK::ParallelExecutor executor(OpenSim::IO::GetNumThreads());
+		executor.execute(aTask,aNumChunks);
+	} else {
+		for(int i=0;i<aNumChunks;i++) aTask.execute(i);
+	}
+}
+
+/**
+ * Number of chunks in which to process aNumColumns columns.  Each column
+ * is a unit of work, so there is no point in more chunks than threads.
+ */
+int numColumnChunks(int aNumColumns)
+{
+	int numChunks = OpenSim::IO::GetNumThreads();
+	if(numChunks>aNumColumns) numChunks = aNumColumns;
+	if(numChunks<1) numChunks = 1;
+	return(numChunks);
+}
+}
+
 //=============================================================================
 // DESTRUCTOR
 //=============================================================================
@@ -82,6 +349,8 @@ const int Storage::LatestVersion = 1;
  */
 Storage::~Storage()
 {
+	delete _mappedFile;
+	discardFlushedRows();
 }
 
 //=============================================================================
@@ -121,6 +390,12 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
 	// SET NULL STATES
 	setNull();
 
+	// BINARY FILE
+	if(IsBinaryFile(aFileName)) {
+		readBinary(aFileName,readHeadersOnly);
+		return;
+	}
+
 	// OPEN FILE
 	ifstream *fp = IO::OpenInputFile(aFileName);
 	if(fp==NULL) throw Exception("Storage: ERROR- failed to open file " + aFileName, __FILE__,__LINE__);
@@ -163,8 +438,15 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
 	int indexRange = currentLabels.findIndex("range");
 
 
-	// DATA	
-	if(indexTime != -1 || indexRange != -1){ //MM edit
+	// DATA
+	// Try the memory-mapped, multi-threaded reader first.  It handles the
+	// regular one-row-per-line layout written by OpenSim; anything else
+	// falls through to the stream based reader below.
+	bool hasTime = (indexTime != -1 || indexRange != -1);
+	long long dataOffset = (long long)fp->tellg();
+	if(dataOffset>=0 && readDataFast(aFileName,dataOffset,nr,nc,hasTime)) {
+		delete fp;
+	}else if(hasTime){ //MM edit
 		int ny = nc-1;
 		double time;
 		double *y = new double[ny];
@@ -227,6 +509,7 @@ Storage::Storage(const Storage &aStorage,bool aCopyData) :
 	_fileVersion = aStorage._fileVersion;
 	// COPY STORED DATA
 	if(aCopyData) copyData(aStorage);
+	else if(aStorage.isColumnar()) setColumnar(true);
 }
 //_____________________________________________________________________________
 /**
@@ -265,7 +548,7 @@ Storage(const Storage &aStorage,int aStateIndex,int aN,
 	// SET THE DATA
 	int i,n;
 	double time,*data = new double[aN];
-	for(i=0;i<aStorage._storage.getSize();i++) {
+	for(i=0;i<aStorage.getSize();i++) {
 		aStorage.getTime(i,time);
 		n = aStorage.getData(i,aStateIndex,aN,data);
 		append(time,n,data);
@@ -312,9 +595,20 @@ setNull()
 	_writeSIMMHeader = false;
 	setHeaderToken(DEFAULT_HEADER_TOKEN);
 	_stepInterval = 1;
-	_lastI = 0;
 	_fp = 0;
 	_inDegrees = false;
+	_columnar = false;
+	_columnarSize = 0;
+	_columnarCapacity = 0;
+	_columnarWidth = -1;
+	_mappedFile = NULL;
+	_mappedTimes = NULL;
+	_mappedData = NULL;
+	_flushInterval = 0;
+	_flushFile = NULL;
+	_numFlushedRows = 0;
+	_flushedFirstTime = SimTK::NaN;
+	_flushedMinStates = 0;
 }
 //_____________________________________________________________________________
 /**
@@ -333,16 +627,188 @@ copyData(const Storage &aStorage)
 	_units = aStorage._units;
 	setInDegrees(aStorage.isInDegrees());
 
+	// ROWS FLUSHED FROM aStorage- READ THEM BACK, THEN APPEND THE REST
+	if(aStorage._numFlushedRows>0) {
+		if(&aStorage==this) return;
+		purge();
+		aStorage.appendFlushedRows(*this);
+		std::vector<double> rowBuffer(aStorage._columnar ? aStorage._columnarWidth : 0);
+		for(int i=0;i<aStorage.getSize();i++) {
+			int n = aStorage._columnar ? aStorage._columnarWidth : aStorage._storage[i].getSize();
+			append(aStorage.getTimeAt(i),n,aStorage.getRowData(i,rowBuffer.data()),false);
+		}
+		return;
+	}
+
+	// COLUMNAR SOURCE- COPY THE BUFFERS WITHOUT UNPACKING aStorage
+	if(aStorage._columnar) {
+		if(&aStorage==this) return;
+		_storage.setSize(0);
+		delete _mappedFile;
+		_mappedFile = NULL;
+		_columnar = true;
+		_columnarSize = aStorage._columnarSize;
+		_columnarCapacity = aStorage._columnarCapacity;
+		_columnarWidth = aStorage._columnarWidth;
+		int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+		const double *times = aStorage.columnarTimes();
+		const double *data = aStorage.columnarData();
+		_columnarTimes.assign(times,times+_columnarCapacity);
+		_columnarData.assign(data,data+nc*_columnarCapacity);
+		return;
+	}
+
 	// ENSURE CAPACITY
-	_storage.ensureCapacity(aStorage._storage.getCapacity());
+	rows().ensureCapacity(aStorage._storage.getCapacity());
 
 	// COPY
 	//rdPtrArray::reset();
-	_storage.setSize(0);
+	rows().setSize(0);
 	for(int i=0;i<aStorage._storage.getSize();i++) {
-		_storage.append(aStorage._storage[i]);
+		rows().append(aStorage._storage[i]);
 	}
 }
+//_____________________________________________________________________________
+/**
+ * Move the stored StateVectors into the contiguous columnar buffers.
+ *
+ * @return true if the data are now columnar; false if the stored rows do
+ * not all have the same number of states, in which case nothing is changed.
+ */
+bool Storage::
+packColumns() const
+{
+	if(_columnar) return(true);
+
+	// ALL ROWS MUST HAVE THE SAME WIDTH
+	int nr = _storage.getSize();
+	int nc = (nr>0) ? _storage[0].getSize() : -1;
+	for(int r=1;r<nr;r++) {
+		if(_storage[r].getSize()!=nc) return(false);
+	}
+
+	// FILL THE BUFFERS
+	_columnarSize = 0;
+	_columnarWidth = nc;
+	_columnarCapacity = 0;
+	_columnarTimes.clear();
+	_columnarData.clear();
+	ensureColumnarCapacity(nr);
+	for(int r=0;r<nr;r++) {
+		const StateVector &vec = _storage[r];
+		_columnarTimes[r] = vec.getTime();
+		const double *y = vec.getData().get();
+		for(int c=0;c<nc;c++) _columnarData[c*_columnarCapacity+r] = y[c];
+	}
+	_columnarSize = nr;
+
+	// RELEASE THE STATEVECTORS
+	int increment = _storage.getCapacityIncrement();
+	_storage = Array<StateVector>(StateVector());
+	_storage.setCapacityIncrement(increment);
+
+	_columnar = true;
+	return(true);
+}
+//_____________________________________________________________________________
+/**
+ * Move the data held in the columnar buffers back into StateVectors.  This
+ * is done whenever a caller needs direct access to the StateVectors, since
+ * those may be modified in place.
+ */
+void Storage::
+unpackColumns() const
+{
+	if(!_columnar) return;
+	_columnar = false;
+
+	int nr = _columnarSize;
+	int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+	_storage.setSize(0);
+	_storage.ensureCapacity(nr);
+	StateVector vec;
+	vec.getData().setSize(nc);
+	double *y = vec.getData().get();
+	for(int r=0;r<nr;r++) {
+		vec.setTime(columnarTimes()[r]);
+		for(int c=0;c<nc;c++) y[c] = columnarData()[c*_columnarCapacity+r];
+		_storage.append(vec);
+	}
+
+	// RELEASE THE BUFFERS
+	delete _mappedFile;
+	_mappedFile = NULL;
+	_columnarSize = 0;
+	_columnarCapacity = 0;
+	_columnarWidth = -1;
+	std::vector<double>().swap(_columnarTimes);
+	std::vector<double>().swap(_columnarData);
+}
+//_____________________________________________________________________________
+/**
+ * Make sure the columnar buffers can hold at least aCapacity rows.  The
+ * capacity is at least doubled when the buffers have to grow, so appending
+ * row after row has amortized constant cost.
+ */
+void Storage::
+ensureColumnarCapacity(int aCapacity) const
+{
+	releaseMappedFile();
+	int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+	bool sized = ((int)_columnarData.size()==nc*_columnarCapacity);
+	if(sized && aCapacity<=_columnarCapacity) return;
+
+	int newCapacity = 2*_columnarCapacity;
+	if(newCapacity<aCapacity) newCapacity = aCapacity;
+	if(newCapacity<Storage_DEFAULT_CAPACITY) newCapacity = Storage_DEFAULT_CAPACITY;
+
+	// COPY THE EXISTING ROWS COLUMN BY COLUMN
+	std::vector<double> data(nc*newCapacity);
+	if(sized) {
+		for(int c=0;c<nc;c++) {
+			if(_columnarSize>0) memcpy(&data[c*newCapacity],
+				&_columnarData[c*_columnarCapacity],_columnarSize*sizeof(double));
+		}
+	}
+	_columnarData.swap(data);
+	_columnarTimes.resize(newCapacity);
+	_columnarCapacity = newCapacity;
+}
+//_____________________________________________________________________________
+/**
+ * Get the states of a row.  The returned pointer refers either to the data
+ * of the row's StateVector or, for columnar data, to rBuffer after the row
+ * has been gathered into it.
+ *
+ * @param aTimeIndex Time index (row) of the states.
+ * @param rBuffer Buffer able to hold a full row; only used when columnar.
+ */
+const double* Storage::
+getRowData(int aTimeIndex,double *rBuffer) const
+{
+	if(!_columnar) return(_storage[aTimeIndex].getData().get());
+	const double *y = columnarData() + aTimeIndex;
+	for(int c=0;c<_columnarWidth;c++,y+=_columnarCapacity) rBuffer[c] = *y;
+	return(rBuffer);
+}
+//_____________________________________________________________________________
+/**
+ * Copy columnar data that are still read from a memory-mapped binary file
+ * (see readBinary()) into the columnar buffers and close the file.  This
+ * must be done before the data are modified.
+ */
+void Storage::
+releaseMappedFile() const
+{
+	if(_mappedFile==NULL) return;
+	int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+	_columnarTimes.assign(_mappedTimes,_mappedTimes+_columnarCapacity);
+	_columnarData.assign(_mappedData,_mappedData+nc*_columnarCapacity);
+	delete _mappedFile;
+	_mappedFile = NULL;
+	_mappedTimes = NULL;
+	_mappedData = NULL;
+}
 
 
 
@@ -467,28 +933,19 @@ parseColumnLabels(const char *aLabels)
 	int len = (int)strlen(aLabels);
 	if(len==0) return;
 
-	// SET NEW
-	char *labelsCopy = new char[len+1];
-	if(aLabels[len-1]=='\n') { 
-		// strip carriage return 
-		strncpy(labelsCopy,aLabels,len-1);
-		labelsCopy[len-1] = 0;
-	} else {
-		strcpy(labelsCopy,aLabels);
-	}
-
-	// Parse 
-	char *token = strtok(labelsCopy,DEFAULT_HEADER_SEPARATOR );
-	while(token!=NULL)
+	// Parse (without strtok, which is not reentrant)
+	const string labels(aLabels);
+	string::size_type start = labels.find_first_not_of(DEFAULT_HEADER_SEPARATOR);
+	while(start!=string::npos)
 	{
+		string::size_type end = labels.find_first_of(DEFAULT_HEADER_SEPARATOR,start);
+
 		// Append column label
-		_columnLabels.append(token);
+		_columnLabels.append(labels.substr(start,end-start));
 
 		// Get next label 
-		token = strtok( NULL, DEFAULT_HEADER_SEPARATOR );
+		start = labels.find_first_not_of(DEFAULT_HEADER_SEPARATOR,end);
 	}
-
-	delete[] labelsCopy;
 }
 
 //_____________________________________________________________________________
@@ -579,19 +1036,47 @@ getCapacityIncrement() const
 int Storage::
 getSmallestNumberOfStates() const
 {
+	if(_columnar) {
+		int n = (_columnarWidth<0) ? 0 : _columnarWidth;
+		if(_numFlushedRows>0 && (_columnarSize==0 || _flushedMinStates<n))
+			n = _flushedMinStates;
+		return(n);
+	}
+
 	int n,nmin=0;
-	for(int i=0;i<_storage.getSize();i++) {
-		n = _storage[i].getSize();
+	for(int i=0;i<rows().getSize();i++) {
+		n = rows()[i].getSize();
 		if(i==0) {
 			nmin = n;
 		} else if(n<nmin) {
 			nmin = n;
 		}
 	}
+	if(_numFlushedRows>0 && (rows().getSize()==0 || _flushedMinStates<nmin))
+		nmin = _flushedMinStates;
 
 	return(nmin);
 }
 //_____________________________________________________________________________
+/**
+ * Get the largest number of states of the rows held in memory; this is
+ * the number of columns whose data can be retrieved with getDataColumn().
+ *
+ * @return Largest number of states.
+ */
+int Storage::
+getLargestNumberOfStates() const
+{
+	if(_columnar) return((_columnarWidth<0) ? 0 : _columnarWidth);
+
+	int nmax=0;
+	for(int i=0;i<_storage.getSize();i++) {
+		if(_storage[i].getSize()>nmax) nmax = _storage[i].getSize();
+	}
+
+	return(nmax);
+}
+//_____________________________________________________________________________
 /**
  * Get the last states stored.
  *
@@ -602,7 +1087,7 @@ getLastStateVector() const
 {
 	StateVector *vec = NULL;
 	try {
-		vec = &_storage.updLast();
+		vec = &rows().updLast();
 	} catch(const Exception&) {
 		//x.print(cout);
 	}
@@ -620,7 +1105,7 @@ getLastStateVector() const
 StateVector* Storage::
 getStateVector(int aTimeIndex) const
 {
-	return(&_storage.updElt(aTimeIndex));
+	return(&rows().updElt(aTimeIndex));
 }
 
 //-----------------------------------------------------------------------------
@@ -636,10 +1121,11 @@ getStateVector(int aTimeIndex) const
 double Storage::
 getFirstTime() const
 {
-	if(_storage.getSize()<=0) {
+	if(_numFlushedRows>0) return(_flushedFirstTime);
+	if(getSize()<=0) {
 		return(SimTK::NaN);
 	}
-	return(_storage[0].getTime());
+	return(getTimeAt(0));
 }
 //_____________________________________________________________________________
 /**
@@ -651,10 +1137,10 @@ getFirstTime() const
 double Storage::
 getLastTime() const
 {
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		return(SimTK::NaN);
 	}
-	return(_storage.getLast().getTime());
+	return(getTimeAt(getSize()-1));
 }
 //_____________________________________________________________________________
 /**
@@ -692,10 +1178,17 @@ bool Storage::
 getTime(int aTimeIndex,double &rTime,int aStateIndex) const
 {
 	if(aTimeIndex<0) return false;
-	if(aTimeIndex>_storage.getSize()) return false;
+	if(aTimeIndex>getSize()) return false;
+
+	// COLUMNAR
+	if(_columnar) {
+		if(aStateIndex >= _columnarWidth) return false;
+		rTime = columnarTimes()[aTimeIndex];
+		return true;
+	}
 
 	// GET STATEVECTOR
-	StateVector &vec = _storage[aTimeIndex];
+	StateVector &vec = rows()[aTimeIndex];
 
 	// CHECK FOR VALID STATE
 	if(aStateIndex >= vec.getSize()) return false;
@@ -721,17 +1214,24 @@ getTime(int aTimeIndex,double &rTime,int aStateIndex) const
 int Storage::
 getTimeColumn(double *&rTimes,int aStateIndex) const
 {
-	if(_storage.getSize()<=0) return(0);
+	if(getSize()<=0) return(0);
 
 	// ALLOCATE MEMORY
 	if(rTimes==NULL) {
-		rTimes = new double[_storage.getSize()];
+		rTimes = new double[getSize()];
+	}
+
+	// COLUMNAR
+	if(_columnar) {
+		if(aStateIndex >= _columnarWidth) return(0);
+		memcpy(rTimes,columnarTimes(),_columnarSize*sizeof(double));
+		return(_columnarSize);
 	}
 
 	// LOOP THROUGH STATEVECTORS
 	int i,nTimes;
 	StateVector *vec;
-	for(i=nTimes=0;i<_storage.getSize();i++) {
+	for(i=nTimes=0;i<rows().getSize();i++) {
 		vec = getStateVector(i);
 		if(vec==NULL) continue;
 		if(aStateIndex >= vec->getSize()) continue;
@@ -744,13 +1244,20 @@ getTimeColumn(double *&rTimes,int aStateIndex) const
 int Storage::
 getTimeColumn(Array<double> &rTimes,int aStateIndex) const
 {
-	if(_storage.getSize()<=0) return(0);
+	if(getSize()<=0) return(0);
 
-	rTimes.setSize(_storage.getSize());
+	rTimes.setSize(getSize());
+
+	// COLUMNAR
+	if(_columnar) {
+		if(aStateIndex >= _columnarWidth) { rTimes.setSize(0); return(0); }
+		memcpy(rTimes.get(),columnarTimes(),_columnarSize*sizeof(double));
+		return(_columnarSize);
+	}
 
 	// LOOP THROUGH STATEVECTORS
 	int i,nTimes;
-	for(i=nTimes=0;i<_storage.getSize();i++) {
+	for(i=nTimes=0;i<rows().getSize();i++) {
 		StateVector *vec = getStateVector(i);
 		if(vec==NULL) continue;
 		if(aStateIndex >= vec->getSize()) continue;
@@ -769,7 +1276,7 @@ getTimeColumn(Array<double> &rTimes,int aStateIndex) const
 void Storage::
 getTimeColumnWithStartTime(Array<double>& rTimes,double aStartTime) const
 {
-	if(_storage.getSize()<=0) return;
+	if(getSize()<=0) return;
 
 	int startIndex = findIndex(aStartTime);
 
@@ -797,7 +1304,14 @@ int Storage::
 getData(int aTimeIndex,int aStateIndex,double &rValue) const
 {
 	if(aTimeIndex<0) return(0);
-	if(aTimeIndex>=_storage.getSize()) return(0);
+	if(aTimeIndex>=getSize()) return(0);
+
+	// COLUMNAR
+	if(_columnar) {
+		if((aStateIndex<0)||(aStateIndex>=_columnarWidth)) return(0);
+		rValue = columnarData()[aStateIndex*_columnarCapacity+aTimeIndex];
+		return(1);
+	}
 
 	// ASSIGNMENT
 	StateVector *vec = getStateVector(aTimeIndex);
@@ -814,7 +1328,20 @@ getData(int aTimeIndex,int aStateIndex,int aN,double **rData) const
 	if(aN<=0) return(0);
 	if(aStateIndex<0) return(0);
 	if(aTimeIndex<0) return(0);
-	if(aTimeIndex>=_storage.getSize()) return(0);
+	if(aTimeIndex>=getSize()) return(0);
+
+	// COLUMNAR
+	if(_columnar) {
+		if(aStateIndex>=_columnarWidth) return(0);
+		int n = aStateIndex + aN;
+		if(n>_columnarWidth) n = _columnarWidth;
+		int N = n - aStateIndex;
+		if(*rData==NULL) *rData = new double[N];
+		double *pData = *rData;
+		const double *y = columnarData() + aStateIndex*_columnarCapacity+aTimeIndex;
+		for(int i=0;i<N;i++,y+=_columnarCapacity) pData[i] = *y;
+		return(N);
+	}
 
 	// GET STATEVECTOR
 	StateVector *vec = getStateVector(aTimeIndex);
@@ -948,8 +1475,8 @@ getDataAtTime(double aT,int aN,double **rData) const
 {
 
 	// FIND THE CORRECT INTERVAL FOR aT
-	int i = findIndex(_lastI,aT);
-	if((i<0)||(_storage.getSize()<=0)) {
+	int i = findIndex(aT);
+	if((i<0)||(getSize()<=0)) {
 		*rData = NULL;
 		return(0);
 	}
@@ -957,20 +1484,33 @@ getDataAtTime(double aT,int aN,double **rData) const
 	// CHECK FOR i AT END POINTS
 	int i1=i,i2=i+1;
 
-	if(i2==_storage.getSize()) {
+	if(i2==getSize()) {
 		i1--;  if(i1<0) i1=0;
 		i2--;  if(i2<0) i2=0;
 	}
 
-	// STATES AT FIRST INDEX
-	int n1 = getStateVector(i1)->getSize();
-	double t1 = getStateVector(i1)->getTime();
-	Array<double> &y1 = getStateVector(i1)->getData();
-
-	// STATES AT NEXT INDEX
-	int n2 = getStateVector(i2)->getSize();
-	double t2 = getStateVector(i2)->getTime();
-	Array<double> &y2 = getStateVector(i2)->getData();
+	// STATES AT FIRST AND NEXT INDEX
+	// Consecutive states of a row are one column apart when columnar.
+	int n1,n2,stride;
+	const double *y1,*y2;
+	double t1 = getTimeAt(i1);
+	double t2 = getTimeAt(i2);
+	if(_columnar) {
+		n1 = n2 = (_columnarWidth<0) ? 0 : _columnarWidth;
+		if(n1<=0) {
+			*rData = NULL;
+			return(0);
+		}
+		y1 = columnarData() + i1;
+		y2 = columnarData() + i2;
+		stride = _columnarCapacity;
+	} else {
+		n1 = getStateVector(i1)->getSize();
+		y1 = getStateVector(i1)->getData().get();
+		n2 = getStateVector(i2)->getSize();
+		y2 = getStateVector(i2)->getData().get();
+		stride = 1;
+	}
 
 	// GET THE SMALLEST N TO PREVENT MEMORY OVER-RUNS
 	int ns = (n1<n2) ? n1 : n2;
@@ -997,9 +1537,9 @@ getDataAtTime(double aT,int aN,double **rData) const
 
 	for(i=0;i<ns;i++) {
 		if(pct==0.0) {
-			y[i] = y1[i];
+			y[i] = y1[i*stride];
 		} else {
-			y[i] = y1[i] + pct*(y2[i]-y1[i]);
+			y[i] = y1[i*stride] + pct*(y2[i*stride]-y1[i*stride]);
 		}
 	}
 
@@ -1058,7 +1598,7 @@ getDataAtTime(double aT,int aN,SimTK::Vector& v) const
 int Storage::
 getDataColumn(int aStateIndex,double *&rData) const
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n<=0) return(0);
 
 	// ALLOCATION
@@ -1066,6 +1606,14 @@ getDataColumn(int aStateIndex,double *&rData) const
 		rData = new double[n];
 	}
 
+	// COLUMNAR
+	if(_columnar) {
+		const double *column = getDataColumnBuffer(aStateIndex);
+		if(column==NULL) return(0);
+		memcpy(rData,column,n*sizeof(double));
+		return(n);
+	}
+
 	// ASSIGNMENT
 	int i,nData;
 	for(i=nData=0;i<n;i++) {
@@ -1079,11 +1627,20 @@ getDataColumn(int aStateIndex,double *&rData) const
 int Storage::
 getDataColumn(int aStateIndex,Array<double> &rData) const
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n<=0) return(0);
 
 	rData.setSize(n);
 
+	// COLUMNAR
+	if(_columnar) {
+		const double *column = getDataColumnBuffer(aStateIndex);
+		if(column==NULL) n = 0;
+		else memcpy(rData.get(),column,n*sizeof(double));
+		rData.setSize(n);
+		return(n);
+	}
+
 	// ASSIGNMENT
 	int i,nData;
 	for(i=nData=0;i<n;i++) {
@@ -1104,13 +1661,13 @@ getDataColumn(int aStateIndex,Array<double> &rData) const
 void Storage::
 getDataColumn(const std::string& columnName, Array<double>& rData, double aStartTime)
 {
-	if(_storage.getSize()<=0) return;
+	if(getSize()<=0) return;
 
 	int startIndex = findIndex(aStartTime);
 	int colIndex = getStateIndex(columnName);
 	double *dataVec=0;
 	getDataColumn(colIndex, dataVec);
-	for(int i=startIndex; i<_storage.getSize(); i++)
+	for(int i=startIndex; i<getSize(); i++)
 		rData.append(dataVec[i]);
 	delete[] dataVec;
 }
@@ -1129,12 +1686,20 @@ getDataColumn(const std::string& columnName, Array<double>& rData, double aStart
 void Storage::
 setDataColumn(int aStateIndex,const Array<double> &aData)
 {
-	int n = _storage.getSize();
+	int n = getSize();
 	if(n!=aData.getSize()) {
 		cout<<"Storage.setDataColumn: ERR- sizes don't match." << endl;
 		return;
 	}
 
+	// COLUMNAR
+	if(_columnar) {
+		if((aStateIndex<0)||(aStateIndex>=_columnarWidth)) return;
+		releaseMappedFile();
+		memcpy(&_columnarData[aStateIndex*_columnarCapacity],aData.get(),n*sizeof(double));
+		return;
+	}
+
 	// ASSIGNMENT
 	for(int i=0;i<n;i++) {
 		StateVector *vec = getStateVector(i);
@@ -1146,13 +1711,22 @@ setDataColumn(int aStateIndex,const Array<double> &aData)
  * set values in the column specified by columnName to newValue
  */
 void Storage::setDataColumnToFixedValue(const std::string& columnName, double newValue) {
-    int n = _storage.getSize();
+    int n = getSize();
     int aStateIndex = getStateIndex(columnName);
 	if(aStateIndex==-1) {
 		cout<<"Storage.setDataColumnToFixedValue: ERR- column not found." << endl;
 		return;
 	}
 
+	// COLUMNAR
+	if(_columnar) {
+		if(aStateIndex>=_columnarWidth) return;
+		releaseMappedFile();
+		double *column = &_columnarData[aStateIndex*_columnarCapacity];
+		for(int i=0;i<n;i++) column[i] = newValue;
+		return;
+	}
+
 	// ASSIGNMENT
 	for(int i=0;i<n;i++) {
 		StateVector *vec = getStateVector(i);
@@ -1203,7 +1777,7 @@ void Storage::getDataForIdentifier(const std::string& identifier, Array<Array<do
 	}
 	/* a row of "data" can be shorter than number of columns if time is the first column, since 
 	   that is not considered a state by storage. Need to fix this! -aseth */
-	int nd = getLastStateVector()->getSize();
+	int nd = _columnar ? _columnarWidth : getLastStateVector()->getSize();
 	int off = _columnLabels.getSize()-nd;
 
 
@@ -1233,6 +1807,215 @@ OpenSim::Array<int>  Storage::getColumnIndicesForIdentifier(const std::string& i
 	}
 	return found;
 }
+//-----------------------------------------------------------------------------
+// COLUMNAR BACKING STORE
+//-----------------------------------------------------------------------------
+//_____________________________________________________________________________
+/**
+ * Set whether the data are held in contiguous, column-major buffers rather
+ * than as one StateVector per row.
+ *
+ * Columnar storage keeps all times in one buffer and each state (column)
+ * in its own contiguous block, so getDataColumn(), getTimeColumn(),
+ * computeArea(), findIndex(), getDataAtTime() and print() sweep contiguous
+ * memory instead of following one pointer per row, and appending a row
+ * does not allocate.  Use getDataColumnBuffer() to read a column without
+ * copying it.
+ *
+ * Methods that hand out or modify StateVectors directly (e.g.,
+ * getStateVector(), add(), insertions) convert the data back to rows
+ * first; call setColumnar(true) again afterwards to restore the columnar
+ * layout.
+ *
+ * @param aTrueFalse Whether (true) or not (false) to hold the data in
+ * columns.
+ * @return true if the requested layout is in effect.  Data whose rows do
+ * not all have the same number of states cannot be held in columns.
+ */
+bool Storage::
+setColumnar(bool aTrueFalse)
+{
+	if(aTrueFalse) return(packColumns());
+	unpackColumns();
+	return(true);
+}
+//_____________________________________________________________________________
+/**
+ * Get the time column without copying it.
+ *
+ * @return Pointer to getSize() contiguous times, or NULL if the data are
+ * not columnar (see setColumnar()) or the storage is empty.  The pointer is
+ * invalidated by anything that appends rows or changes the layout.
+ */
+const double* Storage::
+getTimeColumnBuffer() const
+{
+	if(!_columnar || _columnarSize<=0) return(NULL);
+	return(columnarTimes());
+}
+//_____________________________________________________________________________
+/**
+ * Get the data of a state (column) without copying it.
+ *
+ * @param aStateIndex Index of the state (column).
+ * @return Pointer to getSize() contiguous values, or NULL if the data are
+ * not columnar (see setColumnar()), the storage is empty, or aStateIndex
+ * is out of range.  The pointer is invalidated by anything that appends
+ * rows or changes the layout.
+ */
+const double* Storage::
+getDataColumnBuffer(int aStateIndex) const
+{
+	if(!_columnar || _columnarSize<=0) return(NULL);
+	if((aStateIndex<0)||(aStateIndex>=_columnarWidth)) return(NULL);
+	return(columnarData() + aStateIndex*_columnarCapacity);
+}
+
+//=============================================================================
+// STREAMING
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Limit the number of rows held in memory.
+ *
+ * Once more than aNumRows rows are stored, all but the last row are flushed
+ * to a temporary file and removed from memory, so memory use stays bounded
+ * however many rows are appended (e.g., over a long simulation).  The
+ * flushed rows are written back out by print(), so the printed file is the
+ * same as if all rows had been kept in memory.  The last row is always kept
+ * so that appending a row with the same time still replaces it.
+ *
+ * Only the rows in memory can be accessed through the other methods of
+ * this class; getSize() counts only those rows, and getNumFlushedRows()
+ * gives the number of flushed rows.  Copying the storage reads the flushed
+ * rows back into the copy.  Emptying the storage (e.g., reset(0) or purge())
+ * discards the flushed rows.
+ *
+ * @param aNumRows Maximum number of rows to hold in memory.  0 (the
+ * default) keeps all rows in memory.
+ */
+void Storage::
+setFlushInterval(int aNumRows)
+{
+	_flushInterval = (aNumRows<0) ? 0 : aNumRows;
+	if(_flushInterval>0 && getSize()>_flushInterval) flushRows();
+}
+//_____________________________________________________________________________
+/**
+ * Move all rows but the last from memory to the temporary flush file.
+ */
+void Storage::
+flushRows()
+{
+	int nr = getSize();
+	if(nr<2) return;
+	releaseMappedFile();
+
+	// OPEN THE FLUSH FILE
+	if(_flushFile==NULL) {
+		_flushFile = tmpfile();
+		if(_flushFile==NULL) {
+			cout << "Storage.flushRows: WARNING- could not create a temporary file."
+				<< " Keeping all rows of " << getName() << " in memory." << endl;
+			_flushInterval = 0;
+			return;
+		}
+	}
+
+	// WRITE EACH ROW AS ITS TIME, NUMBER OF STATES, AND STATES
+	std::vector<double> rowBuffer(_columnar ? _columnarWidth : 0);
+	for(int i=0;i<nr-1;i++) {
+		double t = getTimeAt(i);
+		int n = _columnar ? _columnarWidth : _storage[i].getSize();
+		const double *y = getRowData(i,rowBuffer.data());
+		bool ok = fwrite(&t,sizeof(t),1,_flushFile)==1 &&
+			fwrite(&n,sizeof(n),1,_flushFile)==1 &&
+			(n==0 || fwrite(y,sizeof(double),n,_flushFile)==(size_t)n);
+		if(!ok) throw Exception("Storage.flushRows: ERROR- failed to write rows of "
+			+ getName() + " to a temporary file",__FILE__,__LINE__);
+		if(_numFlushedRows==0) {
+			_flushedFirstTime = t;
+			_flushedMinStates = n;
+		} else if(n<_flushedMinStates) {
+			_flushedMinStates = n;
+		}
+		_numFlushedRows++;
+	}
+
+	// KEEP THE LAST ROW
+	if(_columnar) {
+		_columnarTimes[0] = _columnarTimes[nr-1];
+		for(int c=0;c<_columnarWidth;c++)
+			_columnarData[c*_columnarCapacity] = _columnarData[c*_columnarCapacity+nr-1];
+		_columnarSize = 1;
+	} else {
+		_storage[0] = _storage[nr-1];
+		_storage.setSize(1);
+	}
+}
+//_____________________________________________________________________________
+/**
+ * Close the temporary flush file, discarding the rows in it.
+ */
+void Storage::
+discardFlushedRows()
+{
+	if(_flushFile!=NULL) fclose(_flushFile);
+	_flushFile = NULL;
+	_numFlushedRows = 0;
+	_flushedFirstTime = SimTK::NaN;
+	_flushedMinStates = 0;
+}
+//_____________________________________________________________________________
+/**
+ * Print the rows in the temporary flush file, formatted as by print().
+ *
+ * @param rFP File pointer.
+ * @return false if the rows could not be read or printed.
+ */
+bool Storage::
+writeFlushedRows(FILE *rFP) const
+{
+	if(_numFlushedRows==0) return(true);
+	bool ok = (fseek(_flushFile,0,SEEK_SET)==0);
+	double t;
+	int n;
+	std::vector<double> y;
+	for(int i=0;ok && i<_numFlushedRows;i++) {
+		ok = fread(&t,sizeof(t),1,_flushFile)==1 && fread(&n,sizeof(n),1,_flushFile)==1;
+		if(!ok) break;
+		y.resize(n>0 ? n : 1);
+		ok = (n==0 || fread(y.data(),sizeof(double),n,_flushFile)==(size_t)n) &&
+			writeRow(rFP,t,n,y.data())>=0;
+	}
+	if(fseek(_flushFile,0,SEEK_END)!=0) ok = false;
+	return(ok);
+}
+//_____________________________________________________________________________
+/**
+ * Append the rows in the temporary flush file to another storage.
+ *
+ * @param rStorage Storage to which to append the rows.
+ */
+void Storage::
+appendFlushedRows(Storage &rStorage) const
+{
+	if(_numFlushedRows==0) return;
+	bool ok = (fseek(_flushFile,0,SEEK_SET)==0);
+	double t;
+	int n;
+	std::vector<double> y;
+	for(int i=0;ok && i<_numFlushedRows;i++) {
+		ok = fread(&t,sizeof(t),1,_flushFile)==1 && fread(&n,sizeof(n),1,_flushFile)==1;
+		if(!ok) break;
+		y.resize(n>0 ? n : 1);
+		ok = (n==0 || fread(y.data(),sizeof(double),n,_flushFile)==(size_t)n);
+		if(ok) rStorage.append(t,n,y.data(),false);
+	}
+	if(fseek(_flushFile,0,SEEK_END)!=0) ok = false;
+	if(!ok) throw Exception("Storage: ERROR- failed to read rows of "
+		+ getName() + " back from a temporary file",__FILE__,__LINE__);
+}
 //=============================================================================
 // RESET
 //=============================================================================
@@ -1253,11 +2036,13 @@ OpenSim::Array<int>  Storage::getColumnIndicesForIdentifier(const std::string& i
 int Storage::
 reset(int aIndex)
 {
-	if(aIndex>=_storage.getSize()) return(_storage.getSize());
+	if(aIndex<=0) discardFlushedRows();
+	if(aIndex>=getSize()) return(getSize());
 	if(aIndex<0) aIndex = 0;
-	_storage.setSize(aIndex);
+	if(_columnar) _columnarSize = aIndex;
+	else _storage.setSize(aIndex);
 
-	return(_storage.getSize());
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1296,11 +2081,23 @@ crop(const double newStartTime, const double newFinalTime)
 		cout<<"Storage.crop: WARNING: No rows will be left." << endl;
 		numRowsToKeep=0;
 	}
+	if(_columnar) {
+		releaseMappedFile();
+		if (startindex!=0 && numRowsToKeep>0){
+			memmove(&_columnarTimes[0],&_columnarTimes[startindex],numRowsToKeep*sizeof(double));
+			for(int j=0; j<_columnarWidth; j++) {
+				double *column = &_columnarData[j*_columnarCapacity];
+				memmove(column,column+startindex,numRowsToKeep*sizeof(double));
+			}
+		}
+		_columnarSize = numRowsToKeep;
+		return;
+	}
 	if (startindex!=0){
 		for(int i=0; i<finalindex-startindex+1; i++)
-			_storage[i]=_storage[startindex+i];
+			rows()[i]=rows()[startindex+i];
 	}
-	_storage.setSize(numRowsToKeep);
+	rows().setSize(numRowsToKeep);
 }
 
 //=============================================================================
@@ -1316,17 +2113,24 @@ crop(const double newStartTime, const double newFinalTime)
 int Storage::
 append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 {
+	if(_columnar) {
+		const Array<double> &data = aStateVector.getData();
+		return( append(aStateVector.getTime(),data.getSize(),data.get(),
+			aCheckForDuplicateTime) );
+	}
+
 	// TODO: use some tolerance when checking for duplicate time?
-	if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==aStateVector.getTime())
-		_storage.updLast() = aStateVector;
+	if(aCheckForDuplicateTime && rows().getSize() && rows().getLast().getTime()==aStateVector.getTime())
+		rows().updLast() = aStateVector;
 	else
-		_storage.append(aStateVector);
+		rows().append(aStateVector);
 
 	if (_fp!=0){
 		aStateVector.print(_fp);
 		fflush(_fp);
 	}
-	return(_storage.getSize());
+	if(_flushInterval>0 && rows().getSize()>_flushInterval) flushRows();
+	return(rows().getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1341,9 +2145,11 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
 int Storage::
 append(const Array<StateVector> &aStorage)
 {
-	for(int i=0; i<aStorage.getSize(); i++)
-		_storage.append(aStorage[i]);
-	return(_storage.getSize());
+	for(int i=0; i<aStorage.getSize(); i++) {
+		if(_columnar) append(aStorage[i],false);
+		else _storage.append(aStorage[i]);
+	}
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1357,20 +2163,42 @@ append(const Array<StateVector> &aStorage)
 int Storage::
 append(double aT,int aN,const double *aY,bool aCheckForDuplicateTime)
 {
-	if(aY==NULL) return(_storage.getSize());
-	if(aN<0) return(_storage.getSize());
+	if(aY==NULL) return(getSize());
+	if(aN<0) return(getSize());
+
+	// COLUMNAR- WRITE STRAIGHT INTO THE COLUMN BUFFERS
+	if(_columnar) {
+		releaseMappedFile();
+		if(_columnarWidth<0) _columnarWidth = aN;
+		if(aN==_columnarWidth) {
+			int row = _columnarSize;
+			if(aCheckForDuplicateTime && row>0 && _columnarTimes[row-1]==aT) row--;
+			else ensureColumnarCapacity(row+1);
+			_columnarTimes[row] = aT;
+			for(int i=0;i<aN;i++) _columnarData[i*_columnarCapacity+row] = aY[i];
+			_columnarSize = row+1;
+			if (_fp!=0){
+				writeRow(_fp,aT,aN,aY);
+				fflush(_fp);
+			}
+			if(_flushInterval>0 && _columnarSize>_flushInterval) flushRows();
+			return(_columnarSize);
+		}
+		// Rows of differing lengths can only be held as StateVectors.
+		unpackColumns();
+	}
 
 	// APPEND
 	StateVector vec(aT,aN,aY);
 	append(vec,aCheckForDuplicateTime);
 	// TODO: use some tolerance when checking for duplicate time?
 	/*
-	if(aCheckForDuplicateTime && _storage.getSize() && _storage.getLast().getTime()==vec.getTime())
-		_storage.getLast() = vec;
+	if(aCheckForDuplicateTime && rows().getSize() && rows().getLast().getTime()==vec.getTime())
+		rows().getLast() = vec;
 	else
-		_storage.append(vec);
+		rows().append(vec);
 	*/
-	return(_storage.getSize());
+	return(getSize());
 }
 //_____________________________________________________________________________
 /**
@@ -1416,12 +2244,12 @@ append(double aT,const Array<double>& aY,bool aCheckForDuplicateTime)
 int Storage::
 store(int aStep,double aT,int aN,const double *aY)
 {
-	if(_stepInterval==0) return(_storage.getSize());
+	if(_stepInterval==0) return(getSize());
 	if((aStep%_stepInterval) == 0) {
 		append(aT,aN,aY);
 	}
 
-	return(_storage.getSize());
+	return(getSize());
 }
 
 
@@ -1440,8 +2268,13 @@ store(int aStep,double aT,int aN,const double *aY)
 void Storage::
 shiftTime(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].shiftTime(aValue);
+	if(_columnar) {
+		releaseMappedFile();
+		for(int i=0;i<_columnarSize;i++) _columnarTimes[i] += aValue;
+		return;
+	}
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].shiftTime(aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1453,8 +2286,13 @@ shiftTime(double aValue)
 void Storage::
 scaleTime(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].scaleTime(aValue);
+	if(_columnar) {
+		releaseMappedFile();
+		for(int i=0;i<_columnarSize;i++) _columnarTimes[i] *= aValue;
+		return;
+	}
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].scaleTime(aValue);
 	}
 }
 
@@ -1471,8 +2309,8 @@ scaleTime(double aValue)
 void Storage::
 add(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].add(aValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].add(aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1486,8 +2324,8 @@ add(double aValue)
 void Storage::
 add(int aN, double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].add(aN,aValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].add(aN,aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1503,8 +2341,8 @@ add(int aN, double aValue)
 void Storage::
 add(int aN,double aY[])
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].add(aN,aY);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].add(aN,aY);
 	}
 }
 //_____________________________________________________________________________
@@ -1517,8 +2355,8 @@ add(int aN,double aY[])
 void Storage::
 add(StateVector *aStateVector)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].add(aStateVector);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].add(aStateVector);
 	}
 }
 //_____________________________________________________________________________
@@ -1538,7 +2376,7 @@ add(Storage *aStorage)
 
 	int n,N=0,nN;
 	double t,*Y=NULL;
-	for(int i=0;i<_storage.getSize();i++) {
+	for(int i=0;i<rows().getSize();i++) {
 
 		// GET INFO ON THIS STORAGE INSTANCE
 		n = getStateVector(i)->getSize();
@@ -1551,7 +2389,7 @@ add(Storage *aStorage)
 		nN = (n<N) ? n : N;
 
 		// ADD
-		_storage[i].add(nN,Y);
+		rows()[i].add(nN,Y);
 	}
 
 	// CLEANUP
@@ -1571,8 +2409,8 @@ add(Storage *aStorage)
 void Storage::
 subtract(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].subtract(aValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].subtract(aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1588,8 +2426,8 @@ subtract(double aValue)
 void Storage::
 subtract(int aN,double aY[])
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].subtract(aN,aY);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].subtract(aN,aY);
 	}
 }
 //_____________________________________________________________________________
@@ -1602,8 +2440,8 @@ subtract(int aN,double aY[])
 void Storage::
 subtract(StateVector *aStateVector)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].subtract(aStateVector);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].subtract(aStateVector);
 	}
 }
 //_____________________________________________________________________________
@@ -1623,7 +2461,7 @@ subtract(Storage *aStorage)
 
 	int n,N=0,nN;
 	double t,*Y=NULL;
-	for(int i=0;i<_storage.getSize();i++) {
+	for(int i=0;i<rows().getSize();i++) {
 
 		// GET INFO ON THIS STORAGE INSTANCE
 		n = getStateVector(i)->getSize();
@@ -1636,7 +2474,7 @@ subtract(Storage *aStorage)
 		nN = (n<N) ? n : N;
 
 		// SUBTRACT
-		_storage[i].subtract(nN,Y);
+		rows()[i].subtract(nN,Y);
 	}
 
 	// CLEANUP
@@ -1656,8 +2494,8 @@ subtract(Storage *aStorage)
 void Storage::
 multiply(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].multiply(aValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].multiply(aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1673,8 +2511,8 @@ multiply(double aValue)
 void Storage::
 multiply(int aN,double aY[])
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].multiply(aN,aY);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].multiply(aN,aY);
 	}
 }
 
@@ -1688,8 +2526,8 @@ multiply(int aN,double aY[])
 void Storage::
 multiply(StateVector *aStateVector)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].multiply(aStateVector);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].multiply(aStateVector);
 	}
 }
 //_____________________________________________________________________________
@@ -1709,7 +2547,7 @@ multiply(Storage *aStorage)
 
 	int n,N=0,nN;
 	double t,*Y=NULL;
-	for(int i=0;i<_storage.getSize();i++) {
+	for(int i=0;i<rows().getSize();i++) {
 
 		// GET INFO ON THIS STORAGE INSTANCE
 		n = getStateVector(i)->getSize();
@@ -1722,7 +2560,7 @@ multiply(Storage *aStorage)
 		nN = (n<N) ? n : N;
 
 		// MULTIPLY
-		_storage[i].multiply(nN,Y);
+		rows()[i].multiply(nN,Y);
 	}
 
 	// CLEANUP
@@ -1738,11 +2576,18 @@ multiply(Storage *aStorage)
 void Storage::
 multiplyColumn(int aIndex, double aValue)
 {
+	if(_columnar) {
+		if((aIndex<0)||(aIndex>=_columnarWidth)) return;
+		releaseMappedFile();
+		double *column = &_columnarData[aIndex*_columnarCapacity];
+		for(int i=0;i<_columnarSize;i++) column[i] *= aValue;
+		return;
+	}
 	double newValue;
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].getDataValue(aIndex, newValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].getDataValue(aIndex, newValue);
 		newValue *= aValue;
-		_storage[i].setDataValue(aIndex, newValue);
+		rows()[i].setDataValue(aIndex, newValue);
 	}
 }
 
@@ -1758,8 +2603,8 @@ multiplyColumn(int aIndex, double aValue)
 void Storage::
 divide(double aValue)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].divide(aValue);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].divide(aValue);
 	}
 }
 //_____________________________________________________________________________
@@ -1774,8 +2619,8 @@ divide(double aValue)
 void Storage::
 divide(int aN,double aY[])
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].divide(aN,aY);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].divide(aN,aY);
 	}
 }
 //_____________________________________________________________________________
@@ -1787,8 +2632,8 @@ divide(int aN,double aY[])
 void Storage::
 divide(StateVector *aStateVector)
 {
-	for(int i=0;i<_storage.getSize();i++) {
-		_storage[i].divide(aStateVector);
+	for(int i=0;i<rows().getSize();i++) {
+		rows()[i].divide(aStateVector);
 	}
 }
 //_____________________________________________________________________________
@@ -1809,7 +2654,7 @@ divide(Storage *aStorage)
 	int i;
 	int n,N=0,nN;
 	double t,*Y=NULL;
-	for(i=0;i<_storage.getSize();i++) {
+	for(i=0;i<rows().getSize();i++) {
 
 		// GET INFO ON THIS STORAGE INSTANCE
 		n = getStateVector(i)->getSize();
@@ -1822,7 +2667,7 @@ divide(Storage *aStorage)
 		nN = (n<N) ? n : N;
 
 		// DIVIDE
-		_storage[i].divide(nN,Y);
+		rows()[i].divide(nN,Y);
 	}
 
 	// CLEANUP
@@ -1906,7 +2751,7 @@ int Storage::
 integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 {
 	// CHECK THAT THERE ARE STATES STORED
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		cout << "Storage.integrate: ERROR- no stored states." << endl;
 		return(0);
 	}
@@ -1927,11 +2772,16 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 
 	// SET THE INDICES
 	if(aI1<0) aI1 = 0;
-	if(aI2<0) aI2 = _storage.getSize()-1;
+	if(aI2<0) aI2 = getSize()-1;
 
 	// WORKING MEMORY
 	double ti,tf;
-	double *yi=NULL,*yf=NULL;
+	const double *yi=NULL,*yf=NULL;
+	double *bufi=NULL,*buff=NULL;
+	if(_columnar) {
+		bufi = new double[_columnarWidth];
+		buff = new double[_columnarWidth];
+	}
 
 	bool functionAllocatedArea = false;
 	if(!rArea) {
@@ -1944,32 +2794,48 @@ integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const
 
 	// RECORD FIRST STATE
 	if(rStorage) {
-		ti = getStateVector(aI1)->getTime();
+		ti = getTimeAt(aI1);
 		rStorage->append(ti,n,rArea);
 	}
 
+	// COLUMNAR AREA ONLY- SWEEP EACH COLUMN CONTIGUOUSLY
+	if(_columnar && !rStorage) {
+		const double *t = columnarTimes();
+		for(int i=0;i<n;i++) {
+			const double *y = columnarData() + i*_columnarCapacity;
+			double area = 0.0;
+			for(int I=aI1;I<aI2;I++) {
+				area += 0.5*(y[I+1]+y[I])*(t[I+1]-t[I]);
+			}
+			rArea[i] = area;
+		}
+
 	// INTEGRATE
-	for(int I=aI1;I<aI2;I++) {
+	} else {
+		for(int I=aI1;I<aI2;I++) {
 
-		// INITIAL
-		ti = getStateVector(I)->getTime();
-		yi = getStateVector(I)->getData().get();
+			// INITIAL
+			ti = getTimeAt(I);
+			yi = getRowData(I,bufi);
 
-		// FINAL
-		tf = getStateVector(I+1)->getTime();
-		yf = getStateVector(I+1)->getData().get();
+			// FINAL
+			tf = getTimeAt(I+1);
+			yf = getRowData(I+1,buff);
 
-		// AREA
-		for(int i=0;i<n;i++) {
-			rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
-		}
+			// AREA
+			for(int i=0;i<n;i++) {
+				rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
+			}
 
-		// APPEND
-		if(rStorage) rStorage->append(tf,n,rArea);
+			// APPEND
+			if(rStorage) rStorage->append(tf,n,rArea);
+		}
 	}
 
 	// CLEANUP
 	if(functionAllocatedArea) delete[] rArea;
+	delete[] bufi;
+	delete[] buff;
 
 	return(n);
 }
@@ -1981,7 +2847,7 @@ int Storage::
 integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 {
 	// CHECK THAT THERE ARE STATES STORED
-	if(_storage.getSize()<=0) {
+	if(getSize()<=0) {
 		cout << "Storage.integrate: ERROR- no stored states." << endl;
 		return(0);
 	}
@@ -2046,37 +2912,57 @@ integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const
 
 	// SPANS MULTIPLE INTERVALS
 	} else {
-		double *yi=NULL,*yf=NULL;
+		const double *yi=NULL,*yf=NULL;
+		double *bufi=NULL,*buff=NULL;
+		if(_columnar) {
+			bufi = new double[_columnarWidth];
+			buff = new double[_columnarWidth];
+		}
 
 		// FIRST SLICE
 		getDataAtTime(aTI,n,&yI);
-		tf = getStateVector(II)->getTime();
-		yf = getStateVector(II)->getData().get();
+		tf = getTimeAt(II);
+		yf = getRowData(II,buff);
 		for(int i=0;i<n;i++) {
 			rArea[i] += 0.5*(yf[i]+yI[i])*(tf-aTI);
 		}
 		if(rStorage) rStorage->append(tf,n,rArea);
 
 		// INTERVALS
-		for(int I=II;I<FF;I++) {
-			ti = getStateVector(I)->getTime();
-			yi = getStateVector(I)->getData().get();
-			tf = getStateVector(I+1)->getTime();
-			yf = getStateVector(I+1)->getData().get();
+		if(_columnar && !rStorage) {
+			// Sweep each column contiguously.
+			const double *t = columnarTimes();
 			for(int i=0;i<n;i++) {
-				rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
+				const double *y = columnarData() + i*_columnarCapacity;
+				double area = rArea[i];
+				for(int I=II;I<FF;I++) {
+					area += 0.5*(y[I+1]+y[I])*(t[I+1]-t[I]);
+				}
+				rArea[i] = area;
+			}
+		} else {
+			for(int I=II;I<FF;I++) {
+				ti = getTimeAt(I);
+				yi = getRowData(I,bufi);
+				tf = getTimeAt(I+1);
+				yf = getRowData(I+1,buff);
+				for(int i=0;i<n;i++) {
+					rArea[i] += 0.5*(yf[i]+yi[i])*(tf-ti);
+				}
+				if(rStorage) rStorage->append(tf,n,rArea);
 			}
-			if(rStorage) rStorage->append(tf,n,rArea);
 		}
 
 		// LAST SLICE
-		ti = getStateVector(FF)->getTime();
-		yi = getStateVector(FF)->getData().get();
+		ti = getTimeAt(FF);
+		yi = getRowData(FF,bufi);
 		getDataAtTime(aTF,n,&yF);
 		for(int i=0;i<n;i++) {
 			rArea[i] += 0.5*(yF[i]+yi[i])*(aTF-ti);
 		}
 		if(rStorage) rStorage->append(aTF,n,rArea);
+		delete[] bufi;
+		delete[] buff;
 	}
 
 	// CLEANUP
@@ -2102,7 +2988,7 @@ computeArea(int aN,double *aArea) const
 	// CHECK FOR VALID OUTPUT ARRAYS
 	if(aN<=0) return(0);
 	else if(aArea==NULL) return(0);
-	else return integrate(0,_storage.getSize()-1,aN,aArea,NULL);
+	else return integrate(0,getSize()-1,aN,aArea,NULL);
 }
 //_____________________________________________________________________________
 /**
@@ -2213,6 +3099,27 @@ pad(int aPadSize)
 	Signal::Pad(aPadSize,paddedTime);
 	int newSize = paddedTime.getSize();
 
+	// COLUMNAR- PAD THE COLUMNS IN PARALLEL INTO NEW BUFFERS
+	bool columnar = _columnar;
+	if(size>0 && _numFlushedRows==0 && setColumnar(true)) {
+		int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+		std::vector<double> padded((size_t)nc*newSize);
+		if(nc>0) {
+			int numChunks = numColumnChunks(nc);
+			PadColumnsTask task(aPadSize,size,columnarData(),_columnarCapacity,
+				nc,numChunks,newSize,&padded[0]);
+			executeChunks(task,numChunks);
+		}
+		delete _mappedFile;
+		_mappedFile = NULL;
+		_columnarTimes.assign(paddedTime.get(),paddedTime.get()+newSize);
+		_columnarData.swap(padded);
+		_columnarCapacity = newSize;
+		_columnarSize = newSize;
+		if(!columnar) setColumnar(false);
+		return;
+	}
+
 	// PAD EACH COLUMN
 	int nc = getSmallestNumberOfStates();
 	Array<double> paddedSignal(0.0,size);
@@ -2229,8 +3136,11 @@ pad(int aPadSize)
 	}
 
 	// APPEND THE STATEVECTORS
+	_columnarSize = 0;
+	_columnar = false;
 	_storage.setSize(0);
 	for(int i=0;i<newSize;i++) _storage.append(vecs[i]);
+	if(columnar) setColumnar(true);
 
 	// CLEANUP
 	delete[] vecs;
@@ -2263,21 +3173,8 @@ smoothSpline(int aOrder,double aCutoffFrequency)
 		return;
 	}
 
-	// LOOP OVER COLUMNS
-	double *times=NULL;
-	int nc = getSmallestNumberOfStates();
-	double *signal=NULL;
-	Array<double> filt(0.0,size);
-	getTimeColumn(times,0);
-	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,signal,&filt[0]);
-		setDataColumn(i,filt);
-	}
-
-	// CLEANUP
-	delete[] times;
-	delete[] signal;
+	// FILTER THE COLUMNS
+	filterColumns(FilterColumnsTask::SMOOTH_SPLINE,aOrder,dtmin,aCutoffFrequency);
 }
 
 
@@ -2308,18 +3205,8 @@ lowpassIIR(double aCutoffFrequency)
 		return;
 	}
 
-	// LOOP OVER COLUMNS
-	int nc = getSmallestNumberOfStates();
-	double *signal=NULL;
-	Array<double> filt(0.0,size);
-	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::LowpassIIR(dtmin,aCutoffFrequency,size,signal,&filt[0]);
-		setDataColumn(i,filt);
-	}
-
-	// CLEANUP
-	delete[] signal;
+	// FILTER THE COLUMNS
+	filterColumns(FilterColumnsTask::LOWPASS_IIR,0,dtmin,aCutoffFrequency);
 }
 
 
@@ -2350,18 +3237,44 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 		return;
 	}
 
-	// LOOP OVER COLUMNS
-	int nc = getSmallestNumberOfStates();
-	double *signal=NULL;
-	Array<double> filt(0.0,size);
-	for(int i=0;i<nc;i++) {
-		getDataColumn(i,signal);
-		Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,signal,&filt[0]);
-		setDataColumn(i,filt);
+	// FILTER THE COLUMNS
+	filterColumns(FilterColumnsTask::LOWPASS_FIR,aOrder,dtmin,aCutoffFrequency);
+}
+//_____________________________________________________________________________
+/**
+ * Apply one of the filters of Signal to each of the columns, in place.  The
+ * columns are independent, so they are filtered on IO::GetNumThreads()
+ * threads; the result is the same for any number of threads.
+ *
+ * The storage must hold equally spaced rows of equal width, as it does
+ * after resample().
+ */
+void Storage::
+filterColumns(int aFilter,int aOrder,double aDT,double aCutoffFrequency)
+{
+	bool columnar = _columnar;
+	if(!setColumnar(true)) {
+		throw Exception("Storage.filterColumns: rows do not all have the same number of states.",
+			__FILE__,__LINE__);
+	}
+	releaseMappedFile();
+
+	int size = _columnarSize;
+	int nc = (_columnarWidth<0) ? 0 : _columnarWidth;
+	if(nc>0) {
+		int numChunks = numColumnChunks(nc);
+		std::vector<std::string> errors(numChunks);
+		FilterColumnsTask task((FilterColumnsTask::Filter)aFilter,aOrder,aDT,
+			aCutoffFrequency,size,&_columnarTimes[0],&_columnarData[0],
+			_columnarCapacity,nc,numChunks,errors);
+		executeChunks(task,numChunks);
+		for(int c=0;c<numChunks;c++) {
+			if(!errors[c].empty())
+				throw Exception("Storage.filterColumns: "+errors[c],__FILE__,__LINE__);
+		}
 	}
 
-	// CLEANUP
-	delete[] signal;
+	if(!columnar) setColumnar(false);
 }
 
 
@@ -2373,12 +3286,11 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
  * Find the index of the storage element that occured immediately before
  * or at time aT ( aT <= getTime(index) ).
  *
- * This method can be much more efficient than findIndex(aT) if a good guess
- * is made for aI.
- * If aI corresponds to a state which occured later than aT, an exhaustive
- * search is performed by calling findIndex(aT).
+ * This method is a little more efficient than findIndex(aT) if aI is the
+ * answer, as when stepping through the storage in small increments of time.
+ * Otherwise the storage is searched by calling findIndex(aT).
  *
- * @param aI Index at which to start searching.
+ * @param aI Index to try first.
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
  * time, 0 is returned.
@@ -2386,28 +3298,20 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 int Storage::
 findIndex(int aI,double aT) const
 {
-	// MAKE SURE aI IS VALID
-	if(_storage.getSize()<=0) return(-1);
-	if((aI>=_storage.getSize())||(aI<0)) aI=0;
-	if(getStateVector(aI)->getTime()>aT) aI=0;
-
-	// SEARCH
-	//cout << "Storage.findIndex: starting at " << aI << endl;
-	int i;
-	for(i=aI;i<_storage.getSize();i++) {
-		if(aT<getStateVector(i)->getTime()) break;
-	}
-	_lastI = i-1;
-	if(_lastI<0) _lastI=0;
-	return(_lastI);
+	int size = getSize();
+	if(size<=0) return(-1);
+	if((aI>=0)&&(aI<size)&&(getTimeAt(aI)<=aT)&&
+	   ((aI+1==size)||(aT<getTimeAt(aI+1)))) return(aI);
+	return(findIndex(aT));
 }
 //_____________________________________________________________________________
 /**
  * Find the index of the storage element that occured immediately before
  * or at a specified time ( getTime(index) <= aT ).
  *
- * This method is not very efficient because it always starts its search
- * with the first stored state.
+ * The times of the storage are assumed to be in increasing order, and are
+ * searched by bisection. Nothing is remembered between searches, so a
+ * storage may be searched from several threads at once.
  *
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
@@ -2416,14 +3320,17 @@ findIndex(int aI,double aT) const
 int Storage::
 findIndex(double aT) const
 {
-	if(_storage.getSize()<=0) return(-1);
-	int i;
-	for(i=0;i<_storage.getSize();i++) {
-		if(aT<getStateVector(i)->getTime()) break;
+	int size = getSize();
+	if(size<=0) return(-1);
+
+	// FIND THE FIRST TIME LATER THAN aT
+	int lo=0, hi=size;
+	while(lo<hi) {
+		int mid = lo + (hi-lo)/2;
+		if(aT<getTimeAt(mid)) hi = mid;
+		else lo = mid+1;
 	}
-	_lastI = i-1;
-	if(_lastI<0) _lastI=0;
-	return(_lastI);
+	return(lo>0 ? lo-1 : 0);
 }
 //_____________________________________________________________________________
 /** 
@@ -2452,7 +3359,7 @@ void Storage::findFrameRange(double aStartTime, double aEndTime, int& oStartFram
 double Storage::
 resample(double aDT, int aDegree)
 {
-	int numDataRows = _storage.getSize();
+	int numDataRows = getSize();
 
 	if(numDataRows<=1) return aDT;
 
@@ -2468,15 +3375,51 @@ resample(double aDT, int aDegree)
 
 	Array<std::string> saveLabels = getColumnLabels();
 	// Free up memory used by Storage
+	bool columnar = _columnar;
 	_storage.setSize(0);
-	// For every column, collect data and fit spline to originalTimes, dataColumn.
-	Storage *newStorage = splineSet->constructStorage(0,aDT);
-	newStorage->setInDegrees(isInDegrees());
-	copyData(*newStorage);
+	delete _mappedFile;
+	_mappedFile = NULL;
+	_columnar = true;
+	_columnarSize = 0;
+	_columnarCapacity = 0;
+	_columnarWidth = splineSet->getSize();
+	_columnarTimes.clear();
+	_columnarData.clear();
+
+	// TIMES
+	// Stepped as in GCVSplineSet::constructStorage().
+	int nc = _columnarWidth;
+	if(nc>0) {
+		double minX = splineSet->getMinX();
+		double maxX = splineSet->getMaxX();
+		ensureColumnarCapacity(10+(int)((maxX-minX)/aDT));
+		for(double x=minX; x<=maxX; x+=aDT) {
+			ensureColumnarCapacity(_columnarSize+1);
+			_columnarTimes[_columnarSize++] = x;
+		}
+	}
+
+	// EVALUATE THE SPLINES
+	// Each column is evaluated independently, on IO::GetNumThreads() threads.
+	if(nc>0 && _columnarSize>0) {
+		int numChunks = numColumnChunks(nc);
+		std::vector<std::string> errors(numChunks);
+		EvaluateSplinesTask task(*splineSet,&_columnarTimes[0],_columnarSize,
+			&_columnarData[0],_columnarCapacity,nc,numChunks,errors);
+		executeChunks(task,numChunks);
+		for(int c=0;c<numChunks;c++) {
+			if(!errors[c].empty()) {
+				delete splineSet;
+				throw Exception("Storage.resample: "+errors[c],__FILE__,__LINE__);
+			}
+		}
+	}
+	// Like a storage constructed from the splines, the result has default units.
+	_units = Units();
+	if(!columnar) setColumnar(false);
 
 	setColumnLabels(saveLabels);
 
-	delete newStorage;
 	delete splineSet;
 
 	return aDT;
@@ -2488,7 +3431,7 @@ resample(double aDT, int aDegree)
 double Storage::
 resampleLinear(double aDT)
 {
-	int numDataRows = _storage.getSize();
+	int numDataRows = getSize();
 
 	if(numDataRows<=1) return aDT;
 
@@ -2508,6 +3451,7 @@ resampleLinear(double aDT)
 	int nr = IO::ComputeNumberOfSteps(ti,tf,aDT);
 
 	Storage *newStorage = new Storage(nr);
+	if(_columnar) newStorage->setColumnar(true);
 
 	// LOOP THROUGH THE DATA
 	int ny=0;
@@ -2558,7 +3502,7 @@ void Storage::interpolateAt(const Array<double> &targetTimes)
 		ny = getDataAtTime(t,ny,&y);
 		vec.setStates(t,ny,y);
 
-		_storage.insert(tIndex+1, vec);
+		rows().insert(tIndex+1, vec);
 	}
 }
 //=============================================================================
@@ -2648,9 +3592,23 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 //printf("Storage.cpp:print storage=%x  n=%d ",&_storage, _storage.getSize());
 //std::cout << aFileName << endl;
 
+	// ROWS FLUSHED FROM MEMORY
+	if(!writeFlushedRows(fp)) {
+		cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
+		return(false);
+	}
+
+	// A columnar row is gathered into a buffer before it is printed.
+	std::vector<double> rowBuffer(_columnar ? _columnarWidth : 0);
+
 	// VECTORS
-	for(int i=0;i<_storage.getSize();i++) {
-		n = getStateVector(i)->print(fp);
+	for(int i=0;i<getSize();i++) {
+		if(_columnar) {
+			const double *y = getRowData(i,rowBuffer.data());
+			n = writeRow(fp,columnarTimes()[i],_columnarWidth,y);
+		} else {
+			n = getStateVector(i)->print(fp);
+		}
 		if(n<0) {
 			cout << "Storage.print(const string&,const string&): error printing to " << aFileName;
 			return(false);
@@ -2664,6 +3622,178 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 	return(nTotal!=0);
 }
 //_____________________________________________________________________________
+/**
+ * Write the contents of this storage instance to a binary file.
+ *
+ * The file starts with a fixed 64 byte preamble (format identifier,
+ * version, byte order mark, inDegrees flag, units, number of rows, number
+ * of states, column block length, and the offset of the data), followed by
+ * the name, description, and column labels.  The data follow at a 64 byte
+ * aligned offset as one block for the time column and one block per state,
+ * each holding the same number of float64 values.  Values are written
+ * exactly, independent of the precision set with IO::SetPrecision().
+ *
+ * The file is read back by the Storage(const std::string&) constructor,
+ * which recognizes the format from the file contents rather than from the
+ * extension.  Files are written in the byte order of the machine.
+ *
+ * @param aFileName Name of the file to write.
+ * @return true if the file was written, false otherwise.
+ */
+bool Storage::
+printBinary(const string &aFileName) const
+{
+	long long nr = getSize();
+	long long ny = getSmallestNumberOfStates();
+	long long stride = ((nr+7)/8)*8;
+
+	// HEADER
+	std::vector<char> header(BINARY_PREAMBLE_SIZE,0);
+	memcpy(&header[0],BINARY_FILE_MAGIC,sizeof(BINARY_FILE_MAGIC));
+	int fields[4] = { BinaryVersion,(int)BINARY_BYTE_ORDER_MARK,
+		_inDegrees ? 1 : 0,(int)_units.getType() };
+	memcpy(&header[8],fields,sizeof(fields));
+	appendString(header,getName());
+	appendString(header,getDescription());
+	int nLabels = _columnLabels.getSize();
+	appendBytes(header,&nLabels,sizeof(nLabels));
+	for(int i=0;i<nLabels;i++) appendString(header,_columnLabels[i]);
+	long long dataOffset = ((header.size()+63)/64)*64;
+	header.resize(dataOffset,0);
+	long long sizes[4] = { nr,ny,stride,dataOffset };
+	memcpy(&header[24],sizes,sizeof(sizes));
+
+	// OPEN THE FILE
+	FILE *fp = IO::OpenFile(aFileName,"wb");
+	if(fp==NULL) return(false);
+	bool ok = (fwrite(&header[0],1,header.size(),fp)==header.size());
+
+	// COLUMN BLOCKS
+	// Columnar data are written straight from their buffers; rows are
+	// gathered one column at a time.
+	std::vector<double> block(stride,0.0);
+	for(long long c=-1;ok && c<ny;c++) {
+		if(_columnar) {
+			const double *column = (c<0) ? columnarTimes() : columnarData() + c*_columnarCapacity;
+			if(nr>0) memcpy(&block[0],column,nr*sizeof(double));
+		} else {
+			for(int i=0;i<nr;i++)
+				block[i] = (c<0) ? _storage[i].getTime() : _storage[i].getData()[(int)c];
+		}
+		if(stride>0) ok = (fwrite(&block[0],sizeof(double),stride,fp)==(size_t)stride);
+	}
+
+	// CLOSE
+	if(fclose(fp)!=0) ok = false;
+	if(!ok) cout << "Storage.printBinary: error writing to " << aFileName << endl;
+	return(ok);
+}
+//_____________________________________________________________________________
+/**
+ * Determine whether a file is a binary storage file (see printBinary()).
+ *
+ * @param aFileName Name of the file.
+ * @return true if the file exists and starts with the binary file
+ * identifier.
+ */
+bool Storage::
+IsBinaryFile(const string &aFileName)
+{
+	FILE *fp = fopen(aFileName.c_str(),"rb");
+	if(fp==NULL) return(false);
+	char magic[sizeof(BINARY_FILE_MAGIC)];
+	bool isBinary = (fread(magic,1,sizeof(magic),fp)==sizeof(magic)) &&
+		(memcmp(magic,BINARY_FILE_MAGIC,sizeof(magic))==0);
+	fclose(fp);
+	return(isBinary);
+}
+//_____________________________________________________________________________
+/**
+ * Read a binary storage file (see printBinary()).
+ *
+ * The file is memory mapped and the data are left in place, so a column
+ * is only read from disk when it is accessed.  The storage is columnar (see
+ * setColumnar()) and keeps the file open until the data are modified or the
+ * layout is changed, at which point the data are copied into memory.
+ *
+ * @param aFileName Name of the file.
+ * @param aReadHeadersOnly If true, only the name, description, units, and
+ * column labels are read.
+ */
+void Storage::
+readBinary(const string &aFileName,bool aReadHeadersOnly)
+{
+	MemoryMappedFile *file = new MemoryMappedFile(aFileName);
+	const char *begin = file->getData();
+	const char *end = begin + file->getSize();
+
+	// PREAMBLE
+	int fields[4];
+	long long sizes[4];
+	bool ok = file->isOpen() && file->getSize()>=(size_t)BINARY_PREAMBLE_SIZE;
+	if(ok) {
+		memcpy(fields,begin+8,sizeof(fields));
+		memcpy(sizes,begin+24,sizeof(sizes));
+		ok = (memcmp(begin,BINARY_FILE_MAGIC,sizeof(BINARY_FILE_MAGIC))==0) &&
+			(unsigned int)fields[1]==BINARY_BYTE_ORDER_MARK;
+	}
+	if(ok && (fields[0]<1 || fields[0]>BinaryVersion)) {
+		delete file;
+		throw Exception("Storage: ERROR- unsupported binary storage version in file "
+			+ aFileName, __FILE__,__LINE__);
+	}
+	long long nr = sizes[0], ny = sizes[1], stride = sizes[2], dataOffset = sizes[3];
+	ok = ok && nr>=0 && ny>=0 && stride>=nr && stride<=INT_MAX && ny<=INT_MAX &&
+		dataOffset>=BINARY_PREAMBLE_SIZE && dataOffset%8==0 &&
+		dataOffset<=(long long)file->getSize() &&
+		(ny+1)*stride <= ((long long)file->getSize()-dataOffset)/(long long)sizeof(double);
+
+	// NAME, DESCRIPTION, AND COLUMN LABELS
+	string name,description,label;
+	int nLabels = 0;
+	const char *pos = begin + BINARY_PREAMBLE_SIZE;
+	const char *labelsEnd = begin + (ok ? dataOffset : 0);
+	ok = ok && readString(pos,labelsEnd,name) && readString(pos,labelsEnd,description);
+	if(ok && labelsEnd-pos>=(long long)sizeof(nLabels)) {
+		memcpy(&nLabels,pos,sizeof(nLabels));
+		pos += sizeof(nLabels);
+	} else ok = false;
+	Array<string> labels("");
+	for(int i=0;ok && i<nLabels;i++) {
+		ok = readString(pos,labelsEnd,label);
+		labels.append(label);
+	}
+	if(!ok) {
+		delete file;
+		throw Exception("Storage: ERROR- failed to read binary storage file " + aFileName,
+			__FILE__,__LINE__);
+	}
+	cout << "Storage: file=" << aFileName << " (nr=" << nr << " nc=" << ny+1
+		<< ", binary)" << endl;
+
+	setName(name);
+	setDescription(description);
+	setInDegrees(fields[2]!=0);
+	_units = Units((Units::UnitType)fields[3]);
+	_columnLabels = labels;
+	_fileVersion = LatestVersion;
+
+	if(aReadHeadersOnly) {
+		delete file;
+		return;
+	}
+
+	// DATA- LEFT IN THE MAPPED FILE
+	_storage.setSize(0);
+	_columnar = true;
+	_columnarSize = (int)nr;
+	_columnarCapacity = (int)stride;
+	_columnarWidth = (int)ny;
+	_mappedFile = file;
+	_mappedTimes = (const double*)(begin + dataOffset);
+	_mappedData = _mappedTimes + stride;
+}
+//_____________________________________________________________________________
 /**
  * Print the contents of this storage instance to a file named by the argument
  * aFileaName using uniform time spacing.
@@ -2684,6 +3814,15 @@ print(const string &aFileName,double aDT,const string &aMode) const
 	if(aDT<=0) return(0);
 
 	if (_fp!= NULL) fclose(_fp);
+
+	// INTERPOLATION NEEDS THE ROWS FLUSHED FROM MEMORY, SO PRINT A FULL COPY
+	if(_numFlushedRows>0) {
+		Storage copy(*this);
+		copy._writeSIMMHeader = _writeSIMMHeader;
+		copy._keyValueMap = _keyValueMap;
+		return(copy.print(aFileName,aDT,aMode));
+	}
+
 	// OPEN THE FILE
 	FILE *fp = IO::OpenFile(aFileName,aMode);
 	if(fp==NULL) return(-1);
@@ -2779,7 +3918,7 @@ writeHeader(FILE *rFP,double aDT) const
 	// COMPUTE ATTRIBUTES
 	int nr,nc;
 	if(aDT<=0) {
-		nr = _storage.getSize();
+		nr = getSize() + _numFlushedRows;
 	} else {
 		double ti = getFirstTime();
 		double tf = getLastTime();
@@ -2824,7 +3963,7 @@ writeSIMMHeader(FILE *rFP,double aDT, const char *aComment) const
 	// ROWS
 	int nRows;
 	if(aDT<=0) {
-		nRows = _storage.getSize();
+		nRows = getSize() + _numFlushedRows;
 	} else {
 		nRows = IO::ComputeNumberOfSteps(getFirstTime(),getLastTime(),aDT);
 	}
@@ -2892,6 +4031,34 @@ writeColumnLabels(FILE *rFP) const
 
 	return(0);
 }
+//_____________________________________________________________________________
+/**
+ * Write a single row of data.  The format matches StateVector::print().
+ *
+ * @param rFP File pointer.
+ * @return Number of characters written, or a negative number on error.
+ */
+int Storage::
+writeRow(FILE *rFP,double aT,int aN,const double *aY) const
+{
+	char format[IO_STRLEN];
+	sprintf(format,"%s",IO::GetDoubleOutputFormat());
+	int n=0,nTotal=0;
+	n = fprintf(rFP,format,aT);
+	if(n<0) return(n);
+	nTotal += n;
+
+	sprintf(format,"\t%s",IO::GetDoubleOutputFormat());
+	for(int i=0;i<aN;i++) {
+		n = fprintf(rFP,format,aY[i]);
+		if(n<0) return(n);
+		nTotal += n;
+	}
+
+	n = fprintf(rFP,"\n");
+	if(n<0) return(n);
+	return(nTotal+n);
+}
 void Storage::addToRdStorage(Storage& rStorage, double aStartTime, double aEndTime)
 {
 	bool addedData = false;
@@ -3086,6 +4253,108 @@ bool Storage::parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColum
 	return true;
 }
 //_____________________________________________________________________________
+/**
+ * Read the data rows of a storage file by memory mapping the file and
+ * parsing its lines in parallel, straight into the columnar buffers (see
+ * setColumnar()), which are allocated for all rows up front.
+ *
+ * Only the regular layout in which each row occupies exactly one line is
+ * handled.  If the file deviates from it in any way (e.g., a row wrapped
+ * over several lines or a token that is not a number), the storage is left
+ * empty and false is returned so that the caller can fall back to reading
+ * the file through a stream.
+ *
+ * As when the rows are appended one at a time, a row with the same time as
+ * the row before it replaces that row.
+ *
+ * @param aFileName Name of the storage file.
+ * @param aDataOffset Offset in bytes of the first data row in the file.
+ * @param aNumRows Number of rows specified in the header.
+ * @param aNumColumns Number of columns specified in the header.
+ * @param aHasTime Whether the first column holds the time (or range).  If
+ * not, the row index is used as the time.
+ * @return true if all rows were read, false otherwise.
+ */
+bool Storage::
+readDataFast(const string &aFileName,long long aDataOffset,int aNumRows,
+	int aNumColumns,bool aHasTime)
+{
+	if(aNumRows<=0 || aNumColumns<=0) return(false);
+	int ny = aHasTime ? aNumColumns-1 : aNumColumns;
+
+	MemoryMappedFile file(aFileName);
+	if(!file.isOpen() || (size_t)aDataOffset>file.getSize()) return(false);
+	const char *end = file.getData() + file.getSize();
+
+	// LOCATE THE START OF EACH DATA LINE
+	// Blank lines are skipped, as they would be when reading from a stream.
+	std::vector<const char*> lineStarts;
+	lineStarts.reserve(aNumRows);
+	const char *pos = file.getData() + aDataOffset;
+	while(pos<end && (int)lineStarts.size()<aNumRows) {
+		const char *eol = (const char*)memchr(pos,'\n',end-pos);
+		if(eol==NULL) eol = end;
+		const char *p = pos;
+		while(p<eol && (*p==' ' || *p=='\t' || *p=='\r')) p++;
+		if(p<eol) lineStarts.push_back(pos);
+		pos = eol + 1;
+	}
+	if((int)lineStarts.size()<aNumRows) return(false);
+
+	// ALLOCATE THE COLUMNAR BUFFERS FOR ALL ROWS
+	_columnar = true;
+	_columnarSize = 0;
+	_columnarCapacity = 0;
+	_columnarWidth = ny;
+	_columnarTimes.clear();
+	_columnarData.clear();
+	ensureColumnarCapacity(aNumRows);
+
+	// PARSE
+	// Small files are not worth the overhead of dispatching threads.
+	int numChunks = 1;
+	if((long long)aNumRows*aNumColumns>=100000) {
+		numChunks = 4*IO::GetNumThreads();
+		if(numChunks>aNumRows/256+1) numChunks = aNumRows/256+1;
+	}
+	std::vector<char> failed(numChunks,0);
+	ParseLinesTask task(lineStarts,end,aNumColumns,aHasTime,numChunks,
+		_columnarTimes.data(),_columnarData.data(),_columnarCapacity,failed);
+	executeChunks(task,numChunks);
+	for(int i=0;i<numChunks;i++) {
+		if(failed[i]) {
+			_columnar = false;
+			_columnarCapacity = 0;
+			_columnarWidth = -1;
+			std::vector<double>().swap(_columnarTimes);
+			std::vector<double>().swap(_columnarData);
+			return(false);
+		}
+	}
+
+	// DROP ROWS REPLACED BY A LATER ROW WITH THE SAME TIME
+	int nr = 1;
+	for(int r=1;r<aNumRows;r++) {
+		if(_columnarTimes[r]==_columnarTimes[nr-1]) nr--;
+		if(nr!=r) {
+			_columnarTimes[nr] = _columnarTimes[r];
+			for(int c=0;c<ny;c++) {
+				double *y = &_columnarData[(size_t)c*_columnarCapacity];
+				y[nr] = y[r];
+			}
+		}
+		nr++;
+	}
+	_columnarSize = nr;
+
+	// RELEASE THE STATEVECTORS RESERVED FOR THE STREAM READER
+	int increment = _storage.getCapacityIncrement();
+	_storage = Array<StateVector>(StateVector());
+	_storage.setCapacityIncrement(increment);
+
+	return(true);
+}
+//_____________________________________________________________________________
 /**
  * This function exchanges the time column (including the label) with the column	
  * at the passed in aColumnIndex. The index is zero based relative to the Data
@@ -3094,7 +4363,7 @@ void Storage::
 exchangeTimeColumnWith(int aColumnIndex)
 {
 	StateVector* vec;
-	for(int i=0; i< _storage.getSize(); i++){
+	for(int i=0; i< rows().getSize(); i++){
 		vec = getStateVector(i);
 		double swap = vec->getData().get(aColumnIndex);
 		double time=vec->getTime();
@@ -3133,15 +4402,15 @@ void Storage::postProcessSIMMMotion()
 				string rangeValue = iter->second;
 				double start, end;
 				sscanf(rangeValue.c_str(), "%lf %lf", &start, &end);
-				if (_storage.getSize()<2){	// Something wrong throw exception unless start==end
+				if (rows().getSize()<2){	// Something wrong throw exception unless start==end
 					if (start !=end){
 						stringstream errorMessage;
 						errorMessage << "Error: Motion file has inconsistent headers";
 						throw (Exception(errorMessage.str()));
 					}
-					else if (_storage.getSize()==1){
+					else if (rows().getSize()==1){
 						// Prepend a Time column
-						StateVector vec = _storage.get(0);
+						StateVector vec = rows().get(0);
 						vec.getData().append(0.0);
 						_columnLabels.append("time");
 						exchangeTimeColumnWith(_columnLabels.findIndex("time"));
@@ -3150,10 +4419,10 @@ void Storage::postProcessSIMMMotion()
 						throw (Exception("File has no data"));
 				}
 				else {	// time  column from range, size
-					double timeStep = (end - start)/(_storage.getSize()-1);
+					double timeStep = (end - start)/(rows().getSize()-1);
 					_columnLabels.append("time");
-					for(int i=0; i<_storage.getSize(); i++){
-						Array<double>& data=_storage.updElt(i).getData();
+					for(int i=0; i<rows().getSize(); i++){
+						Array<double>& data=rows().updElt(i).getData();
 						data.append(i*timeStep);
 					}
 					int timeColumnIndex=_columnLabels.findIndex("time");
@@ -50,6 +50,11 @@ const int Storage_DEFAULT_CAPACITY = 256;
  * rest of the elements in a row are the states.  Therefore, each column of
  * data in a file corresponds to a particular state.
  *
+ * A storage can also be written to and read from a binary file (see
+ * printBinary()).  The binary file holds each column in a contiguous block,
+ * and it is memory mapped when read, so only the columns that are accessed
+ * are brought into memory.
+ *
  * In an Storage object, statevectors (or rows) are indexed by the
  * TimeIndex, and a particular state (or column) is indexed by the
  * StateIndex.
@@ -61,6 +66,8 @@ namespace OpenSim {
 
 typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToValues;
 
+class MemoryMappedFile;
+
 //static std::string[] simmReservedKeys;
 class OSIMCOMMON_API Storage : public StorageInterface {
 OpenSim_DECLARE_CONCRETE_OBJECT(Storage, StorageInterface);
@@ -77,8 +84,9 @@ public:
 protected:
 	static std::string simmReservedKeys[];
 
-	/** Array of StateVectors. */
-	Array<StateVector> _storage;
+	/** Array of StateVectors. Empty while the data are held in the columnar
+	buffers (see setColumnar()). */
+	mutable Array<StateVector> _storage;
 	/** Token used to mark the end of the description in a file. */
 	std::string _headerToken;
 	/** Column labels. */
@@ -86,8 +94,6 @@ protected:
 	/** Step interval at which states in a simulation are stored. See
 	store(). */
 	int _stepInterval;
-	/** Last index at which a search was started. */
-	mutable int _lastI;
 	/** Flag for whether or not to insert a SIMM style header. */
 	bool _writeSIMMHeader;
 	/** Units in which the data is represented. */
@@ -106,6 +112,44 @@ protected:
 	/** Storage file version as written to the file */
 	int _fileVersion;
 	static const int LatestVersion;
+
+	/** Flag indicating whether the data are held in the contiguous columnar
+	buffers below instead of in _storage. */
+	mutable bool _columnar;
+	/** Number of rows held in the columnar buffers. */
+	mutable int _columnarSize;
+	/** Number of rows for which the columnar buffers are allocated. */
+	mutable int _columnarCapacity;
+	/** Number of states (columns, excluding time) in every row. -1 until the
+	first row is appended. */
+	mutable int _columnarWidth;
+	/** Time stamps, one per row. */
+	mutable std::vector<double> _columnarTimes;
+	/** Data stored column-major; state i occupies the _columnarCapacity
+	entries starting at i*_columnarCapacity. */
+	mutable std::vector<double> _columnarData;
+	/** Binary file from which the columnar data are read in place, or NULL
+	if the data are held in the buffers above. */
+	mutable MemoryMappedFile *_mappedFile;
+	/** Time stamps and data inside _mappedFile, laid out like the buffers
+	above. */
+	mutable const double *_mappedTimes;
+	mutable const double *_mappedData;
+	/** Number of rows held in memory before the older ones are flushed to
+	_flushFile (see setFlushInterval()). 0 keeps all rows in memory. */
+	int _flushInterval;
+	/** Temporary file holding the rows flushed from memory, in binary. */
+	FILE *_flushFile;
+	/** Number of rows in _flushFile. */
+	int _numFlushedRows;
+	/** Time of the first flushed row. */
+	double _flushedFirstTime;
+	/** Smallest number of states of the flushed rows. */
+	int _flushedMinStates;
+	/** Identifies a binary storage file. */
+	static const char BINARY_FILE_MAGIC[8];
+	/** Version of the binary storage file format. */
+	static const int BinaryVersion;
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -142,18 +186,42 @@ private:
 	void copyData(const Storage &aStorage);
 	void parseColumnLabels(const char *aLabels);
 	bool parseHeaders(std::ifstream& aStream, int& rNumRows, int& rNumColumns);
+	bool readDataFast(const std::string& aFileName,long long aDataOffset,
+		int aNumRows,int aNumColumns,bool aHasTime);
 	bool isSimmReservedToken(const std::string& aToken);
 	void postProcessSIMMMotion();
 	void exchangeTimeColumnWith(int aColumnIndex);
+	bool packColumns() const;
+	void unpackColumns() const;
+	void ensureColumnarCapacity(int aCapacity) const;
+	void releaseMappedFile() const;
+	void filterColumns(int aFilter,int aOrder,double aDT,double aCutoffFrequency);
+	const double* columnarTimes() const {
+		return(_mappedFile ? _mappedTimes : _columnarTimes.data()); }
+	const double* columnarData() const {
+		return(_mappedFile ? _mappedData : _columnarData.data()); }
+	void readBinary(const std::string &aFileName,bool aReadHeadersOnly);
+	void flushRows();
+	void discardFlushedRows();
+	bool writeFlushedRows(FILE *rFP) const;
+	void appendFlushedRows(Storage &rStorage) const;
+	Array<StateVector>& rows() const {
+		if(_columnar) unpackColumns();
+		return _storage; }
+	double getTimeAt(int aTimeIndex) const {
+		return(_columnar ? _columnarTimes[aTimeIndex] : _storage[aTimeIndex].getTime()); }
+	const double* getRowData(int aTimeIndex,double *rBuffer) const;
 public:
 
 	//--------------------------------------------------------------------------
 	// GET AND SET
 	//--------------------------------------------------------------------------
 	// SIZE
-	virtual int getSize() const { return(_storage.getSize()); }
+	virtual int getSize() const {
+		return(_columnar ? _columnarSize : _storage.getSize()); }
 	// STATEVECTOR
 	int getSmallestNumberOfStates() const;
+	int getLargestNumberOfStates() const;
 	virtual StateVector* getStateVector(int aTimeIndex) const;
 	virtual StateVector* getLastStateVector() const;
 	// TIME
@@ -205,6 +273,19 @@ public:
 	 */
 	OpenSim::Array<int>  getColumnIndicesForIdentifier(const std::string& identifier) const;
 
+	// COLUMNAR BACKING STORE
+	bool setColumnar(bool aTrueFalse);
+	/** Are the data held in contiguous column-major buffers? */
+	bool isColumnar() const { return _columnar; }
+	const double* getTimeColumnBuffer() const;
+	const double* getDataColumnBuffer(int aStateIndex) const;
+	// STREAMING
+	void setFlushInterval(int aNumRows);
+	/** Number of rows kept in memory before older rows are flushed. */
+	int getFlushInterval() const { return _flushInterval; }
+	/** Number of rows flushed from memory (not counted by getSize()). */
+	int getNumFlushedRows() const { return _numFlushedRows; }
+
 	// STEP INTERVAL
 	void setStepInterval(int aStepInterval);
 	int getStepInterval() const;
@@ -225,7 +306,7 @@ public:
 	//--------------------------------------------------------------------------
 	int reset(int aIndex=0);
 	int reset(double aTime);
-	void purge() { _storage.setSize(0); };	// Similar to reset but doesn't try to keep history
+	void purge() { _storage.setSize(0); _columnarSize=0; discardFlushedRows(); };	// Similar to reset but doesn't try to keep history
 	void crop(const double newStartTime, const double newFinalTime);
 	//--------------------------------------------------------------------------
 	// STORAGE
@@ -297,6 +378,8 @@ public:
 	//--------------------------------------------------------------------------
 	bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
 	int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
+	bool printBinary(const std::string &aFileName) const;
+	static bool IsBinaryFile(const std::string &aFileName);
 	void setOutputFileName(const std::string& aFileName) ;
 	// convenience function for Analyses and DerivCallbacks
 	static void printResult(const Storage *aStorage,const std::string &aName,
@@ -307,6 +390,7 @@ private:
 	int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
 	int writeDescription(FILE *rFP) const;
 	int writeColumnLabels(FILE *rFP) const;
+	int writeRow(FILE *rFP,double aT,int aN,const double *aY) const;
 	int integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const;
 	int integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const;
 
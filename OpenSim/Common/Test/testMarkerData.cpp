@@ -21,6 +21,7 @@
  * -------------------------------------------------------------------------- */
 
 #include <fstream>
+#include <sstream>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/MarkerData.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
@@ -28,6 +29,9 @@
 using namespace OpenSim;
 using namespace std;
 
+void testBinaryRoundTrip(const string& markerFile);
+void testLargeTRCFile(int nFrames, int nMarkers);
+
 int main() {
 	// Create a storge from a std file "std_storage.sto"
     try {
@@ -42,6 +46,18 @@ int main() {
 		md.findFrameRange(0.004, 0.012, rStartFrame, rEndFrame);
 		ASSERT(rStartFrame==1);
 		ASSERT(rEndFrame==3);
+		md.findFrameRange(0.008, 0.008, rStartFrame, rEndFrame);
+		ASSERT(rStartFrame==2);
+		ASSERT(rEndFrame==2);
+		md.findFrameRange(0.005, 0.007, rStartFrame, rEndFrame);
+		ASSERT(rStartFrame==1);
+		ASSERT(rEndFrame==2);
+		md.findFrameRange(-1.0, -0.5, rStartFrame, rEndFrame);
+		ASSERT(rStartFrame==0);
+		ASSERT(rEndFrame==0);
+		md.findFrameRange(0.02, 0.03, rStartFrame, rEndFrame);
+		ASSERT(rStartFrame==4);
+		ASSERT(rEndFrame==4);
 		// ToBeTested void averageFrames(double aThreshold = -1.0, double aStartTime = -SimTK::Infinity, double aEndTime = SimTK::Infinity);
 		ASSERT(md.getFileName()=="TRCFileWithNANs.trc");
 		Storage storage;
@@ -81,6 +97,10 @@ int main() {
 		const SimTK::Vec3& m31 = markers3[1];    
 		SimTK::Vec3 diff3 = (markers3[1]-SimTK::Vec3(expectedData3));
 		ASSERT(diff.norm() < 1e-7, __FILE__, __LINE__);
+
+		testBinaryRoundTrip("TRCFileWithNANs.trc");
+		testBinaryRoundTrip("testNaNsParsing.trc");
+		testLargeTRCFile(100000, 50);
 	}
     catch(const Exception& e) {
         e.print(cerr);
@@ -89,3 +109,93 @@ int main() {
     cout << "Done" << endl;
     return 0;
 }
+
+// Write the marker data of a TRC file to a TRB file, read it back and check
+// that nothing changed, including the missing (NaN) markers.
+void testBinaryRoundTrip(const string& markerFile)
+{
+	MarkerData trc(markerFile);
+	string binaryFile = markerFile.substr(0, markerFile.size()-4) + ".trb";
+	ASSERT(trc.printBinary(binaryFile), __FILE__, __LINE__);
+	MarkerData trb(binaryFile);
+
+	ASSERT(trb.getNumFrames()==trc.getNumFrames(), __FILE__, __LINE__);
+	ASSERT(trb.getNumMarkers()==trc.getNumMarkers(), __FILE__, __LINE__);
+	ASSERT(trb.getUnits().getType()==trc.getUnits().getType(), __FILE__, __LINE__);
+	ASSERT(trb.getDataRate()==trc.getDataRate(), __FILE__, __LINE__);
+	ASSERT(trb.getCameraRate()==trc.getCameraRate(), __FILE__, __LINE__);
+	for (int j=0; j<trc.getNumMarkers(); j++)
+		ASSERT(trb.getMarkerNames()[j]==trc.getMarkerNames()[j], __FILE__, __LINE__);
+	for (int i=0; i<trc.getNumFrames(); i++) {
+		ASSERT(trb.getFrameTime(i)==trc.getFrameTime(i), __FILE__, __LINE__);
+		ASSERT(trb.getFrameNumber(i)==trc.getFrameNumber(i), __FILE__, __LINE__);
+		const SimTK::Array_<SimTK::Vec3>& expected = trc.getFrame(i).getMarkers();
+		const SimTK::Vec3* markers = trb.getFrameMarkers(i);
+		for (int j=0; j<trc.getNumMarkers(); j++)
+			for (int k=0; k<3; k++)
+				ASSERT(markers[j][k]==expected[j][k] ||
+					(SimTK::isNaN(markers[j][k]) && SimTK::isNaN(expected[j][k])), __FILE__, __LINE__);
+	}
+}
+
+// Read a large synthetic TRC file, check every coordinate, and report the
+// time taken to read it as TRC and as TRB.
+void testLargeTRCFile(int nFrames, int nMarkers)
+{
+	string markerFile = "testLargeTRCFile.trc";
+	ofstream out(markerFile.c_str());
+	out << "PathFileType\t4\t(X/Y/Z)\t" << markerFile << endl;
+	out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames" << endl;
+	out << "1000\t1000\t" << nFrames << "\t" << nMarkers << "\tmm\t1000\t1\t" << nFrames << endl;
+	out << "Frame#\tTime";
+	for (int j=0; j<nMarkers; j++)
+		out << "\tM" << j << "\t\t";
+	out << endl << "\t";
+	for (int j=0; j<nMarkers; j++)
+		out << "\tX" << j+1 << "\tY" << j+1 << "\tZ" << j+1;
+	out << endl << endl;
+	// Every 7th marker of every 3rd frame is missing
+	for (int i=0; i<nFrames; i++) {
+		out << i+1 << "\t" << 0.001*i;
+		for (int j=0; j<nMarkers; j++) {
+			if (i%3==0 && j%7==0)
+				out << "\t\t\t";
+			else
+				out << "\t" << i << "." << j << "\t" << -j << "\t" << 0.5*j;
+		}
+		out << endl;
+	}
+	out.close();
+
+	double start = SimTK::realTime();
+	MarkerData trc(markerFile);
+	double trcTime = SimTK::realTime()-start;
+
+	ASSERT(trc.getNumFrames()==nFrames, __FILE__, __LINE__);
+	ASSERT(trc.getNumMarkers()==nMarkers, __FILE__, __LINE__);
+	for (int i=0; i<nFrames; i++) {
+		ASSERT(trc.getFrameNumber(i)==i+1, __FILE__, __LINE__);
+		ASSERT(fabs(trc.getFrameTime(i)-0.001*i) < 1e-12, __FILE__, __LINE__);
+		const SimTK::Vec3* markers = trc.getFrameMarkers(i);
+		for (int j=0; j<nMarkers; j++) {
+			if (i%3==0 && j%7==0) {
+				ASSERT(markers[j].isNaN(), __FILE__, __LINE__);
+			} else {
+				ostringstream x;
+				x << i << "." << j;
+				ASSERT(markers[j][0]==atof(x.str().c_str()), __FILE__, __LINE__);
+				ASSERT(markers[j][1]==-j && markers[j][2]==0.5*j, __FILE__, __LINE__);
+			}
+		}
+	}
+
+	ASSERT(trc.printBinary("testLargeTRCFile.trb"), __FILE__, __LINE__);
+	start = SimTK::realTime();
+	MarkerData trb("testLargeTRCFile.trb");
+	double trbTime = SimTK::realTime()-start;
+	ASSERT(trb.getNumFrames()==nFrames, __FILE__, __LINE__);
+
+	cout << "*********************** testLargeTRCFile ***********************" << endl;
+	cout << nFrames << " frames of " << nMarkers << " markers read in " << trcTime
+		 << "s from TRC and " << trbTime << "s from TRB." << endl;
+}
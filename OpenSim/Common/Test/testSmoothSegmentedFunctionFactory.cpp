@@ -1131,6 +1131,138 @@ void testMonotonicity(SimTK::Matrix mcfSample)
     cout << endl;
 }
 
+/*
+ 6. The lookup table of each curve will be tested against the exact curve. 
+    The errors sampled while the table was built meet its tolerance (see 
+    SmoothSegmentedFunction::setUseLookupTable). They are an estimate, not a 
+    bound, so on a finer grid the errors may exceed the tolerance by up to a 
+    factor of 2. A tolerance that cannot be met leaves the table as it was.
+    The time taken to evaluate the curve with and without the table is 
+    reported.
+*/
+void testMuscleCurveLookupTable(SmoothSegmentedFunction mcf)
+{
+    cout << "   TEST: Lookup Table " << endl;
+    double tol = 1e-8;
+    int npts = 10000;
+
+    SmoothSegmentedFunction mcfTable = mcf;
+    SimTK_TEST_MUST_THROW(mcfTable.setUseLookupTable(true, 0));
+    mcfTable.setUseLookupTable(true, tol);
+    SimTK_TEST(mcfTable.getUseLookupTable());
+    SimTK_TEST(!mcf.getUseLookupTable());
+
+    SimTK::Vec2 domain = mcf.getCurveDomain();
+    double dx = (domain(1)-domain(0))/(npts-1);
+    SimTK::Vector x(npts);
+    for(int i=0; i<npts; i++){
+        x(i) = domain(0) + i*dx;
+    }
+
+    SimTK::Vec3 scale(1.0);
+    SimTK::Vec3 error(0.0);
+    for(int i=0; i<npts; i++){
+        for(int k=0; k<3; k++){
+            double exact = mcf.calcDerivative(x(i),k);
+            scale[k] = max(scale[k], abs(exact));
+            error[k] = max(error[k], abs(mcfTable.calcDerivative(x(i),k)-exact));
+        }
+    }
+    for(int k=0; k<3; k++){
+        SimTK_TEST(error[k] <= 2*tol*scale[k]);
+        SimTK_TEST(mcfTable.getLookupTableMaxError()[k] <= tol*scale[k]);
+    }
+
+    SimTK::Vec3 maxError = mcfTable.getLookupTableMaxError();
+    double yTable = mcfTable.calcValue(x(npts/3));
+    SimTK_TEST_MUST_THROW(mcfTable.setUseLookupTable(true, 1e-30));
+    SimTK_TEST(mcfTable.getUseLookupTable());
+    SimTK_TEST(mcfTable.getLookupTableMaxError() == maxError);
+    SimTK_TEST(mcfTable.calcValue(x(npts/3)) == yTable);
+
+    //The linear extrapolation and higher derivatives are not tabulated
+    double xLeft  = domain(0) - 0.1;
+    double xRight = domain(1) + 0.1;
+    SimTK_TEST(mcfTable.calcValue(xLeft) == mcf.calcValue(xLeft));
+    SimTK_TEST(mcfTable.calcValue(xRight) == mcf.calcValue(xRight));
+    SimTK_TEST(mcfTable.calcDerivative(x(npts/3),3) 
+               == mcf.calcDerivative(x(npts/3),3));
+
+    int nreps = 20;
+    double sumExact = 0;
+    double start = SimTK::realTime();
+    for(int r=0; r<nreps; r++){
+        for(int i=0; i<npts; i++){
+            sumExact += mcf.calcValue(x(i));
+        }
+    }
+    double exactTime = SimTK::realTime()-start;
+
+    double sumTable = 0;
+    start = SimTK::realTime();
+    for(int r=0; r<nreps; r++){
+        for(int i=0; i<npts; i++){
+            sumTable += mcfTable.calcValue(x(i));
+        }
+    }
+    double tableTime = SimTK::realTime()-start;
+    SimTK_TEST_EQ_TOL(sumExact, sumTable, 2*nreps*npts*tol*scale[0]);
+
+    printf( "   passed: lookup table errors in y, dy/dx and d2y/dx2 of\n"
+            "           %e, %e and %e\n"
+            "           %i calls to calcValue: %f s exact, %f s table\n",
+            error[0], error[1], error[2], nreps*npts, exactTime, tableTime);
+    cout << endl;
+}
+
+/*
+ 7. The batch evaluation of each curve, with and without a lookup table, 
+    will be tested against its point by point evaluation, both within the 
+    curve domain and in the linear extrapolation regions.
+*/
+void testMuscleCurveBatchEvaluation(SmoothSegmentedFunction mcf)
+{
+    cout << "   TEST: Batch Evaluation " << endl;
+    int npts = 1000;
+
+    SmoothSegmentedFunction mcfTable = mcf;
+    mcfTable.setUseLookupTable(true);
+
+    SimTK::Vec2 domain = mcf.getCurveDomain();
+    double width = domain(1)-domain(0);
+    double dx = 1.2*width/(npts-1);
+    SimTK::Vector x(npts);
+    for(int i=0; i<npts; i++){
+        x(i) = domain(0) - 0.1*width + i*dx;
+    }
+
+    SimTK::Vector y(npts), dydx(npts), d2ydx2(npts);
+    SimTK::Array_<const SmoothSegmentedFunction*> fcns(npts);
+    for(int i=0; i<npts; i++){
+        fcns[i] = (i%2 == 0) ? &mcf : &mcfTable;
+    }
+    SmoothSegmentedFunction::calcValueAndDerivatives(npts, &fcns[0], 
+        &x[0], &y[0], &dydx[0], &d2ydx2[0]);
+    for(int i=0; i<npts; i++){
+        SimTK_TEST_EQ_TOL(y(i), fcns[i]->calcValue(x(i)), 
+            1e-14*max(1.0,abs(y(i))));
+        SimTK_TEST_EQ_TOL(dydx(i), fcns[i]->calcDerivative(x(i),1), 
+            1e-14*max(1.0,abs(dydx(i))));
+        SimTK_TEST_EQ_TOL(d2ydx2(i), fcns[i]->calcDerivative(x(i),2), 
+            1e-14*max(1.0,abs(d2ydx2(i))));
+    }
+
+    //Outputs that are not needed are not computed
+    SimTK::Vector yOnly(npts);
+    mcf.calcValueAndDerivatives(npts, &x[0], &yOnly[0]);
+    for(int i=0; i<npts; i++){
+        SimTK_TEST(yOnly(i) == mcf.calcValue(x(i)));
+    }
+
+    printf("   passed: batch evaluation of %i points\n", npts);
+    cout << endl;
+}
+
 //______________________________________________________________________________
 /**
  * Create a muscle bench marking system. The bench mark consists of a single muscle 
@@ -1230,6 +1362,12 @@ int main(int argc, char* argv[])
                   createTendonForceLengthCurve(e0,kiso,ftoe,1.01,true,"test"));
             cout << "    passed" << endl;
 
+        //6. Test the lookup table
+            testMuscleCurveLookupTable(tendonCurve);
+
+        //7. Test the batch evaluation
+            testMuscleCurveBatchEvaluation(tendonCurve);
+
         ///////////////////////////////////////
         //FIBER FORCE LENGTH CURVE
         ///////////////////////////////////////
@@ -1294,6 +1432,12 @@ int main(int argc, char* argv[])
                 = SmoothSegmentedFunctionFactory::
                   createFiberForceLengthCurve(0.0,e0f,klow,kisof,1.01,true,"test"));
             cout << "    passed" << endl;
+
+        //6. Test the lookup table
+            testMuscleCurveLookupTable(fiberFLCurve);
+
+        //7. Test the batch evaluation
+            testMuscleCurveBatchEvaluation(fiberFLCurve);
         ///////////////////////////////////////
         //FIBER COMPRESSIVE FORCE LENGTH
         ///////////////////////////////////////
@@ -1603,6 +1747,12 @@ int main(int argc, char* argv[])
             
             cout << "    passed" << endl;
 
+        //6. Test the lookup table
+            testMuscleCurveLookupTable(fiberFVCurve);
+
+        //7. Test the batch evaluation
+            testMuscleCurveBatchEvaluation(fiberFVCurve);
+
         ///////////////////////////////////////
         //FIBER FORCE-VELOCITY INVERSE CURVE
         ///////////////////////////////////////
@@ -1822,6 +1972,12 @@ int main(int argc, char* argv[])
                       shoulderVal, plateauSlope, 1.01,false,"test"));
             cout << "    passed"<<endl;
 
+        //6. Test the lookup table
+            testMuscleCurveLookupTable(fiberfalCurve);
+
+        //7. Test the batch evaluation
+            testMuscleCurveBatchEvaluation(fiberfalCurve);
+
                     ///////////////////////////////////////
         //FIBER COMPRESSIVE PHI CURVE
         ///////////////////////////////////////
@@ -21,7 +21,9 @@
  * -------------------------------------------------------------------------- */
 
 #include <fstream>
+#include <sstream>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/IO.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -72,6 +74,287 @@ int main() {
 		ASSERT(fabs(diff) < 1E-7);
 
 		delete st;
+
+		// Columnar storage must answer every query exactly like row storage
+		Storage rowStore(1000, "rowStore");
+		Storage colStore(1000, "colStore");
+		ASSERT(colStore.setColumnar(true));
+		int nr = 1000, nc = 50;
+		Array<double> y(0.0, nc);
+		for(int r=0; r<nr; ++r){
+			for(int c=0; c<nc; ++c)
+				y[c] = sin(0.001*r*(c+1)) + 0.1*c;
+			rowStore.append(0.002*r, y);
+			colStore.append(0.002*r, y);
+		}
+		ASSERT(colStore.isColumnar());
+		ASSERT(colStore.getSize()==nr);
+		ASSERT(colStore.getSmallestNumberOfStates()==nc);
+		Array<double> rowCol, colCol;
+		for(int c=0; c<nc; ++c){
+			rowStore.getDataColumn(c, rowCol);
+			colStore.getDataColumn(c, colCol);
+			ASSERT(rowCol==colCol);
+			const double *buffer = colStore.getDataColumnBuffer(c);
+			for(int r=0; r<nr; ++r)
+				ASSERT(buffer[r]==rowCol[r]);
+		}
+		Array<double> rowArea(0.0, nc), colArea(0.0, nc);
+		rowStore.computeArea(nc, &rowArea[0]);
+		colStore.computeArea(nc, &colArea[0]);
+		ASSERT(rowArea==colArea);
+		rowStore.computeArea(0.1013, 1.7, nc, &rowArea[0]);
+		colStore.computeArea(0.1013, 1.7, nc, &colArea[0]);
+		ASSERT(rowArea==colArea);
+		rowStore.getDataAtTime(0.5011, nc, rowCol);
+		colStore.getDataAtTime(0.5011, nc, colCol);
+		ASSERT(rowCol==colCol);
+		ASSERT(colStore.findIndex(1.0)==rowStore.findIndex(1.0));
+
+		// Handing out a StateVector converts back to rows
+		StateVector *vec = colStore.getStateVector(10);
+		ASSERT(!colStore.isColumnar());
+		ASSERT(vec->getTime()==rowStore.getStateVector(10)->getTime());
+		ASSERT(vec->getData()==rowStore.getStateVector(10)->getData());
+
+		// Reading a large file must give exactly what the stream reader gives
+		int nrBig = 20000, ncBig = 60;
+		{
+			ofstream out("testStorageLarge.sto");
+			out << "testStorageLarge\nversion=1\nnRows=" << nrBig
+				<< "\nnColumns=" << ncBig+1 << "\ninDegrees=no\nendheader\ntime";
+			for(int c=0; c<ncBig; ++c) out << "\tv" << c;
+			out << "\n";
+			out.precision(17);
+			for(int r=0; r<nrBig; ++r){
+				out << 0.001*r;
+				for(int c=0; c<ncBig; ++c)
+					out << (c%2 ? "\t" : " ") << cos(0.37*r+c)*pow(10.0, c%9-4);
+				out << "\n";
+			}
+		}
+		double startTime = SimTK::realTime();
+		Storage bigStore("testStorageLarge.sto");
+		double fastTime = 1.e3*(SimTK::realTime()-startTime);
+
+		startTime = SimTK::realTime();
+		Storage refStore(nrBig, "testStorageLarge");
+		{
+			ifstream in("testStorageLarge.sto");
+			string line;
+			while(getline(in, line) && line.compare(0, 9, "endheader")!=0);
+			getline(in, line);
+			double t;
+			Array<double> vals(0.0, ncBig);
+			for(int r=0; r<nrBig; ++r){
+				in >> t;
+				for(int c=0; c<ncBig; ++c) in >> vals[c];
+				refStore.append(t, vals);
+			}
+		}
+		double streamTime = 1.e3*(SimTK::realTime()-startTime);
+		cout << "Read " << nrBig << "x" << ncBig+1 << " storage: " << fastTime
+			<< " ms (stream reader: " << streamTime << " ms)" << endl;
+
+		ASSERT(bigStore.getSize()==nrBig);
+		ASSERT(bigStore.isColumnar());
+		Array<double> bigCol, refBigCol;
+		for(int c=0; c<ncBig; c+=5){
+			bigStore.getDataColumn(c, bigCol);
+			refStore.getDataColumn(c, refBigCol);
+			ASSERT(bigCol==refBigCol);
+		}
+		for(int r=0; r<nrBig; r+=7){
+			ASSERT(bigStore.getStateVector(r)->getTime()==refStore.getStateVector(r)->getTime());
+			ASSERT(bigStore.getStateVector(r)->getData()==refStore.getStateVector(r)->getData());
+		}
+
+		// As when appended, a row with the time of the row before replaces it
+		{
+			ofstream out("testStorageRepeatedTime.sto");
+			out << "testStorageRepeatedTime\nversion=1\nnRows=4\nnColumns=2\n"
+				<< "inDegrees=no\nendheader\ntime\tv\n"
+				<< "0\t1\n1\t2\n1\t3\n2\t4\n";
+		}
+		Storage repStore("testStorageRepeatedTime.sto");
+		ASSERT(repStore.isColumnar());
+		ASSERT(repStore.getSize()==3);
+		Array<double> repCol;
+		repStore.getDataColumn(0, repCol);
+		ASSERT(repCol[1]==3.0 && repCol[2]==4.0);
+
+		// Binary files round trip exactly and are read in place
+		ASSERT(!Storage::IsBinaryFile("testStorageLarge.sto"));
+		refStore.setColumnLabels(bigStore.getColumnLabels());
+		refStore.setInDegrees(true);
+		ASSERT(refStore.printBinary("testStorageLarge_binary.sto"));
+		ASSERT(Storage::IsBinaryFile("testStorageLarge_binary.sto"));
+		Storage binStore("testStorageLarge_binary.sto");
+		ASSERT(binStore.isColumnar());
+		ASSERT(binStore.isInDegrees());
+		ASSERT(binStore.getSize()==nrBig);
+		ASSERT(binStore.getColumnLabels()==refStore.getColumnLabels());
+		Array<double> binCol, refCol;
+		binStore.getDataColumn("v17", binCol);
+		refStore.getDataColumn("v17", refCol);
+		ASSERT(binCol==refCol);
+		for(int r=0; r<nrBig; r+=7){
+			double t;
+			binStore.getTime(r, t);
+			ASSERT(t==refStore.getStateVector(r)->getTime());
+		}
+
+		// Modifying the data copies them out of the file
+		binStore.multiplyColumn(3, 2.0);
+		binStore.append(1.e3, refStore.getStateVector(0)->getData());
+		ASSERT(binStore.getSize()==nrBig+1);
+		binStore.getDataColumn(3, binCol);
+		refStore.getDataColumn(3, refCol);
+		ASSERT(binCol[11]==2.0*refCol[11]);
+
+		// Columnar storages are written straight from their buffers
+		ASSERT(colStore.setColumnar(true));
+		ASSERT(colStore.printBinary("testStorageColumnar_binary.sto"));
+		Storage colCopy("testStorageColumnar_binary.sto");
+		for(int c=0; c<nc; ++c){
+			rowStore.getDataColumn(c, rowCol);
+			colCopy.getDataColumn(c, colCol);
+			ASSERT(rowCol==colCol);
+		}
+
+		// Flushing rows from memory must not change what is printed
+		Storage fullStore(512, "stream");
+		Storage streamStore(512, "stream");
+		Storage streamColStore(512, "stream");
+		ASSERT(streamColStore.setColumnar(true));
+		streamStore.setFlushInterval(100);
+		streamColStore.setFlushInterval(100);
+		Array<std::string> streamLabels("", 0);
+		streamLabels.append("time");
+		for(int c=0; c<10; ++c) streamLabels.append(std::string("s") + (char)('0'+c));
+		fullStore.setColumnLabels(streamLabels);
+		streamStore.setColumnLabels(streamLabels);
+		streamColStore.setColumnLabels(streamLabels);
+		Array<double> sy(0.0, 10);
+		for(int r=0; r<5000; ++r){
+			for(int c=0; c<10; ++c) sy[c] = cos(0.01*r + c);
+			fullStore.append(0.001*r, sy);
+			streamStore.append(0.001*r, sy);
+			streamColStore.append(0.001*r, sy);
+			// A repeated time replaces the last row
+			if(r%1000==0){
+				sy[0] = -1.0;
+				fullStore.append(0.001*r, sy);
+				streamStore.append(0.001*r, sy);
+				streamColStore.append(0.001*r, sy);
+			}
+			ASSERT(streamStore.getSize()<=100);
+			ASSERT(streamColStore.getSize()<=100);
+		}
+		ASSERT(streamStore.getSize()+streamStore.getNumFlushedRows()==5000);
+		ASSERT(streamStore.getFirstTime()==fullStore.getFirstTime());
+		ASSERT(streamStore.getLastTime()==fullStore.getLastTime());
+		fullStore.print("testStorageStream_full.sto");
+		streamStore.print("testStorageStream_rows.sto");
+		streamColStore.print("testStorageStream_columns.sto");
+		fullStore.print("testStorageStream_full_dt.sto", 0.0025);
+		streamStore.print("testStorageStream_rows_dt.sto", 0.0025);
+		std::string fullText, rowsText, colsText, fullDtText, rowsDtText;
+		{
+			std::ifstream f1("testStorageStream_full.sto"), f2("testStorageStream_rows.sto"),
+				f3("testStorageStream_columns.sto"), f4("testStorageStream_full_dt.sto"),
+				f5("testStorageStream_rows_dt.sto");
+			std::stringstream b1, b2, b3, b4, b5;
+			b1 << f1.rdbuf(); b2 << f2.rdbuf(); b3 << f3.rdbuf(); b4 << f4.rdbuf(); b5 << f5.rdbuf();
+			fullText = b1.str(); rowsText = b2.str(); colsText = b3.str();
+			fullDtText = b4.str(); rowsDtText = b5.str();
+		}
+		ASSERT(!fullText.empty());
+		ASSERT(rowsText==fullText);
+		ASSERT(colsText==fullText);
+		ASSERT(rowsDtText==fullDtText);
+
+		// Copies read the flushed rows back
+		Storage streamCopy(streamStore);
+		ASSERT(streamCopy.getSize()==fullStore.getSize());
+		ASSERT(streamCopy.getStateVector(1234)->getData()==fullStore.getStateVector(1234)->getData());
+		streamStore.reset(0);
+		ASSERT(streamStore.getNumFlushedRows()==0);
+
+		// Flushing a storage read in place from a binary file copies its
+		// rows out of the file first
+		Storage binFlushStore("testStorageLarge_binary.sto");
+		binFlushStore.setFlushInterval(100);
+		ASSERT(binFlushStore.getSize()==1);
+		ASSERT(binFlushStore.getNumFlushedRows()==nrBig-1);
+		ASSERT(binFlushStore.getLastTime()==refStore.getLastTime());
+		binFlushStore.append(1.e3, refStore.getStateVector(0)->getData());
+		Storage binFlushCopy(binFlushStore);
+		ASSERT(binFlushCopy.getSize()==nrBig+1);
+		for(int r=0; r<nrBig; r+=7){
+			ASSERT(binFlushCopy.getStateVector(r)->getTime()==refStore.getStateVector(r)->getTime());
+			ASSERT(binFlushCopy.getStateVector(r)->getData()==refStore.getStateVector(r)->getData());
+		}
+
+		// Columns are filtered, padded and resampled on several threads with
+		// exactly the result of a single thread
+		int nrFilt = 5000, ncFilt = 48;
+		Storage filtStore(nrFilt, "filter");
+		Array<std::string> filtLabels("time", ncFilt+1);
+		for(int c=0; c<ncFilt; ++c){
+			std::ostringstream label;
+			label << "f" << c;
+			filtLabels[c+1] = label.str();
+		}
+		filtStore.setColumnLabels(filtLabels);
+		Array<double> fy(0.0, ncFilt);
+		for(int r=0; r<nrFilt; ++r){
+			for(int c=0; c<ncFilt; ++c)
+				fy[c] = sin(0.003*r*(c+1)) + 0.05*cos(0.9*r+c);
+			filtStore.append(0.001*r, fy);
+		}
+		const char *operations[] = {"lowpassIIR", "lowpassFIR", "smoothSpline", "pad", "resample"};
+		for(int op=0; op<5; ++op){
+			for(int columnar=0; columnar<2; ++columnar){
+				Storage serial(filtStore), parallel(filtStore);
+				ASSERT(serial.setColumnar(columnar!=0));
+				ASSERT(parallel.setColumnar(columnar!=0));
+				double elapsed[2];
+				for(int run=0; run<2; ++run){
+					Storage &store = run ? parallel : serial;
+					IO::SetNumThreads(run ? 0 : 1);
+					double start = SimTK::realTime();
+					switch(op){
+						case 0: store.lowpassIIR(6.0); break;
+						case 1: store.lowpassFIR(50, 6.0); break;
+						case 2: store.smoothSpline(3, 6.0); break;
+						case 3: store.pad(500); break;
+						case 4: store.resample(0.0007, 5); break;
+					}
+					elapsed[run] = SimTK::realTime()-start;
+				}
+				IO::SetNumThreads(0);
+
+				ASSERT(serial.isColumnar()==(columnar!=0));
+				ASSERT(parallel.isColumnar()==(columnar!=0));
+				ASSERT(parallel.getSize()==serial.getSize());
+				ASSERT(parallel.getSmallestNumberOfStates()==ncFilt);
+				ASSERT(parallel.getColumnLabels()==filtLabels);
+				Array<double> serialTimes, parallelTimes, serialCol, parallelCol;
+				serial.getTimeColumn(serialTimes);
+				parallel.getTimeColumn(parallelTimes);
+				ASSERT(parallelTimes==serialTimes);
+				for(int c=0; c<ncFilt; ++c){
+					serial.getDataColumn(c, serialCol);
+					parallel.getDataColumn(c, parallelCol);
+					ASSERT(parallelCol==serialCol);
+				}
+				if(columnar)
+					cout << operations[op] << " " << nrFilt << "x" << ncFilt << ": "
+						<< 1.e3*elapsed[0] << " ms on 1 thread, " << 1.e3*elapsed[1]
+						<< " ms on " << IO::GetNumThreads() << " threads" << endl;
+			}
+		}
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -24,12 +24,92 @@
 #include "InverseDynamicsSolver.h"
 #include "Model/Model.h"
 #include <OpenSim/Common/FunctionSet.h>
+#include <vector>
 
 using namespace std;
 using namespace SimTK;
 
 namespace OpenSim {
 
+namespace {
+/* Solves the inverse dynamics for one contiguous chunk of a time series per
+ * thread. Each chunk evaluates the coordinate functions for all of its frames
+ * in a batch, one function at a time, and then solves frame by frame on a
+ * copy of the model of its own, so that no two threads compute with the same
+ * model components. */
+class SolveTrajectoryTask : public ParallelExecutor::Task {
+public:
+	SolveTrajectoryTask(const std::vector<Model*>& aModels, const State& aState,
+		const FunctionSet& aQs, const Array_<double>& aTimes, int aNumChunks,
+		Array_<Vector>& rGenForceTrajectory, Array_<Vector>& rQ, Array_<Vector>& rU, 
+		Array_<Vector>& rUDot, std::vector<std::string>& rErrors) :
+		_models(aModels), _state(aState), _Qs(aQs), _times(aTimes), 
+		_numChunks(aNumChunks), _genForceTrajectory(rGenForceTrajectory),
+		_q(rQ), _u(rU), _udot(rUDot), _errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int nt = _times.size();
+		int first = (int)(((long long)nt*aChunk)/_numChunks);
+		int last = (int)(((long long)nt*(aChunk+1))/_numChunks);
+		if(first>=last) return;
+
+		FunctionSet* Qs = NULL;
+		try {
+			// Functions (e.g. GCVSpline) may keep workspace, so each chunk
+			// evaluates its own copy.
+			Qs = _Qs.clone();
+			int nq = Qs->getSize();
+
+			Vector arg(1);
+			std::vector<int> firstDeriv(1, 0), secondDeriv(2, 0);
+			for(int j=0; j<nq; j++){
+				const Function& f = Qs->get(j);
+				for(int i=first; i<last; i++){
+					arg[0] = _times[i];
+					_q[i][j] = f.calcValue(arg);
+					_u[i][j] = f.calcDerivative(firstDeriv, arg);
+					_udot[i][j] = f.calcDerivative(secondDeriv, arg);
+				}
+			}
+
+			// Solve with a copy of the whole given State, so that its state
+			// variables (e.g., of muscles), modeling options and disabled
+			// forces (e.g., excluded by the InverseDynamicsTool) all apply.
+			// The model copies have the same topology as the model the State
+			// was made for.
+			const Model& model = *_models[aChunk];
+			InverseDynamicsSolver solver(model);
+			State s = _state;
+			for(int i=first; i<last; i++){
+				s.updTime() = _times[i];
+				s.updQ() = _q[i];
+				s.updU() = _u[i];
+				Vector &udot = s.updUDot();
+				udot = _udot[i];
+				_genForceTrajectory[i] = solver.solve(s, udot);
+			}
+		}
+		catch(const std::exception& x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+		delete Qs;
+	}
+
+private:
+	const std::vector<Model*>& _models;
+	const State& _state;
+	const FunctionSet& _Qs;
+	const Array_<double>& _times;
+	int _numChunks;
+	Array_<Vector>& _genForceTrajectory;
+	Array_<Vector>& _q;
+	Array_<Vector>& _u;
+	Array_<Vector>& _udot;
+	std::vector<std::string>& _errors;
+};
+}
+
 //______________________________________________________________________________
 /**
  * An implementation of the InverseDynamicsSolver 
@@ -141,4 +221,70 @@ void InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, const
 	}
 }
 
+/** Same as above but solving chunks of the time series concurrently */
+void InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, const Array_<double> &times, Array_<Vector> &genForceTrajectory, int numThreads)
+{
+	int nq = getModel().getNumCoordinates();
+	int nt = times.size();
+
+	if(numThreads<=0) numThreads = ParallelExecutor::getNumProcessors();
+	if(numThreads>nt) numThreads = nt;
+	if(numThreads<=1){
+		solve(s, Qs, times, genForceTrajectory);
+		return;
+	}
+
+	if(Qs.getSize() != nq){
+		throw Exception("InverseDynamicsSolver::solve invalid number of q functions.");
+	}
+
+	if( nq != getModel().getNumSpeeds()){
+		throw Exception("InverseDynamicsSolver::solve using FunctionSet, nq != nu not supported.");
+	}
+
+	//Preallocate if not done already
+	genForceTrajectory.resize(nt, Vector(nq));
+
+	// Coordinates, speeds and accelerations of every frame
+	Array_<Vector> q(nt, Vector(nq)), u(nt, Vector(nq)), udot(nt, Vector(nq));
+	std::vector<std::string> errors(numThreads);
+
+	// Copy the model for each chunk, in sequence, before any thread runs.
+	std::vector<Model*> models(numThreads, (Model*)NULL);
+	try {
+		for(int i=0; i<numThreads; i++){
+			models[i] = new Model(getModel());
+			models[i]->initSystem();
+		}
+
+		SolveTrajectoryTask task(models, s, Qs, times, numThreads, 
+			genForceTrajectory, q, u, udot, errors);
+		ParallelExecutor executor(numThreads);
+		executor.execute(task, numThreads);
+	}
+	catch(...) {
+		for(int i=0; i<numThreads; i++) delete models[i];
+		throw;
+	}
+	for(int i=0; i<numThreads; i++) delete models[i];
+
+	for(int i=0; i<numThreads; i++){
+		if(!errors[i].empty())
+			throw Exception("InverseDynamicsSolver::solve failed: "+errors[i]);
+	}
+
+	// Step the analyses through the frames in time order, leaving the State
+	// at the last frame as when solving in sequence.
+	AnalysisSet& analysisSet = const_cast<AnalysisSet&>(getModel().getAnalysisSet());
+	for(int i=0; i<nt; i++){
+		if(analysisSet.getSize()==0 && i<nt-1) continue;
+		s.updTime() = times[i];
+		s.updQ() = q[i];
+		s.updU() = u[i];
+		s.updUDot() = udot[i];
+		getModel().getMultibodySystem().realize(s,SimTK::Stage::Dynamics);
+		analysisSet.step(s, i);
+	}
+}
+
 } // end of namespace OpenSim
\ No newline at end of file
@@ -97,6 +97,18 @@ public:
 	virtual void solve(SimTK::State& s, const FunctionSet& Qs, 
 		         const SimTK::Array_<double>&  times,
 				 SimTK::Array_<SimTK::Vector>& genForceTrajectory);
+    /** Same as above but the time series is split into contiguous chunks that
+	    are solved concurrently, each on its own copy of the model (made with
+		the Model copy constructor) and of the coordinate functions. Each
+		chunk solves with a copy of s, so the state variables, modeling
+		options and disabled forces of s apply to all of the frames as they
+		do in sequence. The model's analyses are then stepped
+		through the frames in time order. With numThreads <= 0 one thread per
+		processor is used, and with 1 the frames are solved in sequence. */
+	virtual void solve(SimTK::State& s, const FunctionSet& Qs, 
+		         const SimTK::Array_<double>&  times,
+				 SimTK::Array_<SimTK::Vector>& genForceTrajectory,
+				 int numThreads);
 #endif
 //=============================================================================
 };	// END of class InverseDynamicsSolver
@@ -34,6 +34,7 @@
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/IO.h>
 
 
 
@@ -135,6 +136,7 @@ setNull()
 	_dt = 1.0e-4;
     _performAnalyses=true;
     _writeToStorage=true;
+	_flushInterval = 0;
 	_tArray.setSize(0);
     _system = 0;
 	_dtArray.setSize(0);
@@ -168,6 +170,7 @@ constructStorage()
 	columnLabels.append("time");
 	for(int i=0;i<ny;i++) columnLabels.append(stateNames[i]);
 	_stateStore->setColumnLabels(columnLabels);
+	_stateStore->setFlushInterval(_flushInterval);
 
 	return(true);
 }
@@ -561,6 +564,73 @@ setIntegrator(SimTK::Integrator* integrator)
 {
 	_integ = integrator;
 }
+//_____________________________________________________________________________
+/**
+ * Replace the integrator with one of the named method, owned by this manager.
+ * Step size and accuracy settings must be (re)applied to the new integrator.
+ *
+ * @param aMethod Name of the integration method (see createIntegrator()).
+ * @param aStepSize Step size used by the fixed-step methods.
+ */
+void Manager::
+setIntegratorMethod(const std::string& aMethod, double aStepSize)
+{
+	const SimTK::System& system = (_system!=NULL) ?
+		*_system : static_cast<const SimTK::System&>(_model->getMultibodySystem());
+	SimTK::Integrator* integ = createIntegrator(aMethod, system, aStepSize);
+	if(_ownsIntegrator) delete _integ;
+	_integ = integ;
+	_ownsIntegrator = true;
+}
+//_____________________________________________________________________________
+/**
+ * Create a new integrator for a system given the name of the method.
+ * The caller takes ownership of the returned integrator.
+ *
+ * Supported methods are the explicit error-controlled Runge-Kutta variants
+ * (RungeKuttaMerson, RungeKuttaFeldberg, RungeKutta3, RungeKutta2), the
+ * explicit Euler family (ExplicitEuler, SemiExplicitEuler2, Verlet, and the
+ * fixed-step SemiExplicitEuler) and CPodes, a variable-order implicit BDF
+ * method with Newton iteration suited to stiff systems such as equilibrium
+ * muscles with stiff tendons. Names are not case sensitive.
+ *
+ * @param aMethod Name of the integration method.
+ * @param aSystem System to be integrated.
+ * @param aStepSize Step size used by the fixed-step methods.
+ * @return Newly allocated integrator.
+ * @throws Exception if the method is not recognized.
+ */
+SimTK::Integrator* Manager::
+createIntegrator(const std::string& aMethod, const SimTK::System& aSystem,
+				 double aStepSize)
+{
+	string method = IO::Lowercase(aMethod);
+	if(method=="rungekuttamerson" || method=="")
+		return new SimTK::RungeKuttaMersonIntegrator(aSystem);
+	if(method=="rungekuttafeldberg")
+		return new SimTK::RungeKuttaFeldbergIntegrator(aSystem);
+	if(method=="rungekutta3")
+		return new SimTK::RungeKutta3Integrator(aSystem);
+	if(method=="rungekutta2")
+		return new SimTK::RungeKutta2Integrator(aSystem);
+	if(method=="expliciteuler")
+		return new SimTK::ExplicitEulerIntegrator(aSystem);
+	if(method=="semiexpliciteuler")
+		return new SimTK::SemiExplicitEulerIntegrator(aSystem, aStepSize);
+	if(method=="semiexpliciteuler2")
+		return new SimTK::SemiExplicitEuler2Integrator(aSystem);
+	if(method=="verlet")
+		return new SimTK::VerletIntegrator(aSystem);
+	if(method=="cpodes")
+		return new SimTK::CPodesIntegrator(aSystem,
+			SimTK::CPodes::BDF, SimTK::CPodes::Newton);
+
+	string msg = "Manager::createIntegrator: unrecognized integrator method '"
+		+ aMethod + "'. Valid methods are RungeKuttaMerson, RungeKuttaFeldberg,"
+		" RungeKutta3, RungeKutta2, ExplicitEuler, SemiExplicitEuler,"
+		" SemiExplicitEuler2, Verlet and CPodes.";
+	throw Exception(msg,__FILE__,__LINE__);
+}
 
 
 //-----------------------------------------------------------------------------
@@ -654,6 +724,7 @@ void Manager::
 setStateStorage(Storage& aStorage)
 {
 	_stateStore = &aStorage;
+	if(_flushInterval>0) _stateStore->setFlushInterval(_flushInterval);
 }
 //_____________________________________________________________________________
 /**
@@ -667,6 +738,23 @@ getStateStorage() const
  	return(*_stateStore);
 }
 //_____________________________________________________________________________
+/**
+ * Bound the memory used by long integrations.  The state storage and, at
+ * the start of each integration, the storages of the model's analyses keep
+ * at most aNumRows rows in memory and flush older rows to a temporary file
+ * (see Storage::setFlushInterval()).  Printing the storages still writes
+ * every row.
+ *
+ * @param aNumRows Maximum number of rows to keep in memory.  0 keeps all
+ * rows in memory.
+ */
+void Manager::
+setFlushInterval(int aNumRows)
+{
+	_flushInterval = (aNumRows<0) ? 0 : aNumRows;
+	if(hasStateStorage()) _stateStore->setFlushInterval(_flushInterval);
+}
+//_____________________________________________________________________________
 /**
  * Get whether there is a storage buffer for the integration states.
  */
@@ -874,6 +962,7 @@ void Manager::initialize(SimTK::State& s, double dt )
     	// ANALYSES 
     	AnalysisSet& analysisSet = _model->updAnalysisSet();
     	analysisSet.begin(s);
+		if(_flushInterval>0) analysisSet.setFlushInterval(_flushInterval);
     }
 
 	return;
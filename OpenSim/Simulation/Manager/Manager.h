@@ -106,6 +106,10 @@ private:
 	/** flag indicating if manager should write to storage  each step */
     bool _writeToStorage;
 
+	/** Number of rows the state storage and the analysis storages keep in
+	memory before older rows are flushed to file. 0 keeps all rows. */
+	int _flushInterval;
+
     /** controllerSet used for the integration */
     ControllerSet* _controllerSet;
 
@@ -144,6 +148,9 @@ public:
 	// Integrator
 	SimTK::Integrator& getIntegrator() const;
     void setIntegrator( SimTK::Integrator*);
+    void setIntegratorMethod(const std::string& aMethod, double aStepSize=1.0e-3);
+    static SimTK::Integrator* createIntegrator(const std::string& aMethod,
+        const SimTK::System& aSystem, double aStepSize=1.0e-3);
 	// Initial and final times
 	void setInitialTime(double aTI);
 	double getInitialTime() const;
@@ -190,6 +197,9 @@ public:
     bool hasStateStorage() const;
 	void setStateStorage(Storage& aStorage);
 	Storage& getStateStorage() const;
+	void setFlushInterval(int aNumRows);
+	/** Number of rows kept in memory by the state and analysis storages. */
+	int getFlushInterval() const { return _flushInterval; }
 
    //--------------------------------------------------------------------------
    //  INTERRUPT
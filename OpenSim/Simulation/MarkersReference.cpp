@@ -72,7 +72,9 @@ MarkersReference::MarkersReference(MarkerData& aMarkerData, const Set<MarkerWeig
 	populateFromMarkerData(aMarkerData);
 }
 
-/** load the marker data for this MarkersReference from markerFile  */
+/** load the marker data for this MarkersReference from markerFile, which
+    may be a TRC (.trc), binary TRC (.trb) or storage (.sto) file as given by
+    its extension */
 void MarkersReference::loadMarkersFile(const std::string markerFile, Units modelUnits)
 {
 	_markersFile = markerFile;
@@ -123,8 +125,8 @@ SimTK::Vec2 MarkersReference::getValidTimeRange() const
 // default values.
 void MarkersReference::setupProperties()
 {
-	_markersFileProp.setComment("TRC file (.trc) containing the time history of observations of marker."
-								"positions.");
+	_markersFileProp.setComment("TRC file (.trc), binary TRC file (.trb) or storage file (.sto) containing "
+								"the time history of observations of marker positions.");
 	_markersFileProp.setName("marker_file");
 	_propertySet.append( &_markersFileProp );
 
@@ -150,10 +152,17 @@ void  MarkersReference::getValues(const SimTK::State &s, SimTK::Array_<Vec3> &va
 	if(before > after || after < 0)
 		throw Exception("MarkersReference: No index corresponding to time of frame.");
 	else if(after-before > 0){
-		before = abs(_markerData->getFrame(before).getFrameTime()-time) < abs(_markerData->getFrame(after).getFrameTime()-time) ? before : after;
+		before = abs(_markerData->getFrameTime(before)-time) < abs(_markerData->getFrameTime(after)-time) ? before : after;
 	}
 
-	values = _markerData->getFrame(before).getMarkers();
+	// Copy into the caller's array, which only needs to be sized once, so no
+	// allocation is done per frame
+	const Vec3* markers = _markerData->getFrameMarkers(before);
+	unsigned int nm = (unsigned int)_markerData->getNumMarkers();
+	if(values.size() != nm)
+		values.resize(nm);
+	for(unsigned int i=0; i<nm; ++i)
+		values[i] = markers[i];
 }
 
 /** get the speed value of the MarkersReference */
@@ -68,6 +68,7 @@ AbstractTool::AbstractTool():
 	_maxDT(_maxDTProp.getValueDbl()),
 	_minDT(_minDTProp.getValueDbl()),
 	_errorTolerance(_errorToleranceProp.getValueDbl()),
+	_integratorMethod(_integratorMethodProp.getValueStr()),
 	_analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
 	_analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -100,6 +101,7 @@ AbstractTool::AbstractTool(const string &aFileName, bool aUpdateFromXMLNode):
 	_maxDT(_maxDTProp.getValueDbl()),
 	_minDT(_minDTProp.getValueDbl()),
 	_errorTolerance(_errorToleranceProp.getValueDbl()),
+	_integratorMethod(_integratorMethodProp.getValueStr()),
 	_analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
 	_analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -162,6 +164,7 @@ AbstractTool::AbstractTool(const AbstractTool &aTool):
 	_maxDT(_maxDTProp.getValueDbl()),
 	_minDT(_minDTProp.getValueDbl()),
 	_errorTolerance(_errorToleranceProp.getValueDbl()),
+	_integratorMethod(_integratorMethodProp.getValueStr()),
 	_analysisSetProp(PropertyObj("Analyses",AnalysisSet())),
 	_analysisSet((AnalysisSet&)_analysisSetProp.getValueObj()),
     _controllerSetProp(PropertyObj("Controllers", ControllerSet())),
@@ -195,6 +198,7 @@ setNull()
 	_maxDT = 1.0;
 	_minDT = 1.0e-8;
 	_errorTolerance = 1.0e-5;
+	_integratorMethod = "RungeKuttaMerson";
 	_toolOwnsModel=true;
 	_externalLoadsFileName = "";
 }
@@ -269,6 +273,14 @@ void AbstractTool::setupProperties()
 	_errorToleranceProp.setName("integrator_error_tolerance");
 	_propertySet.append( &_errorToleranceProp );
 
+	comment = "Integration method: RungeKuttaMerson (default), RungeKuttaFeldberg, "
+			  "RungeKutta3, RungeKutta2, ExplicitEuler, SemiExplicitEuler, "
+			  "SemiExplicitEuler2, Verlet, or CPodes (implicit BDF, for stiff models). "
+			  "Fixed-step methods use maximum_integrator_step_size as their step.";
+	_integratorMethodProp.setComment(comment);
+	_integratorMethodProp.setName("integrator_method");
+	_propertySet.append( &_integratorMethodProp );
+
 	comment = "Set of analyses to be run during the investigation.";
 	_analysisSetProp.setComment(comment);
 	_analysisSetProp.setName("Analyses");
@@ -316,6 +328,7 @@ operator=(const AbstractTool &aTool)
 	_maxDT = aTool._maxDT;
 	_minDT = aTool._minDT;
 	_errorTolerance = aTool._errorTolerance;
+	_integratorMethod = aTool._integratorMethod;
 	_analysisSet = aTool._analysisSet;
 	_toolOwnsModel = aTool._toolOwnsModel;
 
@@ -117,6 +117,10 @@ protected:
 	integrator step size is decreased. */
 	PropertyDbl _errorToleranceProp;
 	double &_errorTolerance;
+
+	/** Integration method (e.g., RungeKuttaMerson, CPodes). */
+	PropertyStr _integratorMethodProp;
+	std::string &_integratorMethod;
 	
 	/** Set of analyses to be run during the study. */
 	PropertyObj _analysisSetProp;
@@ -304,6 +308,9 @@ public:
 	double getErrorTolerance() const { return _errorTolerance; }
 	void setErrorTolerance(double aErrorTolerance) { _errorTolerance = aErrorTolerance; }
 
+	const std::string& getIntegratorMethod() const { return _integratorMethod; }
+	void setIntegratorMethod(const std::string& aMethod) { _integratorMethod = aMethod; }
+
 	// Model xml file
 	const std::string& getModelFilename() const { return _modelFile; }
 	void setModelFilename(const std::string& aModelFile) { _modelFile = aModelFile; }
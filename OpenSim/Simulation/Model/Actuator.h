@@ -243,10 +243,18 @@ protected:
 		values.append(getForce(state));
 		return values;
 	}
+	int getNumRecordValues() const { return 1; }
+	void writeRecordValues(const SimTK::State& state, double* rValues) const {
+		rValues[0] = getForce(state);
+	}
 
 private:
 	void constructProperties();
 
+	// handles to the force and speed cache variables
+	mutable CacheVariableHandle<double> _forceCV;
+	mutable CacheVariableHandle<double> _speedCV;
+
 //=============================================================================
 };	// END of class Actuator
 //=============================================================================
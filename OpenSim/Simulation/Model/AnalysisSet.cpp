@@ -185,6 +185,27 @@ getOn() const
 	return on;
 }
 
+//_____________________________________________________________________________
+/**
+ * Limit the number of rows that the storages of all analyses hold in
+ * memory (see Storage::setFlushInterval()).  Since analyses may allocate
+ * new storages when their model is set, this should be called just before
+ * an integration.
+ *
+ * @param aNumRows Maximum number of rows to keep in memory.  0 keeps all
+ * rows in memory.
+ */
+void AnalysisSet::
+setFlushInterval(int aNumRows)
+{
+	for(int i=0;i<getSize();i++) {
+		ArrayPtrs<Storage> &storages = get(i).getStorageList();
+		for(int j=0;j<storages.getSize();j++) {
+			if(storages.get(j)!=NULL) storages.get(j)->setFlushInterval(aNumRows);
+		}
+	}
+}
+
 
 //=============================================================================
 // CALLBACKS
@@ -92,6 +92,7 @@ public:
 	void setOn(bool aTrueFalse);
 	void setOn(const Array<bool> &aOn);
 	Array<bool> getOn() const;
+	void setFlushInterval(int aNumRows);
 
 	//--------------------------------------------------------------------------
 	// CALLBACKS
@@ -242,12 +242,20 @@ OpenSim::Array<std::string> BushingForce::getRecordLabels() const
  */
 OpenSim::Array<double> BushingForce::
 getRecordValues(const SimTK::State& state) const 
+{
+	OpenSim::Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
+/**
+ * Write the value(s) to be reported into rValues
+ */
+void BushingForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
 {
 	const string& body1Name = get_body_1();
 	const string& body2Name = get_body_2();
 
-	OpenSim::Array<double> values(1);
-
 	const SimTK::Force::LinearBushing &simtkSpring = 
         (SimTK::Force::LinearBushing &)(_model->getForceSubsystem().getForce(_index));
 
@@ -257,16 +265,12 @@ getRecordValues(const SimTK::State& state) const
 
 	//get the net force added to the system contributed by the bushing
 	simtkSpring.calcForceContribution(state, bodyForces, particleForces, mobilityForces);
-	SimTK::Vec3 forces = bodyForces(_model->getBodySet().get(body1Name).getIndex())[1];
-	SimTK::Vec3 torques = bodyForces(_model->getBodySet().get(body1Name).getIndex())[0];
-	values.append(3, &forces[0]);
-	values.append(3, &torques[0]);
-
-	forces = bodyForces(_model->getBodySet().get(body2Name).getIndex())[1];
-	torques = bodyForces(_model->getBodySet().get(body2Name).getIndex())[0];
-
-	values.append(3, &forces[0]);
-	values.append(3, &torques[0]);
-
-	return values;
+	const SimTK::SpatialVec& F1 = bodyForces(_model->getBodySet().get(body1Name).getIndex());
+	const SimTK::SpatialVec& F2 = bodyForces(_model->getBodySet().get(body2Name).getIndex());
+	for(int i=0; i<3; ++i){
+		rValues[i] = F1[1][i];
+		rValues[3+i] = F1[0][i];
+		rValues[6+i] = F2[1][i];
+		rValues[9+i] = F2[0][i];
+	}
 }
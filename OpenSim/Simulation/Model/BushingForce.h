@@ -129,6 +129,10 @@ public:
 	*  Provide the value(s) to be reported that correspond to the labels
 	*/
 	virtual OpenSim::Array<double> getRecordValues(const SimTK::State& state) const ;
+	/**
+	*  Write the values reported by getRecordValues() into rValues.
+	*/
+	virtual void writeRecordValues(const SimTK::State& state, double* rValues) const ;
 
 private:
 	//--------------------------------------------------------------------------
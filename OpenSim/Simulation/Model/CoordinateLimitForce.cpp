@@ -369,8 +369,14 @@ Array<std::string> CoordinateLimitForce::getRecordLabels() const {
  * frame, etc. used in conjunction with getRecordLabels and should return same size Array
  */
 Array<double> CoordinateLimitForce::getRecordValues(const SimTK::State& state) const {
-	OpenSim::Array<double> values(0.0, 0, 2);
-	values.append(calcLimitForce(state));
-	values.append(computePotentialEnergy(state));
+	OpenSim::Array<double> values(0.0, 2);
+	writeRecordValues(state, values.get());
 	return values;
+}
+/**
+ * Write the values reported by getRecordValues() into rValues.
+ */
+void CoordinateLimitForce::writeRecordValues(const SimTK::State& state, double* rValues) const {
+	rValues[0] = calcLimitForce(state);
+	rValues[1] = computePotentialEnergy(state);
 }
\ No newline at end of file
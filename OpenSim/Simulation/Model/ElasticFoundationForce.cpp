@@ -324,8 +324,16 @@ OpenSim::Array<std::string> ElasticFoundationForce::getRecordLabels() const
  */
 OpenSim::Array<double> ElasticFoundationForce::getRecordValues(const SimTK::State& state) const 
 {
-	OpenSim::Array<double> values(1);
-
+	OpenSim::Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
+/**
+ * Write the value(s) to be reported into rValues
+ */
+void ElasticFoundationForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
+{
 	const ContactParametersSet& contactParametersSet = 
         get_contact_parameters();
 
@@ -339,23 +347,22 @@ OpenSim::Array<double> ElasticFoundationForce::getRecordValues(const SimTK::Stat
 	//get the net force added to the system contributed by the Spring
 	simtkForce.calcForceContribution(state, bodyForces, particleForces, mobilityForces);
 
+	int n = 0;
 	for (int i = 0; i < contactParametersSet.getSize(); ++i)
     {
         ContactParameters& params = contactParametersSet.get(i);
         for (int j = 0; j < params.getGeometry().size(); ++j)
         {
-			ContactGeometry& geom = _model->updContactGeometrySet().get(params.getGeometry()[j]);
-			std::string bodyName = geom.getBodyName();
-	
-			SimTK::Vec3 forces = bodyForces(_model->getBodySet().get(bodyName).getIndex())[1];
-			SimTK::Vec3 torques = bodyForces(_model->getBodySet().get(bodyName).getIndex())[0];
-
-			values.append(3, &forces[0]);
-			values.append(3, &torques[0]);
+			ContactGeometry& geom = 
+                _model->updContactGeometrySet().get(params.getGeometry()[j]);
+			const std::string& bodyName = geom.getBodyName();
+			const SimTK::SpatialVec& F = 
+                bodyForces(_model->getBodySet().get(bodyName).getIndex());
+
+			for (int k = 0; k < 3; ++k) rValues[n++] = F[1][k];
+			for (int k = 0; k < 3; ++k) rValues[n++] = F[0][k];
 		}
 	}
-
-	return values;
 }
 
 
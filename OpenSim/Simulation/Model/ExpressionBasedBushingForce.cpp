@@ -263,6 +263,20 @@ void ExpressionBasedBushingForce::setBody2BushingLocation(const Vec3& location,
 	set_orientation_body_2(orientation);
 }
 
+/** Resolve the deflection variables of a lepton program to their positions
+    in the array of deflections, so evaluating it needs no lookups by name */
+static void bindDeflectionVariables(Lepton::ExpressionProgram& prog)
+{
+	std::vector<std::string> variables(6);
+	variables[0] = "theta_x";
+	variables[1] = "theta_y";
+	variables[2] = "theta_z";
+	variables[3] = "delta_x";
+	variables[4] = "delta_y";
+	variables[5] = "delta_z";
+	prog.bindVariables(variables);
+}
+
 /** Set the expression for the Mx function and create it's lepton program */
 void ExpressionBasedBushingForce::setMxExpression(std::string expression) 
 {
@@ -270,6 +284,7 @@ void ExpressionBasedBushingForce::setMxExpression(std::string expression)
 						expression.end() );
 	set_Mx_expression(expression);
 	MxProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(MxProg);
 }
 
 /** Set the expression for the My function and create it's lepton program */
@@ -280,6 +295,7 @@ void ExpressionBasedBushingForce::setMyExpression(std::string expression)
 						expression.end() );
 	set_My_expression(expression);
 	MyProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(MyProg);
 }
 
 /** Set the expression for the Mz function and create it's lepton program */
@@ -289,6 +305,7 @@ void ExpressionBasedBushingForce::setMzExpression(std::string expression)
 						expression.end() );
 	set_Mz_expression(expression);
 	MzProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(MzProg);
 }
 
 /** Set the expression for the Fx function and create it's lepton program */
@@ -298,6 +315,7 @@ void ExpressionBasedBushingForce::setFxExpression(std::string expression)
 						expression.end() );
 	set_Fx_expression(expression);
 	FxProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(FxProg);
 }
 
 /** Set the expression for the Fy function and create it's lepton program */
@@ -307,6 +325,7 @@ void ExpressionBasedBushingForce::setFyExpression(std::string expression)
 						expression.end() );
 	set_Fy_expression(expression);
 	FyProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(FyProg);
 }
 
 /** Set the expression for the Fz function and create it's lepton program */
@@ -316,6 +335,7 @@ void ExpressionBasedBushingForce::setFzExpression(std::string expression)
 						expression.end() );
 	set_Fz_expression(expression);
 	FzProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	bindDeflectionVariables(FzProg);
 }
 //=============================================================================
 // COMPUTATION
@@ -369,13 +389,8 @@ void ExpressionBasedBushingForce::ComputeForcesAtBushing(const SimTK::State& sta
     //------------------------------------------
     Vec6 fk = Vec6(0.0);
 
-	std::map<std::string, double> deflectionVars;
-	deflectionVars["theta_x"] = dq[0];
-	deflectionVars["theta_y"] = dq[1];
-	deflectionVars["theta_z"] = dq[2];
-	deflectionVars["delta_x"] = dq[3];
-	deflectionVars["delta_y"] = dq[4];
-	deflectionVars["delta_z"] = dq[5];
+	// values in the order the variables were bound to the programs
+	const double deflectionVars[] = {dq[0], dq[1], dq[2], dq[3], dq[4], dq[5]};
 
 	
 	fk[0] = MxProg.evaluate(deflectionVars);
@@ -546,18 +561,28 @@ OpenSim::Array<std::string> ExpressionBasedBushingForce::getRecordLabels() const
  */
 OpenSim::Array<double> ExpressionBasedBushingForce::
 getRecordValues(const SimTK::State& state) const 
+{
+    OpenSim::Array<double> values(0.0,getNumRecordValues());
+    writeRecordValues(state, values.get());
+    return values;
+}
+/**
+ * Write the value(s) reported by getRecordValues() into rValues
+ */
+void ExpressionBasedBushingForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
 {
     SpatialVec F_GM( Vec3(0.0),Vec3(0.0) );
     SpatialVec F_GF( Vec3(0.0),Vec3(0.0) );
     
     ComputeForcesAtBushing(state, F_GM, F_GF);
 
-    OpenSim::Array<double> values(1);
-
-    values.append(3, &F_GF[1][0]);
-	values.append(3, &F_GF[0][0]);
-    values.append(3, &F_GM[1][0]);
-	values.append(3, &F_GM[0][0]);
+    for(int i=0; i<3; ++i){
+        rValues[i] = F_GF[1][i];
+        rValues[3+i] = F_GF[0][i];
+        rValues[6+i] = F_GM[1][i];
+        rValues[9+i] = F_GM[0][i];
+    }
 
 
     /*  Old stuff reporting body forces at body origin
@@ -588,8 +613,6 @@ getRecordValues(const SimTK::State& state) const
 	values.append(3, &torques[0]);
 
     */
-
-	return values;
 }
 
 //_____________________________________________________________________________
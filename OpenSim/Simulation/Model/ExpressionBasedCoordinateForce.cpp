@@ -96,6 +96,11 @@ void ExpressionBasedCoordinateForce::connectToModel(Model& aModel)
 					  expression.end() );
 	
 	_forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	// Resolve the variables now so evaluation needs no lookups by name
+	std::vector<std::string> variables(2);
+	variables[0] = "q";
+	variables[1] = "qdot";
+	_forceProg.bindVariables(variables);
 
 	// Look up the coordinate
 	if (!_model->updCoordinateSet().contains(coordName)) {
@@ -135,9 +140,7 @@ double ExpressionBasedCoordinateForce::calcExpressionForce(const SimTK::State& s
 	using namespace SimTK;
 	double q = _coord->getValue(s);
 	double qdot = _coord->getSpeedValue(s);
-   	std::map<std::string, double> forceVars;
-	forceVars["q"] = q;
-	forceVars["qdot"] = qdot;
+	const double forceVars[] = {q, qdot};
 	double forceMag = _forceProg.evaluate(forceVars);
 	setCacheVariable<double>(s, "force_magnitude", forceMag);
 	return forceMag;
@@ -163,7 +166,11 @@ Array<std::string> ExpressionBasedCoordinateForce::getRecordLabels() const {
 }
 // Provide the value(s) to be reported that correspond to the labels.
 Array<double> ExpressionBasedCoordinateForce::getRecordValues(const SimTK::State& state) const {
-	OpenSim::Array<double> values(0.0, 0, 1);
-	values.append(calcExpressionForce(state));
+	OpenSim::Array<double> values(0.0, 1);
+	writeRecordValues(state, values.get());
 	return values;
+}
+// Write the value(s) reported by getRecordValues() into rValues.
+void ExpressionBasedCoordinateForce::writeRecordValues(const SimTK::State& state, double* rValues) const {
+	rValues[0] = calcExpressionForce(state);
 }
\ No newline at end of file
@@ -175,6 +175,11 @@ void ExpressionBasedPointToPointForce::connectToModel(Model& model)
 					  expression.end() );
 	
 	_forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+	// Resolve the variables now so evaluation needs no lookups by name
+	std::vector<std::string> variables(2);
+	variables[0] = "d";
+	variables[1] = "ddot";
+	_forceProg.bindVariables(variables);
 }
 
 //=============================================================================
@@ -229,9 +234,7 @@ void ExpressionBasedPointToPointForce::computeForce(const SimTK::State& s,
 	//speed along the line connecting the two bodies
 	const double ddot = dot(vRel, r_G)/d;
 
-   	std::map<std::string, double> forceVars;
-	forceVars["d"] = d;
-	forceVars["ddot"] = ddot;
+	const double forceVars[] = {d, ddot};
 
 	double forceMag = _forceProg.evaluate(forceVars);
 	setCacheVariable<double>(s, "force_magnitude", forceMag);
@@ -281,8 +284,15 @@ OpenSim::Array<std::string> ExpressionBasedPointToPointForce::getRecordLabels()
 OpenSim::Array<double> ExpressionBasedPointToPointForce::
 getRecordValues(const SimTK::State& state) const 
 {
-	OpenSim::Array<double> values(1);
+	OpenSim::Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
 
+// Write the value(s) reported by getRecordValues() into rValues.
+void ExpressionBasedPointToPointForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
+{
 	SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
 	SimTK::Vector_<SimTK::Vec3> particleForces(0);
 	SimTK::Vector mobilityForces(0);
@@ -295,18 +305,16 @@ getRecordValues(const SimTK::State& state) const
 		.calcForceContribution(state, bodyForces, particleForces, mobilityForces);
 	
 	SimTK::Vec3 forces = bodyForces(body1.getIndex())[1];
-	values.append(3, &forces[0]);
+	for(int i=0; i<3; ++i) rValues[i] = forces[i];
 
 	SimTK::Vec3 gpoint(0);
 	_model->getSimbodyEngine().getPosition(state, body1, getPoint1(), gpoint);
-	values.append(3, &gpoint[0]);
+	for(int i=0; i<3; ++i) rValues[3+i] = gpoint[i];
 
 	forces = bodyForces(body2.getIndex())[1];
-	values.append(3, &forces[0]);
+	for(int i=0; i<3; ++i) rValues[6+i] = forces[i];
 
 	_model->getSimbodyEngine().getPosition(state, body2, getPoint2(), gpoint);
-	values.append(3, &gpoint[0]);
-
-	return values;
+	for(int i=0; i<3; ++i) rValues[9+i] = gpoint[i];
 }
 
@@ -158,6 +158,10 @@ public:
 	*  Provide the value(s) to be reported that correspond to the labels
 	*/
 	OpenSim::Array<double> getRecordValues(const SimTK::State& state) const OVERRIDE_11;
+	/**
+	*  Write the values reported by getRecordValues() into rValues.
+	*/
+	void writeRecordValues(const SimTK::State& state, double* rValues) const OVERRIDE_11;
 
 	//--------------------------------------------------------------------------
 	// Visible Object Support
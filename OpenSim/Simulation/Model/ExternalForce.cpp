@@ -421,32 +421,39 @@ OpenSim::Array<std::string> ExternalForce::getRecordLabels() const {
  * frame, etc. used in conjunction with getRecordLabels and should return same size Array
  */
 OpenSim::Array<double> ExternalForce::getRecordValues(const SimTK::State& state) const
+{
+	OpenSim::Array<double>	values(SimTK::NaN, getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+};
+/**
+ * Write the values reported by getRecordValues() into rValues.
+ */
+void ExternalForce::writeRecordValues(const SimTK::State& state, double* rValues) const
 {
 	const SimbodyEngine& engine = getModel().getSimbodyEngine();
-	OpenSim::Array<double>	values(SimTK::NaN);
 	double time = state.getTime();
+	int n = 0;
 
 	if (_appliesForce) {
 		Vec3 force = getForceAtTime(time);
 		engine.transform(state, *_forceExpressedInBody, force, engine.getGroundBody(), force);
 		for(int i=0; i<3; ++i)
-			values.append(force[i]);
+			rValues[n++] = force[i];
 	
 		if (_specifiesPoint) {
 			Vec3 point = getPointAtTime(time);
 			engine.transformPosition(state, *_pointExpressedInBody, point, *_appliedToBody, point);
 			for(int i=0; i<3; ++i)
-				values.append(point[i]);
+				rValues[n++] = point[i];
 		}
 	}
 	if (_appliesTorque){
 		Vec3 torque = getTorqueAtTime(time);
 		engine.transform(state, *_forceExpressedInBody, torque, engine.getGroundBody(), torque);
 		for(int i=0; i<3; ++i)
-			values.append(torque[i]);
+			rValues[n++] = torque[i];
 	}
-
-	return values;
 };
 
 
@@ -184,6 +184,10 @@ public:
      * getRecordLabels and should return same size Array.
 	 */
 	virtual OpenSim::Array<double> getRecordValues(const SimTK::State& state) const;
+	/**
+	 * Write the values reported by getRecordValues() into rValues.
+	 */
+	virtual void writeRecordValues(const SimTK::State& state, double* rValues) const;
 	/**
 	 * Methods to query the force properties to find out if it's a body vs. 
      * point force and/or if it applies a torque. 
@@ -27,6 +27,7 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include "OpenSim/Simulation/Model/ModelComponent.h"
 #include <Simbody.h>
+#include <algorithm>
 
 namespace OpenSim {
 
@@ -110,6 +111,25 @@ public:
 	virtual OpenSim::Array<double> getRecordValues(const SimTK::State& state) const {
 		return OpenSim::Array<double>();
 	};
+	/**
+	 * Number of values reported by getRecordValues(). It must not change
+	 * once the system is built, so that reporters can size their rows once.
+	 * The default counts the labels returned by getRecordLabels().
+	 */
+	virtual int getNumRecordValues() const {
+		return getRecordLabels().getSize();
+	}
+	/**
+	 * Write the values reported by getRecordValues() into rValues, which must
+	 * have room for getNumRecordValues() values. The default copies them from
+	 * getRecordValues(), but never more than getNumRecordValues() of them;
+	 * Forces override it to report without allocating.
+	 */
+	virtual void writeRecordValues(const SimTK::State& state, double* rValues) const {
+		OpenSim::Array<double> values = getRecordValues(state);
+		int n = std::min(values.getSize(), getNumRecordValues());
+		for(int i=0; i<n; ++i) rValues[i] = values[i];
+	}
 
 
 	/** Return a flag indicating whether the Force is applied along a Path. If
@@ -117,6 +137,10 @@ public:
 	also implement the getGeometryPath() method. **/
 	virtual bool hasGeometryPath() const { return getPropertyIndex("GeometryPath").isValid();};
 
+	/** Return the index of the SimTK::Force that applies this Force in the
+	model's force subsystem. Valid once the system has been created. **/
+	SimTK::ForceIndex getForceIndex() const { return _index; }
+
 protected:
 	/** Default constructor sets up Force-level properties; can only be
     called from a derived class constructor. **/
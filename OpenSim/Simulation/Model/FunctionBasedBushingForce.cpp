@@ -464,18 +464,28 @@ OpenSim::Array<std::string> FunctionBasedBushingForce::getRecordLabels() const
  */
 OpenSim::Array<double> FunctionBasedBushingForce::
 getRecordValues(const SimTK::State& state) const 
+{
+    OpenSim::Array<double> values(0.0,getNumRecordValues());
+    writeRecordValues(state, values.get());
+    return values;
+}
+/**
+ * Write the value(s) reported by getRecordValues() into rValues
+ */
+void FunctionBasedBushingForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
 {
     SpatialVec F_GM( Vec3(0.0),Vec3(0.0) );
     SpatialVec F_GF( Vec3(0.0),Vec3(0.0) );
     
     ComputeForcesAtBushing(state, F_GM, F_GF);
 
-    OpenSim::Array<double> values(1);
-
-    values.append(3, &F_GF[1][0]);
-	values.append(3, &F_GF[0][0]);
-    values.append(3, &F_GM[1][0]);
-	values.append(3, &F_GM[0][0]);
+    for(int i=0; i<3; ++i){
+        rValues[i] = F_GF[1][i];
+        rValues[3+i] = F_GF[0][i];
+        rValues[6+i] = F_GM[1][i];
+        rValues[9+i] = F_GM[0][i];
+    }
 
 
     /*  Old stuff reporting body forces at body origin
@@ -506,8 +516,6 @@ getRecordValues(const SimTK::State& state) const
 	values.append(3, &torques[0]);
 
     */
-
-	return values;
 }
 
 //_____________________________________________________________________________
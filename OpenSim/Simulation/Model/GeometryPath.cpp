@@ -48,6 +48,25 @@ using SimTK::Vec3;
 
 static const Vec3 DefaultDefaultColor(.5,.5,.5); // boring gray 
 
+namespace {
+    // Reset the result of a previous wrap to "did not wrap".
+    void resetWrapResult(WrapResult& wr)
+    {
+        wr.startPoint = -1;
+        wr.endPoint = -1;
+
+        wr.wrap_pts.setSize(0);
+        wr.wrap_path_length = 0.0;
+        wr.factor = 1.0;
+
+        for (int i = 0; i < 3; i++) {
+            wr.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
+            wr.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
+            wr.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        }
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -121,6 +140,11 @@ void GeometryPath::connectToModel(Model& aModel) {
     }
 
     upd_display().setOwner(this);
+
+    // Make the moment-arm solver now rather than on first use, so that
+    // computeMomentArm() does not modify the path.
+    delete _maSolver;
+    _maSolver = new MomentArmSolver(aModel);
 }
 
 //_____________________________________________________________________________
@@ -134,26 +158,26 @@ void GeometryPath::connectToModel(Model& aModel) {
     // Allocate cache entries to save the current length and speed(=d/dt length)
     // of the path in the cache. Length depends only on q's so will be valid
     // after Position stage, speed requires u's also so valid at Velocity stage.
-    addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
-    addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
+    _lengthCV = addCacheVariable<double>("length", 0.0, SimTK::Stage::Position);
+    _speedCV = addCacheVariable<double>("speed", 0.0, SimTK::Stage::Velocity);
     // Cache the set of points currently defining this path.
-    Array<PathPoint *> pathPrototype;
-    addCacheVariable<Array<PathPoint *> >
-        ("current_path", pathPrototype, SimTK::Stage::Position);
+    _currentPathCV = addCacheVariable<CurrentPath>
+        ("current_path", CurrentPath(), SimTK::Stage::Position);
     // When displaying, cache the set of points to be used to draw the path.
-    addCacheVariable<Array<PathPoint *> >
+    Array<PathPoint *> pathPrototype;
+    _currentDisplayPathCV = addCacheVariable<Array<PathPoint *> >
         ("current_display_path", pathPrototype, SimTK::Stage::Position);
 
     // We consider this cache entry valid any time after it has been created
     // and first marked valid, and we won't ever invalidate it.
-    addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
+    _colorCV = addCacheVariable<SimTK::Vec3>("color", get_default_color(), 
                                   SimTK::Stage::Topology);
 }
 
 void GeometryPath::initStateFromProperties( SimTK::State& s) const
 {
     Super::initStateFromProperties(s);
-    markCacheVariableValid(s, "color"); // it is OK at its default value
+    markCacheVariableValid(s, _colorCV); // it is OK at its default value
 }
 
 //------------------------------------------------------------------------------
@@ -265,7 +289,55 @@ const OpenSim::Array <PathPoint*> & GeometryPath::
 getCurrentPath(const SimTK::State& s)  const
 {
     computePath(s);   // compute checks if path needs to be recomputed
-    return getCacheVariable< Array<PathPoint*> >(s, "current_path");
+    return getCacheVariable(s, _currentPathCV).points;
+}
+
+//_____________________________________________________________________________
+/*
+ * get the result of the last wrap over the wrap object of one of the 
+ * PathWraps of this path
+ *
+ * @return The previous wrap, in the cache of the state.
+ */
+const WrapResult& GeometryPath::
+getPreviousWrap(const SimTK::State& s, const PathWrap& aPathWrap) const
+{
+    computePath(s);
+    const CurrentPath& currentPath = getCacheVariable(s, _currentPathCV);
+    for (int i = 0; i < (int)currentPath.wraps.size(); i++) {
+        if (currentPath.wraps[i] == &aPathWrap)
+            return currentPath.previousWraps[i];
+    }
+    throw Exception("GeometryPath::getPreviousWrap: " + aPathWrap.getName() 
+                    + " is not a wrap of path " + getName() + ".", 
+                    __FILE__, __LINE__);
+}
+
+//_____________________________________________________________________________
+/*
+ * Assignment of the path of one state to another. The copied path refers to
+ * the copied wrap points, not to those of the source.
+ */
+GeometryPath::CurrentPath& GeometryPath::CurrentPath::
+operator=(const CurrentPath& source)
+{
+    if (&source == this)
+        return *this;
+
+    wraps = source.wraps;
+    wrapPoints = source.wrapPoints;
+    previousWraps = source.previousWraps;
+
+    points = source.points;
+    for (int i = 0; i < points.getSize(); i++) {
+        for (int j = 0; j < (int)source.wrapPoints.size(); j++) {
+            if (points[i] == &source.wrapPoints[j]) {
+                points[i] = &wrapPoints[j];
+                break;
+            }
+        }
+    }
+    return *this;
 }
 
 // get the the path as PointForceDirections directions 
@@ -290,7 +362,7 @@ getPointForceDirections(const SimTK::State& s,
     
     for (i = 0; i < np; i++) {
         PointForceDirection *pfd = 
-            new PointForceDirection(currentPath[i]->getLocation(), 
+            new PointForceDirection(currentPath[i]->getLocation(s), 
                                     currentPath[i]->getBody(), Vec3(0));
         rPFDs->append(pfd);
     }
@@ -307,8 +379,8 @@ getPointForceDirections(const SimTK::State& s,
             Vec3 direction(0);
 
             // Find the positions of start and end in the inertial frame.
-            engine.getPosition(s, start->getBody(), start->getLocation(), posStart);
-            engine.getPosition(s, end->getBody(), end->getLocation(), posEnd);
+            engine.getPosition(s, start->getBody(), start->getLocation(s), posStart);
+            engine.getPosition(s, end->getBody(), end->getLocation(s), posEnd);
 
             // Form a vector from start to end, in the inertial frame.
             direction = (posEnd - posStart);
@@ -365,8 +437,8 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
 
         if (bo != bf) {
             // Find the positions of start and end in the inertial frame.
-            po = bo->findStationLocationInGround(s, start->getLocation());
-            pf = bf->findStationLocationInGround(s, end->getLocation());
+            po = bo->findStationLocationInGround(s, start->getLocation(s));
+            pf = bf->findStationLocationInGround(s, end->getLocation(s));
 
             // Form a vector from start to end, in the inertial frame.
 			dir = (pf - po);
@@ -386,9 +458,9 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
 			force = tension*dir;
 
             // add in the tension point forces to body forces
-			bo->applyForceToBodyPoint(s, start->getLocation(), force, 
+			bo->applyForceToBodyPoint(s, start->getLocation(s), force, 
 				bodyForces);
-			bf->applyForceToBodyPoint(s, end->getLocation(), -force,
+			bf->applyForceToBodyPoint(s, end->getLocation(s), -force,
 				bodyForces);
 
 			const MovingPathPoint* mppo = 
@@ -444,7 +516,7 @@ getCurrentDisplayPath(const SimTK::State& s) const
 {
     // update the geometry to make sure the current display path is up to date.
     // updateGeometry(s);
-    return getCacheVariable<Array <PathPoint*> >(s, "current_display_path" );
+    return getCacheVariable(s, _currentDisplayPathCV);
 }
 
 //_____________________________________________________________________________
@@ -457,7 +529,7 @@ void GeometryPath::updateGeometrySize(const SimTK::State& s) const
 {
     const int numberOfSegments = get_display().countGeometry();
     const Array<PathPoint*>& currentDisplayPath = 
-        getCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        getCacheVariable(s, _currentDisplayPathCV);
 
     // Track whether we're creating geometry from scratch or
     // just updating
@@ -503,7 +575,7 @@ void GeometryPath::updateGeometryLocations(const SimTK::State& s) const
     SimTK::Vec3 globalLocation;
     SimTK::Vec3 previousPointGlobalLocation;
     const Array<PathPoint*>& currentDisplayPath = 
-        getCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        getCacheVariable(s, _currentDisplayPathCV);
 
     GeometryPath * mutableThis = const_cast<GeometryPath*>(this);
 
@@ -541,7 +613,7 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
     computePath(s);
 
     // If display path is current do not need to recompute it.
-    if (isCacheVariableValid(s, "current_display_path"))
+    if (isCacheVariableValid(s, _currentDisplayPathCV))
         return;
    
     // Updating the display path will also validate the current_display_path 
@@ -566,22 +638,22 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
 double GeometryPath::getLength( const SimTK::State& s) const
 {
     computePath(s);  // compute checks if path needs to be recomputed
-    return( getCacheVariable<double>(s, "length") );
+    return( getCacheVariable(s, _lengthCV) );
 }
 
 void GeometryPath::setLength( const SimTK::State& s, double length ) const
 {
-    setCacheVariable<double>(s, "length", length); 
+    setCacheVariable(s, _lengthCV, length); 
 }
 
 void GeometryPath::setColor(const SimTK::State& s, const SimTK::Vec3& color) const
 {
-    setCacheVariable<SimTK::Vec3>(s, "color", color);
+    setCacheVariable(s, _colorCV, color);
 }
 
 Vec3 GeometryPath::getColor(const SimTK::State& s) const
 {
-    return getCacheVariable<SimTK::Vec3>(s, "color");
+    return getCacheVariable(s, _colorCV);
 }
 
 
@@ -594,11 +666,11 @@ Vec3 GeometryPath::getColor(const SimTK::State& s) const
 double GeometryPath::getLengtheningSpeed( const SimTK::State& s) const
 {
     computeLengtheningSpeed(s);
-    return getCacheVariable<double>(s, "speed");
+    return getCacheVariable(s, _speedCV);
 }
 void GeometryPath::setLengtheningSpeed( const SimTK::State& s, double speed ) const
 {
-    setCacheVariable<double>(s, "speed", speed);    
+    setCacheVariable(s, _speedCV, speed);    
 }
 
 void GeometryPath::setPreScaleLength( const SimTK::State& s, double length ) {
@@ -703,9 +775,9 @@ placeNewPathPoint(const SimTK::State& s, SimTK::Vec3& aOffset, int aIndex,
             base = start;
             distance = 0.5;
         }
-        const Vec3& startPt = get_PathPointSet().get(start).getLocation();
-        const Vec3& endPt = get_PathPointSet().get(end).getLocation();
-        const Vec3& basePt = get_PathPointSet().get(base).getLocation();
+        const Vec3 startPt = get_PathPointSet().get(start).getLocation(s);
+        const Vec3 endPt = get_PathPointSet().get(end).getLocation(s);
+        const Vec3 basePt = get_PathPointSet().get(base).getLocation(s);
         Vec3 startPt2(0.0);
         Vec3 endPt2(0.0);
         getModel().getSimbodyEngine().transformPosition
@@ -969,36 +1041,28 @@ void GeometryPath::computePath(const SimTK::State& s) const
 {
     const SimTK::Stage& sg = s.getSystemStage();
     
-    if (isCacheVariableValid(s, "current_path"))  {
+    if (isCacheVariableValid(s, _currentPathCV))  {
         return;
     }
 
     // Clear the current path.
-    Array<PathPoint*>& currentPath = 
-        updCacheVariable<Array<PathPoint*> >(s, "current_path");
-    currentPath.setSize(0);
-
-    // >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-    // TODO: This is a bug. Here we are going to modify moving path point
-    // locations *in the property* which means they are out of sync with 
-    // the supplied state. These updates should be done in the state cache.
-    GeometryPath * mutableThis = const_cast<GeometryPath*>(this);
+    CurrentPath& currentPath = updCacheVariable(s, _currentPathCV);
+    currentPath.points.setSize(0);
 
-    // Add the active fixed and moving via points to the path.
+    // Add the active fixed and moving via points to the path. The locations
+    // of moving points are computed from the state wherever they are used
+    // (PathPoint::getLocation(s)), so the points themselves are not modified.
     for (int i = 0; i < get_PathPointSet().getSize(); i++) {
-        // If this is a moving path point, update its location *in the
-        // PathPointSet property* (BAD).
-        mutableThis->upd_PathPointSet()[i].update(s);
         if (get_PathPointSet()[i].isActive(s))
-            currentPath.append(&get_PathPointSet()[i]); // <--- !!!!BAD
+            currentPath.points.append(&get_PathPointSet()[i]);
     }
   
     // Use the current path so far to check for intersection with wrap objects, 
     // which may add additional points to the path.
     applyWrapObjects(s, currentPath);
-    calcLengthAfterPathComputation(s, currentPath);
+    calcLengthAfterPathComputation(s, currentPath.points);
 
-    markCacheVariableValid(s, "current_path");
+    markCacheVariableValid(s, _currentPathCV);
 }
 
 //_____________________________________________________________________________
@@ -1007,7 +1071,7 @@ void GeometryPath::computePath(const SimTK::State& s) const
  */
 void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
 {
-    if (isCacheVariableValid(s, "speed"))
+    if (isCacheVariableValid(s, _speedCV))
         return;
 
     SimTK::Vec3 posRelative, velRelative;
@@ -1026,14 +1090,12 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
         end   = currentPath[i+1];
 
         // Find the positions and velocities in the inertial frame.
-        engine.getPosition(s, start->getBody(), start->getLocation(), 
-            posStartInertial);
-        engine.getPosition(s, end->getBody(), end->getLocation(), 
-            posEndInertial);
-        engine.getVelocity(s, start->getBody(), start->getLocation(), 
-            velStartInertial);
-        engine.getVelocity(s, end->getBody(), end->getLocation(), 
-            velEndInertial);
+        const Vec3 startLoc = start->getLocation(s);
+        const Vec3 endLoc = end->getLocation(s);
+        engine.getPosition(s, start->getBody(), startLoc, posStartInertial);
+        engine.getPosition(s, end->getBody(), endLoc, posEndInertial);
+        engine.getVelocity(s, start->getBody(), startLoc, velStartInertial);
+        engine.getVelocity(s, end->getBody(), endLoc, velEndInertial);
 
         // The points might be moving in their local bodies' reference frames
         // (MovingPathPoints and possibly PathWrapPoints) so find their
@@ -1063,16 +1125,51 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
     setLengtheningSpeed(s, speed);
 }
 
+//_____________________________________________________________________________
+/*
+ * Make the wrap points and previous wraps of a current path match the
+ * PathWrapSet, which may have been edited since they were made. Must not be
+ * called while the path contains wrap points.
+ */
+void GeometryPath::updateWraps(CurrentPath& path) const
+{
+    const int nw = get_PathWrapSet().getSize();
+    bool upToDate = ((int)path.wraps.size() == nw);
+    for (int i = 0; upToDate && i < nw; i++) {
+        PathWrap& ws = get_PathWrapSet().get(i);
+        upToDate = path.wraps[i] == &ws && path.wrapPoints[2*i].getWrapObject()
+                                            == ws.getWrapPoint(0).getWrapObject();
+    }
+    if (upToDate)
+        return;
+
+    path.wraps.clear();
+    path.wrapPoints.clear();
+    path.previousWraps.clear();
+    path.wrapPoints.reserve(2*nw);
+    for (int i = 0; i < nw; i++) {
+        PathWrap& ws = get_PathWrapSet().get(i);
+        path.wraps.push_back(&ws);
+        path.wrapPoints.push_back(ws.getWrapPoint(0));
+        path.wrapPoints.push_back(ws.getWrapPoint(1));
+        path.previousWraps.push_back(WrapResult());
+        resetWrapResult(path.previousWraps.back());
+    }
+}
+
 //_____________________________________________________________________________
 /*
  * Apply the wrap objects to the current path.
  */
 void GeometryPath::
-applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const 
+applyWrapObjects(const SimTK::State& s, CurrentPath& currentPath) const 
 {
+    updateWraps(currentPath);
     if (get_PathWrapSet().getSize() < 1)
         return;
 
+    Array<PathPoint*>& path = currentPath.points;
+
     WrapResult best_wrap;
     Array<int> result, order;
 
@@ -1094,14 +1191,18 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
         for (int i = 0; i < get_PathWrapSet().getSize(); i++)
         {
             result[i] = 0;
-            PathWrap& ws = get_PathWrapSet().get(order[i]);
+            const PathWrap& ws = get_PathWrapSet().get(order[i]);
             const WrapObject* wo = ws.getWrapObject();
+            // This object's wrap points and previous wrap in this state.
+            PathWrapPoint& wp0 = currentPath.wrapPoints[2*order[i]];
+            PathWrapPoint& wp1 = currentPath.wrapPoints[2*order[i] + 1];
+            WrapResult& previousWrap = currentPath.previousWraps[order[i]];
             best_wrap.wrap_pts.setSize(0);
             double min_length_change = SimTK::Infinity;
 
             // First remove this object's wrapping points from the current path.
             for (int j = 0; j <path.getSize(); j++) {
-                if( path.get(j) == &ws.getWrapPoint(0)) {
+                if( path.get(j) == &wp0) {
                     path.remove(j); // remove the first wrap point
                     path.remove(j); // remove the second wrap point
                     break;
@@ -1181,6 +1282,13 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                         WrapResult wr;
                         wr.startPoint = pt1;
                         wr.endPoint   = pt2;
+                        // Pass on the previous wrap, which some wrap objects
+                        // start from.
+                        wr.r1 = previousWrap.r1;
+                        wr.r2 = previousWrap.r2;
+                        wr.c1 = previousWrap.c1;
+                        wr.sv = previousWrap.sv;
+                        wr.factor = previousWrap.factor;
 
                         result[i] = wo->wrapPathSegment(s, *path.get(pt1), 
                                                         *path.get(pt2), ws, wr);
@@ -1193,9 +1301,9 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                             // taken as the mandatory wrap (this is considered 
                             // an ill-conditioned case).
                             best_wrap = wr;
-                            // Store the best wrap in the pathWrap for possible 
+                            // Store the best wrap in the state for possible 
                             // use next time.
-                            ws.setPreviousWrap(wr);
+                            previousWrap = wr;
                             break;
                         }  else if (result[i] == WrapObject::wrapped) {
                             // "wrapped" means the path segment was wrapped over
@@ -1207,9 +1315,9 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                             if (path_length_change < min_length_change)
                             {
                                 best_wrap = wr;
-                                // Store the best wrap in the pathWrap for 
+                                // Store the best wrap in the state for 
                                 // possible use next time
-                                ws.setPreviousWrap(wr);
+                                previousWrap = wr;
                                 min_length_change = path_length_change;
                             } else {
                                 // The wrap was not shorter than the current 
@@ -1224,16 +1332,16 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                 }
 
                 // Deallocate previous wrapping points if necessary.
-                ws.getWrapPoint(1).getWrapPath().setSize(0);
+                wp1.getWrapPath().setSize(0);
 
                 if (best_wrap.wrap_pts.getSize() == 0) {
-                    ws.resetPreviousWrap();
-                    ws.getWrapPoint(1).getWrapPath().setSize(0);
+                    resetWrapResult(previousWrap);
+                    wp1.getWrapPath().setSize(0);
                 } else {
                     // If wrapping did occur, copy wrap info into the PathStruct.
-                    ws.getWrapPoint(0).getWrapPath().setSize(0);
+                    wp0.getWrapPath().setSize(0);
 
-                    Array<SimTK::Vec3>& wrapPath = ws.getWrapPoint(1).getWrapPath();
+                    Array<SimTK::Vec3>& wrapPath = wp1.getWrapPath();
                     wrapPath = best_wrap.wrap_pts;
 
                     // In OpenSim, all conversion to/from the wrap object's 
@@ -1246,17 +1354,17 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                     //            ms->ground_segment);
                     // }
 
-                    ws.getWrapPoint(0).setWrapLength(0.0);
-                    ws.getWrapPoint(1).setWrapLength(best_wrap.wrap_path_length);
-                    ws.getWrapPoint(0).setBody(wo->getBody());
-                    ws.getWrapPoint(1).setBody(wo->getBody());
+                    wp0.setWrapLength(0.0);
+                    wp1.setWrapLength(best_wrap.wrap_path_length);
+                    wp0.setBody(wo->getBody());
+                    wp1.setBody(wo->getBody());
 
-                    ws.getWrapPoint(0).setLocation(s,best_wrap.r1);
-                    ws.getWrapPoint(1).setLocation(s,best_wrap.r2);
+                    wp0.setLocation(s,best_wrap.r1);
+                    wp1.setLocation(s,best_wrap.r2);
 
                     // Now insert the two new wrapping points into mp[] array.
-                    path.insert(best_wrap.endPoint, &ws.getWrapPoint(0));
-                    path.insert(best_wrap.endPoint + 1, &ws.getWrapPoint(1));
+                    path.insert(best_wrap.endPoint, &wp0);
+                    path.insert(best_wrap.endPoint + 1, &wp1);
                 }
             }
         }
@@ -1279,9 +1387,8 @@ applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path) const
                 order[1] = 0;
 
                 // remove wrap object 0 from the list of path points
-                PathWrap& ws = get_PathWrapSet().get(0);
                 for (int j = 0; j < path.getSize(); j++) {
-                    if (path.get(j) == &ws.getWrapPoint(0)) {
+                    if (path.get(j) == &currentPath.wrapPoints[0]) {
                         path.remove(j); // remove the first wrap point
                         path.remove(j); // remove the second wrap point
                         break;
@@ -1305,12 +1412,11 @@ calcPathLengthChange(const SimTK::State& s, const WrapObject& wo,
     const PathPoint* pt1 = path.get(wr.startPoint);
     const PathPoint* pt2 = path.get(wr.endPoint);
 
+    const Vec3 p1 = pt1->getLocation(s);
+    const Vec3 p2 = pt2->getLocation(s);
     double straight_length = getModel().getSimbodyEngine()
-        .calcDistance(s, pt1->getBody(), pt1->getLocation(),
-                         pt2->getBody(), pt2->getLocation());
+        .calcDistance(s, pt1->getBody(), p1, pt2->getBody(), p2);
 
-    const Vec3& p1 = pt1->getLocation();
-    const Vec3& p2 = pt2->getLocation();
     double wrap_length = getModel().getSimbodyEngine()
         .calcDistance(s, pt1->getBody(), p1, wo.getBody(), wr.r1);
     wrap_length += wr.wrap_path_length;
@@ -1348,8 +1454,8 @@ calcLengthAfterPathComputation(const SimTK::State& s,
             if (smwp)
                 length += smwp->getWrapLength();
         } else {
-            length += engine.calcDistance(s, p1->getBody(), p1->getLocation(), 
-                                             p2->getBody(), p2->getLocation());
+            length += engine.calcDistance(s, p1->getBody(), p1->getLocation(s), 
+                                             p2->getBody(), p2->getLocation(s));
         }
     }
 
@@ -1366,9 +1472,6 @@ calcLengthAfterPathComputation(const SimTK::State& s,
 double GeometryPath::
 computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 {
-	if(!_maSolver)
-		_maSolver = new MomentArmSolver(*_model);
-
     return  _maSolver->solve(s, aCoord,  *this);
 }
 
@@ -1384,7 +1487,7 @@ void GeometryPath::updateDisplayer(const SimTK::State& s) const
 void GeometryPath::updateDisplayPath(const SimTK::State& s) const
 {
     Array<PathPoint*>& currentDisplayPath = 
-        updCacheVariable<Array<PathPoint*> >(s, "current_display_path");
+        updCacheVariable(s, _currentDisplayPathCV);
     // Clear the current display path. Delete all path points
     // that have a NULL path pointer. This means that they were
     // created by an earlier call to updateDisplayPath() and are
@@ -1397,7 +1500,7 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
     currentDisplayPath.setSize(0);
 
     const Array<PathPoint*>& currentPath =  
-        getCacheVariable<Array<PathPoint*> >(s, "current_path");
+        getCacheVariable(s, _currentPathCV).points;
     for (int i=0; i<currentPath.getSize(); i++) {
         PathPoint* mp = currentPath.get(i);
         PathWrapPoint* mwp = dynamic_cast<PathWrapPoint*>(mp);
@@ -1416,8 +1519,22 @@ void GeometryPath::updateDisplayPath(const SimTK::State& s) const
                 currentDisplayPath.append(p);
             }
         }
-        currentDisplayPath.append(mp);
+        if (mwp) {
+            // The wrap points belong to the current path of the state, so
+            // display a copy of the tangent point.
+            PathWrapPoint* p = new PathWrapPoint();
+            p->setLocation(s, mwp->getLocation());
+            p->setBody(mwp->getBody());
+            p->setWrapObject(mwp->getWrapObject());
+            currentDisplayPath.append(p);
+        } else {
+            // Moving points are located by the state; keep their location
+            // property current for display. This is why the display path must
+            // not be updated concurrently.
+            mp->update(s);
+            currentDisplayPath.append(mp);
+        }
     }
 
-    markCacheVariableValid(s, "current_display_path");
+    markCacheVariableValid(s, _currentDisplayPathCV);
 }
@@ -32,6 +32,7 @@
 #include "PathPointSet.h"
 #include <OpenSim/Simulation/Wrap/PathWrapSet.h>
 #include <OpenSim/Simulation/MomentArmSolver.h>
+#include <vector>
 
 
 #ifdef SWIG
@@ -53,6 +54,13 @@ class PointForceDirection;
 /**
  * A base class representing a path (muscle, ligament, etc.).
  *
+ * The path of a state, including the points that wrapping inserts into it,
+ * is computed into the cache of that state and nothing is written to the
+ * properties of the path or its points, so lengths, speeds, moment arms and
+ * forces of one path may be computed on distinct states concurrently. The
+ * display path and geometry (updateDisplayer(), updateGeometry()) are not
+ * covered by this and must not be updated concurrently.
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -78,7 +86,37 @@ private:
 	SimTK::ReferencePtr<Object> _owner;
 
 	// solver used to compute moment-arms
-	mutable SimTK::ReferencePtr<MomentArmSolver> _maSolver;
+	SimTK::ReferencePtr<MomentArmSolver> _maSolver;
+
+	// The path in one state: the active path points, which include the
+	// points that wrapping inserts, and the wrap points and previous wrap
+	// results of each PathWrap. These live in the state cache rather than in
+	// the PathWraps so that the path can be computed on distinct states
+	// concurrently. Copies refer to their own wrap points.
+	struct CurrentPath {
+		Array<PathPoint*> points;
+		std::vector<const PathWrap*> wraps;
+		std::vector<PathWrapPoint> wrapPoints; // two per PathWrap
+		std::vector<WrapResult> previousWraps; // one per PathWrap
+
+		CurrentPath() {}
+		CurrentPath(const CurrentPath& source) { *this = source; }
+		CurrentPath& operator=(const CurrentPath& source);
+		friend std::ostream& operator<<(std::ostream& o, 
+			const CurrentPath& cp) {
+			o << "GeometryPath::CurrentPath should not be serialized!" 
+			  << std::endl;
+			return o;
+		}
+	};
+
+	// handles to the cache variables, assigned in addToSystem(); the entries
+	// themselves are allocated when the system's topology is realized
+	mutable CacheVariableHandle<double> _lengthCV;
+	mutable CacheVariableHandle<double> _speedCV;
+	mutable CacheVariableHandle<CurrentPath> _currentPathCV;
+	mutable CacheVariableHandle<Array<PathPoint*> > _currentDisplayPathCV;
+	mutable CacheVariableHandle<SimTK::Vec3> _colorCV;
 	
 //=============================================================================
 // METHODS
@@ -168,6 +206,11 @@ public:
 							   SimTK::Vector& mobilityForces) const;
 
 
+	/** Get the result of the last wrap of this path over the wrap object of
+	one of its PathWraps in the given state. */
+	const WrapResult& getPreviousWrap(const SimTK::State& s, 
+									  const PathWrap& aPathWrap) const;
+
 	//--------------------------------------------------------------------------
 	// COMPUTATIONS
 	//--------------------------------------------------------------------------
@@ -211,7 +254,8 @@ private:
 
 	void computePath(const SimTK::State& s ) const;
 	void computeLengtheningSpeed(const SimTK::State& s) const;
-	void applyWrapObjects(const SimTK::State& s, Array<PathPoint*>& path ) const;
+	void applyWrapObjects(const SimTK::State& s, CurrentPath& path ) const;
+	void updateWraps(CurrentPath& path) const;
 	double calcPathLengthChange(const SimTK::State& s, const WrapObject& wo, 
                                 const WrapResult& wr, 
                                 const Array<PathPoint*>& path) const; 
@@ -326,8 +326,16 @@ OpenSim::Array<std::string> HuntCrossleyForce::getRecordLabels() const
 OpenSim::Array<double> HuntCrossleyForce::
 getRecordValues(const SimTK::State& state) const 
 {
-	OpenSim::Array<double> values(1);
-
+	OpenSim::Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
+/**
+ * Write the value(s) to be reported into rValues
+ */
+void HuntCrossleyForce::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
+{
 	const ContactParametersSet& contactParametersSet = 
         get_contact_parameters();
 
@@ -342,6 +350,7 @@ getRecordValues(const SimTK::State& state) const
 	simtkForce.calcForceContribution(state, bodyForces, particleForces, 
                                      mobilityForces);
 
+	int n = 0;
 	for (int i = 0; i < contactParametersSet.getSize(); ++i)
     {
         ContactParameters& params = contactParametersSet.get(i);
@@ -349,17 +358,14 @@ getRecordValues(const SimTK::State& state) const
         {
 			ContactGeometry& geom = 
                 _model->updContactGeometrySet().get(params.getGeometry()[j]);
-			std::string bodyName = geom.getBodyName();
-	
-			SimTK::Vec3 forces = bodyForces(_model->getBodySet().get(bodyName).getIndex())[1];
-			SimTK::Vec3 torques = bodyForces(_model->getBodySet().get(bodyName).getIndex())[0];
+			const std::string& bodyName = geom.getBodyName();
+			const SimTK::SpatialVec& F = 
+                bodyForces(_model->getBodySet().get(bodyName).getIndex());
 
-			values.append(3, &forces[0]);
-			values.append(3, &torques[0]);
+			for (int k = 0; k < 3; ++k) rValues[n++] = F[1][k];
+			for (int k = 0; k < 3; ++k) rValues[n++] = F[0][k];
 		}
 	}
-
-	return values;
 }
 
 }// end of namespace OpenSim
@@ -471,6 +471,9 @@ SimTK::State& Model::initializeState() {
     // Process the modified modeling option.
 	getMultibodySystem().realizeModel(_workingState);
 
+    // Index the state variables of the Model for fast bulk access.
+    buildStateVariableTable(_workingState);
+
     // Invoke the ModelComponent interface for initializing the state.
     initStateFromProperties(_workingState);
 
@@ -96,6 +96,16 @@ related objects are maintained in a runtime section of the Model object. You
 can also ask a Model to provide visualization using the setUseVisualizer()
 method, in which case it will allocate an maintain a ModelVisualizer.
 
+<b>Threads.</b> Once the System is built, what is computed for a State is kept
+in that State (or computed into scratch space of the call) and not in the
+Model or its components. So realizing the System, computing forces (e.g.,
+Force::computeForce(), GeometryPath lengths and moment arms) and recording
+Analyses may be done on distinct States of one Model by several threads at
+once, provided that each thread uses Analysis instances of its own. Anything
+that modifies the Model, including property setters, initSystem() and
+scaling, as well as display (updateDisplayer(), the ModelVisualizer) must
+not run concurrently with other uses of the Model.
+
 @authors Frank Anderson, Peter Loan, Ayman Habib, Ajay Seth, Michael Sherman
 @see ModelComponent, ModelVisualizer, SimTK::System
 **/
@@ -371,29 +371,45 @@ MovingPathPoint& MovingPathPoint::operator=(const MovingPathPoint &aPoint)
  */
 void MovingPathPoint::update(const SimTK::State& s)
 {
+	_location = calcLocation(s);
+}
+
+//_____________________________________________________________________________
+/**
+ * Compute the point's location from the values of its coordinates, each
+ * clamped to its range.
+ *
+ * @return The location in the body's local reference frame.
+ */
+SimTK::Vec3 MovingPathPoint::calcLocation(const SimTK::State& s) const
+{
+	SimTK::Vec3 location;
+
 	if (_xCoordinate) {
         const double xval = SimTK::clamp(_xCoordinate->getRangeMin(),
                                          _xCoordinate->getValue(s),
                                          _xCoordinate->getRangeMax());
-		_location[0] = _xLocation->calcValue(SimTK::Vector(1, xval));
+		location[0] = _xLocation->calcValue(SimTK::Vector(1, xval));
     } else // type == Constant
-		_location[0] = _xLocation->calcValue(SimTK::Vector(1, 0.0));
+		location[0] = _xLocation->calcValue(SimTK::Vector(1, 0.0));
 
 	if (_yCoordinate) {
         const double yval = SimTK::clamp(_yCoordinate->getRangeMin(),
                                          _yCoordinate->getValue(s),
                                          _yCoordinate->getRangeMax());
-		_location[1] = _yLocation->calcValue(SimTK::Vector(1, yval));
+		location[1] = _yLocation->calcValue(SimTK::Vector(1, yval));
     } else // type == Constant
-		_location[1] = _yLocation->calcValue(SimTK::Vector(1, 0.0));
+		location[1] = _yLocation->calcValue(SimTK::Vector(1, 0.0));
 
 	if (_zCoordinate) {
         const double zval = SimTK::clamp(_zCoordinate->getRangeMin(),
                                          _zCoordinate->getValue(s),
                                          _zCoordinate->getRangeMax());
-		_location[2] = _zLocation->calcValue(SimTK::Vector(1, zval));
+		location[2] = _zLocation->calcValue(SimTK::Vector(1, zval));
     } else // type == Constant
-		_location[2] = _zLocation->calcValue(SimTK::Vector(1, 0.0));
+		location[2] = _zLocation->calcValue(SimTK::Vector(1, 0.0));
+
+	return location;
 }
 
 //_____________________________________________________________________________
@@ -142,6 +142,9 @@ public:
 #endif
    virtual void scale(const SimTK::State& s, const SimTK::Vec3& aScaleFactors);
 
+protected:
+	SimTK::Vec3 calcLocation(const SimTK::State& s) const OVERRIDE_11;
+
 private:
 	void setNull();
 	void setupProperties();
@@ -780,6 +780,14 @@ protected:
     };
 
 
+	/** Handles to the muscle's cache variables, assigned in addToSystem().
+	The entries themselves are allocated when the system's topology is
+	realized. */
+	mutable CacheVariableHandle<MuscleLengthInfo> _lengthInfoCV;
+	mutable CacheVariableHandle<FiberVelocityInfo> _velInfoCV;
+	mutable CacheVariableHandle<MuscleDynamicsInfo> _dynamicsInfoCV;
+	mutable CacheVariableHandle<MusclePotentialEnergyInfo> _potentialEnergyInfoCV;
+
 	/** to support deprecated muscles */
 	double _maxIsometricForce;
 	double _optimalFiberLength;
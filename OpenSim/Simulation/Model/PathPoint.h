@@ -109,6 +109,12 @@ public:
 	const SimTK::Vec3& getLocation() const { return _location; }
 #endif
 	SimTK::Vec3& getLocation()  { return _location; }
+	/** Get the location of the point in its body's frame in the given state.
+	For a point that moves with a coordinate this is computed from the state
+	rather than read from the location property, and nothing is written to
+	the point, so it may be called on distinct states concurrently. */
+	SimTK::Vec3 getLocation(const SimTK::State& s) const
+	{	return calcLocation(s); }
 
 	const double& getLocationCoord(int aXYZ) const { assert(aXYZ>=0 && aXYZ<=2); return _location[aXYZ]; }
 	void setLocationCoord(int aXYZ, double aValue) { assert(aXYZ>=0 && aXYZ<=2); _location[aXYZ]=aValue; }
@@ -151,6 +157,10 @@ public:
 	static void deletePathPoint(PathPoint* aPoint) { if (aPoint) delete aPoint; }
 
 protected:
+	/** Compute the location of the point in the given state. The default is
+	the location property. */
+	virtual SimTK::Vec3 calcLocation(const SimTK::State& s) const
+	{	return _location; }
 
 private:
 	void setNull();
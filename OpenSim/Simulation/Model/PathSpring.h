@@ -180,6 +180,10 @@ protected:
 		values.append(getTension(state));
 		return values;
 	}
+	int getNumRecordValues() const { return 1; }
+	void writeRecordValues(const SimTK::State& state, double* rValues) const {
+		rValues[0] = getTension(state);
+	}
 
 	//--------------------------------------------------------------------------
 	// Display
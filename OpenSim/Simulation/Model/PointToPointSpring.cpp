@@ -225,8 +225,15 @@ OpenSim::Array<std::string> PointToPointSpring::getRecordLabels() const
 OpenSim::Array<double> PointToPointSpring::
 getRecordValues(const SimTK::State& state) const 
 {
-	OpenSim::Array<double> values(1);
+	OpenSim::Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
 
+// Write the value(s) reported by getRecordValues() into rValues.
+void PointToPointSpring::
+writeRecordValues(const SimTK::State& state, double* rValues) const 
+{
 	const SimTK::Force::TwoPointLinearSpring& 
         simtkSpring = SimTK::Force::TwoPointLinearSpring::downcast
                                 (_model->getForceSubsystem().getForce(_index));
@@ -242,18 +249,16 @@ getRecordValues(const SimTK::State& state) const
 	simtkSpring.calcForceContribution(state, bodyForces, particleForces, 
                                       mobilityForces);
 	SimTK::Vec3 forces = bodyForces(body1.getIndex())[1];
-	values.append(3, &forces[0]);
+	for(int i=0; i<3; ++i) rValues[i] = forces[i];
 
 	SimTK::Vec3 gpoint(0);
 	_model->getSimbodyEngine().getPosition(state, body1, getPoint1(), gpoint);
-	values.append(3, &gpoint[0]);
+	for(int i=0; i<3; ++i) rValues[3+i] = gpoint[i];
 
 	forces = bodyForces(body2.getIndex())[1];
-	values.append(3, &forces[0]);
+	for(int i=0; i<3; ++i) rValues[6+i] = forces[i];
 
 	_model->getSimbodyEngine().getPosition(state, body2, getPoint2(), gpoint);
-	values.append(3, &gpoint[0]);
-
-	return values;
+	for(int i=0; i<3; ++i) rValues[9+i] = gpoint[i];
 }
 
@@ -352,7 +352,14 @@ OpenSim::Array<std::string> PrescribedForce::getRecordLabels() const {
  * frame, etc. used in conjunction with getRecordLabels and should return same size Array
  */
 OpenSim::Array<double> PrescribedForce::getRecordValues(const SimTK::State& state) const {
-	OpenSim::Array<double>	values(SimTK::NaN);
+	OpenSim::Array<double>	values(SimTK::NaN, getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+};
+/**
+ * Write the values reported by getRecordValues() into rValues.
+ */
+void PrescribedForce::writeRecordValues(const SimTK::State& state, double* rValues) const {
 	assert(_body!=0);
 
 	const bool pointIsGlobal = get_pointIsGlobal();
@@ -370,6 +377,7 @@ OpenSim::Array<double> PrescribedForce::getRecordValues(const SimTK::State& stat
 	const double time = state.getTime();
 	const SimbodyEngine& engine = getModel().getSimbodyEngine();
 	const SimTK::Vector timeAsVector(1, time);
+	int n = 0;
 
 	if (appliesForce) {
 	    Vec3 force(forceFunctions[0].calcValue(timeAsVector), 
@@ -380,7 +388,7 @@ OpenSim::Array<double> PrescribedForce::getRecordValues(const SimTK::State& stat
                              engine.getGroundBody(), force);
 		if (!pointSpecified) {
 			//applyForce(*_body, force);
-			for (int i=0; i<3; i++) values.append(force[i]);
+			for (int i=0; i<3; i++) rValues[n++] = force[i];
 	    } else {
 	        Vec3 point(pointFunctions[0].calcValue(timeAsVector), 
 		               pointFunctions[1].calcValue(timeAsVector), 
@@ -389,10 +397,14 @@ OpenSim::Array<double> PrescribedForce::getRecordValues(const SimTK::State& stat
 				engine.transformPosition(state, engine.getGroundBody(), point, 
                                          *_body, point);
 			//applyForceToPoint(*_body, point, force);
-			for (int i=0; i<3; i++) values.append(force[i]);
-			for (int i=0; i<3; i++) values.append(point[i]);
+			for (int i=0; i<3; i++) rValues[n++] = force[i];
+			for (int i=0; i<3; i++) rValues[n++] = point[i];
 		}
 	}
+	else if (pointSpecified) {
+		// a point is labeled even though no force is applied at it
+		for (int i=0; i<3; i++) rValues[n++] = SimTK::NaN;
+	}
 	if (appliesTorque) {
 	    Vec3 torque(torqueFunctions[0].calcValue(timeAsVector), 
 		            torqueFunctions[1].calcValue(timeAsVector), 
@@ -400,10 +412,9 @@ OpenSim::Array<double> PrescribedForce::getRecordValues(const SimTK::State& stat
 		if (!forceIsGlobal)
 			engine.transform(state, *_body, torque, 
                              engine.getGroundBody(), torque);
-		for (int i=0; i<3; i++) values.append(torque[i]);
+		for (int i=0; i<3; i++) rValues[n++] = torque[i];
 		//applyTorque(*_body, torque);
 	}
-	return values;
 };
 
 void PrescribedForce::setNull()
@@ -239,6 +239,10 @@ public:
      * getRecordLabels() and should return same size Array.
 	 */
 	virtual OpenSim::Array<double> getRecordValues(const SimTK::State& state) const;
+	/**
+	 * Write the values reported by getRecordValues() into rValues.
+	 */
+	virtual void writeRecordValues(const SimTK::State& state, double* rValues) const;
 
 
 protected:
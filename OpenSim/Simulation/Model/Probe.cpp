@@ -420,6 +420,19 @@ void Probe::setGain(double gain)
  * Provide the probe values to be reported that correspond to the probe labels.
  */
 SimTK::Vector Probe::getProbeOutputs(const State& s) const 
+{
+    SimTK::Vector output(getNumProbeInputs());
+    writeProbeOutputs(s, output.updContiguousScalarData());
+    return output;
+
+    //return afterOperationValueVector.getValue(s);         // save for when we can directly operate on Vector SimTK::Measures
+}
+
+//_____________________________________________________________________________
+/**
+ * Write the probe values to be reported into rValues.
+ */
+void Probe::writeProbeOutputs(const State& s, double* rValues) const 
 {
     if (isDisabled()) {
         stringstream errorMessage;
@@ -429,21 +442,19 @@ SimTK::Vector Probe::getProbeOutputs(const State& s) const
         throw (Exception(errorMessage.str()));
     }
 
-
     // For now, this is scalarized, i.e. compile the result of the separate
-    // Measure for each scalar element of the probe input into a SimTK::Vector
-    // of outputs.
-    SimTK::Vector output(getNumProbeInputs());
-    for (int i=0; i<getNumProbeInputs(); ++i) {
-        if (getOperation() == "integrate")
-            output[i] = getGain() * (afterOperationValues[i].getValue(s) + getInitialConditions()(i));
-        else
-            output[i] = getGain() * afterOperationValues[i].getValue(s);
+    // Measure for each scalar element of the probe input into the outputs.
+    const int n = getNumProbeInputs();
+    const double gain = getGain();
+    if (getOperation() == "integrate") {
+        for (int i=0; i<n; ++i)
+            rValues[i] = gain * (afterOperationValues[i].getValue(s)
+                + get_initial_conditions_for_integration(i));
+    }
+    else {
+        for (int i=0; i<n; ++i)
+            rValues[i] = gain * afterOperationValues[i].getValue(s);
     }
-    
-    return output;
-
-    //return afterOperationValueVector.getValue(s);         // save for when we can directly operate on Vector SimTK::Measures
 }
 
 
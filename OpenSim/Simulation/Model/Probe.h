@@ -202,6 +202,13 @@ public:
     @return         The SimTK::Vector of probe output values.**/
     SimTK::Vector getProbeOutputs(const SimTK::State& state) const;
 
+    /** Writes the values of the probe after the operation has been performed
+        into rValues, without allocating.
+
+    @param  state   System state from which value is computed.  
+    @param  rValues Array with room for getNumProbeInputs() values.**/
+    void writeProbeOutputs(const SimTK::State& state, double* rValues) const;
+
 
 protected:
     // ModelComponent interface.
@@ -26,26 +26,111 @@
 #include "Model/PointForceDirection.h"
 #include "Model/Model.h"
 #include "SimbodyEngine/Body.h"
+#include <pthread.h>
+#include <vector>
 
 using namespace std;
 using namespace SimTK;
 
 namespace OpenSim {
 
+struct MomentArmSolver::Workspace {
+	explicit Workspace(const Model& model) :
+		state(model.getWorkingState()),
+		bodyForces(model.getNumBodies(), SpatialVec(0)),
+		coupling(state.getU()) {}
+
+	// Internal state of the solver initialized as a copy of the default state
+	State state;
+	// Preallocated generalized forces, body forces and coupling factors
+	Vector generalizedForces;
+	Vector_<SpatialVec> bodyForces;
+	Vector coupling;
+	// Preallocated work matrices for solving a full moment-arm matrix:
+	// coupling factors (one column per coordinate), body forces due to unit 
+	// tension (one column per path), resulting generalized forces and the
+	// system Jacobian
+	Matrix couplingMatrix;
+	Matrix pathBodyForces;
+	Matrix pathGeneralizedForces;
+	Matrix systemJacobian;
+};
+
+class MomentArmSolver::WorkspacePool {
+public:
+	WorkspacePool() { pthread_mutex_init(&_mutex, NULL); }
+	~WorkspacePool() {
+		for (size_t i = 0; i < _free.size(); ++i)
+			delete _free[i];
+		pthread_mutex_destroy(&_mutex);
+	}
+
+	// Take a free work space, or make one if all are in use.
+	Workspace* acquire(const Model& model) {
+		Workspace* ws = NULL;
+		pthread_mutex_lock(&_mutex);
+		if (!_free.empty()) {
+			ws = _free.back();
+			_free.pop_back();
+		}
+		pthread_mutex_unlock(&_mutex);
+		return ws ? ws : new Workspace(model);
+	}
+	void release(Workspace* ws) {
+		pthread_mutex_lock(&_mutex);
+		_free.push_back(ws);
+		pthread_mutex_unlock(&_mutex);
+	}
+
+private:
+	pthread_mutex_t _mutex;
+	std::vector<Workspace*> _free;
+};
+
+namespace {
+	// Holds a work space of a solver for the duration of one solve.
+	template <class Pool, class Workspace>
+	class WorkspaceLease {
+	public:
+		WorkspaceLease(Pool& pool, const Model& model) :
+			_pool(pool), _ws(pool.acquire(model)) {}
+		~WorkspaceLease() { _pool.release(_ws); }
+		Workspace& operator*() const { return *_ws; }
+	private:
+		Pool& _pool;
+		Workspace* _ws;
+	};
+}
+
 //______________________________________________________________________________
 /**
  * An implementation of the MomentArmSolver 
  *
  */
-MomentArmSolver::MomentArmSolver(const Model &model) : Solver(model)
+MomentArmSolver::MomentArmSolver(const Model &model) : Solver(model),
+	_workspaces(new WorkspacePool())
 {
 	setAuthors("Ajay Seth");
-	_stateCopy = model.getWorkingState();
+}
+
+MomentArmSolver::MomentArmSolver(const MomentArmSolver& source) :
+	Solver(source), _workspaces(new WorkspacePool())
+{
+}
+
+MomentArmSolver& MomentArmSolver::operator=(const MomentArmSolver& source)
+{
+	if (&source != this) {
+		Solver::operator=(source);
+		delete _workspaces;
+		_workspaces = new WorkspacePool();
+	}
+	return *this;
+}
 
-	// Get the body forces equivalent of the point forces of the path
-	_bodyForces = Vector_<SpatialVec>(getModel().getNumBodies(), SpatialVec(0));
-	// get the right size coupling vector
-	_coupling = _stateCopy.getU();
+MomentArmSolver::~MomentArmSolver()
+{
+	delete _workspaces;
 }
 
 /*********************************************************************************
@@ -62,36 +147,41 @@ Refer to Moment-arm Theory document by Michael Sherman for details.
 double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
 							  const GeometryPath &path) const
 {
+	WorkspaceLease<WorkspacePool, Workspace> lease(*_workspaces, getModel());
+	Workspace& ws = *lease;
+
 	//Local modifiable copy of the state
-	State& s_ma = _stateCopy;
+	State& s_ma = ws.state;
 	s_ma.updQ() = state.getQ();
 
 	// compute the coupling between coordinates due to constraints
-	_coupling = computeCouplingVector(s_ma, aCoord);
+	ws.coupling = computeCouplingVector(s_ma, aCoord);
 
 	// set speeds to zero
 	s_ma.updU() = 0;
 
 	// zero out all the forces
-	_bodyForces *= 0;
-	_generalizedForces = 0;
+	ws.bodyForces *= 0;
+	ws.generalizedForces = 0;
 
 	// apply a tension of unity to the bodies of the path
 	Vector pathDependentMobilityForces(s_ma.getNU(), 0.0);
-	path.addInEquivalentForces(s_ma, 1.0, _bodyForces, pathDependentMobilityForces);
+	path.addInEquivalentForces(s_ma, 1.0, ws.bodyForces, 
+		pathDependentMobilityForces);
 
-	//_bodyForces.dump("bodyForces from addInEquivalentForcesOnBodies");
+	//ws.bodyForces.dump("bodyForces from addInEquivalentForcesOnBodies");
 
 	// Convert body spatial forces F to equivalent mobility forces f based on 
     // geometry (no dynamics required): f = ~J(q) * F.
 	getModel().getMultibodySystem().getMatterSubsystem()
-        .multiplyBySystemJacobianTranspose(s_ma, _bodyForces, _generalizedForces);
+        .multiplyBySystemJacobianTranspose(s_ma, ws.bodyForces, 
+			ws.generalizedForces);
 
-	_generalizedForces += pathDependentMobilityForces;
+	ws.generalizedForces += pathDependentMobilityForces;
 	// Moment-arm is the effective torque (since tension is 1) at the 
     // coordinate of interest taking into account the generalized forces also 
     // acting on other coordinates that are coupled via constraint.
-	return ~_coupling*_generalizedForces;
+	return ~ws.coupling*ws.generalizedForces;
 }
 
 
@@ -101,36 +191,105 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
 {
 	//const clock_t start = clock();
 
+	WorkspaceLease<WorkspacePool, Workspace> lease(*_workspaces, getModel());
+	Workspace& ws = *lease;
+
 	//Local modifiable copy of the state
-	State& s_ma = _stateCopy;
+	State& s_ma = ws.state;
 	s_ma.updQ() = state.getQ();
 
 	// compute the coupling between coordinates due to constraints
-	_coupling = computeCouplingVector(s_ma, aCoord);
+	ws.coupling = computeCouplingVector(s_ma, aCoord);
 
 	// set speeds to zero
 	s_ma.updU() = 0;
 
+	// zero out the forces left by the previous use of the work space
+	ws.bodyForces *= 0;
+
 	int n = pfds.getSize();
 	// Apply body forces along the geometry described by pfds due to a tension of 1N
 	for(int i=0; i<n; i++) {
 		getModel().getMatterSubsystem().
 			addInStationForce(s_ma, 
 				SimTK::MobilizedBodyIndex(pfds[i]->body().getIndex()), 
-				pfds[i]->point(), pfds[i]->direction(), _bodyForces);
+				pfds[i]->point(), pfds[i]->direction(), ws.bodyForces);
 	}
 
-	//_bodyForces.dump("bodyForces from PointForceDirections");
+	//ws.bodyForces.dump("bodyForces from PointForceDirections");
 
 	// Convert body spatial forces F to equivalent mobility forces f based on 
     // geometry (no dynamics required): f = ~J(q) * F.
 	getModel().getMultibodySystem().getMatterSubsystem()
-        .multiplyBySystemJacobianTranspose(s_ma, _bodyForces, _generalizedForces);
+        .multiplyBySystemJacobianTranspose(s_ma, ws.bodyForces, 
+			ws.generalizedForces);
 
 	// Moment-arm is the effective torque (since tension is 1) at the 
     // coordinate of interest taking into account the generalized forces also 
     // acting on other coordinates that are coupled via constraint.
-	return ~_coupling*_generalizedForces;
+	return ~ws.coupling*ws.generalizedForces;
+}
+
+void MomentArmSolver::solve(const State &state, 
+							 const Array<const Coordinate *> &coordinates,
+							 const Array<const GeometryPath *> &paths,
+							 Matrix &momentArms) const
+{
+	WorkspaceLease<WorkspacePool, Workspace> lease(*_workspaces, getModel());
+	Workspace& ws = *lease;
+
+	//Local modifiable copy of the state
+	State& s_ma = ws.state;
+	s_ma.updQ() = state.getQ();
+
+	const SimbodyMatterSubsystem& matter = 
+		getModel().getMultibodySystem().getMatterSubsystem();
+
+	int nc = coordinates.getSize();
+	int np = paths.getSize();
+	int nb = ws.bodyForces.size();
+	int nu = s_ma.getNU();
+
+	// compute the coupling between coordinates due to constraints, once for
+	// each coordinate of interest
+	ws.couplingMatrix.resize(nu, nc);
+	for(int j=0; j<nc; j++)
+		ws.couplingMatrix(j) = computeCouplingVector(s_ma, *coordinates[j]);
+
+	// set speeds to zero
+	s_ma.updU() = 0;
+	getModel().getMultibodySystem().realize(s_ma, SimTK::Stage::Position);
+
+	// apply a tension of unity to the bodies of each path and pack the
+	// resulting spatial forces (moment then force) as columns of a matrix
+	// laid out like the rows of the system Jacobian
+	ws.pathBodyForces.resize(6*nb, np);
+	ws.pathGeneralizedForces.resize(nu, np);
+	Vector pathDependentMobilityForces(nu);
+	for(int i=0; i<np; i++) {
+		ws.bodyForces *= 0;
+		pathDependentMobilityForces = 0;
+		paths[i]->addInEquivalentForces(s_ma, 1.0, ws.bodyForces, 
+			pathDependentMobilityForces);
+
+		for(int b=0; b<nb; b++) {
+			for(int k=0; k<3; k++) {
+				ws.pathBodyForces(6*b+k, i) = ws.bodyForces[b][0][k];
+				ws.pathBodyForces(6*b+3+k, i) = ws.bodyForces[b][1][k];
+			}
+		}
+		ws.pathGeneralizedForces(i) = pathDependentMobilityForces;
+	}
+
+	// Convert the body spatial forces of all paths to equivalent mobility
+	// forces in one product: f = ~J(q) * F.
+	matter.calcSystemJacobian(s_ma, ws.systemJacobian);
+	ws.pathGeneralizedForces += ~ws.systemJacobian*ws.pathBodyForces;
+
+	// Moment-arms are the effective torques (since tensions are 1) at the
+	// coordinates of interest taking into account the generalized forces 
+	// also acting on other coordinates that are coupled via constraint.
+	momentArms = ~ws.pathGeneralizedForces*ws.couplingMatrix;
 }
 
 SimTK::Vector MomentArmSolver::computeCouplingVector(SimTK::State &state, 
@@ -59,7 +59,12 @@ private:
 	//--------------------------------------------------------------------------
 public:
 	explicit MomentArmSolver(const Model& model);
-	virtual ~MomentArmSolver() {}
+	/** A copy has work spaces of its own. */
+	MomentArmSolver(const MomentArmSolver& source);
+#ifndef SWIG
+	MomentArmSolver& operator=(const MomentArmSolver& source);
+#endif
+	virtual ~MomentArmSolver();
 
 	/** Solve for the effective moment-arm about the all coordinates (q) based 
         on the geometric distribution of forces described by a GeometryPath. 
@@ -82,18 +87,32 @@ public:
 	double solve(const SimTK::State& state, const Coordinate &coordinate, 
 		const Array<PointForceDirection *> &pfds) const;
 
-private:
-	// Internal state of the solver initialized as a copy of the default state
-	mutable SimTK::State _stateCopy;
-
-	// Keep preallocated vector of the generalized forces
-	mutable SimTK::Vector _generalizedForces;
-
-	// Keep preallocated vector of the Body_Forces
-	mutable SimTK::Vector_<SimTK::SpatialVec> _bodyForces;
+	/** Solve for the full matrix of moment-arms of a set of GeometryPaths
+		about a set of coordinates. The constraint coupling of each coordinate
+		is computed once, the unit-tension forces of every path are applied
+		together and all the moment-arms are obtained from a single product 
+		with the transpose of the system Jacobian, which is much cheaper than
+		solving for each path and coordinate pair in turn.
+	@param  state				current state of the model
+	@param  coordinates			Coordinates about which we want the moment-arms
+	@param  paths	            GeometryPaths for which to calculate moment-arms
+	@param  momentArms			resulting moment-arms with one row per path and
+								one column per coordinate
+	*/
+	void solve(const SimTK::State& state, 
+		const Array<const Coordinate *> &coordinates,
+		const Array<const GeometryPath *> &paths,
+		SimTK::Matrix &momentArms) const;
 
-	// Keep preallocated vector of the coupling constraint factors
-	mutable SimTK::Vector _coupling;
+private:
+	// Work space of one solve: a copy of the model's state to perturb and
+	// preallocated forces, coupling factors and matrices.
+	struct Workspace;
+	// Work spaces not in use. Each solve takes one (or makes a new one) and
+	// returns it when done, so that the solver may be used on distinct states
+	// from several threads at once.
+	class WorkspacePool;
+	WorkspacePool* _workspaces;
 
 	// compute vector of constraint coupling factors
 	SimTK::Vector computeCouplingVector(SimTK::State &state, 
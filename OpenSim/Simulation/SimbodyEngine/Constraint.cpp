@@ -252,11 +252,32 @@ Array<std::string> Constraint::getRecordLabels() const
  * location frame, etc. used in conjunction with getRecordLabels and should return same size Array
  */
 Array<double> Constraint::getRecordValues(const SimTK::State& state) const
+{
+	Array<double> values(0.0,getNumRecordValues());
+	writeRecordValues(state, values.get());
+	return values;
+}
+
+/**
+ * Number of values reported by getRecordValues(): six for each constrained
+ * body and one for each constrained mobility.
+ */
+int Constraint::getNumRecordValues() const
+{
+	const SimTK::Constraint& simConstraint = _model->getMatterSubsystem().getConstraint(_index);
+	return 6*simConstraint.getNumConstrainedBodies()
+		+ simConstraint.getNumConstrainedU(_model->getWorkingState());
+}
+
+/**
+ * Write the values reported by getRecordValues() into rValues.
+ */
+void Constraint::writeRecordValues(const SimTK::State& state, double* rValues) const
 {
 	// EOMs are solved for accelerations (udots) and constraint multipliers (lambdas)
 	// simulataneously, so system must be realized to acceleration
 	_model->getMultibodySystem().realize(state, SimTK::Stage::Acceleration);
-	SimTK::Constraint& simConstraint = _model->updMatterSubsystem().updConstraint(_index);
+	const SimTK::Constraint& simConstraint = _model->getMatterSubsystem().getConstraint(_index);
 
 	// number of bodies being directly constrained
 	int ncb = simConstraint.getNumConstrainedBodies();
@@ -267,21 +288,17 @@ Array<double> Constraint::getRecordValues(const SimTK::State& state) const
 	bodyForcesInAncestor.setToZero();
 	SimTK::Vector mobilityForces(ncm, 0.0);
 
-	Array<double> values(0.0,6*ncb+ncm);
-
 	calcConstraintForces(state, bodyForcesInAncestor, mobilityForces);
 	
 	for(int i=0; i<ncb; ++i){
 		for(int j=0; j<3; ++j){
 			// Simbody constraints have reaction moments first and OpenSim reports forces first
 			// so swap them here
-			values[i*6+j] = (bodyForcesInAncestor(i)[1])[j]; // moments on constrained body i
-			values[i*6+3+j] = (bodyForcesInAncestor(i)[0])[j]; // forces on constrained body i
+			rValues[i*6+j] = (bodyForcesInAncestor(i)[1])[j]; // moments on constrained body i
+			rValues[i*6+3+j] = (bodyForcesInAncestor(i)[0])[j]; // forces on constrained body i
 		}
 	}
 	for(int i=0; i<ncm; ++i){
-		values[6*ncb+i] = mobilityForces[i];
+		rValues[6*ncb+i] = mobilityForces[i];
 	}
-
-	return values;
-};
+}
@@ -81,6 +81,17 @@ public:
 	 * with getRecordLabels and should return same size Array
 	 */
 	virtual Array<double> getRecordValues(const SimTK::State& state) const;
+	/**
+	 * Number of values reported by getRecordValues(), fixed once the system
+	 * is built.
+	 */
+	virtual int getNumRecordValues() const;
+	/**
+	 * Write the values reported by getRecordValues() into rValues, which must
+	 * have room for getNumRecordValues() values. Subclasses that override
+	 * getRecordValues() must override this method to match.
+	 */
+	virtual void writeRecordValues(const SimTK::State& state, double* rValues) const;
 
 	virtual void scale(const ScaleSet& aScaleSet) {};
 
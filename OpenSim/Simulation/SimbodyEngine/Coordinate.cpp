@@ -664,6 +664,18 @@ void Coordinate::CoordinateStateVariable::
 	throw Exception(msg);
 }
 
+SimTK::SystemYIndex Coordinate::CoordinateStateVariable::
+	computeSystemYIndex(const SimTK::State& state) const
+{
+	const Coordinate& owner = *((Coordinate *)&getOwner());
+	const SimbodyMatterSubsystem& matter = owner.getModel().getMatterSubsystem();
+	const MobilizedBody& mb = matter.getMobilizedBody(owner.getBodyIndex());
+
+	// q's are first in Y
+	return SimTK::SystemYIndex(state.getQStart(matter.getMySubsystemIndex())
+		+ mb.getFirstQIndex(state) + owner.getMobilizerQIndex());
+}
+
 
 //-----------------------------------------------------------------------------
 // Coordinate::SpeedStateVariable
@@ -698,4 +710,17 @@ void Coordinate::SpeedStateVariable::
 	string msg = "SpeedStateVariable::setDerivative() - ERROR \n";
 	msg +=	"Generalized speed derivative (udot) can only be set by the Multibody system.";
 	throw Exception(msg);
+}
+
+SimTK::SystemYIndex Coordinate::SpeedStateVariable::
+	computeSystemYIndex(const SimTK::State& state) const
+{
+	const Coordinate& owner = *((Coordinate *)&getOwner());
+	const SimbodyMatterSubsystem& matter = owner.getModel().getMatterSubsystem();
+	const MobilizedBody& mb = matter.getMobilizedBody(owner.getBodyIndex());
+
+	// u's follow all of the q's in Y
+	return SimTK::SystemYIndex(state.getNQ() 
+		+ state.getUStart(matter.getMySubsystemIndex())
+		+ mb.getFirstUIndex(state) + owner.getMobilizerQIndex());
 }
\ No newline at end of file
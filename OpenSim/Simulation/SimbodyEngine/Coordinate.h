@@ -254,6 +254,8 @@ private:
 		void setValue(SimTK::State& state, double value) const OVERRIDE_11;
 		double getDerivative(const SimTK::State& state) const OVERRIDE_11;
 		void setDerivative(const SimTK::State& state, double deriv) const OVERRIDE_11;
+		SimTK::SystemYIndex
+			computeSystemYIndex(const SimTK::State& state) const OVERRIDE_11;
 	};
 
 	// Class for handling state variable added (allocated) by this Component
@@ -272,6 +274,8 @@ private:
 		void setValue(SimTK::State& state, double value) const OVERRIDE_11;
 		double getDerivative(const SimTK::State& state) const OVERRIDE_11;
 		void setDerivative(const SimTK::State& state, double deriv) const OVERRIDE_11;
+		SimTK::SystemYIndex
+			computeSystemYIndex(const SimTK::State& state) const OVERRIDE_11;
 	};
 
 	// All coordinates (Simbody mobility) have associated constraints that
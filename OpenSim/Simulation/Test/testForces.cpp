@@ -33,13 +33,17 @@
 //		7. ExternalForce
 //		8. PathSpring
 //		9. ExpressionBasedPointToPointForce
+//	   10. ForceReporter rows of all of the above
 //		
 //     Add tests here as Forces are added to OpenSim
 //
 //==============================================================================
 #include <ctime>  // clock(), clock_t, CLOCKS_PER_SEC
+#include <sstream>
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Analyses/osimAnalyses.h>
+#include <OpenSim/Actuators/SpringGeneralizedForce.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -63,6 +67,9 @@ void testCoordinateLimitForce();
 void testCoordinateLimitForceRotational();
 void testExpressionBasedPointToPointForce();
 void testExpressionBasedCoordinateForce();
+void testMuscleForceCache(const std::string& modelFile);
+void testExpressionBasedForcesPerformance(int nBodies);
+void testForceReporterRecordValues();
 
 int main()
 {
@@ -127,6 +134,25 @@ int main()
 		failures.push_back("testExpressionBasedCoordinateForce");
 	}
 
+	try { testExpressionBasedForcesPerformance(50); }
+    catch (const std::exception& e){
+		cout << e.what() <<endl; 
+		failures.push_back("testExpressionBasedForcesPerformance");
+	}
+
+	try { testForceReporterRecordValues(); }
+    catch (const std::exception& e){
+		cout << e.what() <<endl; 
+		failures.push_back("testForceReporterRecordValues");
+	}
+
+	try { testMuscleForceCache("arm26.osim"); 
+	      testMuscleForceCache("gait2354_simbody.osim"); }
+    catch (const std::exception& e){
+		cout << e.what() <<endl; 
+		failures.push_back("testMuscleForceCache");
+	}
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -141,6 +167,153 @@ int main()
 // Test Cases
 //==============================================================================
 
+// Check that the rows a ForceReporter writes through writeRecordValues() hold
+// the same values as getRecordValues() of each force, in a model holding
+// every kind of force that reports more than a single value.
+void testForceReporterRecordValues()
+{
+	using namespace SimTK;
+
+	// the data of the external force must outlive the model
+	Storage forces("external_force_data.sto");
+	forces.setName("ExternalForcesData");
+
+	Model model("BouncingBallModelEF.osim");
+	OpenSim::Body& ball = model.updBodySet().get("ball");
+
+	model.addContactGeometry(new ContactSphere(0.1, Vec3(0), ball, "ball_sphere"));
+	OpenSim::HuntCrossleyForce* contact = new OpenSim::HuntCrossleyForce();
+	OpenSim::HuntCrossleyForce::ContactParameters* contactParams = 
+		new OpenSim::HuntCrossleyForce::ContactParameters(1.0e6, 1e-5, 0.0, 0.0, 0.0);
+	contactParams->addGeometry("ball_sphere");
+	contactParams->addGeometry("ground");
+	contact->addContactParameters(contactParams);
+	contact->setName("hunt_crossley");
+	model.addForce(contact);
+
+	Vec3 stiffness(10), damping(1);
+	model.addForce(new BushingForce("ground", Vec3(0), Vec3(0), 
+		"ball", Vec3(0), Vec3(0), stiffness, stiffness, damping, damping));
+	model.addForce(new ExpressionBasedBushingForce("ground", Vec3(0), Vec3(0), 
+		"ball", Vec3(0.1), Vec3(0), stiffness, stiffness, damping, damping));
+	model.addForce(new FunctionBasedBushingForce("ground", Vec3(0), Vec3(0), 
+		"ball", Vec3(0), Vec3(0.1), stiffness, stiffness, damping, damping));
+	model.addForce(new PointToPointSpring("ground", Vec3(0, 1, 0), 
+		"ball", Vec3(0), 10, 0.5));
+	model.addForce(new ExpressionBasedPointToPointForce("ground", Vec3(0.1, 1, 0),
+		"ball", Vec3(0), "-10*(d-0.5)-ddot"));
+	model.addForce(new CoordinateLimitForce("ball_ty", 0.4, 100, 0.0, 100, 1, 0.05));
+	model.addForce(new ExpressionBasedCoordinateForce("ball_tx", "-10*q-5*qdot"));
+	SpringGeneralizedForce* spring = new SpringGeneralizedForce("ball_tz");
+	spring->setStiffness(10);
+	spring->setViscosity(1);
+	model.addForce(spring);
+
+	model.addForce(new ExternalForce(forces, "force", "point", "torque", 
+		"ball", "ground", "ground"));
+
+	PrescribedForce* prescribed = new PrescribedForce(&ball);
+	prescribed->setForceFunctions(new Constant(1), new Constant(2), new Constant(3));
+	prescribed->setPointFunctions(new Constant(0.1), new Constant(0), new Constant(0));
+	prescribed->setTorqueFunctions(new Constant(0), new Constant(0), new Constant(1));
+	model.addForce(prescribed);
+
+	SimTK::State& s = model.initSystem();
+	const ForceSet& forceSet = model.getForceSet();
+
+	ForceReporter reporter(&model);
+	reporter.begin(s);
+
+	int nLabels = 0;
+	for(int i=0; i<forceSet.getSize(); ++i)
+		nLabels += forceSet[i].getRecordLabels().getSize();
+	ASSERT(reporter.getForceStorage().getColumnLabels().getSize() == nLabels+1,
+		__FILE__, __LINE__, "ForceReporter labels do not match the forces.");
+
+	// Vary the state so that every force, including contact, is engaged
+	const CoordinateSet& coords = model.getCoordinateSet();
+	for(int step=1; step<=10; ++step){
+		s.updTime() = 0.15*step;
+		for(int i=0; i<coords.getSize(); ++i){
+			coords[i].setValue(s, 0.05*sin(1.3*step+i), false);
+			coords[i].setSpeedValue(s, 0.2*cos(0.7*step+i));
+		}
+		reporter.step(s, step);
+
+		const Array<double>& row = 
+			reporter.getForceStorage().getLastStateVector()->getData();
+		ASSERT(row.getSize() == nLabels, __FILE__, __LINE__,
+			"ForceReporter row does not match the labels of the forces.");
+
+		int n = 0;
+		for(int i=0; i<forceSet.getSize(); ++i){
+			Array<double> values = forceSet[i].getRecordValues(s);
+			ASSERT(values.getSize() == forceSet[i].getNumRecordValues(),
+				__FILE__, __LINE__, forceSet[i].getName()+
+				" reports a different number of values than it labels.");
+			for(int j=0; j<values.getSize(); ++j, ++n){
+				ASSERT(row[n] == values[j], __FILE__, __LINE__,
+					"ForceReporter row does not match the values of "+
+					forceSet[i].getName()+".");
+			}
+		}
+	}
+}
+
+// Check that muscle cache variables accessed by handle agree with those 
+// accessed by name, and report the cost of computing the forces of a model
+// and of reading a cache variable by name versus by handle.
+void testMuscleForceCache(const std::string& modelFile)
+{
+	using namespace SimTK;
+
+	LoadOpenSimLibrary("osimActuators");
+	Model model(modelFile);
+	State& s = model.initSystem();
+	model.equilibrateMuscles(s);
+	model.getMultibodySystem().realize(s, Stage::Dynamics);
+
+	const Set<Actuator>& acts = model.getActuators();
+	int nA = acts.getSize();
+	for(int i=0; i<nA; ++i){
+		ASSERT(acts[i].getForce(s) == acts[i].getCacheVariable<double>(s, "force"));
+		ASSERT(acts[i].getSpeed(s) == acts[i].getCacheVariable<double>(s, "speed"));
+	}
+
+	// time computing the forces of all actuators
+	const int nSteps = 1000;
+	clock_t startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		s.invalidateAll(Stage::Position);
+		model.getMultibodySystem().realize(s, Stage::Dynamics);
+	}
+	double computeTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	// time reading a cache variable of every actuator by name
+	double sumByName = 0, sumByHandle = 0;
+	startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		for(int i=0; i<nA; ++i)
+			sumByName += acts[i].getCacheVariable<double>(s, "speed");
+	}
+	double byNameTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	// time reading the same cache variable by handle
+	startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		for(int i=0; i<nA; ++i)
+			sumByHandle += acts[i].getSpeed(s);
+	}
+	double byHandleTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+	ASSERT(sumByName == sumByHandle);
+
+	cout << "*********************** testMuscleForceCache ***********************" << endl;
+	cout << "MODEL: " << modelFile << " with " << nA << " actuators." << endl;
+	cout << "Compute forces: " << computeTime/nSteps << "ms/step." << endl;
+	cout << "Read cache variables by name: " << byNameTime/nSteps 
+		 << "ms/step, by handle: " << byHandleTime/nSteps << "ms/step." << endl;
+}
+
 void testExpressionBasedCoordinateForce()
 {
 	using namespace SimTK;
@@ -245,6 +418,96 @@ void testExpressionBasedCoordinateForce()
 	osimModel->disownAllComponents();
 }
 
+// Integrate a model driven by many expression based forces and report the
+// time taken. Every body slides vertically on a spring-damper coordinate
+// force, is linked to its neighbor by a point-to-point force and to ground by
+// a bushing, so all three kinds of forces are evaluated at every step.
+void testExpressionBasedForcesPerformance(int nBodies)
+{
+	using namespace SimTK;
+
+	Model *osimModel = new Model;
+	osimModel->setName("ManyExpressionBasedForces");
+	osimModel->setGravity(gravity_vec);
+	OpenSim::Body& ground = osimModel->getGroundBody();
+
+	double positionRange[2] = {-10, 10};
+	Array_<ExpressionBasedCoordinateForce*> springs;
+	for(int i=0; i<nBodies; ++i){
+		stringstream index;
+		index << i;
+		string ballName = "ball_" + index.str();
+
+		OpenSim::Body* ball = new OpenSim::Body(ballName, 1.0, Vec3(0), 
+			SimTK::Inertia::sphere(0.1));
+		SliderJoint* slider = new SliderJoint("slider_" + index.str(), 
+			ground, Vec3(0.5*i,0,0), Vec3(0,0,Pi/2), 
+			*ball, Vec3(0), Vec3(0,0,Pi/2));
+		CoordinateSet &coords = slider->upd_CoordinateSet();
+		coords[0].setName("h_" + index.str());
+		coords[0].setRange(positionRange);
+		coords[0].setMotionType(Coordinate::Translational);
+		coords[0].setDefaultValue(0.1*(i%5));
+
+		osimModel->addBody(ball);
+		osimModel->addJoint(slider);
+
+		ExpressionBasedCoordinateForce* spring = 
+			new ExpressionBasedCoordinateForce("h_" + index.str(), "-10*q-5*qdot");
+		osimModel->addForce(spring);
+		springs.push_back(spring);
+
+		ExpressionBasedBushingForce* bushing = 
+			new ExpressionBasedBushingForce("ground", Vec3(0.5*i,0,0), Vec3(0),
+				ballName, Vec3(0), Vec3(0));
+		bushing->setName("bushing_" + index.str());
+		bushing->setMxExpression("-2*theta_x-theta_x^3");
+		bushing->setMyExpression("-2*theta_y-theta_y^3");
+		bushing->setMzExpression("-2*theta_z-theta_z^3");
+		bushing->setFxExpression("-20*delta_x");
+		bushing->setFyExpression("-5*delta_y*(1+delta_y^2)");
+		bushing->setFzExpression("-20*delta_z");
+		osimModel->addForce(bushing);
+
+		if(i > 0){
+			stringstream previous;
+			previous << i-1;
+			ExpressionBasedPointToPointForce* link = 
+				new ExpressionBasedPointToPointForce("ball_" + previous.str(), Vec3(0),
+					ballName, Vec3(0), "-2*(d-0.5)-0.1*ddot");
+			link->setName("link_" + index.str());
+			osimModel->addForce(link);
+		}
+	}
+
+	SimTK::State& osim_state = osimModel->initSystem();
+
+	RungeKuttaMersonIntegrator integrator(osimModel->getMultibodySystem());
+	integrator.setAccuracy(1e-6);
+	Manager manager(*osimModel, integrator);
+	manager.setInitialTime(0.0);
+	manager.setFinalTime(2.0);
+
+	clock_t start = clock();
+	manager.integrate(osim_state);
+	double integrationTime = double(clock()-start)/CLOCKS_PER_SEC;
+
+	// The bound evaluation must reproduce the expression
+	osimModel->getMultibodySystem().realize(osim_state, Stage::Dynamics);
+	const CoordinateSet& coordinates = osimModel->getCoordinateSet();
+	for(int i=0; i<nBodies; ++i){
+		double q = coordinates[i].getValue(osim_state);
+		double qdot = coordinates[i].getSpeedValue(osim_state);
+		ASSERT_EQUAL(-10*q-5*qdot, springs[i]->getForceMagnitude(osim_state), 1e-12);
+	}
+
+	cout << "*********************** testExpressionBasedForcesPerformance ***********************" << endl;
+	cout << nBodies << " bodies, " << osimModel->getForceSet().getSize() 
+		 << " expression based forces, " << integrator.getNumStepsTaken() 
+		 << " steps, " << osimModel->getMultibodySystem().getNumRealizationsOfThisStage(Stage::Dynamics)
+		 << " force evaluations in " << integrationTime << "s." << endl;
+}
+
 void testExpressionBasedPointToPointForce()
 {
 	using namespace SimTK;
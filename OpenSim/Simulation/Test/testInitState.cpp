@@ -42,6 +42,12 @@ void testStates(const string& modelFile);
 // cause the memory footprint of the process to increase significantly.
 //==============================================================================
 void testMemoryUsage(const string& modelFile);
+//==============================================================================
+// testStateValues tests that getting and setting all state variable values
+// at once agrees with accessing each state variable by name, and reports the
+// cost of each.
+//==============================================================================
+void testStateValues(const string& modelFile);
 
 static const int MAX_N_TRIES = 100;
 
@@ -52,6 +58,7 @@ int main()
 		testStates("arm26.osim");
 		testMemoryUsage("arm26.osim");
 		testMemoryUsage("PushUpToesOnGroundWithMuscles.osim");
+		testStateValues("gait2354_simbody.osim");
 	}
 	catch (const Exception& e) {
         cout << "testInitState failed: ";
@@ -199,3 +206,87 @@ void testMemoryUsage(const string& modelFile)
 	ASSERT( delta < 1e8, __FILE__, __LINE__, 
 		"testMemoryUsage: total estimated memory leaked > 100MB.");
 }
+
+void testStateValues(const string& modelFile)
+{
+	using namespace SimTK;
+
+	Model model(modelFile);
+	State& state = model.initSystem();
+	model.equilibrateMuscles(state);
+
+	Array<std::string> names = model.getStateVariableNames();
+	int nsv = names.getSize();
+	ASSERT(nsv == model.getNumStateVariables());
+
+	// values gathered through the state variable table
+	Vector values = model.getStateVariableValues(state);
+	ASSERT(values.size() == nsv);
+
+	// must match each state variable accessed by name exactly
+	for(int i=0; i<nsv; ++i){
+		ASSERT(values[i] == model.getStateVariable(state, names[i]), 
+			__FILE__, __LINE__, 
+			"testStateValues: value of "+names[i]+" does not match.");
+	}
+
+	// setting new values in bulk must have the same effect as setting each
+	// by name (including any clamping of coordinates)
+	Vector newValues = values;
+	for(int i=0; i<nsv; ++i){
+		newValues[i] += 0.001*(i+1);
+	}
+	State byNameState = state;
+	for(int i=0; i<nsv; ++i){
+		model.setStateVariable(byNameState, names[i], newValues[i]);
+	}
+	model.setStateVariableValues(state, newValues);
+	Vector readValues = model.getStateVariableValues(state);
+	for(int i=0; i<nsv; ++i){
+		ASSERT(readValues[i] == model.getStateVariable(byNameState, names[i]),
+			__FILE__, __LINE__, 
+			"testStateValues: set value of "+names[i]+" does not match.");
+	}
+	model.setStateVariableValues(state, values);
+
+	// time getting all of the values by name
+	const int nSteps = 2000;
+	Vector byNameValues(nsv);
+	clock_t startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		for(int i=0; i<nsv; ++i){
+			byNameValues[i] = model.getStateVariable(state, names[i]);
+		}
+	}
+	double byNameGetTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	// time getting all of the values from the table
+	startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		values = model.getStateVariableValues(state);
+	}
+	double tableGetTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	// time setting all of the values by name
+	startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		for(int i=0; i<nsv; ++i){
+			model.setStateVariable(state, names[i], values[i]);
+		}
+	}
+	double byNameSetTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	// time setting all of the values through the table
+	startTime = clock();
+	for(int k=0; k<nSteps; ++k){
+		model.setStateVariableValues(state, values);
+	}
+	double tableSetTime = 1.e3*(clock()-startTime)/CLOCKS_PER_SEC;
+
+	cout << "*********************** testStateValues ***********************" << endl;
+	cout << "MODEL: "<< modelFile <<" has "<< nsv << " state variables." << endl;
+	cout << "Get all values by name: " << byNameGetTime/nSteps 
+		 << "ms/step, from table: " << tableGetTime/nSteps << "ms/step." << endl;
+	cout << "Set all values by name: " << byNameSetTime/nSteps 
+		 << "ms/step, from table: " << tableSetTime/nSteps << "ms/step." << endl;
+}
@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testInverseDynamicsSolver.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testInverseDynamicsSolver solves the inverse dynamics of a long gait-like
+//  trajectory in sequence and in parallel, verifies that the generalized
+//  forces are identical and reports the time taken by each. It then repeats
+//  the comparison with the muscles disabled in the given State, as the
+//  InverseDynamicsTool does for excluded forces.
+//==============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Simulation/InverseDynamicsSolver.h>
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testParallelTrajectory(const string& modelFile, int nt);
+void testParallelTrajectoryExcludingMuscles(const string& modelFile, int nt);
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testParallelTrajectory("gait2354_simbody.osim", 10000);
+		testParallelTrajectoryExcludingMuscles("gait2354_simbody.osim", 1000);
+	}
+	catch (const std::exception& e) {
+		cout << "testInverseDynamicsSolver failed: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+// Coordinates oscillating about their defaults at a gait-like frequency,
+// sampled at 100Hz.
+static Storage* createCoordinates(const Model& model, int nt)
+{
+	using namespace SimTK;
+
+	const CoordinateSet& coords = model.getCoordinateSet();
+	int nq = coords.getSize();
+	Array<string> labels("time", nq+1);
+	for(int j=0; j<nq; ++j)
+		labels[j+1] = coords[j].getName();
+
+	Storage* coordinates = new Storage(nt);
+	coordinates->setColumnLabels(labels);
+	Vector q(nq);
+	for(int i=0; i<nt; ++i){
+		double t = 0.01*i;
+		for(int j=0; j<nq; ++j)
+			q[j] = coords[j].getDefaultValue() + 0.1*sin(2*Pi*t + 0.3*j);
+		coordinates->append(t, nq, &q[0]);
+	}
+	return coordinates;
+}
+
+static void assertIdentical(const SimTK::Array_<SimTK::Vector>& sequential,
+							const SimTK::Array_<SimTK::Vector>& parallel,
+							const string& test)
+{
+	ASSERT(parallel.size() == sequential.size());
+	for(unsigned int i=0; i<sequential.size(); ++i){
+		ASSERT(parallel[i].size() == sequential[i].size());
+		for(int j=0; j<sequential[i].size(); ++j){
+			ASSERT(parallel[i][j] == sequential[i][j], __FILE__, __LINE__,
+				test+": parallel generalized forces differ.");
+		}
+	}
+}
+
+void testParallelTrajectory(const string& modelFile, int nt)
+{
+	using namespace SimTK;
+
+	Model model(modelFile);
+	State& s = model.initSystem();
+
+	Storage* coordinates = createCoordinates(model, nt);
+	GCVSplineSet coordFunctions(5, coordinates);
+	delete coordinates;
+
+	Array_<double> times(nt);
+	for(int i=0; i<nt; ++i)
+		times[i] = 0.01*i;
+
+	InverseDynamicsSolver solver(model);
+
+	Array_<Vector> sequential, parallel;
+	double start = realTime();
+	solver.solve(s, coordFunctions, times, sequential);
+	double sequentialTime = realTime()-start;
+
+	start = realTime();
+	solver.solve(s, coordFunctions, times, parallel, 0);
+	double parallelTime = realTime()-start;
+
+	ASSERT((int)parallel.size() == nt);
+	assertIdentical(sequential, parallel, "testParallelTrajectory");
+
+	cout << "*********************** testParallelTrajectory ***********************" << endl;
+	cout << "MODEL: " << modelFile << ", " << nt << " frames." << endl;
+	cout << "Sequential: " << sequentialTime << "s, parallel on "
+		 << ParallelExecutor::getNumProcessors() << " processors: "
+		 << parallelTime << "s." << endl;
+}
+
+void testParallelTrajectoryExcludingMuscles(const string& modelFile, int nt)
+{
+	using namespace SimTK;
+
+	Model model(modelFile);
+	State& s = model.initSystem();
+
+	Storage* coordinates = createCoordinates(model, nt);
+	GCVSplineSet coordFunctions(5, coordinates);
+	delete coordinates;
+
+	Array_<double> times(nt);
+	for(int i=0; i<nt; ++i)
+		times[i] = 0.01*i;
+
+	InverseDynamicsSolver solver(model);
+	Array_<Vector> withMuscles;
+	solver.solve(s, coordFunctions, times, withMuscles);
+
+	// Exclude the muscles in the State only, as the InverseDynamicsTool does.
+	Set<Muscle>& muscles = model.updMuscles();
+	for(int i=0; i<muscles.getSize(); ++i)
+		muscles[i].setDisabled(s, true);
+
+	Array_<Vector> sequential, parallel;
+	solver.solve(s, coordFunctions, times, sequential);
+	solver.solve(s, coordFunctions, times, parallel, 0);
+	assertIdentical(sequential, parallel,
+		"testParallelTrajectoryExcludingMuscles");
+
+	// The excluded muscles' passive forces must not have been applied.
+	bool differ = false;
+	for(int i=0; i<nt && !differ; ++i)
+		for(int j=0; j<sequential[i].size() && !differ; ++j)
+			differ = (sequential[i][j] != withMuscles[i][j]);
+	ASSERT(differ, __FILE__, __LINE__,
+		"testParallelTrajectoryExcludingMuscles: disabling the muscles had no "
+		"effect.");
+}
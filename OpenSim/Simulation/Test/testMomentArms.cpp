@@ -50,6 +50,8 @@ void testMomentArmDefinitionForModel(const string &filename,
 									 SimTK::Vec2 rom = SimTK::Vec2(-SimTK::Pi/2,0),
 									 double mass = -1.0, string errorMessage = "");
 
+void testMomentArmMatrixForModel(const string &filename);
+
 int main()
 {
 	clock_t startTime = clock();
@@ -118,6 +120,12 @@ int main()
 
 		testMomentArmDefinitionForModel("CoupledCoordinatesMPPsMomentArmTest.osim", "foot_angle", "vas_int_r", SimTK::Vec2(-2*SimTK::Pi/3, SimTK::Pi/18), -1.0, "Multiple moving path points: FAILED");
 		cout << "Multiple moving path points coupled coordinates test: PASSED\n" << endl;
+
+		testMomentArmMatrixForModel("testMomentArmsConstraintB.osim");
+		cout << "Moment-arm matrix with coupled coordinates test: PASSED\n" << endl;
+
+		testMomentArmMatrixForModel("gait2354_simbody.osim");
+		cout << "Moment-arm matrix of all muscles about all coordinates test: PASSED\n" << endl;
 	}
 	catch (const Exception& e) {
         e.print(cerr);
@@ -405,3 +413,67 @@ void testMomentArmDefinitionForModel(const string &filename, const string &coord
 	// dL/dTheta definition or is at least dynamically consistent, in which dL/dTheta is not
 	ASSERT(passesDefinition || passesDynamicConsistency, __FILE__, __LINE__, errorMessage);
 }
+
+//==========================================================================================================
+// Full moment-arm matrix solved at once must match solving each path and coordinate pair in turn
+//==========================================================================================================
+void testMomentArmMatrixForModel(const string &filename)
+{
+	using namespace SimTK;
+
+	Model osimModel(filename);
+	SimTK::State &s = osimModel.initSystem();
+
+	const CoordinateSet &coordSet = osimModel.getCoordinateSet();
+	const Set<Muscle> &muscles = osimModel.getMuscles();
+	int nc = coordSet.getSize();
+	int np = muscles.getSize();
+
+	Array<const Coordinate*> coords(NULL, nc);
+	Array<const GeometryPath*> paths(NULL, np);
+	for(int j=0; j<nc; j++)
+		coords[j] = &coordSet[j];
+	for(int i=0; i<np; i++)
+		paths[i] = &muscles[i].getGeometryPath();
+
+	MomentArmSolver maSolver(osimModel);
+
+	int nsteps = 10;
+	double pairTime = 0, matrixTime = 0;
+	for(int n=0; n<=nsteps; n++){
+		// move all coordinates through part of their range together
+		for(int j=0; j<nc; j++){
+			const Coordinate &coord = coordSet[j];
+			if(coord.getLocked(s)) continue;
+			double q = coord.getDefaultValue() 
+				+ 0.3*(double(n)/nsteps - 0.5)*(coord.getRangeMax()-coord.getRangeMin());
+			coord.setValue(s, q, false);
+		}
+		osimModel.assemble(s);
+		osimModel.getMultibodySystem().realize(s, Stage::Position);
+
+		clock_t start = clock();
+		Matrix pairs(np, nc);
+		for(int j=0; j<nc; j++)
+			for(int i=0; i<np; i++)
+				pairs(i,j) = maSolver.solve(s, *coords[j], *paths[i]);
+		pairTime += double(clock()-start)/CLOCKS_PER_SEC;
+
+		start = clock();
+		Matrix momentArms;
+		maSolver.solve(s, coords, paths, momentArms);
+		matrixTime += double(clock()-start)/CLOCKS_PER_SEC;
+
+		ASSERT(momentArms.nrow() == np && momentArms.ncol() == nc);
+		for(int j=0; j<nc; j++)
+			for(int i=0; i<np; i++)
+				ASSERT_EQUAL(pairs(i,j), momentArms(i,j), 1e-10, __FILE__, __LINE__,
+					"Moment-arm of "+muscles[i].getName()+" about "+coords[j]->getName()
+					+" from the full matrix differs from the single solve.");
+	}
+
+	cout << "*********************** testMomentArmMatrixForModel ***********************" << endl;
+	cout << "MODEL: " << filename << ", " << np << " paths x " << nc << " coordinates." << endl;
+	cout << "Pairwise solves: " << 1.0e3*pairTime << "ms, full matrix: " 
+		 << 1.0e3*matrixTime << "ms over " << nsteps+1 << " poses." << endl;
+}
@@ -0,0 +1,219 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testThreadSafety.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testThreadSafety computes muscle path lengths, speeds, moment arms and
+//  forces, the accelerations of the model and the results of a Kinematics
+//  analysis for many states of one model, first in sequence and then on
+//  several threads at once, and verifies that the results are identical.
+//
+//	Models:
+//      1. arm26, whose paths wrap over cylinders and an ellipsoid
+//		2. gait2354, whose vasti have moving path points
+//==============================================================================
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Analyses/Kinematics.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testConcurrentStates(const string& modelFile, int nStates, int nRepeats);
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testConcurrentStates("arm26.osim", 400, 5);
+		testConcurrentStates("gait2354_simbody.osim", 100, 3);
+	}
+	catch (const std::exception& e) {
+		cout << "testThreadSafety failed: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+//______________________________________________________________________________
+/**
+ * Compute, in a copy of state i, the length, speed, force and one moment arm
+ * of each muscle and the accelerations of the model, and record the state
+ * with a Kinematics analysis. The state is copied so that every computation
+ * starts from the same cache, whichever thread does it.
+ */
+static void computeResults(const Model& model, const SimTK::State& state,
+						   Kinematics& kinematics, SimTK::Vector& results)
+{
+	SimTK::State s = state;
+	model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+
+	const Set<Muscle>& muscles = model.getMuscles();
+	const CoordinateSet& coords = model.getCoordinateSet();
+	int nm = muscles.getSize();
+	int nu = s.getNU();
+	results.resize(4*nm + nu);
+	for(int m=0; m<nm; ++m){
+		const Muscle& muscle = muscles[m];
+		const Coordinate& coord = coords[m % coords.getSize()];
+		results[4*m] = muscle.getLength(s);
+		results[4*m+1] = muscle.getLengtheningSpeed(s);
+		results[4*m+2] = muscle.getForce(s);
+		results[4*m+3] = muscle.computeMomentArm(s, const_cast<Coordinate&>(coord));
+	}
+	for(int j=0; j<nu; ++j)
+		results[4*nm+j] = s.getUDot()[j];
+
+	kinematics.record(s);
+}
+
+/** Computes the results of the states assigned to one worker, each with the
+Kinematics analysis of that worker. Worker w computes states w, w+n, ... of
+the n workers, and looks up the sequential Kinematics results of each in a
+Storage that all workers share. */
+class ComputeStatesTask : public SimTK::ParallelExecutor::Task {
+public:
+	ComputeStatesTask(const Model& model, const SimTK::Array_<SimTK::State>& states,
+					  Array<Kinematics*>& kinematics, const Storage& sequential,
+					  SimTK::Array_<SimTK::Vector>& results,
+					  SimTK::Array_<SimTK::Vector>& lookups) :
+		_model(model), _states(states), _kinematics(kinematics),
+		_sequential(sequential), _results(results), _lookups(lookups) {}
+
+	void execute(int worker) {
+		int nw = _kinematics.getSize();
+		int ny = _sequential.getSmallestNumberOfStates();
+		for(int i=worker; i<(int)_states.size(); i+=nw){
+			computeResults(_model, _states[i], *_kinematics[worker], _results[i]);
+			_lookups[i].resize(ny);
+			_sequential.getDataAtTime(_states[i].getTime(), ny, &_lookups[i][0]);
+		}
+	}
+
+private:
+	const Model& _model;
+	const SimTK::Array_<SimTK::State>& _states;
+	Array<Kinematics*>& _kinematics;
+	const Storage& _sequential;
+	SimTK::Array_<SimTK::Vector>& _results;
+	SimTK::Array_<SimTK::Vector>& _lookups;
+};
+
+// Assert that the accelerations a Kinematics analysis recorded for the state
+// at time t are those in the expected row.
+static void checkKinematicsRow(Storage& store, double t, const double* expected)
+{
+	int index = store.findIndex(t);
+	const StateVector* row = store.getStateVector(index);
+	ASSERT(row->getTime() == t, __FILE__, __LINE__,
+		"testConcurrentStates: Kinematics row is missing.");
+	for(int j=0; j<row->getSize(); ++j){
+		ASSERT(row->getData()[j] == expected[j], __FILE__, __LINE__,
+			"testConcurrentStates: parallel Kinematics results differ.");
+	}
+}
+
+void testConcurrentStates(const string& modelFile, int nStates, int nRepeats)
+{
+	using namespace SimTK;
+
+	Model model(modelFile);
+	State& s0 = model.initSystem();
+	model.equilibrateMuscles(s0);
+
+	// States spread over the ranges of the coordinates, with speeds, so that
+	// paths wrap and unwrap and moving points move. Time identifies a state.
+	const CoordinateSet& coords = model.getCoordinateSet();
+	int nc = coords.getSize();
+	Random::Uniform random(0.0, 1.0);
+	random.setSeed(nStates);
+	Array_<State> states(nStates, s0);
+	for(int i=0; i<nStates; ++i){
+		State& s = states[i];
+		s.setTime(0.01*i);
+		for(int j=0; j<nc; ++j){
+			const Coordinate& coord = coords[j];
+			if(coord.getLocked(s)) continue;
+			double lo = coord.getRangeMin(), hi = coord.getRangeMax();
+			coord.setValue(s, lo + random.getValue()*(hi-lo), false);
+			coord.setSpeedValue(s, 2.0*random.getValue()-1.0);
+		}
+		model.assemble(s);
+	}
+
+	// SEQUENTIAL
+	Kinematics sequentialKinematics(&model);
+	sequentialKinematics.setInDegrees(false);
+	Array_<Vector> sequential(nStates);
+	double start = realTime();
+	for(int i=0; i<nStates; ++i)
+		computeResults(model, states[i], sequentialKinematics, sequential[i]);
+	double sequentialTime = realTime()-start;
+	Storage& sequentialStore = *sequentialKinematics.getAccelerationStorage();
+	int ny = sequentialStore.getSmallestNumberOfStates();
+
+	// PARALLEL, repeated to give races a chance to show up
+	int nw = ParallelExecutor::getNumProcessors();
+	if(nw < 2) nw = 2;
+	double parallelTime = 0;
+	for(int r=0; r<nRepeats; ++r){
+		Array<Kinematics*> kinematics;
+		for(int w=0; w<nw; ++w){
+			kinematics.append(new Kinematics(&model));
+			kinematics[w]->setInDegrees(false);
+		}
+		Array_<Vector> parallel(nStates), lookups(nStates);
+
+		ComputeStatesTask task(model, states, kinematics, sequentialStore,
+							   parallel, lookups);
+		start = realTime();
+		ParallelExecutor executor(nw);
+		executor.execute(task, nw);
+		parallelTime += realTime()-start;
+
+		for(int i=0; i<nStates; ++i){
+			ASSERT(parallel[i].size() == sequential[i].size());
+			for(int j=0; j<sequential[i].size(); ++j){
+				ASSERT(parallel[i][j] == sequential[i][j], __FILE__, __LINE__,
+					"testConcurrentStates: parallel path, force or acceleration "
+					"results differ.");
+			}
+			const double* expected =
+				sequentialStore.getStateVector(i)->getData().get();
+			for(int j=0; j<ny; ++j){
+				ASSERT(lookups[i][j] == expected[j], __FILE__, __LINE__,
+					"testConcurrentStates: concurrent Storage lookups differ.");
+			}
+			checkKinematicsRow(
+				*kinematics[i % nw]->getAccelerationStorage(),
+				states[i].getTime(), expected);
+		}
+		for(int w=0; w<nw; ++w)
+			delete kinematics[w];
+	}
+
+	cout << "************************ testConcurrentStates ************************" << endl;
+	cout << "MODEL: " << modelFile << ", " << nStates << " states." << endl;
+	cout << "Sequential: " << sequentialTime << "s, parallel on " << nw
+		 << " threads: " << parallelTime/nRepeats << "s." << endl;
+}
@@ -86,9 +86,9 @@ protected:
 	const WrapObject* _wrapObject;
 	GeometryPath* _path;
 
-	WrapResult _previousWrap;  // results from previous wrapping
-
-    PathWrapPoint _wrapPoints[2]; // the two muscle points created when the muscle wraps
+    // The two muscle points created when the muscle wraps. The path keeps a
+    // copy of them for each state, in which the wrapping is computed.
+    PathWrapPoint _wrapPoints[2];
 
 //=============================================================================
 // METHODS
@@ -119,9 +119,11 @@ public:
 	const std::string& getMethodName() const { return _methodName; }
 	GeometryPath* getPath() const { return _path; }
 
-	const WrapResult& getPreviousWrap() const { return _previousWrap; }
-	void setPreviousWrap(const WrapResult& aWrapResult);
-	void resetPreviousWrap();
+	/** Get the result of the last wrap of the path over the wrap object in
+	the given state, which seeds the next wrap. The results are kept in the
+	cache of the state, not in this object, so that paths can be wrapped on
+	distinct states concurrently. */
+	const WrapResult& getPreviousWrap(const SimTK::State& s) const;
 
 protected:
 	void setupProperties();
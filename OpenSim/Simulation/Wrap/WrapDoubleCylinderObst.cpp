@@ -406,20 +406,13 @@ static int load_Rxyz(double q[3],double Rxyz[9]) {
 /*====== SOLVE THE SYSTEM OF LINEAR EQUATIONS:  A(NxN)*X(Nx1)=B(Nx1) ========*/
 /*===========================================================================*/
 static int quick_solve_linear(int N,double A[],double X[],double B[]) {
-	static double *MTX=NULL,**Mtx=NULL;
-	static int mtxsize=0;
+	/*== STORAGE FOR DUPLICATE OF A AND ROW POINTERS, LOCAL TO THE CALL ==*/
+	/*== SO THAT WRAPPING MAY RUN ON SEVERAL THREADS; ONLY N=3 IS USED  ==*/
+	enum { MAXN = 3 };
+	double MTX[MAXN*(MAXN+1)],*Mtx[MAXN];
 	double **Mr,*Mrj,*Mij,*Xr,*Br,d;
 	int r,i,j,n;
-
-	/*====================================================================*/
-	/*======= ALLOCATE STORAGE FOR DUPLICATE OF A AND ROW POINTERS =======*/
-	/*====================================================================*/
-	if(mtxsize<N*(N+1)) {	mtxsize=N*(N+1);
-		MTX=(double *)  malloc(mtxsize*sizeof(double));
-		Mtx=(double **) malloc(N*sizeof(double *));
-		if(Mtx==NULL) { fprintf(stderr,"\nOut of memory.\n\n"); exit(0); }
-	}
-	/*====================================================================*/
+	if(N>MAXN) return(-1);
 
 	/*====================================================================*/
 	/*== COPY A INTO MTX(NxN), B INTO MTX(N+1), AND LOAD POINTER VECTOR ==*/
@@ -260,17 +260,13 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
 	bool far_side_wrap = false;
    static SimTK::Vec3 origin(0,0,0);
 
-	// In case you need any variables from the previous wrap, copy them from
-	// the PathWrap into the WrapResult, re-normalizing the ones that were
+	// In case you need any variables from the previous wrap, they have been
+	// copied into the WrapResult by the caller. Re-normalize the ones that were
 	// un-normalized at the end of the previous wrap calculation.
-	const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
-	aWrapResult.factor = previousWrap.factor;
 	for (i = 0; i < 3; i++)
 	{
-		aWrapResult.r1[i] = previousWrap.r1[i] * previousWrap.factor;
-		aWrapResult.r2[i] = previousWrap.r2[i] * previousWrap.factor;
-		aWrapResult.c1[i] = previousWrap.c1[i];
-		aWrapResult.sv[i] = previousWrap.sv[i];
+		aWrapResult.r1[i] *= aWrapResult.factor;
+		aWrapResult.r2[i] *= aWrapResult.factor;
 	}
 
 	aFlag = true;
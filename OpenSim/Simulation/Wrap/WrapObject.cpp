@@ -305,7 +305,9 @@ WrapObject& WrapObject::operator=(const WrapObject& aWrapObject)
  * @param aPoint1 The first patth point
  * @param aPoint2 The second path point
  * @param aPathWrap An object holding the parameters for this path/wrap-object pairing
- * @param aWrapResult The result of the wrapping (tangent points, etc.)
+ * @param aWrapResult The result of the wrapping (tangent points, etc.). On
+ * entry it holds the result of the previous wrap over this object, from which
+ * some wrap objects start their search.
  * @return The status, as a WrapAction enum
  */
 int WrapObject::wrapPathSegment(const SimTK::State& s, PathPoint& aPoint1, PathPoint& aPoint2,
@@ -318,9 +320,9 @@ int WrapObject::wrapPathSegment(const SimTK::State& s, PathPoint& aPoint1, PathP
 
 	// Convert the path points from the frames of the bodies they are attached
 	// to to the frame of the wrap object's body
-	_model->getSimbodyEngine().transformPosition(s, aPoint1.getBody(), aPoint1.getLocation(), getBody(), pt1);
+	_model->getSimbodyEngine().transformPosition(s, aPoint1.getBody(), aPoint1.getLocation(s), getBody(), pt1);
 
-	_model->getSimbodyEngine().transformPosition(s, aPoint2.getBody(), aPoint2.getLocation(), getBody(), pt2);
+	_model->getSimbodyEngine().transformPosition(s, aPoint2.getBody(), aPoint2.getLocation(s), getBody(), pt2);
 
 	// Convert the path points from the frame of the wrap object's body
 	// into the frame of the wrap object
@@ -64,6 +64,7 @@ void WrapResult::copyData(const WrapResult& aWrapResult)
 
 	startPoint = aWrapResult.startPoint;
 	endPoint = aWrapResult.endPoint;
+	factor = aWrapResult.factor;
 
 	int i;
 	for (i = 0; i < 3; i++) {
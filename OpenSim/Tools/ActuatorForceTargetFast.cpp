@@ -49,6 +49,49 @@ using SimTK::Matrix;
 
 #define USE_LINEAR_CONSTRAINT_MATRIX
 
+//______________________________________________________________________________
+/**
+ * The constraints as a function of the actuator forces applied to a state.
+ * Unlike computeConstraintVector(), it changes nothing but the state, so
+ * that the perturbations of the forces can be evaluated in parallel.
+ */
+class ActuatorForceTargetFast::ConstraintFunction :
+	public OptimizationTarget::StateFunction {
+public:
+	ConstraintFunction(const ActuatorForceTargetFast &aTarget) :
+		_target(aTarget)
+	{
+		// Weights and desired accelerations do not depend on the forces
+		CMC_TaskSet& taskSet = _target._controller->updTaskSet();
+		_w = taskSet.getWeights();
+		_aDes = taskSet.getDesiredAccelerations();
+	}
+
+	int evaluate(SimTK::State &s, const Vector &x, Vector &c) const {
+		const Set<Actuator>& fSet = _target._controller->getActuatorSet();
+		for(int i=0;i<fSet.getSize();i++) {
+			Actuator& act = fSet.get(i);
+			act.overrideForce(s,true);
+			act.setOverrideForce(s, x[i]);
+		}
+		_target._controller->getModel().getMultibodySystem().realize(s, SimTK::Stage::Acceleration );
+
+		Array<double> a(0.0);
+		_target._controller->getTaskSet().calcAccelerations(s,a);
+
+		// CONSTRAINTS
+		for(int i=0; i<_target.getNumConstraints(); i++)
+			c[i]=_w[i]*(_aDes[i]-a[i]);
+
+		return(0);
+	}
+
+private:
+	const ActuatorForceTargetFast &_target;
+	Array<double> _w;
+	Array<double> _aDes;
+};
+
 //==============================================================================
 // DESTRUCTOR & CONSTRUCTIOR(S)
 //==============================================================================
@@ -139,11 +182,26 @@ prepareToOptimize(SimTK::State& s, double *x)
 
 	computeConstraintVector(s, f, _constraintVector);
 
-	for(int j=0; j<nf; j++) {
-		f[j] = 1;
-		computeConstraintVector(s, f, c);
-		_constraintMatrix(j) = (c - _constraintVector);
-		f[j] = 0;
+	if(getNumThreads()==1) {
+		for(int j=0; j<nf; j++) {
+			f[j] = 1;
+			computeConstraintVector(s, f, c);
+			_constraintMatrix(j) = (c - _constraintVector);
+			f[j] = 0;
+		}
+	} else {
+		// Unit forward differences give the same columns, with the
+		// actuators spread over threads. Each thread realizes its own copy
+		// of the state, which the model supports (see Model).
+		ConstraintFunction constraints(*this);
+		Array<double> df(1.0,nf);
+		int status = OptimizationTarget::ParallelForwardDifferences(
+			constraints,s,&df[0],f,_constraintVector,_constraintMatrix,
+			getNumThreads());
+		if(status<0)
+			throw Exception("ActuatorForceTargetFast.prepareToOptimize: "
+				"ERROR- failed to compute the constraint matrix.",
+				__FILE__,__LINE__);
 	}
 #endif
 
@@ -80,7 +80,8 @@ CMCTool::CMCTool() :
 	_optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
 	_maxIterations(_maxIterationsProp.getValueInt()),
 	_printLevel(_printLevelProp.getValueInt()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 }
@@ -110,7 +111,8 @@ CMCTool::CMCTool(const string &aFileName, bool aLoadModel) :
 	_optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
 	_maxIterations(_maxIterationsProp.getValueInt()),
 	_printLevel(_printLevelProp.getValueInt()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -180,7 +182,8 @@ CMCTool(const CMCTool &aTool) :
 	_optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
 	_maxIterations(_maxIterationsProp.getValueInt()),
 	_printLevel(_printLevelProp.getValueInt()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	*this = aTool;
@@ -213,6 +216,7 @@ setNull()
 	_maxIterations = 1000;
 	_printLevel = 0;
 	_verbose = false;
+	_numThreads = 1;
 
     _replaceForceSet = false;   // default should be false for Forward.
 	_solveForEquilibriumForAuxiliaryStates = true;
@@ -332,6 +336,12 @@ void CMCTool::setupProperties()
 	_verboseProp.setName("use_verbose_printing");
 	_propertySet.append( &_verboseProp );
 
+	comment = "Number of threads over which the actuator forces are perturbed to compute the "
+		"constraints of the fast optimization target at each time window. 0 uses all processors.";
+	_numThreadsProp.setComment(comment);
+	_numThreadsProp.setName("number_of_threads");
+	_propertySet.append( &_numThreadsProp );
+
 }
 
 
@@ -370,6 +380,7 @@ operator=(const CMCTool &aTool)
 	_maxIterations = aTool._maxIterations;
 	_printLevel = aTool._printLevel;
 	_verbose = aTool._verbose;
+	_numThreads = aTool._numThreads;
 
 	return(*this);
 }
@@ -689,6 +700,7 @@ bool CMCTool::run()
 		target = new ActuatorForceTarget(na,controller);
 	}
 	target->setDX(_numericalDerivativeStepSize);
+	target->setNumThreads(_numThreads);
 
 	// Pick optimizer algorithm
 	SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
@@ -735,11 +747,12 @@ bool CMCTool::run()
 	// ---- SIMULATION ----
 	//
 	// Manager
-    RungeKuttaMersonIntegrator integrator(_model->getMultibodySystem());
+    Manager manager(*_model);
+    manager.setIntegratorMethod(_integratorMethod, _maxDT);
+    SimTK::Integrator& integrator = manager.getIntegrator();
 	integrator.setMaximumStepSize(_maxDT);
 	integrator.setMinimumStepSize(_minDT);
 	integrator.setAccuracy(_errorTolerance);
-    Manager manager(*_model, integrator);
 	
 	_model->setAllControllersEnabled( true );
 
@@ -127,6 +127,10 @@ private:
 	/** Flag for turning on and off verbose printing. */
 	PropertyBool _verboseProp;
 	bool &_verbose;
+	/** Number of threads over which the actuator forces are perturbed to
+	compute the constraint matrix of the fast target. */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
 
 	ForceSet _originalForceSet;
 
@@ -197,6 +201,9 @@ public:
     bool getUseFastTarget() const { return _useFastTarget;};  	 	 
     void setUseFastTarget(bool useFastTarget) const {  _useFastTarget=useFastTarget; };
 
+	int getNumThreads() const { return _numThreads; }
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+
 
 	//--------------------------------------------------------------------------
 	// INTERFACE
@@ -364,13 +364,26 @@ computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF)
 void CMC_Joint::
 computeAccelerations(const SimTK::State& s )
 {
-	_a=SimTK::NaN;
+	calcAccelerations(s,_a);
+}
+//_____________________________________________________________________________
+/**
+ * Compute the acceleration of the coordinate without changing the task, so
+ * that accelerations can be computed for several states concurrently.
+ *
+ * @param rAccel Computed accelerations.
+ * @see computeAccelerations()
+ */
+void CMC_Joint::
+calcAccelerations(const SimTK::State& s, SimTK::Vec3& rAccel) const
+{
+	rAccel=SimTK::NaN;
 
 	// CHECK
 	if(_model==NULL) return;
 
 	// ACCELERATION
-	_a[0] = _q->getAccelerationValue(s);
+	rAccel[0] = _q->getAccelerationValue(s);
 }
 
 
@@ -104,6 +104,7 @@ public:
 	virtual void computeDesiredAccelerations(const SimTK::State& s, double aT);
 	virtual void computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF);
 	virtual void computeAccelerations(const SimTK::State& s );
+	virtual void calcAccelerations(const SimTK::State& s, SimTK::Vec3& rAccel) const;
 
 	//--------------------------------------------------------------------------
 	// XML
@@ -430,33 +430,52 @@ computeAccelerations(const SimTK::State& s )
 	// CHECK
 	if(_model==NULL) return;
 
+	if(_wrtBodyName != "center_of_mass")
+		_wrtBody = &_model->updBodySet().get(_wrtBodyName);
+
+	calcAccelerations(s,_a);
+}
+//_____________________________________________________________________________
+/**
+ * Compute the acceleration of the point without changing the task, so that
+ * accelerations can be computed for several states concurrently.
+ *
+ * @param rAccel Computed accelerations.
+ * @see computeAccelerations()
+ */
+void CMC_Point::
+calcAccelerations(const SimTK::State& s, SimTK::Vec3& rAccel) const
+{
+	// CHECK
+	if(_model==NULL) return;
+
 	// ACCELERATION
-	_a = 0;
-	BodySet& bs = _model->updBodySet();
+	rAccel = 0;
+	const BodySet& bs = _model->getBodySet();
 	if(_wrtBodyName == "center_of_mass") {
 
 		SimTK::Vec3 pVec,vVec,aVec,com;
 		double Mass = 0.0;
 		for(int i=0;i<bs.getSize();i++) {
-			Body& body = bs.get(i);
+			const Body& body = bs.get(i);
 			com = body.get_mass_center();
 			_model->getSimbodyEngine().getAcceleration(s, body,com,aVec);
 			if(aVec[0] != aVec[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
 											+ "' references invalid acceleration components",__FILE__,__LINE__);
 			// ADD TO WHOLE BODY MASS
 			Mass += body.get_mass();
-			_a += body.get_mass() * aVec;
+			rAccel += body.get_mass() * aVec;
 		}
 
 		//COMPUTE COM ACCELERATION OF WHOLE BODY
-		_a /= Mass;
+		rAccel /= Mass;
 
 	} else {
 
-		_wrtBody =  &bs.get(_wrtBodyName);
+		const Body& wrtBody = bs.get(_wrtBodyName);
 
-		_model->getSimbodyEngine().getAcceleration(s, *_wrtBody,_point,_a);
-		if(_a[0] != _a[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
+		_model->getSimbodyEngine().getAcceleration(s, wrtBody,_point,rAccel);
+		if(rAccel[0] != rAccel[0]) throw Exception("CMC_Point.computeAccelerations: ERROR- point task '" + getName() 
 											+ "' references invalid acceleration components",__FILE__,__LINE__);
 	}
 }
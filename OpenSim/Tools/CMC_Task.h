@@ -214,6 +214,7 @@ public:
 	virtual void computeDesiredAccelerations(const SimTK::State& s, double aT) = 0;
 	virtual void computeDesiredAccelerations(const SimTK::State& s, double aTI,double aTF) = 0;
 	virtual void computeAccelerations(const SimTK::State& s ) = 0;
+	virtual void calcAccelerations(const SimTK::State& s, SimTK::Vec3& rAccel) const = 0;
 	virtual void computeJacobian();
 	virtual void computeEffectiveMassMatrix();
 
@@ -884,5 +884,35 @@ computeAccelerations(const SimTK::State& s)
 	//printf("CMC_TaskSet.computeAccelerations: %d ",_a.size());
 	//printf("track goals are active.\n");
 }
+//_____________________________________________________________________________
+/**
+ * Compute the accelerations of the active track goals without changing the
+ * tasks, so that accelerations can be computed for several states
+ * concurrently.  They are ordered as by computeAccelerations().
+ *
+ * @param rAccelerations Computed accelerations.
+ */
+void CMC_TaskSet::
+calcAccelerations(const SimTK::State& s, Array<double>& rAccelerations) const
+{
+	rAccelerations.setSize(0);
+
+	SimTK::Vec3 a;
+	for(int i=0;i<getSize();i++) {
+
+		// If CMC_Task process same way as pre 2.0.2
+		const CMC_Task* task = dynamic_cast<const CMC_Task*>(&get(i));
+		if(task==NULL) continue;
+
+		// COMPUTE
+		task->calcAccelerations(s,a);
+
+		// ACCELERATIONS OF ACTIVE GOALS
+		for(int j=0;j<3;j++) {
+			if(!task->getActive(j)) continue;
+			rAccelerations.append(a[j]);
+		}
+	}
+}
 
 
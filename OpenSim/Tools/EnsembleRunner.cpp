@@ -0,0 +1,374 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  EnsembleRunner.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "EnsembleRunner.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/Property.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ComponentSet.h>
+#include <OpenSim/Simulation/Model/ProbeSet.h>
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Control/ControlSet.h>
+#include <OpenSim/Simulation/Control/ControlSetController.h>
+#include <algorithm>
+#include <cstdio>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace OpenSim {
+
+/** Runs the members of an ensemble assigned to one worker. Worker w runs the
+pending members w, w+n, w+2n, ... of the n workers on a copy of the model
+that only it uses. */
+class EnsembleTask : public SimTK::ParallelExecutor::Task {
+public:
+    EnsembleTask(EnsembleRunner& runner, const vector<int>& pending,
+                 int numWorkers) :
+        _runner(runner), _pending(pending), _numWorkers(numWorkers) {}
+
+    void execute(int worker) {
+        Model* workerModel = NULL;
+        for(int k = worker; k < (int)_pending.size(); k += _numWorkers)
+            _runner.runMember(_pending[k], workerModel);
+        delete workerModel;
+    }
+
+private:
+    EnsembleRunner& _runner;
+    const vector<int>& _pending;
+    int _numWorkers;
+};
+
+} // end of namespace OpenSim
+
+namespace {
+
+// Look up a component of a set by name, or return NULL.
+template <class T>
+Object* findInSet(Set<T>& set, const string& name)
+{
+    int index = set.getIndex(name);
+    return index < 0 ? NULL : &set.get(index);
+}
+
+// Look up a component of a model by name; an empty name is the model itself.
+Object* findComponent(Model& model, const string& name)
+{
+    if(name.empty() || name == model.getName()) return &model;
+    Object* component = findInSet(model.updForceSet(), name);
+    if(!component) component = findInSet(model.updBodySet(), name);
+    if(!component) component = findInSet(model.updJointSet(), name);
+    if(!component) component = findInSet(model.updCoordinateSet(), name);
+    if(!component) component = findInSet(model.updConstraintSet(), name);
+    if(!component) component = findInSet(model.updControllerSet(), name);
+    if(!component) component = findInSet(model.updProbeSet(), name);
+    if(!component)
+        component = findInSet(model.updMiscModelComponentSet(), name);
+    return component;
+}
+
+// Set a double property of either kind: a Property<double> or a deprecated
+// PropertyDbl.
+void setDoubleProperty(Object& object, const string& name, double value)
+{
+    AbstractProperty& prop = object.updPropertyByName(name);
+    Property_Deprecated* deprecated = dynamic_cast<Property_Deprecated*>(&prop);
+    if(deprecated) deprecated->setValue(value);
+    else Property<double>::updAs(prop).setValue(value);
+}
+
+} // end of anonymous namespace
+
+//==============================================================================
+// ENSEMBLE MEMBER
+//==============================================================================
+EnsembleMember::EnsembleMember(const string& name) :
+    _name(name), _controlSet(NULL)
+{
+}
+
+EnsembleMember::EnsembleMember(const EnsembleMember& source) :
+    _controlSet(NULL)
+{
+    *this = source;
+}
+
+EnsembleMember& EnsembleMember::operator=(const EnsembleMember& source)
+{
+    if(this == &source) return *this;
+    _name = source._name;
+    delete _controlSet;
+    _controlSet = source._controlSet ? source._controlSet->clone() : NULL;
+    _stateNames = source._stateNames;
+    _stateValues = source._stateValues;
+    _overrideComponents = source._overrideComponents;
+    _overrideProperties = source._overrideProperties;
+    _overrideValues = source._overrideValues;
+    return *this;
+}
+
+EnsembleMember::~EnsembleMember()
+{
+    delete _controlSet;
+}
+
+void EnsembleMember::setControlSet(const ControlSet& controlSet)
+{
+    delete _controlSet;
+    _controlSet = controlSet.clone();
+}
+
+void EnsembleMember::setInitialState(const string& stateName, double value)
+{
+    int index = _stateNames.findIndex(stateName);
+    if(index >= 0) {
+        _stateValues[index] = value;
+    } else {
+        _stateNames.append(stateName);
+        _stateValues.append(value);
+    }
+}
+
+void EnsembleMember::setPropertyOverride(const string& componentName,
+                                         const string& propertyName,
+                                         double value)
+{
+    for(int i = 0; i < _overrideValues.getSize(); ++i) {
+        if(_overrideComponents[i] == componentName &&
+           _overrideProperties[i] == propertyName) {
+            _overrideValues[i] = value;
+            return;
+        }
+    }
+    _overrideComponents.append(componentName);
+    _overrideProperties.append(propertyName);
+    _overrideValues.append(value);
+}
+
+//==============================================================================
+// CONSTRUCTION
+//==============================================================================
+EnsembleRunner::EnsembleRunner(const string& modelFile)
+{
+    setNull();
+    _model = new Model(modelFile);
+}
+
+EnsembleRunner::EnsembleRunner(const Model& model)
+{
+    setNull();
+    _model = new Model(model);
+}
+
+EnsembleRunner::~EnsembleRunner()
+{
+    clearMembers();
+    delete _model;
+}
+
+void EnsembleRunner::setNull()
+{
+    _model = NULL;
+    _ti = 0.0;
+    _tf = 1.0;
+    _method = "RungeKuttaMerson";
+    _accuracy = 1.0e-5;
+    _maxDT = 1.0;
+    _minDT = 1.0e-8;
+    _maxSteps = 20000;
+    _solveForEquilibrium = false;
+    _numThreads = 0;
+    _resultsDir = "";
+    _keepStorages = true;
+    _flushInterval = 0;
+}
+
+//==============================================================================
+// MEMBERS
+//==============================================================================
+int EnsembleRunner::addMember(const EnsembleMember& member)
+{
+    int index = getNumMembers();
+    EnsembleMember* copy = new EnsembleMember(member);
+    if(copy->getName().empty()) {
+        char name[32];
+        sprintf(name, "member_%d", index);
+        copy->setName(name);
+    }
+    _members.push_back(copy);
+    _stateStores.push_back(NULL);
+    _completed.push_back(0);
+    _hasRun.push_back(0);
+    _errors.push_back("");
+    return index;
+}
+
+void EnsembleRunner::clearMembers()
+{
+    for(int i = 0; i < getNumMembers(); ++i) {
+        delete _members[i];
+        delete _stateStores[i];
+    }
+    _members.clear();
+    _stateStores.clear();
+    _completed.clear();
+    _hasRun.clear();
+    _errors.clear();
+}
+
+const Storage& EnsembleRunner::getStateStorage(int i) const
+{
+    if(_stateStores[i] == NULL)
+        throw Exception("EnsembleRunner::getStateStorage: no states were kept "
+                        "for member " + _members[i]->getName() + ".",
+                        __FILE__, __LINE__);
+    return *_stateStores[i];
+}
+
+//==============================================================================
+// RUN
+//==============================================================================
+int EnsembleRunner::run()
+{
+    vector<int> pending;
+    for(int i = 0; i < getNumMembers(); ++i)
+        if(!_hasRun[i]) pending.push_back(i);
+    if(pending.empty()) return 0;
+
+    int numThreads = _numThreads > 0 ? _numThreads : IO::GetNumThreads();
+    int numWorkers = min(numThreads, (int)pending.size());
+
+    cout << "EnsembleRunner: simulating " << pending.size() << " members of "
+         << _model->getName() << " on " << numWorkers << " thread(s)." << endl;
+    double start = SimTK::realTime();
+
+    EnsembleTask task(*this, pending, numWorkers);
+    if(numWorkers > 1) {
+        SimTK::ParallelExecutor executor(numWorkers);
+        executor.execute(task, numWorkers);
+    } else {
+        task.execute(0);
+    }
+
+    int numCompleted = 0;
+    for(int k = 0; k < (int)pending.size(); ++k) {
+        int i = pending[k];
+        _hasRun[i] = 1;
+        if(_completed[i]) ++numCompleted;
+        else cout << "EnsembleRunner: member " << _members[i]->getName()
+                  << " did not complete: " << _errors[i] << endl;
+    }
+    cout << "EnsembleRunner: " << numCompleted << " of " << pending.size()
+         << " members completed in " << SimTK::realTime()-start << " s."
+         << endl;
+    return numCompleted;
+}
+
+Model* EnsembleRunner::createMemberModel(const EnsembleMember& member) const
+{
+    Model* model = new Model(*_model);
+    try {
+        for(int j = 0; j < member.getNumPropertyOverrides(); ++j) {
+            const string& name = member.getOverrideComponentName(j);
+            Object* component = findComponent(*model, name);
+            if(component == NULL)
+                throw Exception("EnsembleRunner: model has no component named "
+                                + name + ".", __FILE__, __LINE__);
+            setDoubleProperty(*component, member.getOverridePropertyName(j),
+                              member.getOverrideValue(j));
+        }
+        if(member.getControlSet() != NULL) {
+            ControlSetController* controller = new ControlSetController();
+            controller->setName(member.getName() + "_controls");
+            controller->setControlSet(member.getControlSet()->clone());
+            model->addController(controller);
+        }
+        model->buildSystem();
+    } catch(...) {
+        delete model;
+        throw;
+    }
+    return model;
+}
+
+/* Simulates member i, on a copy of the model of its own if it modifies the
+model, or else on the copy of the worker running it, which is made on first
+use. Errors are recorded for the member rather than thrown, so one failed
+member does not stop the others. */
+void EnsembleRunner::runMember(int i, Model*& rWorkerModel)
+{
+    const EnsembleMember& member = *_members[i];
+    Model* memberModel = NULL;
+    try {
+        Model* model;
+        if(member.modifiesModel()) {
+            memberModel = createMemberModel(member);
+            model = memberModel;
+        } else {
+            if(rWorkerModel == NULL) {
+                rWorkerModel = new Model(*_model);
+                rWorkerModel->buildSystem();
+            }
+            model = rWorkerModel;
+        }
+        SimTK::State& s = model->initializeState();
+
+        // INITIAL STATES
+        for(int j = 0; j < member.getNumInitialStates(); ++j)
+            model->setStateVariable(s, member.getInitialStateName(j),
+                                    member.getInitialStateValue(j));
+        if(_solveForEquilibrium) model->equilibrateMuscles(s);
+
+        // MANAGER
+        Manager manager(*model);
+        manager.setIntegratorMethod(_method, _maxDT);
+        SimTK::Integrator& integrator = manager.getIntegrator();
+        integrator.setInternalStepLimit(_maxSteps);
+        integrator.setMaximumStepSize(_maxDT);
+        integrator.setMinimumStepSize(_minDT);
+        integrator.setAccuracy(_accuracy);
+        manager.setSessionName(member.getName());
+        manager.setFlushInterval(_flushInterval);
+        manager.setInitialTime(_ti);
+        manager.setFinalTime(_tf);
+
+        manager.integrate(s);
+        _completed[i] = 1;
+
+        // RESULTS
+        if(!_resultsDir.empty()) {
+            manager.getStateStorage().print(
+                _resultsDir + "/" + member.getName() + "_states.sto");
+            model->updAnalysisSet().printResults(member.getName(), _resultsDir);
+        }
+        if(_keepStorages)
+            _stateStores[i] = new Storage(manager.getStateStorage());
+    } catch(const std::exception& x) {
+        _errors[i] = x.what();
+        if(_errors[i].empty()) _errors[i] = "unknown error";
+    } catch(...) {
+        _errors[i] = "unknown error";
+    }
+    delete memberModel;
+}
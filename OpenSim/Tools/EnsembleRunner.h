@@ -0,0 +1,243 @@
+#ifndef OPENSIM_ENSEMBLE_RUNNER_H_
+#define OPENSIM_ENSEMBLE_RUNNER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  EnsembleRunner.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/Array.h>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Model;
+class ControlSet;
+class Storage;
+
+/** One forward simulation of an EnsembleRunner. A member differs from the
+ensemble's model only in what it specifies: the ControlSet that drives its
+actuators, the values of some of its initial states, and the values of some
+scalar properties of the model's components (e.g., the max_isometric_force
+of a muscle in a Monte Carlo study). Anything left unspecified is taken from
+the model. */
+class OSIMTOOLS_API EnsembleMember {
+public:
+    /** Creates a member that simulates the model as is. */
+    explicit EnsembleMember(const std::string& name = "");
+    EnsembleMember(const EnsembleMember& source);
+    EnsembleMember& operator=(const EnsembleMember& source);
+    ~EnsembleMember();
+
+    const std::string& getName() const { return _name; }
+    void setName(const std::string& name) { _name = name; }
+
+    /** Drives the actuators named in the control set with its controls,
+    through a ControlSetController added to the member's copy of the model.
+    The control set is copied. */
+    void setControlSet(const ControlSet& controlSet);
+    /** @returns the member's control set, or NULL if it has none. */
+    const ControlSet* getControlSet() const { return _controlSet; }
+
+    /** Sets the initial value of a state variable, by the name listed in
+    Model::getStateVariableNames(). */
+    void setInitialState(const std::string& stateName, double value);
+    int getNumInitialStates() const { return _stateNames.getSize(); }
+    const std::string& getInitialStateName(int i) const
+    {   return _stateNames[i]; }
+    double getInitialStateValue(int i) const { return _stateValues[i]; }
+
+    /** Overrides a scalar (double) property of a component of the model.
+    The component is looked up by name in the model's forces, bodies,
+    joints, coordinates, constraints, controllers, probes and miscellaneous
+    components; an empty name or the name of the model refers to the model
+    itself. */
+    void setPropertyOverride(const std::string& componentName,
+                             const std::string& propertyName, double value);
+    int getNumPropertyOverrides() const { return _overrideValues.getSize(); }
+    const std::string& getOverrideComponentName(int i) const
+    {   return _overrideComponents[i]; }
+    const std::string& getOverridePropertyName(int i) const
+    {   return _overrideProperties[i]; }
+    double getOverrideValue(int i) const { return _overrideValues[i]; }
+
+    /** @returns true if the member needs its own copy of the model, i.e., it
+    has a control set or property overrides. Members that only set initial
+    states reuse the model copy of the thread that runs them. */
+    bool modifiesModel() const
+    {   return _controlSet!=NULL || _overrideValues.getSize()>0; }
+
+private:
+    std::string _name;
+    ControlSet* _controlSet;
+    Array<std::string> _stateNames;
+    Array<double> _stateValues;
+    Array<std::string> _overrideComponents;
+    Array<std::string> _overrideProperties;
+    Array<double> _overrideValues;
+};
+
+/** An EnsembleRunner runs many forward simulations of one model that differ
+only in their controls, initial states, or a few property values, on a pool
+of threads within one process. The model is loaded (or copied) once; each
+thread works on its own deep copy of it, made with the Model copy
+constructor, so the .osim file is parsed only once however many members the
+ensemble has. A member that modifies the model (see
+EnsembleMember::modifiesModel()) is simulated on a fresh copy that is
+discarded afterwards; other members reuse their thread's copy and only
+reinitialize its state.
+
+Each member is integrated by its own Manager from the initial to the final
+time, with the integrator method, accuracy and step limits of the runner.
+The states of each member are kept in a Storage of the runner and, when a
+results directory is set, printed to \<directory\>/\<member\>_states.sto
+together with the results of the model's analyses.
+
+Members are assigned to the threads in turn (member i runs on thread
+i modulo the number of threads), so an ensemble whose members take similar
+times keeps all threads busy. Results do not depend on the number of threads.
+
+@code
+EnsembleRunner ensemble("arm26.osim");
+for(int i=0; i<100; ++i) {
+    EnsembleMember member;
+    member.setPropertyOverride("BIClong", "max_isometric_force", fmax[i]);
+    ensemble.addMember(member);
+}
+ensemble.setFinalTime(1.0);
+ensemble.run();
+const Storage& states = ensemble.getStateStorage(0);
+@endcode */
+class OSIMTOOLS_API EnsembleRunner {
+public:
+    /** Creates an ensemble of the model in an .osim file. */
+    explicit EnsembleRunner(const std::string& modelFile);
+    /** Creates an ensemble of a copy of a model. */
+    explicit EnsembleRunner(const Model& model);
+    ~EnsembleRunner();
+
+    /** @returns the model every member is copied from. */
+    const Model& getModel() const { return *_model; }
+
+    /** Adds a copy of a member to the ensemble. A member without a name is
+    named member_\<index\>.
+    @returns the index of the member. */
+    int addMember(const EnsembleMember& member);
+    int getNumMembers() const { return (int)_members.size(); }
+    const EnsembleMember& getMember(int i) const { return *_members[i]; }
+    /** Removes all members and their results. */
+    void clearMembers();
+
+    void setInitialTime(double ti) { _ti = ti; }
+    double getInitialTime() const { return _ti; }
+    void setFinalTime(double tf) { _tf = tf; }
+    double getFinalTime() const { return _tf; }
+
+    /** Integration method of the members' Managers (see
+    Manager::createIntegrator()). The default is RungeKuttaMerson. */
+    void setIntegratorMethod(const std::string& method) { _method = method; }
+    const std::string& getIntegratorMethod() const { return _method; }
+    void setAccuracy(double accuracy) { _accuracy = accuracy; }
+    double getAccuracy() const { return _accuracy; }
+    void setMaxDT(double maxDT) { _maxDT = maxDT; }
+    double getMaxDT() const { return _maxDT; }
+    void setMinDT(double minDT) { _minDT = minDT; }
+    double getMinDT() const { return _minDT; }
+    void setMaximumNumberOfSteps(int maxSteps) { _maxSteps = maxSteps; }
+    int getMaximumNumberOfSteps() const { return _maxSteps; }
+
+    /** Solve for the equilibrium of the auxiliary states (e.g., muscle fiber
+    lengths) of each member before integrating it. The default is false. */
+    void setSolveForEquilibrium(bool solve) { _solveForEquilibrium = solve; }
+    bool getSolveForEquilibrium() const { return _solveForEquilibrium; }
+
+    /** Number of threads to run the members on. 0 or less uses
+    IO::GetNumThreads(). */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
+    /** Directory the members' states and analysis results are printed to
+    once they complete. The directory must exist. An empty name (the
+    default) prints nothing. */
+    void setResultsDirectory(const std::string& dir) { _resultsDir = dir; }
+    const std::string& getResultsDirectory() const { return _resultsDir; }
+
+    /** Keep the states of the members in memory after they are printed.
+    Turning this off, together with a flush interval, bounds the memory of
+    large ensembles whose results go to files. The default is true. */
+    void setKeepStateStorages(bool keep) { _keepStorages = keep; }
+    bool getKeepStateStorages() const { return _keepStorages; }
+
+    /** Number of rows each member keeps in memory while it is integrated
+    (see Manager::setFlushInterval()). 0 (the default) keeps all rows. */
+    void setFlushInterval(int numRows) { _flushInterval = numRows; }
+    int getFlushInterval() const { return _flushInterval; }
+
+    /** Simulates all the members that have not been run yet.
+    @returns the number of members that completed. */
+    int run();
+
+    /** @returns true if member i was run and its integration completed. */
+    bool getCompleted(int i) const { return _completed[i]!=0; }
+    /** @returns the message of the exception that stopped member i, or an
+    empty string. */
+    const std::string& getError(int i) const { return _errors[i]; }
+    /** @returns the states of member i. Throws if the member has not been
+    run or its states were not kept. */
+    const Storage& getStateStorage(int i) const;
+
+private:
+    friend class EnsembleTask;
+
+    // Not copyable; the runner owns its model, members and results.
+    EnsembleRunner(const EnsembleRunner&);
+    EnsembleRunner& operator=(const EnsembleRunner&);
+
+    void setNull();
+    void runMember(int i, Model*& workerModel);
+    Model* createMemberModel(const EnsembleMember& member) const;
+
+    Model* _model;
+    std::vector<EnsembleMember*> _members;
+    std::vector<Storage*> _stateStores;
+    // Flags are ints, not bools: members on different threads set their own
+    // entries concurrently, which a packed std::vector<bool> does not allow.
+    std::vector<int> _completed;
+    std::vector<int> _hasRun;
+    std::vector<std::string> _errors;
+
+    double _ti;
+    double _tf;
+    std::string _method;
+    double _accuracy;
+    double _maxDT;
+    double _minDT;
+    int _maxSteps;
+    bool _solveForEquilibrium;
+    int _numThreads;
+    std::string _resultsDir;
+    bool _keepStorages;
+    int _flushInterval;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_ENSEMBLE_RUNNER_H_
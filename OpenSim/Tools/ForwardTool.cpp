@@ -268,8 +268,9 @@ bool ForwardTool::run()
 
 	// SETUP SIMULATION
 	// Manager (now allocated on the heap so that getManager doesn't return stale pointer on stack
-    RungeKuttaMersonIntegrator integrator(_model->getMultibodySystem());
-    Manager manager(*_model, integrator);
+    Manager manager(*_model);
+    manager.setIntegratorMethod(_integratorMethod, _maxDT);
+    SimTK::Integrator& integrator = manager.getIntegrator();
     setManager( manager );
 	manager.setSessionName(getName());
 	manager.setInitialTime(_ti);
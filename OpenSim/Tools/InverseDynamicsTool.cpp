@@ -67,7 +67,8 @@ InverseDynamicsTool::InverseDynamicsTool() : DynamicsTool(),
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 }
@@ -86,7 +87,8 @@ InverseDynamicsTool::InverseDynamicsTool(const string &aFileName, bool aLoadMode
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -108,7 +110,8 @@ InverseDynamicsTool::InverseDynamicsTool(const InverseDynamicsTool &aTool) :
 	_lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
 	_outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
 	_jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+	_outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	*this = aTool;
@@ -124,6 +127,7 @@ void InverseDynamicsTool::setNull()
 	_model = NULL;
 	_lowpassCutoffFrequency = -1.0;
 	_coordinateValues = NULL;
+	_numThreads = 1;
 }
 //_____________________________________________________________________________
 /**
@@ -155,6 +159,11 @@ void InverseDynamicsTool::setupProperties()
 	_outputBodyForcesAtJointsFileNameProp.setName("output_body_forces_file");
 	_outputBodyForcesAtJointsFileNameProp.setValue("body_forces_at_joints.sto");
 	_propertySet.append(&_outputBodyForcesAtJointsFileNameProp);
+
+	_numThreadsProp.setComment("Number of threads over which the time frames are solved. "
+		"A value of 0 or less uses one thread per processor. The default value is 1.");
+	_numThreadsProp.setName("number_of_threads");
+	_propertySet.append(&_numThreadsProp);
 }
 
 //_____________________________________________________________________________
@@ -186,6 +195,7 @@ operator=(const InverseDynamicsTool &aTool)
 	_lowpassCutoffFrequency = aTool._lowpassCutoffFrequency;
 	_outputGenForceFileName = aTool._outputGenForceFileName;
 	_outputBodyForcesAtJointsFileName = aTool._outputBodyForcesAtJointsFileName;
+	_numThreads = aTool._numThreads;
 	_coordinateValues = NULL;
 
 	return(*this);
@@ -334,7 +344,7 @@ bool InverseDynamicsTool::run()
 
 		// solve for the trajectory of generalized forces that correspond to the 
 		// coordinate trajectories provided
-		ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+		ivdSolver.solve(s, *coordFunctions, times, genForceTraj, _numThreads);
 
 
 		success = true;
@@ -27,6 +27,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyDblArray.h>
 #include "DynamicsTool.h"
@@ -93,6 +94,10 @@ protected:
 	PropertyStr _outputBodyForcesAtJointsFileNameProp;
 	std::string &_outputBodyForcesAtJointsFileName;
 
+	/** number of threads over which the time frames are solved */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -151,6 +156,12 @@ public:
 	void setLowpassCutoffFrequency(double aFrequency) {
 		_lowpassCutoffFrequency = aFrequency;
 	}
+    /**
+     * get/set the number of threads over which the time frames are solved.
+     * 0 or less uses one thread per processor.
+     */
+	int getNumThreads() const { return _numThreads; }
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
 	//--------------------------------------------------------------------------
 	// INTERFACE
 	//--------------------------------------------------------------------------
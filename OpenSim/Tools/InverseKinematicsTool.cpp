@@ -46,6 +46,8 @@
 #include "IKMarkerTask.h"
 
 #include "SimTKsimbody.h"
+#include <algorithm>
+#include <vector>
 
 
 using namespace OpenSim;
@@ -77,7 +79,9 @@ InverseKinematicsTool::InverseKinematicsTool() : Tool(),
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_chunkOverlap(_chunkOverlapProp.getValueInt())
 {
 	setNull();
 }
@@ -102,7 +106,9 @@ InverseKinematicsTool::InverseKinematicsTool(const string &aFileName, bool aLoad
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_chunkOverlap(_chunkOverlapProp.getValueInt())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -130,7 +136,9 @@ InverseKinematicsTool::InverseKinematicsTool(const InverseKinematicsTool &aTool)
 	_timeRange(_timeRangeProp.getValueDblArray()),
 	_reportErrors(_reportErrorsProp.getValueBool()),
 	_outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+	_reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt()),
+	_chunkOverlap(_chunkOverlapProp.getValueInt())
 {
 	setNull();
 	*this = aTool;
@@ -144,6 +152,7 @@ void InverseKinematicsTool::setNull()
 {
 	setupProperties();
 	_model = NULL;
+	_maxChunkDiscrepancy = 0.0;
 }
 //_____________________________________________________________________________
 /**
@@ -171,7 +180,7 @@ void InverseKinematicsTool::setupProperties()
 	_ikTaskSetProp.setName("IKTaskSet");
 	_propertySet.append(&_ikTaskSetProp);
 
-	_markerFileNameProp.setComment("TRC file (.trc) containing the time history of observations of marker positions.");
+	_markerFileNameProp.setComment("TRC file (.trc) or binary TRC file (.trb) containing the time history of observations of marker positions.");
 	_markerFileNameProp.setName("marker_file");
 	_propertySet.append(&_markerFileNameProp);
 
@@ -202,6 +211,19 @@ void InverseKinematicsTool::setupProperties()
 	_reportMarkerLocationsProp.setValue(false);
 	_propertySet.append(&_reportMarkerLocationsProp);
 
+	_numThreadsProp.setComment("Number of threads over which the frames are solved. With more than one, "
+		"each thread solves a contiguous chunk of the frames with its own copy of the model. "
+		"0 uses all processors.");
+	_numThreadsProp.setName("number_of_threads");
+	_numThreadsProp.setValue(1);
+	_propertySet.append(&_numThreadsProp);
+
+	_chunkOverlapProp.setComment("Number of frames preceding each chunk, when solved on more than one "
+		"thread, that its solver assembles and tracks before the frames of the chunk.");
+	_chunkOverlapProp.setName("chunk_overlap");
+	_chunkOverlapProp.setValue(10);
+	_propertySet.append(&_chunkOverlapProp);
+
 }
 
 //_____________________________________________________________________________
@@ -239,6 +261,8 @@ operator=(const InverseKinematicsTool &aTool)
 	_reportErrors = aTool._reportErrors;
 	_outputMotionFileName = aTool._outputMotionFileName;
 	_reportMarkerLocations = aTool._reportMarkerLocations;
+	_numThreads = aTool._numThreads;
+	_chunkOverlap = aTool._chunkOverlap;
 
 	return(*this);
 }
@@ -251,14 +275,132 @@ operator=(const InverseKinematicsTool &aTool)
 //=============================================================================
 // RUN
 //=============================================================================
+namespace {
+/* Solves one contiguous chunk of the frames per thread, each with its own copy
+ * of the model, state, coordinate references and solver. Every chunk but the
+ * first assembles at a frame up to the overlap before its own and tracks from
+ * there, so that its solver is warm by its first frame. The solutions of the
+ * overlapped frames are kept to measure how far adjacent chunks disagree. */
+class TrackChunkTask : public SimTK::ParallelExecutor::Task {
+public:
+	TrackChunkTask(const std::vector<Model*>& aModels, MarkersReference& aMarkersReference,
+		const SimTK::Array_<CoordinateReference>& aCoordinateReferences,
+		double aConstraintWeight, double aAccuracy, double aStartTime, double aDt,
+		int aNumFrames, int aOverlap, bool aReportErrors, bool aReportMarkerLocations,
+		std::vector<Vector>& rQ, std::vector<std::vector<Vector> >& rOverlapQ,
+		std::vector<SimTK::Array_<double> >& rSquaredMarkerErrors,
+		std::vector<SimTK::Array_<Vec3> >& rMarkerLocations,
+		std::vector<std::string>& rErrors) :
+		_models(aModels), _markersReference(aMarkersReference),
+		_coordinateReferences(aCoordinateReferences),
+		_constraintWeight(aConstraintWeight), _accuracy(aAccuracy),
+		_startTime(aStartTime), _dt(aDt), _numFrames(aNumFrames), _overlap(aOverlap),
+		_reportErrors(aReportErrors), _reportMarkerLocations(aReportMarkerLocations),
+		_q(rQ), _overlapQ(rOverlapQ), _squaredMarkerErrors(rSquaredMarkerErrors),
+		_markerLocations(rMarkerLocations), _errors(rErrors) {}
+
+	void execute(int aChunk) {
+		int numChunks = (int)_models.size();
+		int first = (int)(((long long)_numFrames*aChunk)/numChunks);
+		int last = (int)(((long long)_numFrames*(aChunk+1))/numChunks);
+		int warmUp = aChunk==0 ? first : std::max(0, first-_overlap);
+		try {
+			Model& model = *_models[aChunk];
+			SimTK::State s = model.getWorkingState();
+			SimTK::Array_<CoordinateReference> coordinateReferences(_coordinateReferences);
+			InverseKinematicsSolver ikSolver(model, _markersReference,
+				coordinateReferences, _constraintWeight);
+			ikSolver.setAccuracy(_accuracy);
+			s.updTime() = _startTime + warmUp*_dt;
+			ikSolver.assemble(s);
+
+			_overlapQ[aChunk].resize(first-warmUp);
+			for(int i=warmUp; i<last; i++){
+				s.updTime() = _startTime + i*_dt;
+				ikSolver.track(s);
+				if(i < first){
+					_overlapQ[aChunk][i-warmUp] = s.getQ();
+					continue;
+				}
+				_q[i] = s.getQ();
+				if(_reportErrors)
+					ikSolver.computeCurrentSquaredMarkerErrors(_squaredMarkerErrors[i]);
+				if(_reportMarkerLocations)
+					ikSolver.computeCurrentMarkerLocations(_markerLocations[i]);
+			}
+		} catch(const std::exception& x) {
+			_errors[aChunk] = x.what();
+			if(_errors[aChunk].empty()) _errors[aChunk] = "unknown error";
+		}
+	}
+
+private:
+	const std::vector<Model*>& _models;
+	MarkersReference& _markersReference;
+	const SimTK::Array_<CoordinateReference>& _coordinateReferences;
+	double _constraintWeight;
+	double _accuracy;
+	double _startTime;
+	double _dt;
+	int _numFrames;
+	int _overlap;
+	bool _reportErrors;
+	bool _reportMarkerLocations;
+	std::vector<Vector>& _q;
+	std::vector<std::vector<Vector> >& _overlapQ;
+	std::vector<SimTK::Array_<double> >& _squaredMarkerErrors;
+	std::vector<SimTK::Array_<Vec3> >& _markerLocations;
+	std::vector<std::string>& _errors;
+};
+
+// Print the total, RMS and largest marker error of a frame.
+void printMarkerErrors(int aFrame, double aTime,
+	const SimTK::Array_<double>& aSquaredMarkerErrors,
+	const InverseKinematicsSolver& aSolver)
+{
+	int nm = aSquaredMarkerErrors.size();
+	double totalSquaredMarkerError = 0.0;
+	double maxSquaredMarkerError = 0.0;
+	int worst = -1;
+	for(int j=0; j<nm; ++j){
+		totalSquaredMarkerError += aSquaredMarkerErrors[j];
+		if(aSquaredMarkerErrors[j] > maxSquaredMarkerError){
+			maxSquaredMarkerError = aSquaredMarkerErrors[j];
+			worst = j;
+		}
+	}
+	cout << "Frame " << aFrame << " (t=" << aTime << "):\t";
+	cout << "total squared error = " << totalSquaredMarkerError;
+	cout << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm);
+	cout << ", max=" << sqrt(maxSquaredMarkerError) << " (" << aSolver.getMarkerNameForIndex(worst) << ")" << endl;
+}
+
+// Append the model marker locations of a frame to a storage.
+void appendMarkerLocations(double aTime, const SimTK::Array_<Vec3>& aMarkerLocations,
+	Storage& rModelMarkerLocations)
+{
+	int nm = aMarkerLocations.size();
+	Array<double> locations(0.0, 3*nm);
+	for(int j=0; j<nm; ++j){
+		for(int k=0; k<3; ++k)
+			locations.set(3*j+k, aMarkerLocations[j][k]);
+	}
+	rModelMarkerLocations.append(aTime, 3*nm, &locations[0]);
+}
+}
+
 //_____________________________________________________________________________
 /**
  * Run the inverse kinematics tool.
+ *
+ * With more than one thread, the frames are split into contiguous chunks that
+ * are solved in parallel and then reported in order, as if solved in sequence.
  */
 bool InverseKinematicsTool::run()
 {
 	bool success = false;
 	bool modelFromFile=true;
+	std::vector<Model*> chunkModels;
 	try{
 		//Load and create the indicated model
 		if (!_model) 
@@ -268,6 +410,13 @@ bool InverseKinematicsTool::run()
 
 		_model->printBasicInfo(cout);
 
+		// Copy the model for each chunk solved in parallel before any
+		// reporter is added to it
+		int numThreads = _numThreads;
+		if(numThreads<=0) numThreads = SimTK::ParallelExecutor::getNumProcessors();
+		for(int c=0; c<numThreads && numThreads>1; ++c)
+			chunkModels.push_back(_model->clone());
+
 
 		// Do the maneuver to change then restore working directory 
 		// so that the parsing code behaves properly if called from a different directory.
@@ -355,6 +504,8 @@ bool InverseKinematicsTool::run()
 		double final_time = (markersValidTimRange[1] < _timeRange[1]) ? markersValidTimRange[1] : _timeRange[1];
 
 		// create the solver given the input data
+		// (when solving in chunks, it assembles the initial state reported
+		// and names the markers)
 		InverseKinematicsSolver ikSolver(*_model, markersReference, coordinateReferences, _constraintWeight);
 		ikSolver.setAccuracy(_accuracy);
 		s.updTime() = start_time;
@@ -373,44 +524,79 @@ bool InverseKinematicsTool::run()
 		
 		Storage *modelMarkerLocations = _reportMarkerLocations ? new Storage(Nframes, "ModelMarkerLocations") : NULL;
 
-		for (int i = 0; i < Nframes; i++) {
+		int numChunks = std::min((int)chunkModels.size(), Nframes);
+		if(numChunks > 1){
+			// SOLVE CHUNKS IN PARALLEL
+			for(int c=numChunks; c<(int)chunkModels.size(); ++c)
+				delete chunkModels[c];
+			chunkModels.resize(numChunks);
+			for(int c=0; c<numChunks; ++c)
+				chunkModels[c]->initSystem();
+
+			std::vector<Vector> q(Nframes);
+			std::vector<std::vector<Vector> > overlapQ(numChunks);
+			std::vector<SimTK::Array_<double> > chunkSquaredMarkerErrors(_reportErrors ? Nframes : 0);
+			std::vector<SimTK::Array_<Vec3> > chunkMarkerLocations(_reportMarkerLocations ? Nframes : 0);
+			std::vector<std::string> errors(numChunks);
+			TrackChunkTask task(chunkModels, markersReference, coordinateReferences,
+				_constraintWeight, _accuracy, start_time, dt, Nframes, std::max(_chunkOverlap, 0),
+				_reportErrors, _reportMarkerLocations, q, overlapQ,
+				chunkSquaredMarkerErrors, chunkMarkerLocations, errors);
+			SimTK::ParallelExecutor executor(numChunks);
+			executor.execute(task, numChunks);
+
+			for(int c=0; c<numChunks; ++c){
+				if(!errors[c].empty())
+					throw Exception("InverseKinematicsTool: "+errors[c], __FILE__, __LINE__);
+			}
+
+			// Largest disagreement of a chunk with the chunks before it over
+			// the frames it warmed up on
+			_maxChunkDiscrepancy = 0.0;
+			for(int c=1; c<numChunks; ++c){
+				int first = (int)(((long long)Nframes*c)/numChunks);
+				int warmUp = first-(int)overlapQ[c].size();
+				for(int i=warmUp; i<first; ++i){
+					double discrepancy = (overlapQ[c][i-warmUp]-q[i]).normInf();
+					if(discrepancy > _maxChunkDiscrepancy) _maxChunkDiscrepancy = discrepancy;
+				}
+			}
+			cout << "InverseKinematicsTool solved " << numChunks << " chunks in parallel, "
+				 << "max discrepancy over overlapping frames = " << _maxChunkDiscrepancy << endl;
+
+			// REPORT IN ORDER
+			for (int i = 0; i < Nframes; i++) {
+				s.updTime() = start_time + i*dt;
+				s.updQ() = q[i];
+
+				if(_reportErrors)
+					printMarkerErrors(i, s.getTime(), chunkSquaredMarkerErrors[i], ikSolver);
+				if(_reportMarkerLocations)
+					appendMarkerLocations(s.getTime(), chunkMarkerLocations[i], *modelMarkerLocations);
+
+				kinematicsReporter.step(s, i);
+				analysisSet.step(s, i);
+			}
+		}
+		else for (int i = 0; i < Nframes; i++) {
 			s.updTime() = start_time + i*dt;
 			ikSolver.track(s);
 			
 			if(_reportErrors){
-				double totalSquaredMarkerError = 0.0;
-				double maxSquaredMarkerError = 0.0;
-				int worst = -1;
-
 				ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
-				for(int j=0; j<nm; ++j){
-					totalSquaredMarkerError += squaredMarkerErrors[j];
-					if(squaredMarkerErrors[j] > maxSquaredMarkerError){
-						maxSquaredMarkerError = squaredMarkerErrors[j];
-						worst = j;
-					}
-				}
-				cout << "Frame " << i << " (t=" << s.getTime() << "):\t";
-				cout << "total squared error = " << totalSquaredMarkerError;
-				cout << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm);
-				cout << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")" << endl;
+				printMarkerErrors(i, s.getTime(), squaredMarkerErrors, ikSolver);
 			}
 
 			if(_reportMarkerLocations){
 				ikSolver.computeCurrentMarkerLocations(markerLocations);
-				Array<double> locations(0.0, 3*nm);
-				for(int j=0; j<nm; ++j){
-					for(int k=0; k<3; ++k)
-						locations.set(3*j+k, markerLocations[j][k]);
-				}
-
-				modelMarkerLocations->append(s.getTime(), 3*nm, &locations[0]);
-
+				appendMarkerLocations(s.getTime(), markerLocations, *modelMarkerLocations);
 			}
 
 			kinematicsReporter.step(s, i);
 			analysisSet.step(s, i);
 		}
+		for(unsigned int c=0; c<chunkModels.size(); ++c) delete chunkModels[c];
+		chunkModels.clear();
 
 		// Do the maneuver to change then restore working directory 
 		// so that output files are saved to same folder as setup file.
@@ -444,6 +630,7 @@ bool InverseKinematicsTool::run()
 		cout << "InverseKinematicsTool completed " << Nframes-1 << " frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
 	}
 	catch (const std::exception& ex) {
+		for(unsigned int c=0; c<chunkModels.size(); ++c) delete chunkModels[c];
 		std::cout << "InverseKinematicsTool Failed: " << ex.what() << std::endl;
 		throw (Exception("InverseKinematicsTool Failed, please see messages window for details..."));
 	}
@@ -27,6 +27,7 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Common/PropertyDblArray.h>
 #include "Tool.h"
@@ -108,6 +109,18 @@ private:
 	PropertyBool _reportMarkerLocationsProp;
 	bool &_reportMarkerLocations;
 
+	// number of threads over which chunks of the frames are solved
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
+
+	// number of frames preceding each chunk over which its solver warms up
+	PropertyInt _chunkOverlapProp;
+	int &_chunkOverlap;
+
+	/** Largest difference of a coordinate between a chunk and the preceding
+	chunk over the frames they overlap, in the last parallel run. */
+	double _maxChunkDiscrepancy;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -162,6 +175,19 @@ public:
 	std::string getOutputMotionFileName() { return _outputMotionFileName;}
 	IKTaskSet& getIKTaskSet() { return _ikTaskSet; }
 
+	/** Number of threads over which the frames are solved. With more than
+	one, each thread solves a contiguous chunk of the frames with its own
+	copy of the model. 0 uses all processors. */
+	int getNumThreads() const { return _numThreads; }
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+	/** Number of frames preceding each chunk that its solver tracks, after
+	assembling at the first of them, before solving the frames of the chunk. */
+	int getChunkOverlap() const { return _chunkOverlap; }
+	void setChunkOverlap(int aNumFrames) { _chunkOverlap = aNumFrames; }
+	/** Largest difference in value of any coordinate between adjacent chunks
+	over the frames they overlap, in the last run on more than one thread. */
+	double getMaxChunkDiscrepancy() const { return _maxChunkDiscrepancy; }
+
 	//--------------------------------------------------------------------------
 	// INTERFACE
 	//--------------------------------------------------------------------------
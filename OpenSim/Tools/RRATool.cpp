@@ -77,7 +77,8 @@ RRATool::RRATool() :
 	_finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
 	_adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
 	_outputModelFile(_outputModelFileProp.getValueStr()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 }
@@ -102,7 +103,8 @@ RRATool::RRATool(const string &aFileName, bool aLoadModel) :
 	_finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
 	_adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
 	_outputModelFile(_outputModelFileProp.getValueStr()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	updateFromXMLDocument();
@@ -167,7 +169,8 @@ RRATool(const RRATool &aTool) :
 	_finalTimeForCOMAdjustment(_finalTimeForCOMAdjustmentProp.getValueDbl()),
 	_adjustedCOMBody(_adjustedCOMBodyProp.getValueStr()),
 	_outputModelFile(_outputModelFileProp.getValueStr()),
-	_verbose(_verboseProp.getValueBool())
+	_verbose(_verboseProp.getValueBool()),
+	_numThreads(_numThreadsProp.getValueInt())
 {
 	setNull();
 	*this = aTool;
@@ -199,6 +202,7 @@ setNull()
 	_outputModelFile = "";
 	_adjustKinematicsToReduceResiduals=true;
 	_verbose = false;
+	_numThreads = 1;
 	_targetDT = .001;
     _replaceForceSet = false;   // default should be false for Forward.
 
@@ -298,6 +302,12 @@ void RRATool::setupProperties()
 	_verboseProp.setName("use_verbose_printing");
 	_propertySet.append( &_verboseProp );
 
+	comment = "Number of threads over which the actuator forces are perturbed to compute the "
+		"constraints of the fast optimization target at each time window. 0 uses all processors.";
+	_numThreadsProp.setComment(comment);
+	_numThreadsProp.setName("number_of_threads");
+	_propertySet.append( &_numThreadsProp );
+
 }
 
 
@@ -332,6 +342,7 @@ operator=(const RRATool &aTool)
 	_initialTimeForCOMAdjustment = aTool._initialTimeForCOMAdjustment;
 	_finalTimeForCOMAdjustment = aTool._finalTimeForCOMAdjustment;
 	_verbose = aTool._verbose;
+	_numThreads = aTool._numThreads;
 
 	return(*this);
 }
@@ -676,6 +687,7 @@ bool RRATool::run()
 		target = new ActuatorForceTarget(na,controller);
 	}
 	target->setDX(_numericalDerivativeStepSize);
+	target->setNumThreads(_numThreads);
 
 	// Pick optimizer algorithm
 	SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
@@ -722,11 +734,12 @@ bool RRATool::run()
 	// ---- SIMULATION ----
 	//
 	// Manager
-    RungeKuttaMersonIntegrator integrator(_model->getMultibodySystem());
+    Manager manager(*_model);
+    manager.setIntegratorMethod(_integratorMethod, _maxDT);
+    SimTK::Integrator& integrator = manager.getIntegrator();
 	integrator.setMaximumStepSize(_maxDT);
 	integrator.setMinimumStepSize(_minDT);
 	integrator.setAccuracy(_errorTolerance);
-    Manager manager(*_model, integrator);
 	
 	_model->setAllControllersEnabled( true );
 
@@ -117,6 +117,10 @@ private:
 	/** Flag for turning on and off verbose printing. */
 	PropertyBool _verboseProp;
 	bool &_verbose;
+	/** Number of threads over which the actuator forces are perturbed to
+	compute the constraint matrix of the fast target. */
+	PropertyInt _numThreadsProp;
+	int &_numThreads;
 
 	ForceSet _originalForceSet;
 
@@ -177,6 +181,9 @@ public:
 	const std::string &getExternalLoadsFileName() const { return _externalLoadsFileName; }
 	void setExternalLoadsFileName(const std::string &aFileName) { _externalLoadsFileName = aFileName; }
 
+	int getNumThreads() const { return _numThreads; }
+	void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
+
 	//--------------------------------------------------------------------------
 	// INTERFACE
 	//--------------------------------------------------------------------------
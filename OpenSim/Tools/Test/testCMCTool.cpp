@@ -0,0 +1,162 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testCMCTool.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testCMCTool sets up computed muscle control of the gait2354 model, with a
+//  reserve actuator on every coordinate, tracking a synthetic gait-like motion.
+//  It runs the tool with the constraint matrix of each time window computed in
+//  sequence and with the actuator perturbations spread over all processors,
+//  verifies that the actuator forces are identical and reports the time taken
+//  by each.
+//==============================================================================
+#include <fstream>
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Tools/CMCTool.h>
+#include <OpenSim/Tools/CMC_TaskSet.h>
+#include <OpenSim/Tools/CMC_Joint.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void writeCMCSetup(const string& modelFile, const string& setupFile, double duration);
+double runCMC(const string& setupFile, const string& name, int numThreads);
+void testParallelConstraintMatrix(const string& setupFile);
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		writeCMCSetup("gait2354_simbody.osim", "gait2354_cmc_setup.xml", 0.1);
+		testParallelConstraintMatrix("gait2354_cmc_setup.xml");
+	}
+	catch (const std::exception& e) {
+		cout << "testCMCTool failed: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+void writeCMCSetup(const string& modelFile, const string& setupFile, double duration)
+{
+	Model model(modelFile);
+	const CoordinateSet& coords = model.getCoordinateSet();
+	int nq = coords.getSize();
+
+	// Reserve actuators strong enough for the accelerations of every
+	// coordinate to be met.
+	for(int j=0; j<nq; ++j){
+		CoordinateActuator* reserve = new CoordinateActuator(coords[j].getName());
+		reserve->setName(coords[j].getName()+"_reserve");
+		reserve->setOptimalForce(1000.0);
+		reserve->setMinControl(-SimTK::Infinity);
+		reserve->setMaxControl(SimTK::Infinity);
+		model.addForce(reserve);
+	}
+	model.print("gait2354_cmc.osim");
+
+	// Coordinates oscillating about their defaults at a gait-like frequency,
+	// sampled at 100Hz, padded beyond the window tracked.
+	Array<string> labels("time", nq+1);
+	for(int j=0; j<nq; ++j)
+		labels[j+1] = coords[j].getName();
+	Storage kinematics;
+	kinematics.setName("gait2354_cmc_kinematics");
+	kinematics.setColumnLabels(labels);
+	kinematics.setInDegrees(false);
+	SimTK::Vector q(nq);
+	int nt = (int)(100*duration) + 21;
+	for(int i=0; i<nt; ++i){
+		double t = 0.01*i;
+		for(int j=0; j<nq; ++j)
+			q[j] = coords[j].getDefaultValue() + 0.05*sin(2*SimTK::Pi*t + 0.3*j);
+		kinematics.append(t, nq, &q[0]);
+	}
+	kinematics.print("gait2354_cmc_kinematics.sto");
+
+	// Track every coordinate
+	CMC_TaskSet tasks;
+	for(int j=0; j<nq; ++j){
+		CMC_Joint* task = new CMC_Joint(coords[j].getName());
+		task->setName(coords[j].getName());
+		task->setActive(true);
+		task->setWeight(1.0);
+		task->setKP(100.0);
+		task->setKV(20.0);
+		tasks.adoptAndAppend(task);
+	}
+	tasks.print("gait2354_cmc_tasks.xml");
+
+	CMCTool cmc;
+	cmc.setName("gait2354_cmc");
+	cmc.setModelFilename("gait2354_cmc.osim");
+	cmc.setDesiredKinematicsFileName("gait2354_cmc_kinematics.sto");
+	cmc.setTaskSetFileName("gait2354_cmc_tasks.xml");
+	cmc.setInitialTime(0.0);
+	cmc.setFinalTime(duration);
+	cmc.setTimeWindow(0.01);
+	cmc.setResultsDir("Results_CMC");
+	cmc.print(setupFile);
+}
+
+double runCMC(const string& setupFile, const string& name, int numThreads)
+{
+	CMCTool cmc(setupFile);
+	cmc.setName(name);
+	cmc.setNumThreads(numThreads);
+
+	double start = SimTK::realTime();
+	ASSERT(cmc.run(), __FILE__, __LINE__, "testCMCTool: CMC failed.");
+	return SimTK::realTime()-start;
+}
+
+void testParallelConstraintMatrix(const string& setupFile)
+{
+	double sequentialTime = runCMC(setupFile, "gait2354_cmc_sequential", 1);
+	double parallelTime = runCMC(setupFile, "gait2354_cmc_parallel", 0);
+
+	// The constraint matrices are identical, so the optimizer follows the
+	// same iterates in both runs.
+	Storage sequential("Results_CMC/gait2354_cmc_sequential_Actuation_force.sto");
+	Storage parallel("Results_CMC/gait2354_cmc_parallel_Actuation_force.sto");
+	int n = sequential.getSize();
+	ASSERT(n > 0 && parallel.getSize() == n, __FILE__, __LINE__);
+	int nc = sequential.getColumnLabels().getSize()-1;
+	ASSERT(parallel.getColumnLabels().getSize()-1 == nc, __FILE__, __LINE__);
+	for(int i=0; i<n; ++i){
+		const Array<double>& fs = sequential.getStateVector(i)->getData();
+		const Array<double>& fp = parallel.getStateVector(i)->getData();
+		for(int j=0; j<nc; ++j){
+			ASSERT(fp[j] == fs[j], __FILE__, __LINE__,
+				"testParallelConstraintMatrix: parallel actuator forces differ.");
+		}
+	}
+
+	cout << "*********************** testParallelConstraintMatrix ***********************" << endl;
+	cout << "MODEL: gait2354_cmc.osim, " << n << " frames." << endl;
+	cout << "Sequential: " << sequentialTime << "s, parallel on "
+		 << SimTK::ParallelExecutor::getNumProcessors() << " processors: "
+		 << parallelTime << "s." << endl;
+}
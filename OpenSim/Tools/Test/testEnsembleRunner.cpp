@@ -0,0 +1,246 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testEnsembleRunner.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testEnsembleRunner runs ensembles of arm26 simulations and verifies that
+//
+//		1. the results on four threads are identical to those on one,
+//		2. property overrides, control sets and initial states take effect
+//		   without changing the ensemble's model,
+//		3. a failed member does not stop the others,
+//
+//  and reports the Monte Carlo throughput (simulations per minute) against
+//  the number of threads.
+//==============================================================================
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Tools/EnsembleRunner.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+const static double finalTime = 0.2;
+
+void testThreadsGiveIdenticalResults();
+void testMemberSpecifications();
+void testFailedMember();
+void reportThroughput(int numMembers);
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testThreadsGiveIdenticalResults();
+		cout << "Identical results on 1 and 4 threads: PASSED\n" << endl;
+		testMemberSpecifications();
+		cout << "Overrides, control sets and initial states: PASSED\n" << endl;
+		testFailedMember();
+		cout << "Failed member: PASSED\n" << endl;
+		reportThroughput(16);
+	}
+	catch (const std::exception& e) {
+		cout << "testEnsembleRunner failed: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+//______________________________________________________________________________
+// Values of a state over time; state labels may carry the path of the state
+// (e.g., r_elbow/r_elbow_flex).
+static Array<double> stateValues(const Storage& states, const string& name)
+{
+	const Array<string>& labels = states.getColumnLabels();
+	for(int i = 1; i < labels.getSize(); ++i) {
+		const string& label = labels[i];
+		if(label == name || (label.length() > name.length() &&
+			label.compare(label.length()-name.length()-1, string::npos,
+						  "/"+name) == 0)) {
+			Array<double> values;
+			states.getDataColumn(i-1, values);
+			return values;
+		}
+	}
+	throw Exception("No column for " + name + " in " + states.getName());
+}
+
+static double firstValue(const Storage& states, const string& name)
+{
+	return stateValues(states, name)[0];
+}
+
+static double finalValue(const Storage& states, const string& name)
+{
+	return stateValues(states, name).getLast();
+}
+
+// An ensemble that exercises every kind of member specification.
+static void addMembers(EnsembleRunner& ensemble)
+{
+	ControlSet controls("arm26_controls.xml");
+	for(int i = 0; i < 6; ++i) {
+		EnsembleMember member;
+		if(i % 3 == 1)
+			member.setPropertyOverride("BIClong", "max_isometric_force",
+									   400.0 + 100.0*i);
+		if(i % 3 == 2)
+			member.setControlSet(controls);
+		member.setInitialState("r_elbow_flex", 0.1*i);
+		ensemble.addMember(member);
+	}
+}
+
+static void runEnsemble(EnsembleRunner& ensemble, int numThreads)
+{
+	ensemble.setFinalTime(finalTime);
+	ensemble.setNumThreads(numThreads);
+	int numCompleted = ensemble.run();
+	ASSERT(numCompleted == ensemble.getNumMembers(), __FILE__, __LINE__,
+		"runEnsemble: not all members completed.");
+}
+
+void testThreadsGiveIdenticalResults()
+{
+	EnsembleRunner serial("arm26.osim"), parallel("arm26.osim");
+	addMembers(serial);
+	addMembers(parallel);
+	runEnsemble(serial, 1);
+	runEnsemble(parallel, 4);
+
+	for(int i = 0; i < serial.getNumMembers(); ++i) {
+		const Storage& expected = serial.getStateStorage(i);
+		const Storage& found = parallel.getStateStorage(i);
+		ASSERT(expected.getSize() == found.getSize(), __FILE__, __LINE__,
+			"testThreadsGiveIdenticalResults: numbers of steps differ.");
+		for(int r = 0; r < expected.getSize(); ++r) {
+			const StateVector& e = *expected.getStateVector(r);
+			const StateVector& f = *found.getStateVector(r);
+			ASSERT(e.getTime() == f.getTime() && e.getSize() == f.getSize(),
+				__FILE__, __LINE__,
+				"testThreadsGiveIdenticalResults: rows differ.");
+			for(int j = 0; j < e.getSize(); ++j)
+				ASSERT(e.getData()[j] == f.getData()[j], __FILE__, __LINE__,
+					"testThreadsGiveIdenticalResults: states differ.");
+		}
+	}
+}
+
+void testMemberSpecifications()
+{
+	EnsembleRunner ensemble("arm26.osim");
+	double fmax = dynamic_cast<const Muscle&>(
+		ensemble.getModel().getForceSet().get("BIClong")).getMaxIsometricForce();
+
+	EnsembleMember baseline("baseline");
+	int b = ensemble.addMember(baseline);
+
+	EnsembleMember stronger("stronger");
+	stronger.setPropertyOverride("BIClong", "max_isometric_force", 3*fmax);
+	int s = ensemble.addMember(stronger);
+
+	EnsembleMember controlled("controlled");
+	controlled.setControlSet(ControlSet("arm26_controls.xml"));
+	int c = ensemble.addMember(controlled);
+
+	EnsembleMember flexed("flexed");
+	flexed.setInitialState("r_elbow_flex", 1.0);
+	flexed.setInitialState("r_shoulder_elev", -0.2);
+	int f = ensemble.addMember(flexed);
+
+	runEnsemble(ensemble, 2);
+
+	// The members' copies were modified, not the ensemble's model.
+	ASSERT(dynamic_cast<const Muscle&>(ensemble.getModel().getForceSet()
+		.get("BIClong")).getMaxIsometricForce() == fmax, __FILE__, __LINE__,
+		"testMemberSpecifications: the override changed the ensemble's model.");
+
+	const Storage& baseStates = ensemble.getStateStorage(b);
+	double baseElbow = finalValue(baseStates, "r_elbow_flex");
+	ASSERT(finalValue(ensemble.getStateStorage(s), "r_elbow_flex") != baseElbow,
+		__FILE__, __LINE__,
+		"testMemberSpecifications: the property override had no effect.");
+	ASSERT(finalValue(ensemble.getStateStorage(c), "r_elbow_flex") != baseElbow,
+		__FILE__, __LINE__,
+		"testMemberSpecifications: the control set had no effect.");
+
+	const Storage& flexedStates = ensemble.getStateStorage(f);
+	ASSERT_EQUAL(1.0, firstValue(flexedStates, "r_elbow_flex"), 1e-10,
+		__FILE__, __LINE__,
+		"testMemberSpecifications: the initial elbow angle was not set.");
+	ASSERT_EQUAL(-0.2, firstValue(flexedStates, "r_shoulder_elev"), 1e-10,
+		__FILE__, __LINE__,
+		"testMemberSpecifications: the initial shoulder angle was not set.");
+	ASSERT_EQUAL(0.0, firstValue(baseStates, "r_elbow_flex"), 1e-10,
+		__FILE__, __LINE__,
+		"testMemberSpecifications: an initial state leaked between members.");
+}
+
+void testFailedMember()
+{
+	EnsembleRunner ensemble("arm26.osim");
+	ensemble.addMember(EnsembleMember("good"));
+	EnsembleMember bad("bad");
+	bad.setPropertyOverride("NoSuchMuscle", "max_isometric_force", 1.0);
+	int i = ensemble.addMember(bad);
+	ensemble.addMember(EnsembleMember("alsoGood"));
+
+	ensemble.setFinalTime(finalTime);
+	ensemble.setNumThreads(2);
+	ASSERT(ensemble.run() == 2, __FILE__, __LINE__,
+		"testFailedMember: the good members did not complete.");
+	ASSERT(!ensemble.getCompleted(i) && !ensemble.getError(i).empty(),
+		__FILE__, __LINE__, "testFailedMember: the failure was not recorded.");
+	ASSERT_THROW(OpenSim::Exception, ensemble.getStateStorage(i));
+}
+
+// Monte Carlo study of the strength of the biceps, run on 1, 2, 4, ...
+// threads up to the number of processors.
+void reportThroughput(int numMembers)
+{
+	Model model("arm26.osim");
+	SimTK::Random::Uniform random(0.5, 1.5);
+	random.setSeed(numMembers);
+	Array<double> scales;
+	for(int i = 0; i < numMembers; ++i)
+		scales.append(random.getValue());
+
+	int maxThreads = SimTK::ParallelExecutor::getNumProcessors();
+	cout << "************************* reportThroughput *************************"
+		 << endl;
+	for(int numThreads = 1; ; numThreads *= 2) {
+		if(numThreads > maxThreads) numThreads = maxThreads;
+		EnsembleRunner ensemble(model);
+		for(int i = 0; i < numMembers; ++i) {
+			EnsembleMember member;
+			member.setPropertyOverride("BIClong", "max_isometric_force",
+									   624.3*scales[i]);
+			ensemble.addMember(member);
+		}
+		double start = SimTK::realTime();
+		runEnsemble(ensemble, numThreads);
+		double elapsed = SimTK::realTime() - start;
+		cout << numThreads << " thread(s): " << 60.0*numMembers/elapsed
+			 << " simulations per minute." << endl;
+		if(numThreads >= maxThreads) break;
+	}
+}
@@ -0,0 +1,251 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testInverseKinematicsTool.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testInverseKinematicsTool generates a long synthetic marker trajectory
+//  (100k frames at 1kHz) from known motion of the arm26 model, then
+//  1. looks up the markers of every frame through a MarkersReference and
+//     checks that the frame nearest in time is returned, and
+//  2. runs the InverseKinematicsTool on the trajectory, checks the recovered
+//     coordinates against the known motion and reports the time taken, and
+//  3. runs it again with the frames solved in chunks on all processors,
+//     checks the result against the sequential one and reports the time
+//     taken and the discrepancy between chunks.
+//==============================================================================
+#include <fstream>
+#include <iomanip>
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/IKTaskSet.h>
+#include <OpenSim/Tools/IKMarkerTask.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void writeSyntheticMarkerFile(const string& modelFile, const string& markerFile,
+							  int nFrames, double rate);
+void testMarkersReferenceLookup(const string& markerFile, int nFrames, double rate);
+void testInverseKinematicsTool(const string& modelFile, const string& markerFile,
+							   int nFrames, double rate);
+void testChunkedInverseKinematics(const string& modelFile, const string& markerFile,
+								  int nFrames, double rate);
+
+// known motion of the arm coordinates
+static double shoulderAngle(double t) { return 0.5 + 0.4*sin(SimTK::Pi*t); }
+static double elbowAngle(double t) { return 1.0 + 0.6*sin(1.4*SimTK::Pi*t); }
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		int nFrames = 100000;
+		double rate = 1000.0;
+		writeSyntheticMarkerFile("arm26.osim", "arm26_synthetic_markers.trc", nFrames, rate);
+		testMarkersReferenceLookup("arm26_synthetic_markers.trc", nFrames, rate);
+		testInverseKinematicsTool("arm26.osim", "arm26_synthetic_markers.trc", nFrames, rate);
+		testChunkedInverseKinematics("arm26.osim", "arm26_synthetic_markers.trc", nFrames, rate);
+	}
+	catch (const Exception& e) {
+		e.print(cerr);
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+void writeSyntheticMarkerFile(const string& modelFile, const string& markerFile,
+							  int nFrames, double rate)
+{
+	Model model(modelFile);
+	SimTK::State& s = model.initSystem();
+
+	const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+	const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+	const MarkerSet& markers = model.getMarkerSet();
+	int nm = markers.getSize();
+
+	ofstream out(markerFile.c_str());
+	out << "PathFileType\t4\t(X/Y/Z)\t" << markerFile << endl;
+	out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames" << endl;
+	out << rate << "\t" << rate << "\t" << nFrames << "\t" << nm << "\tm\t" << rate << "\t1\t" << nFrames << endl;
+	out << "Frame#\tTime";
+	for(int j=0; j<nm; ++j)
+		out << "\t" << markers[j].getName() << "\t\t";
+	out << endl << "\t";
+	for(int j=0; j<nm; ++j)
+		out << "\tX" << j+1 << "\tY" << j+1 << "\tZ" << j+1;
+	out << endl << endl;
+
+	out.setf(ios::fixed);
+	SimTK::Vec3 location;
+	for(int i=0; i<nFrames; ++i){
+		double t = i/rate;
+		shoulder.setValue(s, shoulderAngle(t), false);
+		elbow.setValue(s, elbowAngle(t), false);
+		model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+
+		out << setprecision(6) << i+1 << "\t" << t;
+		out << setprecision(8);
+		for(int j=0; j<nm; ++j){
+			model.getSimbodyEngine().transformPosition(s, markers[j].getBody(),
+				markers[j].getOffset(), model.getGroundBody(), location);
+			out << "\t" << location[0] << "\t" << location[1] << "\t" << location[2];
+		}
+		out << endl;
+	}
+	out.close();
+}
+
+void testMarkersReferenceLookup(const string& markerFile, int nFrames, double rate)
+{
+	MarkerData markerData(markerFile);
+	MarkersReference markersReference(markerData);
+	ASSERT(markerData.getNumFrames() == nFrames, __FILE__, __LINE__);
+
+	SimTK::State s;
+	SimTK::Array_<SimTK::Vec3> values;
+	double start = SimTK::realTime();
+	for(int i=0; i<nFrames; ++i){
+		// times between samples must resolve to the nearest frame
+		s.updTime() = (i + 0.3)/rate;
+		markersReference.getValues(s, values);
+		const SimTK::Array_<SimTK::Vec3>& expected = markerData.getFrame(i).getMarkers();
+		ASSERT(values.size() == expected.size(), __FILE__, __LINE__);
+		for(unsigned int j=0; j<values.size(); ++j)
+			ASSERT(values[j] == expected[j], __FILE__, __LINE__,
+				"testMarkersReferenceLookup: markers of the wrong frame returned.");
+	}
+	double lookupTime = SimTK::realTime()-start;
+
+	cout << "*********************** testMarkersReferenceLookup ***********************" << endl;
+	cout << nFrames << " frames looked up in " << lookupTime << "s." << endl;
+}
+
+void testInverseKinematicsTool(const string& modelFile, const string& markerFile,
+							   int nFrames, double rate)
+{
+	Model model(modelFile);
+
+	InverseKinematicsTool ik;
+	ik.setName("arm26_synthetic");
+	ik.setModel(model);
+	ik.setMarkerDataFileName(markerFile);
+	ik.setStartTime(0.0);
+	ik.setEndTime((nFrames-1)/rate);
+	ik.setOutputMotionFileName("arm26_synthetic_ik.mot");
+	ik.getPropertySet().get("report_errors")->setValue(false);
+
+	const MarkerSet& markers = model.getMarkerSet();
+	for(int j=0; j<markers.getSize(); ++j){
+		IKMarkerTask* task = new IKMarkerTask();
+		task->setName(markers[j].getName());
+		task->setApply(true);
+		task->setWeight(1.0);
+		ik.getIKTaskSet().adoptAndAppend(task);
+	}
+
+	double start = SimTK::realTime();
+	ASSERT(ik.run(), __FILE__, __LINE__, "testInverseKinematicsTool: IK failed.");
+	double ikTime = SimTK::realTime()-start;
+
+	// Recovered coordinates (in degrees) must follow the known motion
+	Storage result("arm26_synthetic_ik.mot");
+	// the tool derives its frame count from the time range, so round-off may
+	// drop the last frame
+	int n = result.getSize();
+	ASSERT(n >= nFrames-1 && n <= nFrames, __FILE__, __LINE__);
+	Array<double> time, shoulder, elbow;
+	result.getTimeColumn(time);
+	result.getDataColumn("r_shoulder_elev", shoulder);
+	result.getDataColumn("r_elbow_flex", elbow);
+	for(int i=0; i<n; i+=997){
+		ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*shoulderAngle(time[i]), shoulder[i], 1e-2,
+			__FILE__, __LINE__, "testInverseKinematicsTool: shoulder angle not recovered.");
+		ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*elbowAngle(time[i]), elbow[i], 1e-2,
+			__FILE__, __LINE__, "testInverseKinematicsTool: elbow angle not recovered.");
+	}
+
+	cout << "*********************** testInverseKinematicsTool ***********************" << endl;
+	cout << "MODEL: " << modelFile << ", " << nFrames << " frames at " << rate << "Hz." << endl;
+	cout << "Inverse kinematics: " << ikTime << "s ("
+		 << 1.0e6*ikTime/nFrames << "us per frame)." << endl;
+}
+
+void testChunkedInverseKinematics(const string& modelFile, const string& markerFile,
+								  int nFrames, double rate)
+{
+	Model model(modelFile);
+
+	InverseKinematicsTool ik;
+	ik.setName("arm26_synthetic_chunked");
+	ik.setModel(model);
+	ik.setMarkerDataFileName(markerFile);
+	ik.setStartTime(0.0);
+	ik.setEndTime((nFrames-1)/rate);
+	ik.setOutputMotionFileName("arm26_synthetic_ik_chunked.mot");
+	ik.getPropertySet().get("report_errors")->setValue(false);
+	ik.setNumThreads(0);
+	ik.setChunkOverlap(20);
+
+	const MarkerSet& markers = model.getMarkerSet();
+	for(int j=0; j<markers.getSize(); ++j){
+		IKMarkerTask* task = new IKMarkerTask();
+		task->setName(markers[j].getName());
+		task->setApply(true);
+		task->setWeight(1.0);
+		ik.getIKTaskSet().adoptAndAppend(task);
+	}
+
+	double start = SimTK::realTime();
+	ASSERT(ik.run(), __FILE__, __LINE__, "testChunkedInverseKinematics: IK failed.");
+	double ikTime = SimTK::realTime()-start;
+
+	// Every frame, including the first of each chunk, agrees with the
+	// sequential solution to within the accuracy of the solver
+	Storage sequential("arm26_synthetic_ik.mot");
+	Storage chunked("arm26_synthetic_ik_chunked.mot");
+	int n = sequential.getSize();
+	ASSERT(chunked.getSize() == n, __FILE__, __LINE__);
+	Array<double> shoulder, elbow, chunkedShoulder, chunkedElbow;
+	sequential.getDataColumn("r_shoulder_elev", shoulder);
+	sequential.getDataColumn("r_elbow_flex", elbow);
+	chunked.getDataColumn("r_shoulder_elev", chunkedShoulder);
+	chunked.getDataColumn("r_elbow_flex", chunkedElbow);
+	for(int i=0; i<n; ++i){
+		ASSERT_EQUAL(shoulder[i], chunkedShoulder[i], 1e-3, __FILE__, __LINE__,
+			"testChunkedInverseKinematics: shoulder angle differs from sequential solution.");
+		ASSERT_EQUAL(elbow[i], chunkedElbow[i], 1e-3, __FILE__, __LINE__,
+			"testChunkedInverseKinematics: elbow angle differs from sequential solution.");
+	}
+	ASSERT(ik.getMaxChunkDiscrepancy() < 1e-4, __FILE__, __LINE__,
+		"testChunkedInverseKinematics: chunks disagree over their overlap.");
+
+	cout << "*********************** testChunkedInverseKinematics ***********************" << endl;
+	cout << "MODEL: " << modelFile << ", " << nFrames << " frames at " << rate << "Hz on "
+		 << SimTK::ParallelExecutor::getNumProcessors() << " processors." << endl;
+	cout << "Inverse kinematics: " << ikTime << "s ("
+		 << 1.0e6*ikTime/nFrames << "us per frame), max discrepancy between chunks "
+		 << ik.getMaxChunkDiscrepancy() << "." << endl;
+}
@@ -0,0 +1,285 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testSetNameLookup.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2012 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//==============================================================================
+//	testSetNameLookup
+//  1. checks that objects of a Set are found by name, with and without the
+//     name index, as the set is appended to, inserted into, removed from,
+//     copied and cleared, and as its objects are renamed, and
+//  2. adds thousands of markers to the gait2354 model, then loads the model
+//     and sets up and runs inverse kinematics on them with name lookups by
+//     index and by linear search, checks the results are identical and
+//     reports the time taken by each.
+//==============================================================================
+#include <fstream>
+#include <sstream>
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Tools/IKTaskSet.h>
+#include <OpenSim/Tools/IKMarkerTask.h>
+#include <OpenSim/Common/NameIndex.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testSetLookups();
+void writeLargeModel(const string& modelFile, const string& largeModelFile,
+					 const string& markerFile, int nMarkers, int nFrames);
+void testLargeModelSetup(const string& largeModelFile, const string& markerFile,
+						 int nFrames);
+
+int main()
+{
+	try {
+		LoadOpenSimLibrary("osimActuators");
+		testSetLookups();
+		writeLargeModel("gait2354_simbody.osim", "gait2354_markers.osim",
+			"gait2354_markers.trc", 3000, 10);
+		testLargeModelSetup("gait2354_markers.osim", "gait2354_markers.trc", 10);
+	}
+	catch (const std::exception& e) {
+		cout << "testSetNameLookup failed: " << e.what() << endl;
+		return 1;
+	}
+	cout << "Done" << endl;
+	return 0;
+}
+
+static string markerName(int i)
+{
+	ostringstream name;
+	name << "marker_" << i;
+	return name.str();
+}
+
+// Every name sought, from every start index, must be found where a linear
+// search finds it.
+static void checkLookups(const MarkerSet& markers, int nNames)
+{
+	int n = markers.getSize();
+	for(int i=0; i<nNames; ++i){
+		string name = markerName(i);
+		for(int start=0; start<n; start+=7){
+			NameIndex::setEnabled(false);
+			int expected = markers.getIndex(name, start);
+			NameIndex::setEnabled(true);
+			ASSERT(markers.getIndex(name, start) == expected, __FILE__, __LINE__,
+				"testSetLookups: "+name+" not found where a linear search finds it.");
+		}
+		ASSERT(markers.contains(name) == (markers.getIndex(name) >= 0),
+			__FILE__, __LINE__);
+	}
+}
+
+void testSetLookups()
+{
+	int n = 200;
+	MarkerSet markers;
+	for(int i=0; i<n; ++i){
+		Marker* marker = new Marker();
+		marker->setName(markerName(i));
+		markers.adoptAndAppend(marker);
+	}
+	checkLookups(markers, n+10);
+
+	// removal and insertion shift the objects that follow
+	markers.remove(17);
+	markers.remove(markers.getSize()-1);
+	Marker* inserted = new Marker();
+	inserted->setName(markerName(n+1));
+	markers.insert(3, inserted);
+	checkLookups(markers, n+10);
+	ASSERT(markers.getIndex(markerName(n+1)) == 3, __FILE__, __LINE__);
+	ASSERT(markers.getIndex(markerName(17)) == -1, __FILE__, __LINE__);
+
+	// renamed objects are found by their new names only
+	string oldName = markers[50].getName();
+	markers[50].setName(markerName(n+2));
+	markers[70].setName(markerName(n+3));
+	markers[70].setName(markerName(n+4));
+	checkLookups(markers, n+10);
+	ASSERT(markers.getIndex(markerName(n+2)) == 50, __FILE__, __LINE__);
+	ASSERT(markers.getIndex(markerName(n+4)) == 70, __FILE__, __LINE__);
+	ASSERT(!markers.contains(oldName), __FILE__, __LINE__);
+	ASSERT(!markers.contains(markerName(n+3)), __FILE__, __LINE__);
+
+	// objects named after they are appended, as by deserialization
+	int nUnnamed = 20;
+	for(int i=0; i<nUnnamed; ++i)
+		markers.adoptAndAppend(new Marker());
+	ASSERT(!markers.contains(markerName(n+5)), __FILE__, __LINE__);
+	for(int i=0; i<nUnnamed; ++i)
+		markers[markers.getSize()-nUnnamed+i].setName(markerName(n+5+i));
+	checkLookups(markers, n+5+nUnnamed);
+
+	// an object renamed to the name of another may be found in place of
+	// it, until the array changes
+	markers[60].setName(markerName(10));
+	markers[80].setName(markerName(90));
+	const string duplicated[] = { markerName(10), markerName(90) };
+	for(int i=0; i<2; ++i){
+		ASSERT(markers[markers.getIndex(duplicated[i])].getName() == duplicated[i],
+			__FILE__, __LINE__);
+		for(int start=0; start<markers.getSize(); start+=7){
+			int index = markers.getIndex(duplicated[i], start);
+			ASSERT(markers[index].getName() == duplicated[i], __FILE__, __LINE__);
+		}
+	}
+
+	MarkerSet copy(markers);
+	checkLookups(copy, n+5+nUnnamed);
+
+	markers.setSize(0);
+	checkLookups(markers, n+10);
+	for(int i=n-1; i>=0; --i){
+		Marker* marker = new Marker();
+		marker->setName(markerName(i));
+		markers.adoptAndAppend(marker);
+	}
+	checkLookups(markers, n+10);
+	ASSERT(markers.getIndex(markerName(0)) == n-1, __FILE__, __LINE__);
+
+	markers.clearAndDestroy();
+	ASSERT(markers.getIndex(markerName(0)) == -1, __FILE__, __LINE__);
+
+	cout << "*********************** testSetLookups ***********************" << endl;
+	cout << "Lookups by index match linear search." << endl;
+}
+
+void writeLargeModel(const string& modelFile, const string& largeModelFile,
+					 const string& markerFile, int nMarkers, int nFrames)
+{
+	Model model(modelFile);
+	BodySet& bodies = model.updBodySet();
+	int nb = bodies.getSize();
+
+	// Markers spread over the bodies other than ground
+	MarkerSet& markers = model.updMarkerSet();
+	markers.clearAndDestroy();
+	for(int i=0; i<nMarkers; ++i){
+		double offset[3] = { 0.05*sin(0.7*i), 0.1*cos(1.3*i), 0.05*sin(2.1*i) };
+		markers.addMarker(markerName(i), offset, bodies[1+i%(nb-1)]);
+	}
+	model.print(largeModelFile);
+
+	Model large(largeModelFile);
+	SimTK::State& s = large.initSystem();
+	const MarkerSet& largeMarkers = large.getMarkerSet();
+	ASSERT(largeMarkers.getSize() == nMarkers, __FILE__, __LINE__);
+
+	// The markers of the default pose, in every frame
+	ofstream out(markerFile.c_str());
+	out << "PathFileType\t4\t(X/Y/Z)\t" << markerFile << endl;
+	out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\tOrigDataRate\tOrigDataStartFrame\tOrigNumFrames" << endl;
+	out << "100\t100\t" << nFrames << "\t" << nMarkers << "\tm\t100\t1\t" << nFrames << endl;
+	out << "Frame#\tTime";
+	for(int j=0; j<nMarkers; ++j)
+		out << "\t" << largeMarkers[j].getName() << "\t\t";
+	out << endl << "\t";
+	for(int j=0; j<nMarkers; ++j)
+		out << "\tX" << j+1 << "\tY" << j+1 << "\tZ" << j+1;
+	out << endl << endl;
+
+	large.getMultibodySystem().realize(s, SimTK::Stage::Position);
+	SimTK::Vector_<SimTK::Vec3> locations(nMarkers);
+	for(int j=0; j<nMarkers; ++j){
+		large.getSimbodyEngine().transformPosition(s, largeMarkers[j].getBody(),
+			largeMarkers[j].getOffset(), large.getGroundBody(), locations[j]);
+	}
+	out.precision(10);
+	for(int i=0; i<nFrames; ++i){
+		out << i+1 << "\t" << 0.01*i;
+		for(int j=0; j<nMarkers; ++j)
+			out << "\t" << locations[j][0] << "\t" << locations[j][1] << "\t" << locations[j][2];
+		out << endl;
+	}
+	out.close();
+}
+
+// Load the model and set up and run inverse kinematics on all of its markers,
+// returning the times taken to load and to run.
+static void runLargeModel(const string& largeModelFile, const string& markerFile,
+						  int nFrames, const string& name,
+						  double& loadTime, double& ikTime)
+{
+	double start = SimTK::realTime();
+	Model model(largeModelFile);
+	model.initSystem();
+	loadTime = SimTK::realTime()-start;
+
+	start = SimTK::realTime();
+	InverseKinematicsTool ik;
+	ik.setName(name);
+	ik.setModel(model);
+	ik.setMarkerDataFileName(markerFile);
+	ik.setStartTime(0.0);
+	ik.setEndTime(0.01*(nFrames-1));
+	ik.setOutputMotionFileName(name+".mot");
+	ik.getPropertySet().get("report_errors")->setValue(false);
+	const MarkerSet& markers = model.getMarkerSet();
+	for(int j=0; j<markers.getSize(); ++j){
+		IKMarkerTask* task = new IKMarkerTask();
+		task->setName(markers[j].getName());
+		task->setApply(true);
+		task->setWeight(1.0);
+		ik.getIKTaskSet().adoptAndAppend(task);
+	}
+	ASSERT(ik.run(), __FILE__, __LINE__, "testLargeModelSetup: IK failed.");
+	ikTime = SimTK::realTime()-start;
+}
+
+void testLargeModelSetup(const string& largeModelFile, const string& markerFile,
+						 int nFrames)
+{
+	double linearLoad, linearIK, indexedLoad, indexedIK;
+	NameIndex::setEnabled(false);
+	runLargeModel(largeModelFile, markerFile, nFrames, "gait2354_markers_linear",
+		linearLoad, linearIK);
+	NameIndex::setEnabled(true);
+	runLargeModel(largeModelFile, markerFile, nFrames, "gait2354_markers_indexed",
+		indexedLoad, indexedIK);
+
+	Storage linear("gait2354_markers_linear.mot");
+	Storage indexed("gait2354_markers_indexed.mot");
+	int n = linear.getSize();
+	ASSERT(n > 0 && indexed.getSize() == n, __FILE__, __LINE__);
+	int nc = linear.getColumnLabels().getSize()-1;
+	for(int i=0; i<n; ++i){
+		const Array<double>& ql = linear.getStateVector(i)->getData();
+		const Array<double>& qi = indexed.getStateVector(i)->getData();
+		for(int j=0; j<nc; ++j){
+			ASSERT(qi[j] == ql[j], __FILE__, __LINE__,
+				"testLargeModelSetup: coordinates differ with the name index.");
+		}
+	}
+
+	cout << "*********************** testLargeModelSetup ***********************" << endl;
+	cout << "MODEL: " << largeModelFile << ", "
+		 << indexed.getColumnLabels().getSize()-1 << " coordinates, "
+		 << n << " frames." << endl;
+	cout << "Linear search: load " << linearLoad << "s, inverse kinematics "
+		 << linearIK << "s." << endl;
+	cout << "Name index: load " << indexedLoad << "s, inverse kinematics "
+		 << indexedIK << "s." << endl;
+}
@@ -50,6 +50,8 @@ using namespace std;
  */
 VectorFunctionForActuators::~VectorFunctionForActuators()
 {
+	delete _timeStepper;
+	delete _integrator;
 }
 //_____________________________________________________________________________
 /**
@@ -106,6 +108,8 @@ setNull()
 	_CMCActuatorSubsystem = NULL;
     _model             = NULL;
 	_integrator        = NULL;
+	_timeStepper       = NULL;
+	_controller        = NULL;
 }
 
 //_____________________________________________________________________________
@@ -259,30 +263,29 @@ evaluate( const SimTK::State& s, double *aX, double *rF)
 	int i;
 	int N = getNX();
 
-    CMC& controller=  dynamic_cast<CMC&>(_model->updControllerSet().get("CMC" ));
-    controller.updControlSet().setControlValues(_tf, aX);
-
-    // create a Manager that will integrate just the actuator subsystem and use only the 
-    // CMC controller
+	// The controller, time stepper and actuator system state are set up on
+	// the first evaluation and reused by the many that follow in a root solve.
+	if(_controller==NULL) {
+		_controller = &dynamic_cast<CMC&>(_model->updControllerSet().get("CMC" ));
+	}
+	if(_timeStepper==NULL) {
+		_actSysState = _CMCActuatorSystem->getDefaultState();
+		_timeStepper = new SimTK::TimeStepper(*_CMCActuatorSystem, *_integrator);
+	}
+    _controller->updControlSet().setControlValues(_tf, aX);
 
-	Manager manager(*_model, *_integrator);
-    manager.setInitialTime(_ti);
-	manager.setFinalTime(_tf);
-    manager.setSystem( _CMCActuatorSystem );
-    // tell the mangager to not call the analayses or write to storage 
-    // while the CMCSubsystem is being integrated.
-	manager.setPerformAnalyses(false); 
-	manager.setWriteToStorage(false); 
-	SimTK::State& actSysState = _CMCActuatorSystem->updDefaultState();
-	getCMCActSubsys()->updZ(actSysState) = _model->getMultibodySystem()
+	// Integrate just the actuator subsystem over the target window, starting
+	// from the actuator states of the model. This is what a Manager without
+	// analyses or storage would do.
+	getCMCActSubsys()->updZ(_actSysState) = _model->getMultibodySystem()
                                             .getDefaultSubsystem().getZ(s);
-
-    actSysState.setTime(_ti);
+    _actSysState.setTime(_ti);
 
 	// Integration
-    manager.integrate(actSysState, 0.000001);
+	_timeStepper->initialize(_actSysState);
+	_timeStepper->stepTo(_tf);
 
-    const Set<Actuator>& forceSet = controller.getActuatorSet();
+    const Set<Actuator>& forceSet = _controller->getActuatorSet();
 	// Vector function values
 	int j = 0;
 	for(i=0;i<N;i++) {
@@ -50,6 +50,8 @@
  */
 namespace OpenSim { 
 
+class CMC;
+
 class VectorFunctionForActuators : public VectorFunctionUncoupledNxN {
 OpenSim_DECLARE_CONCRETE_OBJECT(VectorFunctionForActuators, 
                                 VectorFunctionUncoupledNxN);
@@ -70,6 +72,12 @@ protected:
 	CMCActuatorSubsystem* _CMCActuatorSubsystem;
 	/** Integrator. */
 	SimTK::Integrator* _integrator;
+	/** Time stepper for the actuator system, kept between evaluations. */
+	SimTK::TimeStepper* _timeStepper;
+	/** State of the actuator system that is integrated by each evaluation. */
+	SimTK::State _actSysState;
+	/** CMC controller whose controls are set by each evaluation. */
+	CMC* _controller;
     /** Model */
     Model* _model;
 
@@ -27,6 +27,7 @@
 #include "CMCTool.h"
 #include "ForwardTool.h"
 #include "AnalyzeTool.h"
+#include "EnsembleRunner.h"
 
 #include "InverseKinematicsTool.h"
 #include "GenericModelMaker.h"
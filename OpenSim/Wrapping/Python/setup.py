@@ -14,6 +14,7 @@ setup(name='opensim',
       packages=['opensim'],
       package_data={'opensim': ['_opensim.*']},
       include_package_data=True,
+      install_requires=['numpy'],
       classifiers=[
           'Intended Audience :: Science/Research',
           'Operating System :: OS Independent',
@@ -661,7 +661,20 @@ JOINT_ADOPT_HELPER(PlanarJoint);
 		  return availableClassNames;
 	}
 }
+*/
 
+// NumPy
+// =====
+/*
+Data held in contiguous memory on the C++ side (Array<double>, SimTK::Vector,
+the Q, U and Z of a State and the columns of a columnar Storage) are handed to
+Python as NumPy arrays that view that memory rather than copies of it, and can
+be set in bulk from NumPy arrays, so that large trials need not be moved one
+element at a time through the proxies. A view keeps the Python object it was
+taken from alive, but not the memory itself: it is invalidated by anything
+that resizes or reallocates the data (e.g., appending to an Array or a
+Storage), just like a pointer to the data would be in C++.
+*/
 %include "numpy.i"
 
 %init %{
@@ -669,7 +682,257 @@ import_array();
 %}
 
 %apply (double* IN_ARRAY1, int DIM1) {(double* dValues, int size)}
-*/
+%apply (double* IN_ARRAY1, int DIM1) {(double* times, int nTimes)}
+%apply (double* IN_ARRAY2, int DIM1, int DIM2)
+    {(double* rows, int nRows, int nColumns)}
+
+%{
+namespace {
+// Make a NumPy array of doubles that views the given memory. Strides are in
+// elements. The array keeps owner (the proxy of the object that holds the
+// memory) alive; it is writable only if writable is true.
+PyObject* createNumPyView(const double* data, int nd, const npy_intp* dims,
+                          const npy_intp* strides, bool writable,
+                          PyObject* owner)
+{
+    npy_intp byteStrides[2];
+    for (int i = 0; i < nd; ++i)
+        byteStrides[i] = strides[i]*(npy_intp)sizeof(double);
+    int flags = NPY_ARRAY_ALIGNED | (writable ? NPY_ARRAY_WRITEABLE : 0);
+    PyObject* array = PyArray_New(&PyArray_Type, nd,
+        const_cast<npy_intp*>(dims), NPY_DOUBLE, byteStrides,
+        const_cast<double*>(data), 0, flags, NULL);
+    if (array && owner && owner != Py_None) {
+        Py_INCREF(owner);
+        PyArray_SetBaseObject((PyArrayObject*)array, owner);
+    }
+    return array;
+}
+
+PyObject* createNumPyView(const double* data, int n, int stride,
+                          bool writable, PyObject* owner)
+{
+    npy_intp dims[1] = {n};
+    npy_intp strides[1] = {stride};
+    // An empty array need not (and, with NULL data, must not) view anything.
+    if (n == 0) return PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+    return createNumPyView(data, 1, dims, strides, writable, owner);
+}
+
+// View a SimTK::Vector, whose elements need not be contiguous.
+PyObject* createNumPyView(const SimTK::Vector& v, bool writable,
+                          PyObject* owner)
+{
+    int n = v.size();
+    int stride = n > 1 ? (int)(&v[1] - &v[0]) : 1;
+    return createNumPyView(n > 0 ? &v[0] : NULL, n, stride, writable, owner);
+}
+
+// Copy an Array into a new NumPy array.
+PyObject* createNumPyCopy(const OpenSim::Array<double>& a)
+{
+    npy_intp dims[1] = {a.getSize()};
+    PyObject* array = PyArray_SimpleNew(1, dims, NPY_DOUBLE);
+    if (array && a.getSize() > 0)
+        memcpy(PyArray_DATA((PyArrayObject*)array), a.get(),
+               a.getSize()*sizeof(double));
+    return array;
+}
+
+void checkNumPySize(const char* method, int expected, int size)
+{
+    if (size != expected) {
+        std::stringstream msg;
+        msg << method << ": expected " << expected << " values but got "
+            << size << ".";
+        throw OpenSim::Exception(msg.str());
+    }
+}
+}
+%}
+
+/* The bulk setters check sizes; raise their errors as Python exceptions. */
+%define NUMPY_EXCEPTION(METHOD)
+%exception METHOD {
+    try {
+        $action
+    }
+    catch(const std::exception& _ex) {
+        PyErr_SetString(PyExc_RuntimeError, _ex.what());
+        SWIG_fail;
+    }
+}
+%enddef
+
+NUMPY_EXCEPTION(SimTK::Vector_<double>::setFromPyArray);
+NUMPY_EXCEPTION(SimTK::State::setQFromPyArray);
+NUMPY_EXCEPTION(SimTK::State::setUFromPyArray);
+NUMPY_EXCEPTION(SimTK::State::setZFromPyArray);
+NUMPY_EXCEPTION(OpenSim::Storage::appendRows);
+NUMPY_EXCEPTION(OpenSim::Storage::_getDataColumnAsNumPy);
+
+%extend OpenSim::Array<double> {
+    PyObject* _asNumPy(PyObject* owner) {
+        return createNumPyView(self->get(), self->getSize(), 1, true, owner);
+    }
+%pythoncode %{
+    def asNumPy(self):
+        """A writable NumPy array viewing the elements of this Array. The
+        view is invalidated if the Array is resized."""
+        return self._asNumPy(self)
+%}
+};
+
+%extend SimTK::Vector_<double> {
+    PyObject* _asNumPy(PyObject* owner) {
+        return createNumPyView(*self, true, owner);
+    }
+    void setFromPyArray(double* dValues, int size) {
+        self->resize(size);
+        for (int i = 0; i < size; ++i)
+            (*self)[i] = dValues[i];
+    }
+%pythoncode %{
+    def asNumPy(self):
+        """A writable NumPy array viewing the elements of this Vector. The
+        view is invalidated if the Vector is resized. Use the State's bulk
+        setters rather than writing to views of a State's Q, U or Z."""
+        return self._asNumPy(self)
+%}
+};
+
+%extend SimTK::State {
+    PyObject* _getQAsNumPy(PyObject* owner) const {
+        return createNumPyView(self->getQ(), false, owner);
+    }
+    PyObject* _getUAsNumPy(PyObject* owner) const {
+        return createNumPyView(self->getU(), false, owner);
+    }
+    PyObject* _getZAsNumPy(PyObject* owner) const {
+        return createNumPyView(self->getZ(), false, owner);
+    }
+    PyObject* _getYAsNumPy(PyObject* owner) const {
+        return createNumPyView(self->getY(), false, owner);
+    }
+    void setQFromPyArray(double* dValues, int size) {
+        checkNumPySize("State.setQFromPyArray", self->getNQ(), size);
+        self->updQ() = SimTK::Vector(size, dValues);
+    }
+    void setUFromPyArray(double* dValues, int size) {
+        checkNumPySize("State.setUFromPyArray", self->getNU(), size);
+        self->updU() = SimTK::Vector(size, dValues);
+    }
+    void setZFromPyArray(double* dValues, int size) {
+        checkNumPySize("State.setZFromPyArray", self->getNZ(), size);
+        self->updZ() = SimTK::Vector(size, dValues);
+    }
+%pythoncode %{
+    def getQAsNumPy(self):
+        """A read-only NumPy array viewing the generalized coordinates of
+        this State. Set them with setQFromPyArray(), which invalidates what
+        was computed from them."""
+        return self._getQAsNumPy(self)
+
+    def getUAsNumPy(self):
+        """A read-only NumPy array viewing the generalized speeds of this
+        State. Set them with setUFromPyArray()."""
+        return self._getUAsNumPy(self)
+
+    def getZAsNumPy(self):
+        """A read-only NumPy array viewing the auxiliary states of this
+        State. Set them with setZFromPyArray()."""
+        return self._getZAsNumPy(self)
+
+    def getYAsNumPy(self):
+        """A read-only NumPy array viewing Q, U and Z of this State, packed
+        in that order."""
+        return self._getYAsNumPy(self)
+%}
+};
+
+%extend OpenSim::Storage {
+    void appendRows(double* times, int nTimes,
+                    double* rows, int nRows, int nColumns) {
+        checkNumPySize("Storage.appendRows", nRows, nTimes);
+        // Rows appended to an empty Storage are held in columns, which
+        // appends without allocating per row and can be viewed in place.
+        if (self->getSize() == 0 && self->getNumFlushedRows() == 0)
+            self->setColumnar(true);
+        for (int i = 0; i < nRows; ++i)
+            self->append(times[i], nColumns, rows + i*nColumns);
+    }
+    PyObject* _getTimeColumnAsNumPy(PyObject* owner) {
+        if (self->setColumnar(true) && self->getTimeColumnBuffer())
+            return createNumPyView(self->getTimeColumnBuffer(),
+                                   self->getSize(), 1, false, owner);
+        OpenSim::Array<double> times;
+        self->getTimeColumn(times);
+        return createNumPyCopy(times);
+    }
+    PyObject* _getDataColumnAsNumPy(int stateIndex, PyObject* owner) {
+        if (stateIndex < 0 || stateIndex >= self->getSmallestNumberOfStates())
+            throw OpenSim::Exception(
+                "Storage.getDataColumnAsNumPy: column index out of range.");
+        if (self->setColumnar(true) && self->getDataColumnBuffer(stateIndex))
+            return createNumPyView(self->getDataColumnBuffer(stateIndex),
+                                   self->getSize(), 1, false, owner);
+        OpenSim::Array<double> column;
+        self->getDataColumn(stateIndex, column);
+        return createNumPyCopy(column);
+    }
+    PyObject* _getDataAsNumPy(PyObject* owner) {
+        int nr = self->getSize();
+        int nc = self->getSmallestNumberOfStates();
+        if (nc < 0) nc = 0;
+        npy_intp dims[2] = {nr, nc};
+        // Columns of a columnar Storage are equally spaced blocks of one
+        // buffer, so all of the data can be viewed as one matrix.
+        if (nr > 0 && nc > 0 && self->setColumnar(true) &&
+                self->getDataColumnBuffer(0)) {
+            const double* data = self->getDataColumnBuffer(0);
+            npy_intp columnStride = nc > 1 ?
+                self->getDataColumnBuffer(1) - data : nr;
+            npy_intp strides[2] = {1, columnStride};
+            return createNumPyView(data, 2, dims, strides, false, owner);
+        }
+        PyObject* array = PyArray_SimpleNew(2, dims, NPY_DOUBLE);
+        if (!array) return NULL;
+        double* out = (double*)PyArray_DATA((PyArrayObject*)array);
+        OpenSim::Array<double> column;
+        for (int j = 0; j < nc; ++j) {
+            self->getDataColumn(j, column);
+            for (int i = 0; i < nr && i < column.getSize(); ++i)
+                out[i*nc + j] = column[i];
+        }
+        return array;
+    }
+%pythoncode %{
+    def getTimeColumnAsNumPy(self):
+        """The times of the rows in memory as a read-only NumPy array. The
+        array views the Storage, which is converted to its columnar layout
+        if need be (see setColumnar()), unless the rows cannot be held in
+        columns, in which case it is a copy. Appending rows invalidates the
+        view."""
+        return self._getTimeColumnAsNumPy(self)
+
+    def getDataColumnAsNumPy(self, column):
+        """A data column, given by its index (not counting time) or its
+        label, as a read-only NumPy array that views the Storage as
+        getTimeColumnAsNumPy() does."""
+        if isinstance(column, str):
+            index = self.getStateIndex(column)
+            if index < 0:
+                raise KeyError(column)
+            column = index
+        return self._getDataColumnAsNumPy(column, self)
+
+    def getDataAsNumPy(self):
+        """All data in memory as a read-only NumPy array of one row per time
+        and one column per state (not counting time), viewing the Storage as
+        getTimeColumnAsNumPy() does."""
+        return self._getDataAsNumPy(self)
+%}
+};
 /* rest of header files to be wrapped */
 %include <OpenSim/version.h>
 %include <SimTKcommon.h>
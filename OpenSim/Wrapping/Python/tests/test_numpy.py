@@ -0,0 +1,85 @@
+"""The tests here ensure that data are exchanged with NumPy arrays in bulk,
+and that the arrays view the C++ data rather than copy them where the data
+are contiguous.
+
+"""
+import os
+import time
+
+import numpy as np
+
+import opensim as osim
+
+def test_array_view():
+    a = osim.ArrayDouble()
+    a.setFromPyArray(np.arange(5.0))
+    assert a.getSize() == 5
+    view = a.asNumPy()
+    assert np.array_equal(view, np.arange(5.0))
+    # Writing through the view writes the Array.
+    view[2] = 10.0
+    assert a.getitem(2) == 10.0
+
+def test_vector_view():
+    v = osim.Vector()
+    v.setFromPyArray(np.linspace(0, 1, 7))
+    assert v.size() == 7
+    view = v.asNumPy()
+    view[0] = -1.0
+    assert v.get(0) == -1.0
+    assert np.array_equal(view[1:], np.linspace(0, 1, 7)[1:])
+
+def test_state_views():
+    model = osim.Model(os.environ['OPENSIM_HOME'] +
+            "/Models/Arm26/arm26.osim")
+    state = model.initSystem()
+
+    q = np.linspace(0.1, 0.2, state.getNQ())
+    state.setQFromPyArray(q)
+    assert np.array_equal(state.getQAsNumPy(), q)
+    assert not state.getQAsNumPy().flags.writeable
+    state.setUFromPyArray(-q[:state.getNU()])
+    assert np.array_equal(state.getUAsNumPy(), -q[:state.getNU()])
+    y = state.getYAsNumPy()
+    assert y.size == state.getNQ() + state.getNU() + state.getNZ()
+    assert np.array_equal(y[:state.getNQ()], q)
+
+    # Sizes are checked.
+    try:
+        state.setQFromPyArray(np.zeros(state.getNQ() + 1))
+        assert False
+    except RuntimeError:
+        pass
+
+def test_storage_round_trip():
+    nRows, nColumns = 100000, 100
+    times = 0.001 * np.arange(nRows)
+    data = np.random.RandomState(0).rand(nRows, nColumns)
+    labels = osim.ArrayStr()
+    labels.append("time")
+    for j in range(nColumns):
+        labels.append("c%d" % j)
+
+    storage = osim.Storage()
+    storage.setColumnLabels(labels)
+    start = time.time()
+    storage.appendRows(times, data)
+    appendTime = time.time() - start
+    assert storage.getSize() == nRows
+
+    start = time.time()
+    out = storage.getDataAsNumPy()
+    outTimes = storage.getTimeColumnAsNumPy()
+    viewTime = time.time() - start
+    assert out.shape == (nRows, nColumns)
+    assert np.array_equal(out, data)
+    assert np.array_equal(outTimes, times)
+    assert np.array_equal(storage.getDataColumnAsNumPy("c42"), data[:, 42])
+    assert np.array_equal(storage.getDataColumnAsNumPy(7), data[:, 7])
+
+    # The columns are viewed, not copied.
+    assert not out.flags.owndata
+    assert not out.flags.writeable
+
+    print("Storage round-trip of %d x %d: appendRows %.3fs, "
+          "getDataAsNumPy %.6fs." % (nRows, nColumns, appendTime, viewTime))
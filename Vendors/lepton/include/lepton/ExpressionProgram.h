@@ -82,11 +82,30 @@ public:
      *                     will be thrown.
      */
     double evaluate(const std::map<std::string, double>& variables) const;
+    /**
+     * Resolve the variables that appear in the expression to positions in an array of values.  After this
+     * the program can be evaluated with evaluate(const double*), which neither looks up variables by name
+     * nor allocates memory, and so is much faster when the program is evaluated many times.
+     *
+     * @param variables    the names of the variables, in the order their values will be passed to
+     *                     evaluate(const double*).  Names that do not appear in the expression are allowed.
+     *                     If a variable appears in the expression but is not in this list, an exception
+     *                     will be thrown and the previous binding, if any, is left unchanged.
+     */
+    void bindVariables(const std::vector<std::string>& variables);
+    /**
+     * Evaluate the expression using the variables resolved by bindVariables().
+     *
+     * @param values       the values of the variables, in the order their names were passed to
+     *                     bindVariables().
+     */
+    double evaluate(const double* values) const;
 private:
     friend class ParsedExpression;
     ExpressionProgram(const ParsedExpression& expression);
     void buildProgram(const ExpressionTreeNode& node);
     std::vector<Operation*> operations;
+    std::vector<int> variableSlots;
     int maxArgs, stackSize;
 };
 
@@ -30,6 +30,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "lepton/ExpressionProgram.h"
+#include "lepton/Exception.h"
 #include "lepton/Operation.h"
 #include "lepton/ParsedExpression.h"
 
@@ -64,6 +65,7 @@ ExpressionProgram::ExpressionProgram(const ExpressionProgram& program) {
 ExpressionProgram& ExpressionProgram::operator=(const ExpressionProgram& program) {
     maxArgs = program.maxArgs;
     stackSize = program.stackSize;
+    variableSlots = program.variableSlots;
     operations.resize(program.operations.size());
     for (int i = 0; i < (int) operations.size(); i++)
         operations[i] = program.operations[i]->clone();
@@ -103,3 +105,49 @@ double ExpressionProgram::evaluate(const std::map<std::string, double>& variable
     }
     return stack[stackSize-1];
 }
+
+void ExpressionProgram::bindVariables(const vector<string>& variables) {
+    // Bind into a local vector so a failure leaves the previous binding intact.
+    vector<int> slots(operations.size(), -1);
+    for (int i = 0; i < (int) operations.size(); i++) {
+        if (operations[i]->getId() != Operation::VARIABLE)
+            continue;
+        for (int j = 0; j < (int) variables.size(); j++)
+            if (variables[j] == operations[i]->getName()) {
+                slots[i] = j;
+                break;
+            }
+        if (slots[i] == -1)
+            throw Exception("bindVariables: No value given for variable '"+operations[i]->getName()+"'");
+    }
+    variableSlots.swap(slots);
+}
+
+double ExpressionProgram::evaluate(const double* values) const {
+    static const map<string, double> noVariables;
+    if (variableSlots.size() != operations.size())
+        throw Exception("evaluate: bindVariables() must be called before evaluating with an array of values");
+
+    // Keep the stack on the call stack unless the program is unusually deep.
+    const int localStackSize = 64;
+    double localStack[localStackSize];
+    vector<double> largeStack;
+    double* stack = localStack;
+    if (stackSize+1 > localStackSize) {
+        largeStack.resize(stackSize+1);
+        stack = &largeStack[0];
+    }
+    int stackPointer = stackSize;
+    for (int i = 0; i < (int) operations.size(); i++) {
+        if (variableSlots[i] >= 0) {
+            stackPointer--;
+            stack[stackPointer] = values[variableSlots[i]];
+            continue;
+        }
+        int numArgs = operations[i]->getNumArguments();
+        double result = operations[i]->evaluate(&stack[stackPointer], noVariables);
+        stackPointer += numArgs-1;
+        stack[stackPointer] = result;
+    }
+    return stack[stackSize-1];
+}
@@ -292,36 +292,42 @@ Operation* Parser::getOperatorOperation(const std::string& name) {
     }
 }
 
+static map<string, Operation::Id> createFunctionOperationMap() {
+    map<string, Operation::Id> opMap;
+    opMap["sqrt"] = Operation::SQRT;
+    opMap["exp"] = Operation::EXP;
+    opMap["log"] = Operation::LOG;
+    opMap["sin"] = Operation::SIN;
+    opMap["cos"] = Operation::COS;
+    opMap["sec"] = Operation::SEC;
+    opMap["csc"] = Operation::CSC;
+    opMap["tan"] = Operation::TAN;
+    opMap["cot"] = Operation::COT;
+    opMap["asin"] = Operation::ASIN;
+    opMap["acos"] = Operation::ACOS;
+    opMap["atan"] = Operation::ATAN;
+    opMap["sinh"] = Operation::SINH;
+    opMap["cosh"] = Operation::COSH;
+    opMap["tanh"] = Operation::TANH;
+    opMap["erf"] = Operation::ERF;
+    opMap["erfc"] = Operation::ERFC;
+    opMap["step"] = Operation::STEP;
+    opMap["delta"] = Operation::DELTA;
+    opMap["square"] = Operation::SQUARE;
+    opMap["cube"] = Operation::CUBE;
+    opMap["recip"] = Operation::RECIPROCAL;
+    opMap["min"] = Operation::MIN;
+    opMap["max"] = Operation::MAX;
+    opMap["abs"] = Operation::ABS;
+    return opMap;
+}
+
+// Built when the library is loaded rather than on first use, so that
+// expressions may be parsed on several threads at once.
+static const map<string, Operation::Id> opMap = createFunctionOperationMap();
+
 Operation* Parser::getFunctionOperation(const std::string& name, const map<string, CustomFunction*>& customFunctions) {
 
-    static map<string, Operation::Id> opMap;
-    if (opMap.size() == 0) {
-        opMap["sqrt"] = Operation::SQRT;
-        opMap["exp"] = Operation::EXP;
-        opMap["log"] = Operation::LOG;
-        opMap["sin"] = Operation::SIN;
-        opMap["cos"] = Operation::COS;
-        opMap["sec"] = Operation::SEC;
-        opMap["csc"] = Operation::CSC;
-        opMap["tan"] = Operation::TAN;
-        opMap["cot"] = Operation::COT;
-        opMap["asin"] = Operation::ASIN;
-        opMap["acos"] = Operation::ACOS;
-        opMap["atan"] = Operation::ATAN;
-        opMap["sinh"] = Operation::SINH;
-        opMap["cosh"] = Operation::COSH;
-        opMap["tanh"] = Operation::TANH;
-        opMap["erf"] = Operation::ERF;
-        opMap["erfc"] = Operation::ERFC;
-        opMap["step"] = Operation::STEP;
-        opMap["delta"] = Operation::DELTA;
-        opMap["square"] = Operation::SQUARE;
-        opMap["cube"] = Operation::CUBE;
-        opMap["recip"] = Operation::RECIPROCAL;
-        opMap["min"] = Operation::MIN;
-        opMap["max"] = Operation::MAX;
-        opMap["abs"] = Operation::ABS;
-    }
     string trimmed = name.substr(0, name.size()-1);
 
     // First check custom functions.
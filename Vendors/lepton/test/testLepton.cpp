@@ -39,6 +39,30 @@ int main() {
 		value = Lepton::Parser::parse("sqrt(x)-1").evaluate(variables);
 		ASSERT(fabs(value-2.) < 1E-7);
         Lepton::Parser::parse("state.muscle1.activation^2");
+
+		// Variables bound to positions in an array of values
+		Lepton::ExpressionProgram program = Lepton::Parser::parse("y*sqrt(x)-1").optimize().createProgram();
+		vector<string> names;
+		names.push_back("x");
+		names.push_back("unused");
+		names.push_back("y");
+		program.bindVariables(names);
+		double values[] = {9.0, 0.0, 2.0};
+		ASSERT(fabs(program.evaluate(values)-5.) < 1E-7);
+		variables["y"] = 2.0;
+		ASSERT(program.evaluate(values) == program.evaluate(variables));
+		Lepton::ExpressionProgram copy = program;
+		values[0] = 16.0;
+		ASSERT(fabs(copy.evaluate(values)-7.) < 1E-7);
+		bool unboundThrew = false;
+		try {
+			names.pop_back();
+			program.bindVariables(names);
+		}
+		catch (const Lepton::Exception&) {
+			unboundThrew = true;
+		}
+		ASSERT(unboundThrew);
     }
     catch (...) {
 		//cout << "Failed" << endl;